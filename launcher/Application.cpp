@@ -15,6 +15,7 @@
 #include "ui/pages/global/ExternalToolsPage.h"
 #include "ui/pages/global/AccountListPage.h"
 #include "ui/pages/global/PasteEEPage.h"
+#include "ui/pages/global/NetworkStatsPage.h"
 #include "ui/pages/global/CustomCommandsPage.h"
 
 #include "ui/themes/ITheme.h"
@@ -45,12 +46,17 @@
 #include <QStringList>
 #include <QDebug>
 #include <QStyleFactory>
+#include <QJsonDocument>
+#include <QRegExp>
 
 #include "InstanceList.h"
 
 #include <minecraft/auth/AccountList.h>
 #include "icons/IconList.h"
 #include "net/HttpMetaCache.h"
+#include "net/NetworkStats.h"
+#include "net/Mirrors.h"
+#include "ImageLoader.h"
 
 #include "java/JavaUtils.h"
 
@@ -64,9 +70,13 @@
 
 #include "translations/TranslationsModel.h"
 #include "meta/Index.h"
+#include "minecraft/update/BatchUpdateTask.h"
+#include "tasks/TaskScheduler.h"
 
 #include <Commandline.h>
 #include <FileSystem.h>
+#include <Json.h>
+#include <Exception.h>
 #include <DesktopServices.h>
 #include <LocalPeer.h>
 
@@ -210,6 +220,16 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         parser.addOption("import");
         parser.addShortOpt("import", 'I');
         parser.addDocumentation("import", "Import instance from specified zip (local path or URL)");
+        // --update
+        parser.addOption("update");
+        parser.addShortOpt("update", 'u');
+        parser.addDocumentation("update", "Update the specified instances (comma separated instance IDs, or 'all') without showing any window, then exit", "ids");
+        // --report
+        parser.addOption("report");
+        parser.addDocumentation("report", "Write the results of --update as JSON into the specified file instead of the standard output", "file");
+        // --max-downloads
+        parser.addOption("max-downloads", 6);
+        parser.addDocumentation("max-downloads", "How many files --update downloads at the same time", "count");
 
         // parse the arguments
         try
@@ -248,6 +268,15 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
     m_profileToUse = args["profile"].toString();
     m_liveCheck = args["alive"].toBool();
     m_zipToImport = args["import"].toUrl();
+    {
+        auto update = args["update"].toString();
+        if(!update.isEmpty())
+        {
+            m_instancesToUpdate = update.split(',', QString::SkipEmptyParts);
+        }
+    }
+    m_updateReport = args["report"].toString();
+    m_maxDownloads = args["max-downloads"].toInt();
 
     QString origcwdPath = QDir::currentPath();
     QString binPath = applicationDirPath();
@@ -322,6 +351,27 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         return;
     }
 
+    if(!m_instancesToUpdate.isEmpty() && !m_instanceIdToLaunch.isEmpty())
+    {
+        std::cerr << "--update cannot be used in combination with --launch!" << std::endl;
+        m_status = Application::Failed;
+        return;
+    }
+
+    if(m_instancesToUpdate.isEmpty() && !m_updateReport.isEmpty())
+    {
+        std::cerr << "--report can only be used in combination with --update!" << std::endl;
+        m_status = Application::Failed;
+        return;
+    }
+
+    if(m_maxDownloads < 1)
+    {
+        std::cerr << "--max-downloads needs a positive number!" << std::endl;
+        m_status = Application::Failed;
+        return;
+    }
+
 #if defined(Q_OS_MAC)
     // move user data to new location if on macOS and it still exists in Contents/MacOS
     QDir fi(applicationDirPath());
@@ -398,6 +448,14 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         if(m_peerInstance->isClient()) {
             int timeout = 2000;
 
+            // the running launcher owns the caches and instances, updating them from here would fight over them
+            if(!m_instancesToUpdate.isEmpty())
+            {
+                std::cerr << "--update cannot be used while the launcher is running!" << std::endl;
+                m_status = Application::Failed;
+                return;
+            }
+
             if(m_instanceIdToLaunch.isEmpty())
             {
                 ApplicationMessage activate;
@@ -520,7 +578,9 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
 
     // Initialize application settings
     {
-        m_settings.reset(new INISettingsObject(BuildConfig.LAUNCHER_CONFIGFILE, this));
+        auto settings = new INISettingsObject(BuildConfig.LAUNCHER_CONFIGFILE, this);
+        settings->setSaveDelay();
+        m_settings.reset(settings);
 
         // Theming
         m_settings->registerSetting("IconTheme", QString("multimc"));
@@ -611,6 +671,23 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         m_settings->registerSetting("ShowGlobalGameTime", true);
         m_settings->registerSetting("RecordGameTime", true);
 
+        // Warm the page cache with the game files during the launch
+        m_settings->registerSetting("PrefetchGameFiles", false);
+        m_settings->registerSetting("PrefetchBudgetMiB", 1024);
+
+        // Launch without touching the network when nothing changed since the last update
+        m_settings->registerSetting("WarmLaunch", true);
+        m_settings->registerSetting("WarmLaunchMaxAgeHours", 24);
+
+        // Where to get game files from when their usual server fails, and whether missing assets stop an update
+        m_settings->registerSetting("AssetsMirrors", "");
+        m_settings->registerSetting("LibrariesMirrors", "");
+        m_settings->registerSetting("MetaMirrors", "");
+        m_settings->registerSetting("AllowOptionalDownloadFailures", true);
+
+        // Resolve Flame pack files with a single request, when there is a service for it
+        m_settings->registerSetting("FlameBatchResolveURL", "");
+
         // Minecraft launch method
         m_settings->registerSetting("MCLaunchMethod", "LauncherPart");
 
@@ -655,6 +732,7 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
             m_globalSettingsProvider->addPage<ExternalToolsPage>();
             m_globalSettingsProvider->addPage<AccountListPage>();
             m_globalSettingsProvider->addPage<PasteEEPage>();
+            m_globalSettingsProvider->addPage<NetworkStatsPage>();
         }
         qDebug() << "<> Settings loaded.";
     }
@@ -672,6 +750,11 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         QString user = settings()->get("ProxyUser").toString();
         QString pass = settings()->get("ProxyPass").toString();
         updateProxySettings(proxyTypeStr, addr, port, user, pass);
+        updateDownloadMirrors(
+            settings()->get("AssetsMirrors").toString(),
+            settings()->get("LibrariesMirrors").toString(),
+            settings()->get("MetaMirrors").toString()
+        );
         qDebug() << "<> Network done.";
     }
 
@@ -770,6 +853,7 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         m_metacache->addBase("ModpacksCHPacks", QDir("cache/ModpacksCHPacks").absolutePath());
         m_metacache->addBase("TechnicPacks", QDir("cache/TechnicPacks").absolutePath());
         m_metacache->addBase("FlamePacks", QDir("cache/FlamePacks").absolutePath());
+        m_metacache->addBase("FlameMeta", QDir("cache/FlameMeta").absolutePath());
         m_metacache->addBase("root", QDir::currentPath());
         m_metacache->addBase("translations", QDir("translations").absolutePath());
         m_metacache->addBase("icons", QDir("cache/icons").absolutePath());
@@ -800,6 +884,19 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
             // save any remaining instance state
             m_instances->saveNow();
         }
+        INISettingsObject::flushAll();
+        // next to the launcher log, so both can be looked at when downloads were slow
+        if(!Net::NetworkStats::instance()->hosts().isEmpty())
+        {
+            try
+            {
+                Json::write(Net::NetworkStats::instance()->toJson(), BuildConfig.LAUNCHER_NAME + "-network.json");
+            }
+            catch (const Exception &e)
+            {
+                qWarning() << "Couldn't save network statistics:" << e.cause();
+            }
+        }
         if(logFile)
         {
             logFile->flush();
@@ -814,6 +911,12 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         qDebug() << "<> Application theme set.";
     }
 
+    if(!m_instancesToUpdate.isEmpty())
+    {
+        performBatchUpdate();
+        return;
+    }
+
     if(createSetupWizard())
     {
         return;
@@ -821,6 +924,67 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
     performMainStartupAction();
 }
 
+void Application::performBatchUpdate()
+{
+    m_status = Application::Initialized;
+
+    QList<InstancePtr> instances;
+    if(m_instancesToUpdate == QStringList() << "all")
+    {
+        for(int i = 0; i < m_instances->count(); i++)
+        {
+            instances.append(m_instances->at(i));
+        }
+    }
+    else
+    {
+        for(auto &id: m_instancesToUpdate)
+        {
+            auto inst = m_instances->getInstanceById(id);
+            if(!inst)
+            {
+                std::cerr << "There is no instance with the ID " << id.toStdString() << "!" << std::endl;
+                m_status = Application::Failed;
+                return;
+            }
+            instances.append(inst);
+        }
+    }
+
+    qDebug() << "<> Updating" << instances.size() << "instances";
+    // nothing else competes for the network here, let the job use as many connections as it was asked to
+    auto scheduler = TaskScheduler::instance();
+    scheduler->setBudget(TaskScheduler::Network, qMax(m_maxDownloads, scheduler->budget(TaskScheduler::Network)));
+    m_batchUpdate.reset(new BatchUpdateTask(instances, m_maxDownloads));
+    connect(m_batchUpdate.get(), &Task::status, [](const QString & status)
+    {
+        std::cerr << status.toStdString() << std::endl;
+    });
+    connect(m_batchUpdate.get(), &Task::finished, this, [this]()
+    {
+        auto report = QJsonDocument(m_batchUpdate->report()).toJson();
+        if(m_updateReport.isEmpty() || m_updateReport == "-")
+        {
+            std::cout << report.constData();
+        }
+        else
+        {
+            try
+            {
+                FS::write(m_updateReport, report);
+            }
+            catch (const Exception &e)
+            {
+                std::cerr << "Could not write the report: " << e.cause().toStdString() << std::endl;
+            }
+        }
+        qDebug() << "<> Update finished:" << (m_batchUpdate->wasSuccessful() ? "succeeded" : m_batchUpdate->failReason());
+        exit(m_batchUpdate->wasSuccessful() ? 0 : 1);
+    });
+    // start once the event loop runs, exit() does nothing before that
+    QMetaObject::invokeMethod(m_batchUpdate.get(), "start", Qt::QueuedConnection);
+}
+
 bool Application::createSetupWizard()
 {
     bool javaRequired = [&]()
@@ -1322,6 +1486,14 @@ QString Application::msaClientId() const {
     return Secrets::getMSAClientID('-');
 }
 
+void Application::updateDownloadMirrors(QString assets, QString libraries, QString meta)
+{
+    auto mirrors = Net::Mirrors::instance();
+    mirrors->setMirrors(BuildConfig.RESOURCE_BASE, assets.split(QRegExp("\\s+"), QString::SkipEmptyParts));
+    mirrors->setMirrors(BuildConfig.LIBRARY_BASE, libraries.split(QRegExp("\\s+"), QString::SkipEmptyParts));
+    mirrors->setMirrors(BuildConfig.META_URL, meta.split(QRegExp("\\s+"), QString::SkipEmptyParts));
+}
+
 void Application::updateProxySettings(QString proxyTypeStr, QString addr, int port, QString user, QString password)
 {
     // Set the application proxy settings.
@@ -1402,6 +1574,15 @@ shared_qobject_ptr<Meta::Index> Application::metadataIndex()
     return m_metadataIndex;
 }
 
+shared_qobject_ptr<ImageLoader> Application::images()
+{
+    if (!m_images)
+    {
+        m_images.reset(new ImageLoader(m_network, QDir("cache/thumbnails").absolutePath()));
+    }
+    return m_images;
+}
+
 QString Application::getJarsPath()
 {
     if(m_jarsPath.isEmpty())
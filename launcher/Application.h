@@ -32,6 +32,8 @@ class BaseDetachedToolFactory;
 class TranslationsModel;
 class ITheme;
 class MCEditTool;
+class ImageLoader;
+class BatchUpdateTask;
 
 namespace Meta {
     class Index;
@@ -106,12 +108,17 @@ public:
 
     void updateProxySettings(QString proxyTypeStr, QString addr, int port, QString user, QString password);
 
+    /// Each argument is a whitespace separated list of base URLs to fall back to
+    void updateDownloadMirrors(QString assets, QString libraries, QString meta);
+
     shared_qobject_ptr<QNetworkAccessManager> network();
 
     shared_qobject_ptr<HttpMetaCache> metacache();
 
     shared_qobject_ptr<Meta::Index> metadataIndex();
 
+    shared_qobject_ptr<ImageLoader> images();
+
     QString getJarsPath();
 
     /*!
@@ -149,6 +156,7 @@ private slots:
 private:
     bool createSetupWizard();
     void performMainStartupAction();
+    void performBatchUpdate();
 
     // sets the fatal error message and m_status to Failed.
     void showFatalErrorMessage(const QString & title, const QString & content);
@@ -167,6 +175,7 @@ private:
 
     shared_qobject_ptr<HttpMetaCache> m_metacache;
     shared_qobject_ptr<Meta::Index> m_metadataIndex;
+    shared_qobject_ptr<ImageLoader> m_images;
 
     std::shared_ptr<SettingsObject> m_settings;
     std::shared_ptr<InstanceList> m_instances;
@@ -208,11 +217,17 @@ private:
     LocalPeer * m_peerInstance = nullptr;
 
     SetupWizard * m_setupWizard = nullptr;
+
+    // headless update of instances, see --update
+    shared_qobject_ptr<BatchUpdateTask> m_batchUpdate;
 public:
     QString m_instanceIdToLaunch;
     QString m_serverToJoin;
     QString m_profileToUse;
     bool m_liveCheck = false;
     QUrl m_zipToImport;
+    QStringList m_instancesToUpdate;
+    QString m_updateReport;
+    int m_maxDownloads = 6;
     std::unique_ptr<QFile> logFile;
 };
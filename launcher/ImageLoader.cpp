@@ -0,0 +1,223 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ImageLoader.h"
+
+#include "Application.h"
+#include "FileSystem.h"
+#include "net/NetJob.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QPixmap>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+namespace {
+// enough for a pack page full of logos, but not for a whole catalog
+const int maxFetches = 6;
+// images requested while scrolling quickly past them are dropped again
+const int maxQueued = 64;
+const int memoryBudget = 32 * 1024 * 1024;
+// most failures are network trouble or a server having a bad moment, so they are not remembered forever
+const qint64 failureRetryMs = 5 * 60 * 1000;
+}
+
+ImageLoader::ImageLoader(shared_qobject_ptr<QNetworkAccessManager> network, const QString &thumbnailRoot, QObject *parent)
+    : QObject(parent), m_network(network), m_thumbnailRoot(thumbnailRoot), m_icons(memoryBudget)
+{
+    m_decodePool.setMaxThreadCount(2);
+    m_clock.start();
+}
+
+ImageLoader::~ImageLoader()
+{
+    m_decodePool.waitForDone();
+}
+
+QString ImageLoader::originalPath(const QString &base, const QString &path) const
+{
+    return APPLICATION->metacache()->resolveEntry(base, path)->getFullPath();
+}
+
+QString ImageLoader::thumbnailPath(const Request &request) const
+{
+    auto name = QString("%1@%2x%3.png").arg(request.path).arg(request.size.width()).arg(request.size.height());
+    return FS::PathCombine(m_thumbnailRoot, request.base, name);
+}
+
+QIcon ImageLoader::icon(const QString &base, const QString &path, const QUrl &url, const QSize &size)
+{
+    auto key = QString("%1/%2@%3x%4").arg(base, path).arg(size.width()).arg(size.height());
+    if(auto cached = m_icons.object(key))
+    {
+        return *cached;
+    }
+    if(m_pending.contains(key))
+    {
+        return QIcon();
+    }
+    auto failed = m_failed.find(key);
+    if(failed != m_failed.end())
+    {
+        if(m_clock.elapsed() - *failed < failureRetryMs)
+        {
+            return QIcon();
+        }
+        m_failed.erase(failed);
+    }
+
+    // thumbnails are made at twice the display size, so they stay sharp on high DPI screens
+    Request request{key, base, path, url, size * 2};
+    m_pending.insert(key, request);
+
+    // the same checks the cached download would do, without setting up a job for every logo
+    auto entry = APPLICATION->metacache()->resolveEntry(base, path);
+    if(entry->isStale() || !QFile::exists(entry->getFullPath()))
+    {
+        enqueue(key);
+    }
+    else
+    {
+        QFileInfo thumbnail(thumbnailPath(request));
+        decode(request, thumbnail.exists() && thumbnail.lastModified() >= QFileInfo(entry->getFullPath()).lastModified());
+    }
+    return QIcon();
+}
+
+void ImageLoader::enqueue(const QString &key)
+{
+    m_queue.append(key);
+    if(m_queue.size() > maxQueued)
+    {
+        // it will be requested again if it's still on screen
+        m_pending.remove(m_queue.takeFirst());
+    }
+    fetchNext();
+}
+
+void ImageLoader::fetchNext()
+{
+    while(m_fetching < maxFetches && !m_queue.isEmpty())
+    {
+        auto request = m_pending.value(m_queue.takeLast());
+
+        auto entry = APPLICATION->metacache()->resolveEntry(request.base, request.path);
+        auto job = new NetJob(QString("Image Download %1").arg(request.path));
+        job->setPriority(TaskScheduler::Priority::Background);
+        job->addNetAction(Net::Download::makeCached(request.url, entry));
+
+        connect(job, &NetJob::succeeded, this, [this, job, request]
+        {
+            m_fetching--;
+            job->deleteLater();
+            decode(request, false);
+            fetchNext();
+        });
+        connect(job, &NetJob::failed, this, [this, job, request](QString reason)
+        {
+            qWarning() << "Failed to download image" << request.url.toString() << ":" << reason;
+            m_fetching--;
+            job->deleteLater();
+            m_pending.remove(request.key);
+            m_failed.insert(request.key, m_clock.elapsed());
+            fetchNext();
+        });
+
+        // cache hits finish right away, before start() returns
+        m_fetching++;
+        job->start(m_network);
+    }
+}
+
+void ImageLoader::decode(const Request &request, bool fromThumbnail)
+{
+    auto source = fromThumbnail ? thumbnailPath(request) : originalPath(request.base, request.path);
+    auto target = thumbnailPath(request);
+    auto size = request.size;
+
+    auto watcher = new QFutureWatcher<QImage>(this);
+    auto key = request.key;
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, key, fromThumbnail]
+    {
+        decoded(key, watcher->result(), fromThumbnail);
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&m_decodePool, [source, target, size, fromThumbnail]
+    {
+        auto image = thumbnail(source, size);
+        if(!image.isNull() && !fromThumbnail)
+        {
+            QSaveFile file(target);
+            if(!FS::ensureFilePathExists(target) || !file.open(QIODevice::WriteOnly) || !image.save(&file, "PNG") || !file.commit())
+            {
+                qWarning() << "Could not save thumbnail" << target;
+            }
+        }
+        return image;
+    }));
+}
+
+void ImageLoader::decoded(const QString &key, const QImage &image, bool fromThumbnail)
+{
+    if(image.isNull())
+    {
+        if(fromThumbnail)
+        {
+            // a broken thumbnail, make a new one from the original
+            qWarning() << "Discarding unreadable thumbnail" << thumbnailPath(m_pending.value(key));
+            QFile::remove(thumbnailPath(m_pending.value(key)));
+            enqueue(key);
+            return;
+        }
+        m_pending.remove(key);
+        m_failed.insert(key, m_clock.elapsed());
+        return;
+    }
+
+    auto request = m_pending.take(key);
+    m_icons.insert(key, new QIcon(QPixmap::fromImage(image)), image.bytesPerLine() * image.height());
+    emit loaded(request.base, request.path);
+}
+
+QImage ImageLoader::thumbnail(const QString &source, const QSize &size)
+{
+    QImageReader reader(source);
+    auto fullSize = reader.size();
+    if(fullSize.isValid() && reader.supportsOption(QImageIOHandler::ScaledSize))
+    {
+        // formats like JPEG can decode at a fraction of the resolution, which is much cheaper. Leave some headroom for
+        // the smooth scaling below.
+        auto reduced = fullSize.scaled(size * 2, Qt::KeepAspectRatio);
+        if(reduced.width() < fullSize.width())
+        {
+            reader.setScaledSize(reduced);
+        }
+    }
+
+    QImage image = reader.read();
+    if(image.isNull())
+    {
+        qWarning() << "Could not read image" << source << ":" << reader.errorString();
+        return image;
+    }
+    if(image.width() > size.width() || image.height() > size.height())
+    {
+        image = image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return image;
+}
@@ -0,0 +1,96 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QCache>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QIcon>
+#include <QImage>
+#include <QNetworkAccessManager>
+#include <QObject>
+#include <QSize>
+#include <QStringList>
+#include <QThreadPool>
+#include <QUrl>
+
+#include "QObjectPtr.h"
+
+/**
+ * Loads the pack logos shown by the platform pages.
+ *
+ * Images are downloaded into the meta cache, a few at a time, with the most recently requested ones first. Concurrent
+ * requests for the same image share one download. Decoding and scaling happen on worker threads, and the scaled down
+ * thumbnails are kept on disk and in a memory cache with a byte budget, so scrolling through a list again doesn't touch
+ * the network or decode the originals.
+ */
+class ImageLoader : public QObject
+{
+    Q_OBJECT
+public:
+    ImageLoader(shared_qobject_ptr<QNetworkAccessManager> network, const QString &thumbnailRoot, QObject *parent = nullptr);
+    virtual ~ImageLoader();
+
+    /**
+     * Icon for the image stored under the meta cache base and path, scaled down to fit the size.
+     *
+     * Returns a null icon while the image is loading or if it failed to load. loaded() is emitted once it's ready.
+     * Failed images are tried again when they are asked for a while after the failure.
+     */
+    QIcon icon(const QString &base, const QString &path, const QUrl &url, const QSize &size);
+
+    /// Where the original of the image is downloaded to
+    QString originalPath(const QString &base, const QString &path) const;
+
+    /// Decode an image file and scale it down to fit the size. Safe to call from any thread.
+    static QImage thumbnail(const QString &source, const QSize &size);
+
+signals:
+    void loaded(const QString &base, const QString &path);
+
+private:
+    struct Request
+    {
+        QString key;
+        QString base;
+        QString path;
+        QUrl url;
+        QSize size;
+    };
+
+    QString thumbnailPath(const Request &request) const;
+    void enqueue(const QString &key);
+    void fetchNext();
+    void decode(const Request &request, bool fromThumbnail);
+    void decoded(const QString &key, const QImage &image, bool fromThumbnail);
+
+private:
+    shared_qobject_ptr<QNetworkAccessManager> m_network;
+    QString m_thumbnailRoot;
+
+    /// requested images that aren't ready yet
+    QHash<QString, Request> m_pending;
+    /// pending images waiting for a download slot, the newest request is last
+    QStringList m_queue;
+    int m_fetching = 0;
+    /// images that failed to load, with the time of the failure on m_clock
+    QHash<QString, qint64> m_failed;
+    QElapsedTimer m_clock;
+
+    /// least recently used icons are dropped first, the cost is in bytes
+    QCache<QString, QIcon> m_icons;
+    QThreadPool m_decodePool;
+};
@@ -0,0 +1,58 @@
+#include <QTest>
+#include <QImageReader>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "ImageLoader.h"
+
+namespace {
+QString writeImage(const QString &path, const QSize &size, const char *format)
+{
+    QImage image(size, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    image.save(path, format);
+    return path;
+}
+}
+
+class ImageLoaderTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_Thumbnail()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+
+        auto wide = writeImage(FS::PathCombine(temp.path(), "wide.png"), QSize(400, 100), "PNG");
+        QCOMPARE(ImageLoader::thumbnail(wide, QSize(96, 96)).size(), QSize(96, 24));
+
+        // small images are not scaled up
+        auto small = writeImage(FS::PathCombine(temp.path(), "small.png"), QSize(16, 16), "PNG");
+        QCOMPARE(ImageLoader::thumbnail(small, QSize(96, 96)).size(), QSize(16, 16));
+
+        if(!QImageReader::supportedImageFormats().contains("jpg"))
+        {
+            QSKIP("No JPEG support");
+        }
+        // decoded at a reduced size first
+        auto photo = writeImage(FS::PathCombine(temp.path(), "photo.jpg"), QSize(2000, 1500), "JPG");
+        QCOMPARE(ImageLoader::thumbnail(photo, QSize(96, 96)).size(), QSize(96, 72));
+    }
+
+    void test_Invalid()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto path = FS::PathCombine(temp.path(), "broken.png");
+        FS::write(path, "not an image");
+        QVERIFY(ImageLoader::thumbnail(path, QSize(96, 96)).isNull());
+        QVERIFY(ImageLoader::thumbnail(FS::PathCombine(temp.path(), "missing.png"), QSize(96, 96)).isNull());
+    }
+};
+
+QTEST_GUILESS_MAIN(ImageLoaderTest)
+
+#include "ImageLoader_test.moc"
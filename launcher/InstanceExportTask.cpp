@@ -0,0 +1,681 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "InstanceExportTask.h"
+
+#include "FileSystem.h"
+#include "Json.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <zlib.h>
+
+namespace {
+const int indexFormatVersion = 1;
+const quint16 methodStored = 0;
+const quint16 methodDeflated = 8;
+const quint16 flagUtf8 = 1 << 11;
+const quint32 overflow32 = 0xffffffff;
+// position of the CRC field in a local file header
+const qint64 localHeaderCrcOffset = 14;
+// how much uncompressed data may be held in memory by entries waiting to be written
+const qint64 inFlightBudget = 256 * 1024 * 1024;
+const qint64 copyChunk = 1024 * 1024;
+// anything bigger is stored, so a single entry never has to be held in memory whole
+const quint64 maxDeflateSize = 128 * 1024 * 1024;
+
+// formats that are compressed already, deflating them again is a waste of time
+const QSet<QString> storedSuffixes = {
+    "jar", "zip", "litemod", "png", "jpg", "jpeg", "ogg", "mp3", "gz", "xz", "lzma", "mca", "mcr"
+};
+
+// a file from the previous export that can be copied into the new archive as is
+struct PreviousEntry
+{
+    quint16 method = methodStored;
+    quint32 crc = 0;
+    quint64 compressedSize = 0;
+    quint64 dataOffset = 0;
+};
+
+struct Entry
+{
+    QString name;
+    QString path;
+    bool isDir = false;
+    quint64 size = 0;
+    QDateTime modified;
+    quint32 mode = 0;
+    bool reuse = false;
+    PreviousEntry previous;
+};
+
+struct Packed
+{
+    enum Source
+    {
+        Nothing,
+        Memory,
+        File,
+        Previous
+    };
+    Source source = Nothing;
+    quint16 method = methodStored;
+    quint32 crc = 0;
+    quint64 compressedSize = 0;
+    quint64 previousOffset = 0;
+    QByteArray data;
+    QString error;
+};
+
+struct Written
+{
+    QByteArray name;
+    bool isDir;
+    qint64 modified;
+    quint32 dosTime;
+    quint32 mode;
+    quint16 method;
+    quint32 crc;
+    quint64 size;
+    quint64 compressedSize;
+    quint64 headerOffset;
+    quint64 dataOffset;
+};
+
+void u16(QByteArray &out, quint16 value)
+{
+    uchar bytes[2];
+    qToLittleEndian(value, bytes);
+    out.append(reinterpret_cast<const char *>(bytes), 2);
+}
+
+void u32(QByteArray &out, quint32 value)
+{
+    uchar bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(reinterpret_cast<const char *>(bytes), 4);
+}
+
+void u64(QByteArray &out, quint64 value)
+{
+    uchar bytes[8];
+    qToLittleEndian(value, bytes);
+    out.append(reinterpret_cast<const char *>(bytes), 8);
+}
+
+quint32 dosTime(const QDateTime &when)
+{
+    auto local = when.toLocalTime();
+    auto date = local.date();
+    auto time = local.time();
+    if(date.year() < 1980)
+    {
+        return 1 << 21 | 1 << 16;
+    }
+    return quint32(date.year() - 1980) << 25 | quint32(date.month()) << 21 | quint32(date.day()) << 16 |
+           quint32(time.hour()) << 11 | quint32(time.minute()) << 5 | quint32(time.second() / 2);
+}
+
+quint32 unixMode(QFileDevice::Permissions permissions, bool isDir)
+{
+    quint32 mode = isDir ? 040000 : 0100000;
+    if(permissions & QFileDevice::ReadOwner)
+        mode |= 0400;
+    if(permissions & QFileDevice::WriteOwner)
+        mode |= 0200;
+    if(permissions & QFileDevice::ExeOwner)
+        mode |= 0100;
+    if(permissions & QFileDevice::ReadGroup)
+        mode |= 0040;
+    if(permissions & QFileDevice::WriteGroup)
+        mode |= 0020;
+    if(permissions & QFileDevice::ExeGroup)
+        mode |= 0010;
+    if(permissions & QFileDevice::ReadOther)
+        mode |= 0004;
+    if(permissions & QFileDevice::WriteOther)
+        mode |= 0002;
+    if(permissions & QFileDevice::ExeOther)
+        mode |= 0001;
+    return mode;
+}
+
+void collect(const QDir &root, const QString &relative, const QString &prefix, const SeparatorPrefixTree<'/'> &blocked,
+             const QString &output, QVector<Entry> &entries)
+{
+    QDir dir(root.filePath(relative));
+    auto infos = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System, QDir::Name | QDir::DirsLast);
+    for(auto &info: infos)
+    {
+        QString relPath = relative.isEmpty() ? info.fileName() : relative + '/' + info.fileName();
+        if(blocked.covers(relPath) || info.absoluteFilePath() == output)
+        {
+            continue;
+        }
+        Entry entry;
+        entry.path = info.absoluteFilePath();
+        entry.isDir = info.isDir() && !info.isSymLink();
+        entry.modified = info.lastModified();
+        entry.mode = unixMode(info.permissions(), entry.isDir);
+        if(entry.isDir)
+        {
+            entry.name = prefix + '/' + relPath + '/';
+            entries.append(entry);
+            collect(root, relPath, prefix, blocked, output, entries);
+        }
+        else if(info.isFile())
+        {
+            entry.name = prefix + '/' + relPath;
+            entry.size = quint64(info.size());
+            entries.append(entry);
+        }
+    }
+}
+
+bool storedAsIs(const Entry &entry)
+{
+    return entry.size > maxDeflateSize || storedSuffixes.contains(QFileInfo(entry.name).suffix().toLower());
+}
+
+Packed pack(const Entry &entry, const std::atomic<bool> *stop)
+{
+    Packed packed;
+    if(entry.isDir || *stop)
+    {
+        return packed;
+    }
+    if(entry.reuse)
+    {
+        packed.source = Packed::Previous;
+        packed.method = entry.previous.method;
+        packed.crc = entry.previous.crc;
+        packed.compressedSize = entry.previous.compressedSize;
+        packed.previousOffset = entry.previous.dataOffset;
+        return packed;
+    }
+
+    if(storedAsIs(entry))
+    {
+        // big or already compressed files are streamed into the archive by the writer, which also computes the CRC
+        // from the very bytes it copies. Reading them here as well could see different content.
+        packed.source = Packed::File;
+        packed.compressedSize = entry.size;
+        return packed;
+    }
+
+    QFile file(entry.path);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        packed.error = QObject::tr("Could not open %1: %2").arg(entry.path, file.errorString());
+        return packed;
+    }
+    uLong crc = crc32(0L, Z_NULL, 0);
+    auto data = file.readAll();
+    if(quint64(data.size()) != entry.size)
+    {
+        packed.error = QObject::tr("%1 changed while exporting").arg(entry.path);
+        return packed;
+    }
+    crc = crc32(crc, reinterpret_cast<const Bytef *>(data.constData()), uInt(data.size()));
+    packed.crc = quint32(crc);
+    packed.source = Packed::Memory;
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // raw deflate, zip archives have no zlib header around the data
+    if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK)
+    {
+        QByteArray compressed(int(deflateBound(&stream, uLong(data.size()))), Qt::Uninitialized);
+        stream.next_in = reinterpret_cast<Bytef *>(data.data());
+        stream.avail_in = uInt(data.size());
+        stream.next_out = reinterpret_cast<Bytef *>(compressed.data());
+        stream.avail_out = uInt(compressed.size());
+        bool ok = deflate(&stream, Z_FINISH) == Z_STREAM_END;
+        auto compressedSize = int(stream.total_out);
+        deflateEnd(&stream);
+        // incompressible content is stored instead
+        if(ok && compressedSize < data.size())
+        {
+            compressed.resize(compressedSize);
+            packed.method = methodDeflated;
+            packed.data = compressed;
+            packed.compressedSize = quint64(compressedSize);
+            return packed;
+        }
+    }
+    packed.data = data;
+    packed.compressedSize = quint64(data.size());
+    return packed;
+}
+
+bool copyFrom(QFile &in, qint64 length, QSaveFile &out, uLong *crc = nullptr)
+{
+    while(length > 0)
+    {
+        auto buffer = in.read(qMin(length, copyChunk));
+        if(buffer.isEmpty() || out.write(buffer) != buffer.size())
+        {
+            return false;
+        }
+        if(crc)
+        {
+            *crc = crc32(*crc, reinterpret_cast<const Bytef *>(buffer.constData()), uInt(buffer.size()));
+        }
+        length -= buffer.size();
+    }
+    return true;
+}
+}
+
+InstanceExportTask::InstanceExportTask(const QString &root, const QString &prefix, const SeparatorPrefixTree<'/'> &blocked,
+                                       const QString &output, const QString &indexPath)
+    : m_root(root), m_prefix(prefix), m_blocked(blocked), m_output(QFileInfo(output).absoluteFilePath()), m_indexPath(indexPath),
+      m_aborted(false)
+{
+    connect(this, &InstanceExportTask::archiveProgress, this, &InstanceExportTask::setProgress);
+}
+
+void InstanceExportTask::executeTask()
+{
+    setStatus(tr("Exporting to %1").arg(m_output));
+    m_future = QtConcurrent::run(QThreadPool::globalInstance(), this, &InstanceExportTask::exportArchive);
+    connect(&m_futureWatcher, &QFutureWatcher<QString>::finished, this, &InstanceExportTask::exportFinished);
+    m_futureWatcher.setFuture(m_future);
+}
+
+bool InstanceExportTask::abort()
+{
+    m_aborted = true;
+    return true;
+}
+
+void InstanceExportTask::exportFinished()
+{
+    auto error = m_future.result();
+    if(m_aborted)
+    {
+        emitAborted();
+        return;
+    }
+    if(!error.isEmpty())
+    {
+        emitFailed(error);
+        return;
+    }
+    emitSucceeded();
+}
+
+QString InstanceExportTask::exportArchive()
+{
+    QVector<Entry> entries;
+    {
+        Entry root;
+        root.name = m_prefix + '/';
+        root.isDir = true;
+        root.path = m_root;
+        root.modified = QFileInfo(m_root).lastModified();
+        root.mode = unixMode(QFileInfo(m_root).permissions(), true);
+        entries.append(root);
+    }
+    collect(QDir(m_root), QString(), m_prefix, m_blocked, m_output, entries);
+
+    // entries that did not change since the previous export are copied out of its archive
+    QFile previous;
+    int reused = 0;
+    try
+    {
+        if(QFile::exists(m_indexPath))
+        {
+            auto index = Json::requireObject(Json::requireDocument(m_indexPath, "Export index"), "Export index");
+            QFileInfo archiveInfo(Json::requireString(index, "archive"));
+            if(Json::requireInteger(index, "formatVersion") == indexFormatVersion && archiveInfo.isFile() &&
+               quint64(archiveInfo.size()) == quint64(Json::requireDouble(index, "archiveSize")) &&
+               archiveInfo.lastModified().toMSecsSinceEpoch() == qint64(Json::requireDouble(index, "archiveModified")))
+            {
+                QHash<QString, QJsonObject> files;
+                for(auto value: Json::requireArray(index, "entries"))
+                {
+                    auto object = Json::requireObject(value, "Export index entry");
+                    files.insert(Json::requireString(object, "name"), object);
+                }
+                for(auto &entry: entries)
+                {
+                    auto found = files.find(entry.name);
+                    if(entry.isDir || found == files.end())
+                    {
+                        continue;
+                    }
+                    auto &object = found.value();
+                    if(quint64(Json::requireDouble(object, "size")) != entry.size ||
+                       qint64(Json::requireDouble(object, "modified")) != entry.modified.toMSecsSinceEpoch())
+                    {
+                        continue;
+                    }
+                    entry.reuse = true;
+                    entry.previous.method = quint16(Json::requireInteger(object, "method"));
+                    entry.previous.crc = quint32(Json::requireDouble(object, "crc"));
+                    entry.previous.compressedSize = quint64(Json::requireDouble(object, "compressedSize"));
+                    entry.previous.dataOffset = quint64(Json::requireDouble(object, "dataOffset"));
+                    reused++;
+                }
+                previous.setFileName(archiveInfo.absoluteFilePath());
+                if(reused && !previous.open(QIODevice::ReadOnly))
+                {
+                    for(auto &entry: entries)
+                    {
+                        entry.reuse = false;
+                    }
+                    reused = 0;
+                }
+            }
+        }
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << "Ignoring the previous export index:" << e.cause();
+        for(auto &entry: entries)
+        {
+            entry.reuse = false;
+        }
+        reused = 0;
+    }
+
+    qint64 totalBytes = 0;
+    for(auto &entry: entries)
+    {
+        totalBytes += qint64(entry.size);
+    }
+
+    QSaveFile out(m_output);
+    if(!out.open(QIODevice::WriteOnly))
+    {
+        return tr("Could not open %1 for writing: %2").arg(m_output, out.errorString());
+    }
+
+    // the writer stays a bounded distance ahead of the workers, both in entries and in memory used
+    std::atomic<bool> stop(false);
+    QThreadPool pool;
+    const int threads = qMax(1, QThread::idealThreadCount());
+    pool.setMaxThreadCount(threads);
+    const int window = threads * 4;
+    QVector<QFuture<Packed>> futures(entries.size());
+    int submitted = 0;
+    qint64 inFlight = 0;
+    auto inMemory = [&](const Entry &entry)
+    {
+        return entry.isDir || entry.reuse || storedAsIs(entry) ? 0 : qint64(entry.size);
+    };
+
+    QVector<Written> written;
+    written.reserve(entries.size());
+    quint64 offset = 0;
+    qint64 doneBytes = 0;
+    QElapsedTimer sinceProgress;
+    sinceProgress.start();
+    QString error;
+
+    for(int i = 0; i < entries.size() && error.isEmpty(); i++)
+    {
+        while(submitted < entries.size() && submitted - i < window && (submitted == i || inFlight + inMemory(entries[submitted]) <= inFlightBudget))
+        {
+            inFlight += inMemory(entries[submitted]);
+            futures[submitted] = QtConcurrent::run(&pool, pack, entries[submitted], &stop);
+            submitted++;
+        }
+        auto packed = futures[i].result();
+        futures[i] = QFuture<Packed>();
+        inFlight -= inMemory(entries[i]);
+        if(m_aborted)
+        {
+            error = tr("Aborted");
+            break;
+        }
+        if(!packed.error.isEmpty())
+        {
+            error = packed.error;
+            break;
+        }
+
+        const auto &entry = entries[i];
+        Written record;
+        record.name = entry.name.toUtf8();
+        record.isDir = entry.isDir;
+        record.modified = entry.modified.toMSecsSinceEpoch();
+        record.dosTime = dosTime(entry.modified);
+        record.mode = entry.mode;
+        record.method = packed.method;
+        record.crc = packed.crc;
+        record.size = entry.size;
+        record.compressedSize = packed.compressedSize;
+        record.headerOffset = offset;
+
+        bool zip64 = record.size >= overflow32 || record.compressedSize >= overflow32;
+        QByteArray header;
+        u32(header, 0x04034b50);
+        u16(header, zip64 ? 45 : 20);
+        u16(header, flagUtf8);
+        u16(header, record.method);
+        u32(header, record.dosTime);
+        u32(header, record.crc);
+        u32(header, zip64 ? overflow32 : quint32(record.compressedSize));
+        u32(header, zip64 ? overflow32 : quint32(record.size));
+        u16(header, quint16(record.name.size()));
+        u16(header, zip64 ? 20 : 0);
+        header.append(record.name);
+        if(zip64)
+        {
+            u16(header, 0x0001);
+            u16(header, 16);
+            u64(header, record.size);
+            u64(header, record.compressedSize);
+        }
+        if(out.write(header) != header.size())
+        {
+            error = tr("Could not write %1: %2").arg(m_output, out.errorString());
+            break;
+        }
+
+        record.dataOffset = offset + quint64(header.size());
+
+        bool ok = true;
+        switch(packed.source)
+        {
+            case Packed::Nothing:
+                break;
+            case Packed::Memory:
+                ok = out.write(packed.data) == packed.data.size();
+                break;
+            case Packed::File:
+            {
+                QFile file(entry.path);
+                if(!file.open(QIODevice::ReadOnly))
+                {
+                    error = tr("Could not open %1: %2").arg(entry.path, file.errorString());
+                    break;
+                }
+                uLong crc = crc32(0L, Z_NULL, 0);
+                ok = copyFrom(file, qint64(record.size), out, &crc);
+                if(!ok && out.error() != QFileDevice::NoError)
+                {
+                    break;
+                }
+                if(!ok || quint64(file.size()) != record.size)
+                {
+                    error = tr("%1 changed while exporting").arg(entry.path);
+                    break;
+                }
+                // only known now, so it is patched into the local header that was written ahead of the data
+                record.crc = quint32(crc);
+                QByteArray crcField;
+                u32(crcField, record.crc);
+                ok = out.seek(qint64(record.headerOffset) + localHeaderCrcOffset) && out.write(crcField) == crcField.size() &&
+                     out.seek(qint64(record.dataOffset + record.compressedSize));
+                break;
+            }
+            case Packed::Previous:
+                ok = previous.seek(qint64(packed.previousOffset)) && copyFrom(previous, qint64(packed.compressedSize), out);
+                break;
+        }
+        if(!error.isEmpty())
+        {
+            break;
+        }
+        if(!ok)
+        {
+            error = tr("Could not write %1 to %2").arg(entry.path, m_output);
+            break;
+        }
+        offset += quint64(header.size()) + record.compressedSize;
+        written.append(record);
+
+        doneBytes += qint64(entry.size);
+        if(sinceProgress.elapsed() > 100)
+        {
+            emit archiveProgress(doneBytes, totalBytes);
+            sinceProgress.restart();
+        }
+    }
+    if(!error.isEmpty())
+    {
+        // let everything still queued bail out, the pool waits for them when it goes away
+        stop = true;
+        return error;
+    }
+
+    // central directory
+    QByteArray directory;
+    QJsonArray indexEntries;
+    for(auto &record: written)
+    {
+        QByteArray extra;
+        if(record.size >= overflow32)
+            u64(extra, record.size);
+        if(record.compressedSize >= overflow32)
+            u64(extra, record.compressedSize);
+        if(record.headerOffset >= overflow32)
+            u64(extra, record.headerOffset);
+        bool zip64 = !extra.isEmpty();
+        u32(directory, 0x02014b50);
+        // made by unix, so the mode in the external attributes is used
+        u16(directory, 3 << 8 | (zip64 ? 45 : 20));
+        u16(directory, zip64 ? 45 : 20);
+        u16(directory, flagUtf8);
+        u16(directory, record.method);
+        u32(directory, record.dosTime);
+        u32(directory, record.crc);
+        u32(directory, record.compressedSize >= overflow32 ? overflow32 : quint32(record.compressedSize));
+        u32(directory, record.size >= overflow32 ? overflow32 : quint32(record.size));
+        u16(directory, quint16(record.name.size()));
+        u16(directory, zip64 ? quint16(extra.size() + 4) : 0);
+        u16(directory, 0);
+        u16(directory, 0);
+        u16(directory, 0);
+        // the low byte holds the DOS attributes, 0x10 is the directory flag
+        u32(directory, record.mode << 16 | (record.isDir ? 0x10 : 0));
+        u32(directory, record.headerOffset >= overflow32 ? overflow32 : quint32(record.headerOffset));
+        directory.append(record.name);
+        if(zip64)
+        {
+            u16(directory, 0x0001);
+            u16(directory, quint16(extra.size()));
+            directory.append(extra);
+        }
+
+        if(!record.isDir)
+        {
+            QJsonObject object;
+            object.insert("name", QString::fromUtf8(record.name));
+            object.insert("size", double(record.size));
+            object.insert("modified", double(record.modified));
+            object.insert("method", int(record.method));
+            object.insert("crc", double(record.crc));
+            object.insert("compressedSize", double(record.compressedSize));
+            object.insert("dataOffset", double(record.dataOffset));
+            indexEntries.append(object);
+        }
+    }
+
+    const quint64 directoryOffset = offset;
+    const quint64 count = quint64(written.size());
+    QByteArray end;
+    if(count >= 0xffff || directoryOffset >= overflow32 || quint64(directory.size()) >= overflow32)
+    {
+        const quint64 zip64End = directoryOffset + quint64(directory.size());
+        u32(end, 0x06064b50);
+        u64(end, 44);
+        u16(end, 3 << 8 | 45);
+        u16(end, 45);
+        u32(end, 0);
+        u32(end, 0);
+        u64(end, count);
+        u64(end, count);
+        u64(end, quint64(directory.size()));
+        u64(end, directoryOffset);
+
+        u32(end, 0x07064b50);
+        u32(end, 0);
+        u64(end, zip64End);
+        u32(end, 1);
+    }
+    u32(end, 0x06054b50);
+    u16(end, 0);
+    u16(end, 0);
+    u16(end, count >= 0xffff ? 0xffff : quint16(count));
+    u16(end, count >= 0xffff ? 0xffff : quint16(count));
+    u32(end, quint64(directory.size()) >= overflow32 ? overflow32 : quint32(directory.size()));
+    u32(end, directoryOffset >= overflow32 ? overflow32 : quint32(directoryOffset));
+    u16(end, 0);
+
+    if(out.write(directory) != directory.size() || out.write(end) != end.size())
+    {
+        return tr("Could not write %1: %2").arg(m_output, out.errorString());
+    }
+    // the previous archive may be the one being replaced
+    previous.close();
+    if(!out.commit())
+    {
+        return tr("Could not write %1: %2").arg(m_output, out.errorString());
+    }
+    emit archiveProgress(totalBytes, totalBytes);
+    qDebug() << "Exported" << written.size() << "entries to" << m_output << "," << reused << "copied from the previous export";
+
+    QFileInfo archiveInfo(m_output);
+    QJsonObject index;
+    index.insert("formatVersion", indexFormatVersion);
+    index.insert("archive", m_output);
+    index.insert("archiveSize", double(archiveInfo.size()));
+    index.insert("archiveModified", double(archiveInfo.lastModified().toMSecsSinceEpoch()));
+    index.insert("entries", indexEntries);
+    try
+    {
+        Json::write(index, m_indexPath);
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << "Could not save the export index:" << e.cause();
+    }
+    return QString();
+}
@@ -0,0 +1,81 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "tasks/Task.h"
+#include "SeparatorPrefixTree.h"
+#include <QFuture>
+#include <QFutureWatcher>
+#include <atomic>
+
+/**
+ * Packs an instance folder into a zip archive in the background.
+ *
+ * Entries are deflated in parallel, each into its own independent stream, and written to the archive in order. Content
+ * that is compressed already (jars, zips, images, sounds, region files) is stored as is. What went into the archive is
+ * remembered in an index file, so the next export of the same instance can copy unchanged entries straight out of the
+ * previous archive instead of compressing them again.
+ */
+class InstanceExportTask : public Task
+{
+    Q_OBJECT
+public:
+    /**
+     * \param root The folder to export.
+     * \param prefix The folder the files are put in inside the archive.
+     * \param blocked Paths relative to root that are left out.
+     * \param output The archive to write.
+     * \param indexPath Where to remember the contents of the archive for the next export.
+     */
+    InstanceExportTask(const QString &root, const QString &prefix, const SeparatorPrefixTree<'/'> &blocked, const QString &output,
+                       const QString &indexPath);
+
+    bool canAbort() const override
+    {
+        return true;
+    }
+
+    bool wasAborted() const
+    {
+        return m_aborted;
+    }
+
+public slots:
+    bool abort() override;
+
+signals:
+    /// Reported from the worker thread, turned into progress() on ours
+    void archiveProgress(qint64 current, qint64 total);
+
+protected:
+    virtual void executeTask() override;
+
+private slots:
+    void exportFinished();
+
+private:
+    QString exportArchive();
+
+private:
+    QString m_root;
+    QString m_prefix;
+    SeparatorPrefixTree<'/'> m_blocked;
+    QString m_output;
+    QString m_indexPath;
+    std::atomic<bool> m_aborted;
+    QFuture<QString> m_future;
+    QFutureWatcher<QString> m_futureWatcher;
+};
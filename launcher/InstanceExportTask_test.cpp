@@ -0,0 +1,75 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "InstanceExportTask.h"
+#include "ZipExtractor.h"
+
+namespace {
+QByteArray content(int seed, int size)
+{
+    QByteArray data(size, 0);
+    for(int i = 0; i < size; i++)
+    {
+        data[i] = char((i / 13 + seed) & 0xff);
+    }
+    return data;
+}
+
+bool exportTo(const QString &root, const SeparatorPrefixTree<'/'> &blocked, const QString &output, const QString &index)
+{
+    InstanceExportTask task(root, "Instance", blocked, output, index);
+    QSignalSpy finished(&task, &Task::finished);
+    task.start();
+    if(!finished.wait(10000))
+    {
+        return false;
+    }
+    return task.wasSuccessful();
+}
+}
+
+class InstanceExportTaskTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_RoundTrip()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto root = FS::PathCombine(temp.path(), "instance");
+        FS::write(FS::PathCombine(root, "instance.cfg"), "name=Test\n");
+        FS::write(FS::PathCombine(root, ".minecraft", "options.txt"), content(1, 100000));
+        FS::write(FS::PathCombine(root, ".minecraft", "mods", "mod.jar"), content(2, 50000));
+        FS::write(FS::PathCombine(root, ".minecraft", "logs", "latest.log"), "secret");
+        QDir(root).mkpath(".minecraft/empty");
+
+        SeparatorPrefixTree<'/'> blocked;
+        blocked.insert(".minecraft/logs");
+        auto index = FS::PathCombine(temp.path(), "index.json");
+        auto first = FS::PathCombine(temp.path(), "first.zip");
+        QVERIFY(exportTo(root, blocked, first, index));
+
+        ZipExtractor extractor(first);
+        QVERIFY(extractor.open());
+        auto target = FS::PathCombine(temp.path(), "extracted");
+        QVERIFY(extractor.extract("", target).has_value());
+        QCOMPARE(FS::read(FS::PathCombine(target, "Instance", "instance.cfg")), QByteArray("name=Test\n"));
+        QCOMPARE(FS::read(FS::PathCombine(target, "Instance", ".minecraft", "options.txt")), content(1, 100000));
+        QCOMPARE(FS::read(FS::PathCombine(target, "Instance", ".minecraft", "mods", "mod.jar")), content(2, 50000));
+        QVERIFY(QFileInfo(FS::PathCombine(target, "Instance", ".minecraft", "empty")).isDir());
+        QVERIFY(!QFile::exists(FS::PathCombine(target, "Instance", ".minecraft", "logs")));
+
+        // nothing changed, so the second archive is copied together from the first one
+        auto second = FS::PathCombine(temp.path(), "second.zip");
+        QVERIFY(exportTo(root, blocked, second, index));
+        QCOMPARE(FS::read(second), FS::read(first));
+    }
+};
+
+QTEST_GUILESS_MAIN(InstanceExportTaskTest)
+
+#include "InstanceExportTask_test.moc"
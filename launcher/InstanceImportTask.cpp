@@ -22,6 +22,7 @@
 #include "settings/INISettingsObject.h"
 #include "icons/IconUtils.h"
 #include <QtConcurrentRun>
+#include "tasks/TaskScheduler.h"
 
 // FIXME: this does not belong here, it's Minecraft/Flame specific
 #include "minecraft/MinecraftInstance.h"
@@ -131,53 +132,26 @@ void InstanceImportTask::processZipPack()
     }
 
     // make sure we extract just the pack
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractSubDir, m_packZip.get(), root, extractDir.absolutePath());
-    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &InstanceImportTask::extractFinished);
-    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &InstanceImportTask::extractAborted);
-    m_extractFutureWatcher.setFuture(m_extractFuture);
+    auto target = extractDir.absolutePath();
+    m_extractSlot = TaskScheduler::instance()->request(this, tr("Extracting %1").arg(m_archivePath), TaskScheduler::Priority::Foreground,
+                                                       TaskScheduler::Disk | TaskScheduler::Cpu, [this, root, target]()
+    {
+        m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractSubDir, m_packZip.get(), root, target);
+        connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &InstanceImportTask::extractFinished);
+        connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &InstanceImportTask::extractAborted);
+        m_extractFutureWatcher.setFuture(m_extractFuture);
+    });
 }
 
 void InstanceImportTask::extractFinished()
 {
+    TaskScheduler::instance()->release(m_extractSlot);
     m_packZip.reset();
     if (!m_extractFuture.result())
     {
         emitFailed(tr("Failed to extract modpack"));
         return;
     }
-    QDir extractDir(m_stagingPath);
-
-    qDebug() << "Fixing permissions for extracted pack files...";
-    QDirIterator it(extractDir, QDirIterator::Subdirectories);
-    while (it.hasNext())
-    {
-        auto filepath = it.next();
-        QFileInfo file(filepath);
-        auto permissions = QFile::permissions(filepath);
-        auto origPermissions = permissions;
-        if(file.isDir())
-        {
-            // Folder +rwx for current user
-            permissions |= QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser;
-        }
-        else
-        {
-            // File +rw for current user
-            permissions |= QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser;
-        }
-        if(origPermissions != permissions)
-        {
-            if(!QFile::setPermissions(filepath, permissions))
-            {
-                logWarning(tr("Could not fix permissions for %1").arg(filepath));
-            }
-            else
-            {
-                qDebug() << "Fixed" << filepath;
-            }
-        }
-    }
-
     switch(m_modpackType)
     {
         case ModpackType::Flame:
@@ -197,6 +171,7 @@ void InstanceImportTask::extractFinished()
 
 void InstanceImportTask::extractAborted()
 {
+    TaskScheduler::instance()->release(m_extractSlot);
     emitFailed(tr("Instance import has been aborted."));
     return;
 }
@@ -333,7 +308,8 @@ void InstanceImportTask::processFlame()
         FS::deletePath(jarmodsPath);
     }
     instance.setName(m_instName);
-    m_modIdResolver = new Flame::FileResolvingTask(APPLICATION->network(), pack);
+    m_modIdResolver = new Flame::FileResolvingTask(APPLICATION->network(), pack, APPLICATION->metacache().get());
+    m_modIdResolver->setBatchUrl(QUrl(APPLICATION->settings()->get("FlameBatchResolveURL").toString()));
     connect(m_modIdResolver.get(), &Flame::FileResolvingTask::succeeded, [&]()
     {
         auto results = m_modIdResolver->getResults();
@@ -63,6 +63,7 @@ private: /* data */
     std::unique_ptr<QuaZip> m_packZip;
     QFuture<nonstd::optional<QStringList>> m_extractFuture;
     QFutureWatcher<nonstd::optional<QStringList>> m_extractFutureWatcher;
+    quint64 m_extractSlot = 0;
     enum class ModpackType{
         Unknown,
         MultiMC,
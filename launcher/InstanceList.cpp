@@ -543,6 +543,7 @@ InstancePtr InstanceList::loadInstance(const InstanceId& id)
 
     auto instanceRoot = FS::PathCombine(m_instDir, id);
     auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instanceRoot, "instance.cfg"));
+    instanceSettings->setSaveDelay();
     InstancePtr inst;
 
     instanceSettings->registerSetting("InstanceType", "Legacy");
@@ -74,3 +74,20 @@ int Strings::naturalCompare(const QString &s1, const QString &s2, Qt::CaseSensit
     // The two strings are the same (02 == 2) so fall back to the normal sort
     return QString::compare(s1, s2, cs);
 }
+
+QString Strings::humanReadableFileSize(qint64 bytes)
+{
+    static const char * units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    if(bytes < 1024)
+    {
+        return QString("%1 %2").arg(bytes).arg(units[0]);
+    }
+    double value = bytes;
+    unsigned unit = 0;
+    while(value >= 1024.0 && unit < (sizeof(units) / sizeof(const char *)) - 1)
+    {
+        value /= 1024.0;
+        unit++;
+    }
+    return QString("%1 %2").arg(value, 0, 'f', 1).arg(units[unit]);
+}
@@ -5,4 +5,7 @@
 namespace Strings
 {
     int naturalCompare(const QString &s1, const QString &s2, Qt::CaseSensitivity cs);
+
+    /// Size in bytes, as a short string with a binary unit (B, KiB, MiB, ...)
+    QString humanReadableFileSize(qint64 bytes);
 }
@@ -19,6 +19,7 @@
 #include <JlCompress.h>
 #include "MMCZip.h"
 #include "FileSystem.h"
+#include "ZipExtractor.h"
 
 #include <QDebug>
 
@@ -210,10 +211,26 @@ bool MMCZip::findFilesInZip(QuaZip * zip, const QString & what, QStringList & re
 // ours
 nonstd::optional<QStringList> MMCZip::extractSubDir(QuaZip *zip, const QString & subdir, const QString &target)
 {
+    qDebug() << "Extracting subdir" << subdir << "from" << zip->getZipName() << "to" << target;
+
+    // archives on disk are extracted in parallel, straight from their central directory
+    if(!zip->getZipName().isEmpty())
+    {
+        ZipExtractor extractor(zip->getZipName());
+        if(extractor.open())
+        {
+            auto extracted = extractor.extract(subdir, target);
+            if(!extracted)
+            {
+                qWarning() << "Failed to extract" << zip->getZipName() << ":" << extractor.errorString();
+            }
+            return extracted;
+        }
+        qDebug() << "Using sequential extraction:" << extractor.errorString();
+    }
+
     QDir directory(target);
     QStringList extracted;
-
-    qDebug() << "Extracting subdir" << subdir << "from" << zip->getZipName() << "to" << target;
     auto numEntries = zip->getEntriesCount();
     if(numEntries < 0) {
         qWarning() << "Failed to enumerate files in archive";
@@ -248,8 +265,20 @@ nonstd::optional<QStringList> MMCZip::extractSubDir(QuaZip *zip, const QString &
             JlCompress::removeFile(extracted);
             return nonstd::nullopt;
         }
+        // some archives carry no permissions at all, make sure we can still use what was extracted
+        {
+            auto permissions = QFile::permissions(absFilePath);
+            auto wanted = permissions | QFileDevice::ReadUser | QFileDevice::WriteUser;
+            if(absFilePath.endsWith('/'))
+            {
+                wanted |= QFileDevice::ExeUser;
+            }
+            if(permissions != wanted && !QFile::setPermissions(absFilePath, wanted))
+            {
+                qWarning() << "Could not fix permissions of" << absFilePath;
+            }
+        }
         extracted.append(absFilePath);
-        qDebug() << "Extracted file" << name;
     } while (zip->goToNextFile());
     return extracted;
 }
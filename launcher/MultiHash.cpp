@@ -0,0 +1,353 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MultiHash.h"
+
+#include <QFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MULTIHASH_SHA_NI
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+class MultiHash::Digest
+{
+public:
+    explicit Digest(Algorithm algorithm) : algorithm(algorithm) {}
+    virtual ~Digest() {}
+    virtual void addData(const char *data, int length) = 0;
+    virtual void reset() = 0;
+    virtual QByteArray result() const = 0;
+
+    const Algorithm algorithm;
+};
+
+namespace {
+// how much data is passed to one digest before moving on to the next
+const int blockSize = 64 * 1024;
+// files are mapped this much at a time
+const qint64 mapSize = 64 * 1024 * 1024;
+
+class QtDigest : public MultiHash::Digest
+{
+public:
+    explicit QtDigest(MultiHash::Algorithm algorithm) : Digest(algorithm), m_hash(algorithm) {}
+    void addData(const char *data, int length) override
+    {
+        m_hash.addData(data, length);
+    }
+    void reset() override
+    {
+        m_hash.reset();
+    }
+    QByteArray result() const override
+    {
+        return m_hash.result();
+    }
+
+private:
+    QCryptographicHash m_hash;
+};
+
+#ifdef MULTIHASH_SHA_NI
+bool detectShaNi()
+{
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+    bool ssse3 = ecx & (1u << 9);
+    bool sse41 = ecx & (1u << 19);
+    if(!ssse3 || !sse41 || __get_cpuid_max(0, nullptr) < 7)
+    {
+        return false;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return ebx & (1u << 29);
+}
+
+template<int G, int F>
+__attribute__((target("sha,ssse3,sse4.1"))) inline void sha1Rounds(__m128i &abcd, __m128i (&e)[2], __m128i (&msg)[4])
+{
+    // four rounds, while scheduling the message words of the following ones
+    e[G & 1] = _mm_sha1nexte_epu32(e[G & 1], msg[G % 4]);
+    e[(G + 1) & 1] = abcd;
+    msg[(G + 1) % 4] = _mm_sha1msg2_epu32(msg[(G + 1) % 4], msg[G % 4]);
+    abcd = _mm_sha1rnds4_epu32(abcd, e[G & 1], F);
+    msg[(G + 3) % 4] = _mm_sha1msg1_epu32(msg[(G + 3) % 4], msg[G % 4]);
+    msg[(G + 2) % 4] = _mm_xor_si128(msg[(G + 2) % 4], msg[G % 4]);
+}
+
+__attribute__((target("sha,ssse3,sse4.1"))) void sha1Blocks(quint32 state[5], const uchar *data, qint64 blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0x1b);
+    __m128i e0 = _mm_set_epi32(int(state[4]), 0, 0, 0);
+    for(qint64 block = 0; block < blocks; block++, data += 64)
+    {
+        const __m128i abcdSaved = abcd;
+        const __m128i eSaved = e0;
+        __m128i e[2];
+        __m128i msg[4];
+
+        // the first rounds, while the message words are still being loaded
+        msg[0] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), mask);
+        e[0] = _mm_add_epi32(e0, msg[0]);
+        e[1] = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e[0], 0);
+
+        msg[1] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16)), mask);
+        e[1] = _mm_sha1nexte_epu32(e[1], msg[1]);
+        e[0] = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e[1], 0);
+        msg[0] = _mm_sha1msg1_epu32(msg[0], msg[1]);
+
+        msg[2] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32)), mask);
+        e[0] = _mm_sha1nexte_epu32(e[0], msg[2]);
+        e[1] = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e[0], 0);
+        msg[1] = _mm_sha1msg1_epu32(msg[1], msg[2]);
+        msg[0] = _mm_xor_si128(msg[0], msg[2]);
+
+        msg[3] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48)), mask);
+        sha1Rounds<3, 0>(abcd, e, msg);
+        sha1Rounds<4, 0>(abcd, e, msg);
+        sha1Rounds<5, 1>(abcd, e, msg);
+        sha1Rounds<6, 1>(abcd, e, msg);
+        sha1Rounds<7, 1>(abcd, e, msg);
+        sha1Rounds<8, 1>(abcd, e, msg);
+        sha1Rounds<9, 1>(abcd, e, msg);
+        sha1Rounds<10, 2>(abcd, e, msg);
+        sha1Rounds<11, 2>(abcd, e, msg);
+        sha1Rounds<12, 2>(abcd, e, msg);
+        sha1Rounds<13, 2>(abcd, e, msg);
+        sha1Rounds<14, 2>(abcd, e, msg);
+        // the message schedule of the last few is wasted, but harmless
+        sha1Rounds<15, 3>(abcd, e, msg);
+        sha1Rounds<16, 3>(abcd, e, msg);
+        sha1Rounds<17, 3>(abcd, e, msg);
+        sha1Rounds<18, 3>(abcd, e, msg);
+        sha1Rounds<19, 3>(abcd, e, msg);
+
+        e0 = _mm_sha1nexte_epu32(e[0], eSaved);
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = quint32(_mm_extract_epi32(e0, 3));
+}
+
+class ShaNiDigest : public MultiHash::Digest
+{
+public:
+    ShaNiDigest() : Digest(QCryptographicHash::Sha1)
+    {
+        reset();
+    }
+    void addData(const char *data, int length) override
+    {
+        auto input = reinterpret_cast<const uchar *>(data);
+        m_length += quint64(length);
+        if(m_buffered)
+        {
+            int take = std::min(length, 64 - m_buffered);
+            memcpy(m_buffer + m_buffered, input, take);
+            m_buffered += take;
+            input += take;
+            length -= take;
+            if(m_buffered < 64)
+            {
+                return;
+            }
+            sha1Blocks(m_state, m_buffer, 1);
+            m_buffered = 0;
+        }
+        sha1Blocks(m_state, input, length / 64);
+        m_buffered = length % 64;
+        memcpy(m_buffer, input + length - m_buffered, m_buffered);
+    }
+    void reset() override
+    {
+        static const quint32 initial[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+        memcpy(m_state, initial, sizeof(m_state));
+        m_buffered = 0;
+        m_length = 0;
+    }
+    QByteArray result() const override
+    {
+        quint32 state[5];
+        memcpy(state, m_state, sizeof(state));
+        // padding: a one bit, zeros and the length in bits, in one or two final blocks
+        uchar tail[128] = {};
+        memcpy(tail, m_buffer, m_buffered);
+        tail[m_buffered] = 0x80;
+        int blocks = m_buffered < 56 ? 1 : 2;
+        qToBigEndian<quint64>(m_length * 8, tail + blocks * 64 - 8);
+        sha1Blocks(state, tail, blocks);
+
+        QByteArray out(20, 0);
+        for(int i = 0; i < 5; i++)
+        {
+            qToBigEndian<quint32>(state[i], reinterpret_cast<uchar *>(out.data()) + i * 4);
+        }
+        return out;
+    }
+
+private:
+    quint32 m_state[5];
+    uchar m_buffer[64];
+    int m_buffered = 0;
+    quint64 m_length = 0;
+};
+#endif
+
+std::unique_ptr<MultiHash::Digest> makeDigest(MultiHash::Algorithm algorithm)
+{
+#ifdef MULTIHASH_SHA_NI
+    if(algorithm == QCryptographicHash::Sha1 && MultiHash::hasHardwareSha1())
+    {
+        return std::unique_ptr<MultiHash::Digest>(new ShaNiDigest());
+    }
+#endif
+    return std::unique_ptr<MultiHash::Digest>(new QtDigest(algorithm));
+}
+}
+
+MultiHash::MultiHash(std::initializer_list<Algorithm> algorithms)
+{
+    for(auto algorithm: algorithms)
+    {
+        m_digests.push_back(makeDigest(algorithm));
+    }
+}
+
+MultiHash::MultiHash(Algorithm algorithm) : MultiHash({algorithm})
+{
+}
+
+MultiHash::~MultiHash()
+{
+}
+
+bool MultiHash::hasHardwareSha1()
+{
+#ifdef MULTIHASH_SHA_NI
+    static const bool supported = detectShaNi();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void MultiHash::addData(const char *data, qint64 length)
+{
+    while(length > 0)
+    {
+        int block = int(std::min<qint64>(length, blockSize));
+        for(auto &digest: m_digests)
+        {
+            digest->addData(data, block);
+        }
+        data += block;
+        length -= block;
+    }
+}
+
+void MultiHash::addData(const QByteArray &data)
+{
+    addData(data.constData(), data.size());
+}
+
+bool MultiHash::addData(QIODevice *device)
+{
+    QByteArray buffer(blockSize, Qt::Uninitialized);
+    qint64 read = 0;
+    while((read = device->read(buffer.data(), blockSize)) > 0)
+    {
+        addData(buffer.constData(), read);
+    }
+    return read == 0;
+}
+
+bool MultiHash::addFile(const QString &path)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    const qint64 size = file.size();
+    qint64 offset = 0;
+    while(offset < size)
+    {
+        qint64 length = std::min(size - offset, mapSize);
+        auto mapped = file.map(offset, length);
+        if(!mapped)
+        {
+            // some files can't be mapped, read the rest of them instead
+            return file.seek(offset) && addData(&file);
+        }
+        addData(reinterpret_cast<const char *>(mapped), length);
+        file.unmap(mapped);
+        offset += length;
+    }
+    return true;
+}
+
+void MultiHash::reset()
+{
+    for(auto &digest: m_digests)
+    {
+        digest->reset();
+    }
+}
+
+QByteArray MultiHash::result(Algorithm algorithm) const
+{
+    for(auto &digest: m_digests)
+    {
+        if(digest->algorithm == algorithm)
+        {
+            return digest->result();
+        }
+    }
+    return QByteArray();
+}
+
+QByteArray MultiHash::result() const
+{
+    return m_digests.empty() ? QByteArray() : m_digests.front()->result();
+}
+
+QByteArray MultiHash::hash(const QByteArray &data, Algorithm algorithm)
+{
+    MultiHash hash(algorithm);
+    hash.addData(data);
+    return hash.result();
+}
+
+QByteArray MultiHash::hashFile(const QString &path, Algorithm algorithm)
+{
+    MultiHash hash(algorithm);
+    if(!hash.addFile(path))
+    {
+        return QByteArray();
+    }
+    return hash.result();
+}
@@ -0,0 +1,67 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QString>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+class QIODevice;
+
+/**
+ * Computes one or more digests of the same data in a single pass.
+ *
+ * Data is fed to all the digests a block at a time, so it is only brought into the CPU cache once. SHA-1 uses the SHA
+ * extensions of x86 CPUs when they are available, everything else goes through QCryptographicHash. Files are hashed
+ * straight from a memory mapping.
+ */
+class MultiHash
+{
+public:
+    using Algorithm = QCryptographicHash::Algorithm;
+
+    explicit MultiHash(std::initializer_list<Algorithm> algorithms);
+    explicit MultiHash(Algorithm algorithm);
+    ~MultiHash();
+
+    void addData(const char *data, qint64 length);
+    void addData(const QByteArray &data);
+    /// Reads the device until its end. Returns false on read errors.
+    bool addData(QIODevice *device);
+    /// Returns false if the file can't be read.
+    bool addFile(const QString &path);
+
+    void reset();
+
+    /// Digest of everything added so far, empty for algorithms that were not requested
+    QByteArray result(Algorithm algorithm) const;
+    QByteArray result() const;
+
+    static QByteArray hash(const QByteArray &data, Algorithm algorithm);
+    /// Digest of the file's contents, empty if it can't be read
+    static QByteArray hashFile(const QString &path, Algorithm algorithm);
+
+    /// True if SHA-1 is computed with the CPU's SHA instructions
+    static bool hasHardwareSha1();
+
+    class Digest;
+
+private:
+    std::vector<std::unique_ptr<Digest>> m_digests;
+};
@@ -0,0 +1,93 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "MultiHash.h"
+
+/*
+ * Compares MultiHash with plain QCryptographicHash. Run it directly for meaningful numbers:
+ *   ./MultiHashBenchmark
+ * ctest only runs it once on a small input (MULTIHASH_BENCH_SIZE), to make sure it still works.
+ */
+namespace {
+QByteArray benchData()
+{
+    bool ok = false;
+    int size = qEnvironmentVariableIntValue("MULTIHASH_BENCH_SIZE", &ok);
+    QByteArray data(ok && size > 0 ? size : 32 * 1024 * 1024, Qt::Uninitialized);
+    for(int i = 0; i < data.size(); i++)
+    {
+        data[i] = char((i * 131 + 7) & 0xff);
+    }
+    return data;
+}
+
+// downloads arrive in chunks about this big
+const int chunkSize = 16 * 1024;
+}
+
+class MultiHashBenchmark : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void initTestCase()
+    {
+        m_data = benchData();
+        qDebug() << "Hardware SHA-1:" << MultiHash::hasHardwareSha1();
+    }
+
+    void sha1_QCryptographicHash()
+    {
+        QBENCHMARK
+        {
+            QCryptographicHash hash(QCryptographicHash::Sha1);
+            hash.addData(m_data);
+            hash.result();
+        }
+    }
+    void sha1_MultiHash()
+    {
+        QBENCHMARK
+        {
+            MultiHash::hash(m_data, QCryptographicHash::Sha1);
+        }
+    }
+
+    // what a cached download with a SHA-1 check used to do: two hashes, each fed every chunk
+    void md5Sha1Chunks_QCryptographicHash()
+    {
+        QBENCHMARK
+        {
+            QCryptographicHash md5(QCryptographicHash::Md5);
+            QCryptographicHash sha1(QCryptographicHash::Sha1);
+            for(int offset = 0; offset < m_data.size(); offset += chunkSize)
+            {
+                int size = qMin(chunkSize, m_data.size() - offset);
+                md5.addData(m_data.constData() + offset, size);
+                sha1.addData(m_data.constData() + offset, size);
+            }
+            md5.result();
+            sha1.result();
+        }
+    }
+    void md5Sha1Chunks_MultiHash()
+    {
+        QBENCHMARK
+        {
+            MultiHash hash({QCryptographicHash::Md5, QCryptographicHash::Sha1});
+            for(int offset = 0; offset < m_data.size(); offset += chunkSize)
+            {
+                hash.addData(m_data.constData() + offset, qMin(chunkSize, m_data.size() - offset));
+            }
+            hash.result(QCryptographicHash::Md5);
+            hash.result(QCryptographicHash::Sha1);
+        }
+    }
+
+private:
+    QByteArray m_data;
+};
+
+QTEST_GUILESS_MAIN(MultiHashBenchmark)
+
+#include "MultiHash_bench.moc"
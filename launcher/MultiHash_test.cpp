@@ -0,0 +1,96 @@
+#include <QTest>
+#include <QBuffer>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "MultiHash.h"
+
+namespace {
+QByteArray testData(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for(int i = 0; i < size; i++)
+    {
+        data[i] = char((i * 131 + 7) & 0xff);
+    }
+    return data;
+}
+}
+
+class MultiHashTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_Matches_data()
+    {
+        QTest::addColumn<int>("size");
+        QTest::addColumn<int>("chunk");
+        for(int size: {0, 1, 55, 56, 63, 64, 65, 1000, 200000})
+        {
+            for(int chunk: {1, 63, 64, 4096})
+            {
+                QTest::newRow(qPrintable(QString("%1 bytes in %2 byte chunks").arg(size).arg(chunk))) << size << chunk;
+            }
+        }
+    }
+    void test_Matches()
+    {
+        QFETCH(int, size);
+        QFETCH(int, chunk);
+        auto data = testData(size);
+        MultiHash hash({QCryptographicHash::Md5, QCryptographicHash::Sha1, QCryptographicHash::Sha256});
+        for(int offset = 0; offset < size; offset += chunk)
+        {
+            hash.addData(data.constData() + offset, qMin(chunk, size - offset));
+        }
+        QCOMPARE(hash.result(QCryptographicHash::Md5), QCryptographicHash::hash(data, QCryptographicHash::Md5));
+        QCOMPARE(hash.result(QCryptographicHash::Sha1), QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+        QCOMPARE(hash.result(QCryptographicHash::Sha256), QCryptographicHash::hash(data, QCryptographicHash::Sha256));
+        QVERIFY(hash.result(QCryptographicHash::Sha512).isEmpty());
+    }
+
+    void test_Reset()
+    {
+        MultiHash hash(QCryptographicHash::Sha1);
+        hash.addData(testData(100));
+        hash.reset();
+        hash.addData(QByteArray("abc"));
+        QCOMPARE(hash.result().toHex(), QByteArray("a9993e364706816aba3e25717850c26c9cd0d89d"));
+        // reading the result doesn't end the hash
+        hash.addData(QByteArray("def"));
+        QCOMPARE(hash.result(), QCryptographicHash::hash("abcdef", QCryptographicHash::Sha1));
+    }
+
+    void test_Device()
+    {
+        auto data = testData(300000);
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        MultiHash hash(QCryptographicHash::Sha1);
+        QVERIFY(hash.addData(&buffer));
+        QCOMPARE(hash.result(), QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+    }
+
+    void test_File()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto data = testData(1000000);
+        auto path = FS::PathCombine(temp.path(), "file.bin");
+        FS::write(path, data);
+        QCOMPARE(MultiHash::hashFile(path, QCryptographicHash::Sha1), QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+        QCOMPARE(MultiHash::hashFile(path, QCryptographicHash::Md5), QCryptographicHash::hash(data, QCryptographicHash::Md5));
+
+        auto empty = FS::PathCombine(temp.path(), "empty.bin");
+        FS::write(empty, QByteArray());
+        QCOMPARE(MultiHash::hashFile(empty, QCryptographicHash::Sha1).toHex(), QByteArray("da39a3ee5e6b4b0d3255bfef95601890afd80709"));
+
+        QVERIFY(MultiHash::hashFile(FS::PathCombine(temp.path(), "missing"), QCryptographicHash::Sha1).isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(MultiHashTest)
+
+#include "MultiHash_test.moc"
@@ -0,0 +1,500 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ZipExtractor.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <atomic>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+const quint32 localHeaderSignature = 0x04034b50;
+const quint32 centralHeaderSignature = 0x02014b50;
+const quint32 endOfCentralDirectorySignature = 0x06054b50;
+const quint32 zip64LocatorSignature = 0x07064b50;
+const quint32 zip64EndOfCentralDirectorySignature = 0x06064b50;
+
+const quint16 flagEncrypted = 1 << 0;
+const quint16 flagUtf8 = 1 << 11;
+const quint16 methodStored = 0;
+const quint16 methodDeflated = 8;
+
+const int hostUnix = 3;
+const int hostOSX = 19;
+const quint32 typeMask = 0170000;
+const quint32 typeSymlink = 0120000;
+
+// keeps both the input and output chunks handed to zlib within its 32 bit counters
+const quint64 maxChunk = 1 << 30;
+const int bufferSize = 256 * 1024;
+
+template <typename T>
+T read(const uchar *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+bool isAscii(const QByteArray &bytes)
+{
+    for(auto c: bytes)
+    {
+        if(uchar(c) >= 0x80)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+QFileDevice::Permissions filePermissions(quint32 mode)
+{
+    QFileDevice::Permissions permissions = QFileDevice::ReadOwner | QFileDevice::ReadUser | QFileDevice::WriteOwner | QFileDevice::WriteUser;
+    if(mode & 0100)
+        permissions |= QFileDevice::ExeOwner | QFileDevice::ExeUser;
+    if(mode & 0040)
+        permissions |= QFileDevice::ReadGroup;
+    if(mode & 0020)
+        permissions |= QFileDevice::WriteGroup;
+    if(mode & 0010)
+        permissions |= QFileDevice::ExeGroup;
+    if(mode & 0004)
+        permissions |= QFileDevice::ReadOther;
+    if(mode & 0002)
+        permissions |= QFileDevice::WriteOther;
+    if(mode & 0001)
+        permissions |= QFileDevice::ExeOther;
+    return permissions;
+}
+}
+
+ZipExtractor::ZipExtractor(const QString &archivePath) : m_path(archivePath)
+{
+}
+
+bool ZipExtractor::fail(const QString &error)
+{
+    m_error = error;
+    m_entries.clear();
+    m_file.close();
+    return false;
+}
+
+bool ZipExtractor::open()
+{
+    m_entries.clear();
+    m_file.setFileName(m_path);
+    if(!m_file.open(QIODevice::ReadOnly))
+    {
+        return fail(QString("Could not open %1: %2").arg(m_path, m_file.errorString()));
+    }
+    m_size = m_file.size();
+    if(m_size < 22)
+    {
+        return fail(QString("%1 is not a zip archive").arg(m_path));
+    }
+    const uchar *data = m_file.map(0, m_size);
+    if(!data)
+    {
+        return fail(QString("Could not map %1: %2").arg(m_path, m_file.errorString()));
+    }
+
+    // the end of central directory record is followed by a comment of at most 64 KiB
+    qint64 end = -1;
+    for(qint64 pos = m_size - 22, lowest = qMax<qint64>(0, m_size - 22 - 0xffff); pos >= lowest; pos--)
+    {
+        if(read<quint32>(data + pos) == endOfCentralDirectorySignature)
+        {
+            end = pos;
+            break;
+        }
+    }
+    if(end < 0)
+    {
+        return fail(QString("%1 is not a zip archive").arg(m_path));
+    }
+    if(read<quint16>(data + end + 4) != 0 && read<quint16>(data + end + 4) != 0xffff)
+    {
+        return fail(QString("%1 spans multiple disks").arg(m_path));
+    }
+    quint64 count = read<quint16>(data + end + 10);
+    quint64 directorySize = read<quint32>(data + end + 12);
+    quint64 directoryOffset = read<quint32>(data + end + 16);
+    if(count == 0xffff || directorySize == 0xffffffff || directoryOffset == 0xffffffff)
+    {
+        qint64 locator = end - 20;
+        if(locator < 0 || read<quint32>(data + locator) != zip64LocatorSignature)
+        {
+            return fail(QString("%1 has a broken zip64 locator").arg(m_path));
+        }
+        quint64 zip64End = read<quint64>(data + locator + 8);
+        if(zip64End + 56 > quint64(m_size) || read<quint32>(data + zip64End) != zip64EndOfCentralDirectorySignature)
+        {
+            return fail(QString("%1 has a broken zip64 end of central directory").arg(m_path));
+        }
+        count = read<quint64>(data + zip64End + 32);
+        directorySize = read<quint64>(data + zip64End + 40);
+        directoryOffset = read<quint64>(data + zip64End + 48);
+    }
+    if(directoryOffset > quint64(m_size) || directorySize > quint64(m_size) - directoryOffset)
+    {
+        return fail(QString("%1 has a truncated central directory").arg(m_path));
+    }
+
+    const uchar *p = data + directoryOffset;
+    const uchar *directoryEnd = p + directorySize;
+    // every entry takes at least 46 bytes, so a bogus count can't make us reserve the world
+    m_entries.reserve(int(qMin<quint64>(count, directorySize / 46)));
+    for(quint64 i = 0; i < count; i++)
+    {
+        if(directoryEnd - p < 46 || read<quint32>(p) != centralHeaderSignature)
+        {
+            return fail(QString("%1 has a corrupted central directory").arg(m_path));
+        }
+        Entry entry;
+        int host = read<quint16>(p + 4) >> 8;
+        entry.flags = read<quint16>(p + 8);
+        entry.method = read<quint16>(p + 10);
+        entry.crc = read<quint32>(p + 16);
+        entry.compressedSize = read<quint32>(p + 20);
+        entry.size = read<quint32>(p + 24);
+        int nameLength = read<quint16>(p + 28);
+        int extraLength = read<quint16>(p + 30);
+        int commentLength = read<quint16>(p + 32);
+        quint32 externalAttributes = read<quint32>(p + 38);
+        entry.localHeaderOffset = read<quint32>(p + 42);
+        if(directoryEnd - p < 46 + nameLength + extraLength + commentLength)
+        {
+            return fail(QString("%1 has a corrupted central directory").arg(m_path));
+        }
+
+        QByteArray rawName(reinterpret_cast<const char *>(p + 46), nameLength);
+        if(!(entry.flags & flagUtf8) && !isAscii(rawName))
+        {
+            return fail(QString("%1 uses a legacy file name encoding").arg(m_path));
+        }
+        entry.name = QString::fromUtf8(rawName);
+        if(host == hostUnix || host == hostOSX)
+        {
+            entry.mode = externalAttributes >> 16;
+        }
+
+        // zip64 extended information, holding only the fields that did not fit
+        const uchar *extra = p + 46 + nameLength;
+        const uchar *extraEnd = extra + extraLength;
+        while(extraEnd - extra >= 4)
+        {
+            quint16 id = read<quint16>(extra);
+            quint16 length = read<quint16>(extra + 2);
+            if(extraEnd - extra - 4 < length)
+            {
+                break;
+            }
+            if(id == 0x0001)
+            {
+                const uchar *field = extra + 4;
+                const uchar *fieldEnd = field + length;
+                auto widen = [&](quint64 &value)
+                {
+                    if(value == 0xffffffff && fieldEnd - field >= 8)
+                    {
+                        value = read<quint64>(field);
+                        field += 8;
+                    }
+                };
+                widen(entry.size);
+                widen(entry.compressedSize);
+                widen(entry.localHeaderOffset);
+            }
+            extra += 4 + length;
+        }
+        p += 46 + nameLength + extraLength + commentLength;
+
+        if(entry.flags & flagEncrypted)
+        {
+            return fail(QString("%1 is encrypted").arg(m_path));
+        }
+        if(entry.method != methodStored && entry.method != methodDeflated)
+        {
+            return fail(QString("%1 uses unsupported compression method %2").arg(m_path).arg(entry.method));
+        }
+        if((entry.mode & typeMask) == typeSymlink)
+        {
+            return fail(QString("%1 contains symbolic links").arg(m_path));
+        }
+        m_entries.append(entry);
+    }
+    // the workers map the archive on their own
+    m_file.close();
+    return true;
+}
+
+bool ZipExtractor::extractEntry(const uchar *data, const Entry &entry, const QString &path, QByteArray &buffer, QString &error) const
+{
+    quint64 offset = entry.localHeaderOffset;
+    if(offset + 30 > quint64(m_size) || read<quint32>(data + offset) != localHeaderSignature)
+    {
+        error = QString("Corrupted local header of %1").arg(entry.name);
+        return false;
+    }
+    quint64 dataOffset = offset + 30 + read<quint16>(data + offset + 26) + read<quint16>(data + offset + 28);
+    if(dataOffset > quint64(m_size) || entry.compressedSize > quint64(m_size) - dataOffset)
+    {
+        error = QString("Truncated data of %1").arg(entry.name);
+        return false;
+    }
+
+    QFile out(path);
+    if(!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        error = QString("Could not open %1 for writing: %2").arg(path, out.errorString());
+        return false;
+    }
+
+    const uchar *in = data + dataOffset;
+    quint64 left = entry.compressedSize;
+    quint64 written = 0;
+    uLong crc = crc32(0L, Z_NULL, 0);
+    if(entry.method == methodStored)
+    {
+        while(left)
+        {
+            auto chunk = qMin(left, maxChunk);
+            crc = crc32(crc, in, uInt(chunk));
+            if(out.write(reinterpret_cast<const char *>(in), qint64(chunk)) != qint64(chunk))
+            {
+                error = QString("Could not write %1: %2").arg(path, out.errorString());
+                return false;
+            }
+            in += chunk;
+            left -= chunk;
+            written += chunk;
+        }
+    }
+    else
+    {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        // raw deflate, there is no zlib header inside zip archives
+        if(inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        {
+            error = QString("Could not initialize zlib for %1").arg(entry.name);
+            return false;
+        }
+        int result = Z_OK;
+        while(result != Z_STREAM_END)
+        {
+            if(stream.avail_in == 0 && left)
+            {
+                auto chunk = qMin(left, maxChunk);
+                stream.next_in = const_cast<Bytef *>(in);
+                stream.avail_in = uInt(chunk);
+                in += chunk;
+                left -= chunk;
+            }
+            stream.next_out = reinterpret_cast<Bytef *>(buffer.data());
+            stream.avail_out = uInt(buffer.size());
+            result = inflate(&stream, Z_NO_FLUSH);
+            if(result != Z_OK && result != Z_STREAM_END)
+            {
+                inflateEnd(&stream);
+                error = QString("Corrupted data in %1").arg(entry.name);
+                return false;
+            }
+            qint64 produced = buffer.size() - stream.avail_out;
+            crc = crc32(crc, reinterpret_cast<const Bytef *>(buffer.constData()), uInt(produced));
+            if(out.write(buffer.constData(), produced) != produced)
+            {
+                inflateEnd(&stream);
+                error = QString("Could not write %1: %2").arg(path, out.errorString());
+                return false;
+            }
+            written += produced;
+        }
+        inflateEnd(&stream);
+    }
+    if(written != entry.size || crc != entry.crc)
+    {
+        error = QString("CRC mismatch in %1").arg(entry.name);
+        return false;
+    }
+    // archives made on other systems carry no mode, whatever the file was created with is fine then
+    if(entry.mode & 0777)
+    {
+        out.setPermissions(filePermissions(entry.mode));
+    }
+    return true;
+}
+
+nonstd::optional<QStringList> ZipExtractor::extract(const QString &subdir, const QString &target)
+{
+    struct Job
+    {
+        int entry;
+        QString path;
+    };
+
+    QDir directory(target);
+    const QString root = QDir::cleanPath(directory.absolutePath());
+    QStringList extracted;
+    QVector<Job> jobs;
+    // duplicate names are legal in zip files, the last entry wins like it did when extracting one by one
+    QHash<QString, int> jobForPath;
+    QSet<QString> folders;
+    folders.insert(root);
+    for(int i = 0; i < m_entries.size(); i++)
+    {
+        QString name = m_entries[i].name;
+        if(!name.startsWith(subdir))
+        {
+            continue;
+        }
+        name.remove(0, subdir.size());
+        QString absFilePath = directory.absoluteFilePath(name);
+        if(name.isEmpty())
+        {
+            absFilePath += "/";
+        }
+        QString cleanPath = QDir::cleanPath(absFilePath);
+        if(cleanPath != root && !cleanPath.startsWith(root + '/'))
+        {
+            m_error = QString("%1 points outside of the target folder").arg(m_entries[i].name);
+            return nonstd::nullopt;
+        }
+        if(absFilePath.endsWith('/'))
+        {
+            folders.insert(cleanPath);
+        }
+        else
+        {
+            folders.insert(QFileInfo(cleanPath).path());
+            auto existing = jobForPath.constFind(cleanPath);
+            if(existing != jobForPath.constEnd())
+            {
+                jobs[existing.value()].entry = i;
+            }
+            else
+            {
+                jobForPath.insert(cleanPath, jobs.size());
+                jobs.append({i, cleanPath});
+            }
+        }
+        extracted.append(absFilePath);
+    }
+
+    // creating the folders up front keeps the workers from racing each other on mkpath
+    for(auto &folder: folders)
+    {
+        if(!QDir().mkpath(folder))
+        {
+            m_error = QString("Could not create folder %1").arg(folder);
+            return nonstd::nullopt;
+        }
+    }
+    if(jobs.isEmpty())
+    {
+        return extracted;
+    }
+
+    // our own pool, this is usually called from a task already running on the global one
+    QThreadPool pool;
+    int threads = qBound(1, QThread::idealThreadCount(), jobs.size());
+    pool.setMaxThreadCount(threads);
+
+    std::atomic<int> next(0);
+    std::atomic<bool> failed(false);
+    // only touched through const accessors and distinct elements from the workers
+    std::vector<char> done(jobs.size(), 0);
+    QMutex errorLock;
+    QString error;
+    auto setError = [&](const QString &message)
+    {
+        QMutexLocker locker(&errorLock);
+        if(error.isEmpty())
+        {
+            error = message;
+        }
+        failed = true;
+    };
+    auto worker = [&]()
+    {
+        QFile file(m_path);
+        if(!file.open(QIODevice::ReadOnly))
+        {
+            setError(QString("Could not open %1: %2").arg(m_path, file.errorString()));
+            return;
+        }
+        const uchar *data = file.map(0, m_size);
+        if(!data)
+        {
+            setError(QString("Could not map %1: %2").arg(m_path, file.errorString()));
+            return;
+        }
+        QByteArray buffer(bufferSize, Qt::Uninitialized);
+        while(!failed)
+        {
+            int job = next++;
+            if(job >= jobs.size())
+            {
+                break;
+            }
+            const auto &current = jobs.at(job);
+            QString message;
+            if(!extractEntry(data, m_entries.at(current.entry), current.path, buffer, message))
+            {
+                QFile::remove(current.path);
+                setError(message);
+                break;
+            }
+            done[job] = 1;
+        }
+    };
+
+    QVector<QFuture<void>> futures;
+    for(int i = 0; i < threads; i++)
+    {
+        futures.append(QtConcurrent::run(&pool, worker));
+    }
+    for(auto &future: futures)
+    {
+        future.waitForFinished();
+    }
+
+    if(failed)
+    {
+        m_error = error;
+        for(int i = 0; i < jobs.size(); i++)
+        {
+            if(done[i])
+            {
+                QFile::remove(jobs.at(i).path);
+            }
+        }
+        return nonstd::nullopt;
+    }
+    qDebug() << "Extracted" << jobs.size() << "files from" << m_path << "using" << threads << "threads";
+    return extracted;
+}
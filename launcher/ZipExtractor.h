@@ -0,0 +1,79 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <nonstd/optional>
+
+/**
+ * Extracts zip archives straight from their central directory, spreading the entries over several threads.
+ *
+ * Each worker has its own handle and memory mapped view of the archive, so nothing is shared between them except the
+ * list of entries. Permissions are applied as every file is written, always leaving the files readable and writable by
+ * the user.
+ *
+ * Only stored and deflated entries with UTF-8 (or plain ASCII) names are handled. Encrypted archives, symbolic links,
+ * legacy file name encodings and anything else out of the ordinary make open() fail, and the caller is expected to
+ * fall back to QuaZip.
+ */
+class ZipExtractor
+{
+public:
+    explicit ZipExtractor(const QString &archivePath);
+
+    /// Map the archive and read its central directory
+    bool open();
+
+    /**
+     * Extract everything under subdir into target, which is created if it does not exist.
+     *
+     * \return The full paths of the extracted entries in archive order, nothing on failure. Files written before the
+     *         failure are removed again.
+     */
+    nonstd::optional<QStringList> extract(const QString &subdir, const QString &target);
+
+    QString errorString() const
+    {
+        return m_error;
+    }
+
+private:
+    struct Entry
+    {
+        QString name;
+        quint16 flags = 0;
+        quint16 method = 0;
+        quint32 crc = 0;
+        quint64 compressedSize = 0;
+        quint64 size = 0;
+        quint64 localHeaderOffset = 0;
+        // unix mode bits, 0 if the archive was not made on a unix system
+        quint32 mode = 0;
+    };
+
+    bool fail(const QString &error);
+    bool extractEntry(const uchar *data, const Entry &entry, const QString &path, QByteArray &buffer, QString &error) const;
+
+private:
+    QString m_path;
+    QString m_error;
+    QFile m_file;
+    qint64 m_size = 0;
+    QVector<Entry> m_entries;
+};
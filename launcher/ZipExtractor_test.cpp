@@ -0,0 +1,224 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include "TestUtil.h"
+
+#include <zlib.h>
+
+#include "FileSystem.h"
+#include "ZipExtractor.h"
+
+namespace {
+struct TestEntry
+{
+    QByteArray name;
+    QByteArray data;
+    quint32 mode;
+    bool deflate;
+};
+
+// minimal archive writer, so the test does not depend on what QuaZip puts into the headers
+class ZipWriter
+{
+public:
+    void add(const TestEntry &entry)
+    {
+        QByteArray payload = entry.data;
+        if(entry.deflate)
+        {
+            z_stream stream;
+            memset(&stream, 0, sizeof(stream));
+            deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+            payload.resize(int(deflateBound(&stream, uLong(entry.data.size()))));
+            stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(entry.data.constData()));
+            stream.avail_in = uInt(entry.data.size());
+            stream.next_out = reinterpret_cast<Bytef *>(payload.data());
+            stream.avail_out = uInt(payload.size());
+            deflate(&stream, Z_FINISH);
+            payload.resize(int(stream.total_out));
+            deflateEnd(&stream);
+        }
+        quint32 crc = quint32(crc32(0L, reinterpret_cast<const Bytef *>(entry.data.constData()), uInt(entry.data.size())));
+        quint16 method = entry.deflate ? 8 : 0;
+
+        int offset = m_data.size();
+        u32(m_data, 0x04034b50);
+        u16(m_data, 20);
+        u16(m_data, 1 << 11);
+        u16(m_data, method);
+        u32(m_data, 0);
+        u32(m_data, crc);
+        u32(m_data, quint32(payload.size()));
+        u32(m_data, quint32(entry.data.size()));
+        u16(m_data, quint16(entry.name.size()));
+        u16(m_data, 0);
+        m_data.append(entry.name);
+        m_data.append(payload);
+
+        u32(m_directory, 0x02014b50);
+        u16(m_directory, 3 << 8 | 20);
+        u16(m_directory, 20);
+        u16(m_directory, 1 << 11);
+        u16(m_directory, method);
+        u32(m_directory, 0);
+        u32(m_directory, crc);
+        u32(m_directory, quint32(payload.size()));
+        u32(m_directory, quint32(entry.data.size()));
+        u16(m_directory, quint16(entry.name.size()));
+        u16(m_directory, 0);
+        u16(m_directory, 0);
+        u16(m_directory, 0);
+        u16(m_directory, 0);
+        u32(m_directory, entry.mode << 16);
+        u32(m_directory, quint32(offset));
+        m_directory.append(entry.name);
+        m_count++;
+    }
+
+    QByteArray finish() const
+    {
+        QByteArray out = m_data + m_directory;
+        u32(out, 0x06054b50);
+        u16(out, 0);
+        u16(out, 0);
+        u16(out, m_count);
+        u16(out, m_count);
+        u32(out, quint32(m_directory.size()));
+        u32(out, quint32(m_data.size()));
+        u16(out, 0);
+        return out;
+    }
+
+private:
+    static void u16(QByteArray &out, quint16 value)
+    {
+        uchar bytes[2];
+        qToLittleEndian(value, bytes);
+        out.append(reinterpret_cast<const char *>(bytes), 2);
+    }
+    static void u32(QByteArray &out, quint32 value)
+    {
+        uchar bytes[4];
+        qToLittleEndian(value, bytes);
+        out.append(reinterpret_cast<const char *>(bytes), 4);
+    }
+
+    QByteArray m_data;
+    QByteArray m_directory;
+    quint16 m_count = 0;
+};
+
+QByteArray content(int seed, int size)
+{
+    QByteArray data(size, 0);
+    for(int i = 0; i < size; i++)
+    {
+        data[i] = char((i / 7 + seed) & 0xff);
+    }
+    return data;
+}
+}
+
+class ZipExtractorTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_Extract()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        ZipWriter writer;
+        writer.add({"overrides/", "", 040755, false});
+        writer.add({"overrides/run.sh", "#!/bin/sh\n", 0100755, false});
+        writer.add({"overrides/readonly.txt", "data", 0100444, true});
+        for(int i = 0; i < 64; i++)
+        {
+            writer.add({"overrides/mods/mod" + QByteArray::number(i) + ".jar", content(i, 1000 + i * 997), 0100644, i % 2 == 0});
+        }
+        writer.add({"manifest.json", "{}", 0100644, true});
+        auto archive = FS::PathCombine(temp.path(), "pack.zip");
+        FS::write(archive, writer.finish());
+
+        auto target = FS::PathCombine(temp.path(), "minecraft");
+        ZipExtractor extractor(archive);
+        QVERIFY(extractor.open());
+        auto extracted = extractor.extract("overrides/", target);
+        QVERIFY(extracted.has_value());
+        QCOMPARE(extracted->size(), 67);
+        QCOMPARE(extracted->at(1), QDir(target).absoluteFilePath("run.sh"));
+        QVERIFY(!QFile::exists(FS::PathCombine(target, "manifest.json")));
+
+        for(int i = 0; i < 64; i++)
+        {
+            QCOMPARE(FS::read(FS::PathCombine(target, "mods", QString("mod%1.jar").arg(i))), content(i, 1000 + i * 997));
+        }
+        QCOMPARE(FS::read(FS::PathCombine(target, "readonly.txt")), QByteArray("data"));
+#ifdef Q_OS_UNIX
+        QVERIFY(QFile::permissions(FS::PathCombine(target, "run.sh")) & QFileDevice::ExeUser);
+        // always left writable for us
+        QVERIFY(QFile::permissions(FS::PathCombine(target, "readonly.txt")) & QFileDevice::WriteUser);
+#endif
+    }
+
+    void test_Corrupted()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        ZipWriter writer;
+        writer.add({"good.txt", content(1, 5000), 0100644, true});
+        writer.add({"bad.txt", content(2, 5000), 0100644, true});
+        auto data = writer.finish();
+        // flip a byte inside the second entry's compressed data
+        int bad = data.indexOf("bad.txt") + 10;
+        data[bad] = char(data[bad] ^ 0x55);
+        auto archive = FS::PathCombine(temp.path(), "broken.zip");
+        FS::write(archive, data);
+
+        auto target = FS::PathCombine(temp.path(), "out");
+        ZipExtractor extractor(archive);
+        QVERIFY(extractor.open());
+        QVERIFY(!extractor.extract("", target).has_value());
+        QVERIFY(!extractor.errorString().isEmpty());
+        QVERIFY(!QFile::exists(FS::PathCombine(target, "bad.txt")));
+    }
+
+    void test_DuplicateNames()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        ZipWriter writer;
+        writer.add({"config/options.txt", content(1, 200000), 0100644, true});
+        writer.add({"config/other.txt", "other", 0100644, false});
+        writer.add({"config/./options.txt", "second", 0100644, false});
+        writer.add({"config/options.txt", "last", 0100644, true});
+        auto archive = FS::PathCombine(temp.path(), "sloppy.zip");
+        FS::write(archive, writer.finish());
+
+        auto target = FS::PathCombine(temp.path(), "out");
+        ZipExtractor extractor(archive);
+        QVERIFY(extractor.open());
+        QVERIFY(extractor.extract("", target).has_value());
+        QCOMPARE(FS::read(FS::PathCombine(target, "config", "options.txt")), QByteArray("last"));
+        QCOMPARE(FS::read(FS::PathCombine(target, "config", "other.txt")), QByteArray("other"));
+    }
+
+    void test_Escape()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        ZipWriter writer;
+        writer.add({"../evil.txt", "nope", 0100644, false});
+        auto archive = FS::PathCombine(temp.path(), "evil.zip");
+        FS::write(archive, writer.finish());
+
+        ZipExtractor extractor(archive);
+        QVERIFY(extractor.open());
+        QVERIFY(!extractor.extract("", FS::PathCombine(temp.path(), "out")).has_value());
+        QVERIFY(!QFile::exists(FS::PathCombine(temp.path(), "evil.txt")));
+    }
+};
+
+QTEST_GUILESS_MAIN(ZipExtractorTest)
+
+#include "ZipExtractor_test.moc"
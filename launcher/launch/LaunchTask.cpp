@@ -211,6 +211,12 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
         m_logModel.reset(new LogModel());
         m_logModel->setMaxLines(m_instance->getConsoleMaxLines());
         m_logModel->setStopOnOverflow(m_instance->shouldStopOnConsoleOverflow());
+        // lines that no longer fit go to a compressed temporary file, so the whole session can still be uploaded.
+        // when logging stops on overflow, nothing is ever pushed out and there is no need for it.
+        if(!m_instance->shouldStopOnConsoleOverflow() && !m_logModel->setArchiveEnabled(true))
+        {
+            qWarning() << "Could not create the log archive, old log lines will be discarded";
+        }
         // FIXME: should this really be here?
         m_logModel->setOverflowMessage(tr("MultiMC stopped watching the game log because the log length surpassed %1 lines.\n"
             "You may have to fix your mods because the game is still logging to files and"
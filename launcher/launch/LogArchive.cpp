@@ -0,0 +1,227 @@
+#include "LogArchive.h"
+
+#include <QDir>
+#include <QIODevice>
+#include <QtEndian>
+#include <QDebug>
+
+#include <algorithm>
+
+#include "BuildConfig.h"
+
+namespace {
+// uncompressed size at which pending lines are written out as a segment
+const int segmentSize = 64 * 1024;
+// per line: one byte of level, four bytes of length
+const int recordHeaderSize = 5;
+}
+
+bool LogArchive::open()
+{
+    if(m_file)
+    {
+        return true;
+    }
+    std::unique_ptr<QTemporaryFile> file(new QTemporaryFile(QDir::temp().filePath(BuildConfig.LAUNCHER_NAME + "-log-XXXXXX")));
+    if(!file->open())
+    {
+        qWarning() << "Could not open log archive file:" << file->errorString();
+        return false;
+    }
+    m_file = std::move(file);
+    m_failed = false;
+    return true;
+}
+
+bool LogArchive::isOpen() const
+{
+    return m_file && !m_failed;
+}
+
+void LogArchive::append(MessageLevel::Enum level, const char* data, int size)
+{
+    if(!isOpen())
+    {
+        return;
+    }
+    char header[recordHeaderSize];
+    header[0] = char(level);
+    qToLittleEndian<quint32>(quint32(size), reinterpret_cast<uchar *>(header + 1));
+    m_pending.append(header, recordHeaderSize);
+    m_pending.append(data, size);
+    m_pendingLines++;
+    m_lineCount++;
+    if(m_pending.size() >= segmentSize)
+    {
+        flush();
+    }
+}
+
+bool LogArchive::flush()
+{
+    if(!isOpen())
+    {
+        return false;
+    }
+    if(!m_pendingLines)
+    {
+        return true;
+    }
+    auto compressed = qCompress(m_pending);
+    Segment segment;
+    segment.offset = m_file->size();
+    segment.compressedSize = compressed.size();
+    segment.firstLine = m_lineCount - m_pendingLines;
+    segment.lineCount = m_pendingLines;
+    if(!m_file->seek(segment.offset) || m_file->write(compressed) != compressed.size())
+    {
+        qWarning() << "Could not write to log archive file:" << m_file->errorString();
+        m_failed = true;
+        return false;
+    }
+    m_segments.append(segment);
+    m_pending.clear();
+    m_pendingLines = 0;
+    return true;
+}
+
+void LogArchive::clear()
+{
+    m_segments.clear();
+    m_pending.clear();
+    m_pendingLines = 0;
+    m_lineCount = 0;
+    if(m_file)
+    {
+        m_file->resize(0);
+    }
+}
+
+bool LogArchive::readSegment(const LogArchive::Segment& segment, QByteArray& raw)
+{
+    if(!m_file->seek(segment.offset))
+    {
+        return false;
+    }
+    auto compressed = m_file->read(segment.compressedSize);
+    if(compressed.size() != int(segment.compressedSize))
+    {
+        return false;
+    }
+    raw = qUncompress(compressed);
+    return !raw.isEmpty();
+}
+
+template <typename F>
+bool LogArchive::forEachLine(F callback)
+{
+    if(!isOpen())
+    {
+        return false;
+    }
+    auto walk = [&](const QByteArray & raw, int firstLine)
+    {
+        int lineNum = firstLine;
+        const char * data = raw.constData();
+        int pos = 0;
+        while(pos + recordHeaderSize <= raw.size())
+        {
+            auto level = MessageLevel::Enum(data[pos]);
+            auto size = int(qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(data + pos + 1)));
+            pos += recordHeaderSize;
+            callback(lineNum++, level, data + pos, size);
+            pos += size;
+        }
+    };
+    QByteArray raw;
+    for(auto & segment: m_segments)
+    {
+        if(!readSegment(segment, raw))
+        {
+            qWarning() << "Log archive segment at" << segment.offset << "is unreadable";
+            return false;
+        }
+        walk(raw, segment.firstLine);
+    }
+    walk(m_pending, m_lineCount - m_pendingLines);
+    return true;
+}
+
+QList<int> LogArchive::find(const QString& needle, Qt::CaseSensitivity cs)
+{
+    QList<int> found;
+    if(needle.isEmpty())
+    {
+        return found;
+    }
+    // UTF-8 substring matching is exact, so case sensitive searches do not need to decode the lines
+    bool bytewise = cs == Qt::CaseSensitive;
+    auto needleUtf8 = needle.toUtf8();
+    forEachLine([&](int lineNum, MessageLevel::Enum, const char * data, int size)
+    {
+        if(bytewise)
+        {
+            if(QByteArray::fromRawData(data, size).contains(needleUtf8))
+            {
+                found.append(lineNum);
+            }
+        }
+        else if(QString::fromUtf8(data, size).contains(needle, cs))
+        {
+            found.append(lineNum);
+        }
+    });
+    return found;
+}
+
+QString LogArchive::line(int lineNum)
+{
+    if(!isOpen() || lineNum < 0 || lineNum >= m_lineCount)
+    {
+        return QString();
+    }
+    int firstLine = m_lineCount - m_pendingLines;
+    QByteArray raw;
+    if(lineNum >= firstLine)
+    {
+        raw = m_pending;
+    }
+    else
+    {
+        // the last segment starting at or before the line holds it
+        auto segment = std::upper_bound(m_segments.begin(), m_segments.end(), lineNum, [](int lineNum, const Segment & segment)
+        {
+            return lineNum < segment.firstLine;
+        }) - 1;
+        if(!readSegment(*segment, raw))
+        {
+            qWarning() << "Log archive segment at" << segment->offset << "is unreadable";
+            return QString();
+        }
+        firstLine = segment->firstLine;
+    }
+    const char * data = raw.constData();
+    int pos = 0;
+    while(pos + recordHeaderSize <= raw.size())
+    {
+        auto size = int(qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(data + pos + 1)));
+        pos += recordHeaderSize;
+        if(firstLine++ == lineNum)
+        {
+            return QString::fromUtf8(data + pos, size);
+        }
+        pos += size;
+    }
+    return QString();
+}
+
+bool LogArchive::writeTo(QIODevice& out)
+{
+    bool ok = true;
+    bool result = forEachLine([&](int, MessageLevel::Enum, const char * data, int size)
+    {
+        ok &= out.write(data, size) == size;
+        ok &= out.putChar('\n');
+    });
+    return result && ok;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QTemporaryFile>
+#include <QVector>
+#include <memory>
+
+#include "MessageLevel.h"
+
+class QIODevice;
+
+/**
+ * Append-only on-disk store for log lines evicted from a LogModel.
+ *
+ * Lines are batched into segments, each compressed separately with qCompress and appended to a temporary file.
+ * The segment table is kept in memory, so any line can be reached by decompressing a single segment.
+ */
+class LogArchive
+{
+public:
+    LogArchive() = default;
+    ~LogArchive() = default;
+
+    /// Opens the backing temporary file. Returns false if the archive cannot be used.
+    bool open();
+    bool isOpen() const;
+
+    /// Add a line (UTF-8 encoded) to the end of the archive.
+    void append(MessageLevel::Enum level, const char * data, int size);
+
+    /// Compress and write out any lines that are still pending.
+    bool flush();
+
+    /// Drop everything, keeping the archive open.
+    void clear();
+
+    int lineCount() const
+    {
+        return m_lineCount;
+    }
+
+    /// Line numbers (counting from the oldest archived line) that contain the needle.
+    QList<int> find(const QString & needle, Qt::CaseSensitivity cs = Qt::CaseInsensitive);
+
+    /// The archived line with the given number, or a null string if there is no such line.
+    QString line(int lineNum);
+
+    /// Write all archived lines, newline separated, to the given device.
+    bool writeTo(QIODevice & out);
+
+private: /* types */
+    struct Segment
+    {
+        qint64 offset;
+        quint32 compressedSize;
+        int firstLine;
+        int lineCount;
+    };
+
+private: /* methods */
+    bool readSegment(const Segment & segment, QByteArray & raw);
+    template <typename F> bool forEachLine(F callback);
+
+private: /* data */
+    std::unique_ptr<QTemporaryFile> m_file;
+    QVector<Segment> m_segments;
+    QByteArray m_pending;
+    int m_pendingLines = 0;
+    int m_lineCount = 0;
+    bool m_failed = false;
+};
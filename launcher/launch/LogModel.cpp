@@ -1,8 +1,41 @@
 #include "LogModel.h"
 
+#include <QBuffer>
+#include <cstring>
+
+namespace {
+// bytes of line data kept in memory per line of the configured limit
+const qint64 arenaBytesPerLine = 128;
+const qint64 minimumArenaBudget = 1024 * 1024;
+const qint64 maximumArenaBudget = 1024 * 1024 * 1024;
+const int initialArenaSize = 16 * 1024;
+
+// longest prefix of the UTF-8 text that fits in maxSize bytes, ending at a line break if there is one
+int utf8PrefixSize(const QByteArray & bytes, int maxSize)
+{
+    if(bytes.size() <= maxSize)
+    {
+        return bytes.size();
+    }
+    int newline = bytes.lastIndexOf('\n', maxSize - 1);
+    if(newline > 0)
+    {
+        return newline;
+    }
+    // do not cut a multi-byte sequence in half, continuation bytes look like 10xxxxxx
+    int size = maxSize;
+    while(size > 0 && (uchar(bytes[size]) & 0xC0) == 0x80)
+    {
+        size--;
+    }
+    return size;
+}
+}
+
 LogModel::LogModel(QObject *parent):QAbstractListModel(parent)
 {
     m_content.resize(m_maxLines);
+    resetArena();
 }
 
 int LogModel::rowCount(const QModelIndex &parent) const
@@ -22,7 +55,7 @@ QVariant LogModel::data(const QModelIndex &index, int role) const
     auto realRow = (row + m_firstLine) % m_maxLines;
     if (role == Qt::DisplayRole || role == Qt::EditRole)
     {
-        return m_content[realRow].line;
+        return QString::fromUtf8(lineBytes(m_content[realRow]));
     }
     if(role == LevelRole)
     {
@@ -32,35 +65,137 @@ QVariant LogModel::data(const QModelIndex &index, int role) const
     return QVariant();
 }
 
-void LogModel::append(MessageLevel::Enum level, QString line)
+QByteArray LogModel::lineBytes(const entry& e) const
 {
-    if(m_suspended)
+    int offset = e.offset;
+    int size = e.size;
+    int tail = m_arena.size() - offset;
+    if(size <= tail)
     {
-        return;
+        return QByteArray::fromRawData(m_arena.constData() + offset, size);
     }
-    int lineNum = (m_firstLine + m_numLines) % m_maxLines;
-    // overflow
-    if(m_numLines == m_maxLines)
+    // the line wraps around the end of the arena
+    QByteArray out;
+    out.reserve(size);
+    out.append(m_arena.constData() + offset, tail);
+    out.append(m_arena.constData(), size - tail);
+    return out;
+}
+
+void LogModel::resetArena()
+{
+    m_arenaBudget = qBound(minimumArenaBudget, qint64(m_maxLines) * arenaBytesPerLine, maximumArenaBudget);
+    m_arena.clear();
+    m_arena.resize(initialArenaSize);
+    m_arenaUsed = 0;
+    m_writePos = 0;
+    m_wrapped = false;
+}
+
+void LogModel::dropOldest(int count)
+{
+    for(int i = 0; i < count; i++)
     {
-        if(m_stopOnOverflow)
+        auto & e = m_content[m_firstLine];
+        if(m_archiveEnabled)
         {
-            // nothing more to do, the buffer is full
-            return;
+            auto bytes = lineBytes(e);
+            m_archive.append(e.level, bytes.constData(), bytes.size());
         }
-        beginRemoveRows(QModelIndex(), 0, 0);
+        m_arenaUsed -= e.size;
         m_firstLine = (m_firstLine + 1) % m_maxLines;
         m_numLines --;
-        endRemoveRows();
+    }
+}
+
+int LogModel::linesToEvict(int size) const
+{
+    // when logging stops on overflow, nothing is ever evicted and the arena is allowed to outgrow its budget
+    bool bounded = m_wrapped || !m_stopOnOverflow;
+    int evict = 0;
+    qint64 used = m_arenaUsed;
+    while(evict < m_numLines && (m_numLines - evict >= m_maxLines || (bounded && used + size > m_arenaBudget)))
+    {
+        used -= m_content[(m_firstLine + evict) % m_maxLines].size;
+        evict ++;
+    }
+    return evict;
+}
+
+void LogModel::pushLine(MessageLevel::Enum level, const char* data, int size)
+{
+    // until the arena wraps around for the first time, its contents are contiguous and it can simply grow
+    if(!m_wrapped && m_writePos + size >= m_arena.size())
+    {
+        qint64 wanted = qMax(qint64(m_arena.size()) * 2, qint64(m_writePos) + size + 1);
+        if(!m_stopOnOverflow)
+        {
+            wanted = qMin(wanted, qint64(m_arenaBudget));
+        }
+        if(wanted > m_arena.size())
+        {
+            m_arena.resize(wanted);
+        }
+    }
+    if(m_writePos == m_arena.size())
+    {
+        m_writePos = 0;
+        m_wrapped = true;
+    }
+    int offset = m_writePos;
+    int tail = qMin(size, m_arena.size() - offset);
+    char * arena = m_arena.data();
+    memcpy(arena + offset, data, tail);
+    if(tail < size)
+    {
+        memcpy(arena, data + tail, size - tail);
+    }
+    m_writePos = offset + size;
+    if(m_writePos > m_arena.size())
+    {
+        m_writePos -= m_arena.size();
+        m_wrapped = true;
+    }
+
+    int lineNum = (m_firstLine + m_numLines) % m_maxLines;
+    m_content[lineNum].offset = offset;
+    m_content[lineNum].size = size;
+    m_content[lineNum].level = level;
+    m_numLines ++;
+    m_arenaUsed += size;
+}
+
+void LogModel::append(MessageLevel::Enum level, QString line)
+{
+    if(m_suspended)
+    {
+        return;
+    }
+    // overflow
+    if(m_numLines == m_maxLines && m_stopOnOverflow)
+    {
+        // nothing more to do, the buffer is full
+        return;
     }
     else if (m_numLines == m_maxLines - 1 && m_stopOnOverflow)
     {
         level = MessageLevel::Fatal;
         line = m_overflowMessage;
     }
+    auto bytes = line.toUtf8();
+    if(bytes.size() > m_arenaBudget)
+    {
+        bytes.truncate(utf8PrefixSize(bytes, m_arenaBudget));
+    }
+    int evict = linesToEvict(bytes.size());
+    if(evict)
+    {
+        beginRemoveRows(QModelIndex(), 0, evict - 1);
+        dropOldest(evict);
+        endRemoveRows();
+    }
     beginInsertRows(QModelIndex(), m_numLines, m_numLines);
-    m_numLines ++;
-    m_content[lineNum].level = level;
-    m_content[lineNum].line = line;
+    pushLine(level, bytes.constData(), bytes.size());
     endInsertRows();
 }
 
@@ -79,20 +214,33 @@ void LogModel::clear()
     beginResetModel();
     m_firstLine = 0;
     m_numLines = 0;
+    resetArena();
+    m_archive.clear();
     endResetModel();
 }
 
 QString LogModel::toPlainText()
 {
-    QString out;
-    out.reserve(m_numLines * 80);
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    writeTo(buffer);
+    return QString::fromUtf8(buffer.data());
+}
+
+bool LogModel::writeTo(QIODevice& out, bool includeArchived)
+{
+    bool ok = true;
+    if(includeArchived && m_archiveEnabled && m_archive.lineCount())
+    {
+        ok &= m_archive.writeTo(out);
+    }
     for(int i = 0; i < m_numLines; i++)
     {
-        QString & line = m_content[(m_firstLine + i) % m_maxLines].line;
-        out.append(line + '\n');
+        auto bytes = lineBytes(m_content[(m_firstLine + i) % m_maxLines]);
+        ok &= out.write(bytes) == bytes.size();
+        ok &= out.putChar('\n');
     }
-    out.squeeze();
-    return out;
+    return ok;
 }
 
 void LogModel::setMaxLines(int maxLines)
@@ -102,40 +250,46 @@ void LogModel::setMaxLines(int maxLines)
     {
         return;
     }
-    // if it all still fits in the buffer, just resize it
-    if(m_firstLine + m_numLines < m_maxLines)
+    // work out how many of the newest lines fit under the new limits
+    qint64 budget = qBound(minimumArenaBudget, qint64(maxLines) * arenaBytesPerLine, maximumArenaBudget);
+    int keep = 0;
+    qint64 keptBytes = 0;
+    while(keep < m_numLines && keep < maxLines)
     {
-        m_maxLines = maxLines;
-        m_content.resize(maxLines);
-        return;
-    }
-    // otherwise, we need to reorganize the data because it crosses the wrap boundary
-    QVector<entry> newContent;
-    newContent.resize(maxLines);
-    if(m_numLines <= maxLines)
-    {
-        // if it all fits in the new buffer, just copy it over
-        for(int i = 0; i < m_numLines; i++)
+        auto size = m_content[(m_firstLine + m_numLines - keep - 1) % m_maxLines].size;
+        if(!m_stopOnOverflow && keptBytes + size > budget)
         {
-            newContent[i] = m_content[(m_firstLine + i) % m_maxLines];
+            break;
         }
-        m_content.swap(newContent);
+        keptBytes += size;
+        keep ++;
     }
-    else
+    // if it doesn't fit, part of the data needs to be thrown away (the oldest log messages)
+    int lead = m_numLines - keep;
+    if(lead)
     {
-        // if it doesn't fit, part of the data needs to be thrown away (the oldest log messages)
-        int lead = m_numLines - maxLines;
         beginRemoveRows(QModelIndex(), 0, lead - 1);
-        for(int i = 0; i < maxLines; i++)
-        {
-            newContent[i] = m_content[(m_firstLine + lead + i) % m_maxLines];
-        }
-        m_numLines = m_maxLines;
-        m_content.swap(newContent);
+        dropOldest(lead);
         endRemoveRows();
     }
-    m_firstLine = 0;
+    // repack what is left into a fresh index and arena
+    QVector<QPair<MessageLevel::Enum, QByteArray>> kept;
+    kept.reserve(m_numLines);
+    for(int i = 0; i < m_numLines; i++)
+    {
+        auto & e = m_content[(m_firstLine + i) % m_maxLines];
+        kept.append(qMakePair(e.level, QByteArray(lineBytes(e).constData(), e.size)));
+    }
     m_maxLines = maxLines;
+    m_content.clear();
+    m_content.resize(maxLines);
+    m_firstLine = 0;
+    m_numLines = 0;
+    resetArena();
+    for(auto & line: kept)
+    {
+        pushLine(line.first, line.second.constData(), line.second.size());
+    }
 }
 
 int LogModel::getMaxLines()
@@ -153,6 +307,44 @@ void LogModel::setOverflowMessage(const QString& overflowMessage)
     m_overflowMessage = overflowMessage;
 }
 
+bool LogModel::setArchiveEnabled(bool enabled)
+{
+    if(enabled && !m_archive.open())
+    {
+        return false;
+    }
+    m_archiveEnabled = enabled;
+    return true;
+}
+
+bool LogModel::archiveEnabled() const
+{
+    return m_archiveEnabled && m_archive.isOpen();
+}
+
+int LogModel::archivedLines() const
+{
+    return m_archiveEnabled ? m_archive.lineCount() : 0;
+}
+
+QList<int> LogModel::findArchived(const QString& needle, Qt::CaseSensitivity cs)
+{
+    if(!m_archiveEnabled)
+    {
+        return QList<int>();
+    }
+    return m_archive.find(needle, cs);
+}
+
+QString LogModel::archivedLine(int lineNum)
+{
+    if(!m_archiveEnabled)
+    {
+        return QString();
+    }
+    return m_archive.line(lineNum);
+}
+
 void LogModel::setLineWrap(bool state)
 {
     if(m_lineWrap != state)
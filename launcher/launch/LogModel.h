@@ -3,7 +3,16 @@
 #include <QAbstractListModel>
 #include <QString>
 #include "MessageLevel.h"
+#include "LogArchive.h"
 
+class QIODevice;
+
+/**
+ * Model of the lines logged by a launched instance.
+ *
+ * Lines are kept UTF-8 encoded in a ring-shaped byte arena, with a small fixed size index entry per line.
+ * When enabled, lines pushed out of the ring are spilled into a LogArchive instead of being discarded.
+ */
 class LogModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -20,12 +29,25 @@ public:
     bool suspended();
 
     QString toPlainText();
+    /// Write the log, newline separated, to the given device. Archived lines come first unless left out.
+    bool writeTo(QIODevice & out, bool includeArchived = true);
 
     int getMaxLines();
     void setMaxLines(int maxLines);
     void setStopOnOverflow(bool stop);
     void setOverflowMessage(const QString & overflowMessage);
 
+    /**
+     * Keep lines that no longer fit in memory in a compressed temporary file.
+     * Nothing is ever evicted while logging stops on overflow, so the archive stays empty then.
+     */
+    bool setArchiveEnabled(bool enabled);
+    bool archiveEnabled() const;
+    int archivedLines() const;
+    /// Archived line numbers (counting from the oldest archived line) that contain the needle.
+    QList<int> findArchived(const QString & needle, Qt::CaseSensitivity cs = Qt::CaseInsensitive);
+    QString archivedLine(int lineNum);
+
     void setLineWrap(bool state);
     bool wrapLines() const;
 
@@ -37,17 +59,34 @@ public:
 private /* types */:
     struct entry
     {
+        quint32 offset;
+        quint32 size;
         MessageLevel::Enum level;
-        QString line;
     };
 
+private: /* methods */
+    QByteArray lineBytes(const entry & e) const;
+    void pushLine(MessageLevel::Enum level, const char * data, int size);
+    void dropOldest(int count);
+    int linesToEvict(int size) const;
+    void resetArena();
+
 private: /* data */
+    // index of the lines in the circular buffer
     QVector <entry> m_content;
     int m_maxLines = 1000;
     // first line in the circular buffer
     int m_firstLine = 0;
     // number of lines occupied in the circular buffer
     int m_numLines = 0;
+    // UTF-8 line data, grows up to m_arenaBudget and then wraps around
+    QByteArray m_arena;
+    int m_arenaBudget = 0;
+    int m_arenaUsed = 0;
+    int m_writePos = 0;
+    bool m_wrapped = false;
+    LogArchive m_archive;
+    bool m_archiveEnabled = false;
     bool m_stopOnOverflow = false;
     QString m_overflowMessage = "OVERFLOW";
     bool m_suspended = false;
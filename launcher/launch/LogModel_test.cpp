@@ -0,0 +1,134 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "launch/LogModel.h"
+
+class LogModelTest : public QObject
+{
+    Q_OBJECT
+private:
+    QString lineAt(LogModel & model, int row)
+    {
+        return model.data(model.index(row), Qt::DisplayRole).toString();
+    }
+
+private
+slots:
+    void test_RingWrap()
+    {
+        LogModel model;
+        model.setMaxLines(10);
+        for(int i = 0; i < 25; i++)
+        {
+            model.append(MessageLevel::Info, QString("line %1 éè").arg(i));
+        }
+        QCOMPARE(model.rowCount(), 10);
+        QCOMPARE(lineAt(model, 0), QString("line 15 éè"));
+        QCOMPARE(lineAt(model, 9), QString("line 24 éè"));
+        QCOMPARE(model.data(model.index(3), LogModel::LevelRole).toInt(), int(MessageLevel::Info));
+    }
+
+    void test_ArenaWrap()
+    {
+        // lines big enough to wrap the byte arena many times over
+        LogModel model;
+        model.setMaxLines(100);
+        QString big(100 * 1024, 'x');
+        for(int i = 0; i < 50; i++)
+        {
+            model.append(MessageLevel::Message, QString::number(i) + big);
+        }
+        QVERIFY(model.rowCount() < 50);
+        auto last = model.rowCount() - 1;
+        QCOMPARE(lineAt(model, last), QString::number(49) + big);
+        QCOMPARE(lineAt(model, last - 1), QString::number(48) + big);
+    }
+
+    void test_StopOnOverflow()
+    {
+        LogModel model;
+        model.setMaxLines(5);
+        model.setStopOnOverflow(true);
+        model.setOverflowMessage("STOP");
+        for(int i = 0; i < 10; i++)
+        {
+            model.append(MessageLevel::Info, QString::number(i));
+        }
+        QCOMPARE(model.rowCount(), 5);
+        QCOMPARE(lineAt(model, 0), QString("0"));
+        QCOMPARE(lineAt(model, 4), QString("STOP"));
+    }
+
+    void test_StopOnOverflowWithArchive()
+    {
+        LogModel model;
+        model.setMaxLines(5);
+        model.setStopOnOverflow(true);
+        model.setOverflowMessage("STOP");
+        QVERIFY(model.setArchiveEnabled(true));
+        for(int i = 0; i < 10; i++)
+        {
+            model.append(MessageLevel::Info, QString::number(i));
+        }
+        QCOMPARE(model.rowCount(), 5);
+        QCOMPARE(model.archivedLines(), 0);
+        QCOMPARE(lineAt(model, 4), QString("STOP"));
+    }
+
+    void test_Archive()
+    {
+        LogModel model;
+        model.setMaxLines(10);
+        QVERIFY(model.setArchiveEnabled(true));
+        QString expected;
+        for(int i = 0; i < 5000; i++)
+        {
+            auto line = QString("archived line %1").arg(i);
+            model.append(MessageLevel::Info, line);
+            expected += line + '\n';
+        }
+        QCOMPARE(model.rowCount(), 10);
+        QCOMPARE(model.archivedLines(), 4990);
+        QCOMPARE(model.toPlainText(), expected);
+        QCOMPARE(model.findArchived("line 1234"), QList<int>() << 1234);
+        QCOMPARE(model.findArchived("LINE 4000", Qt::CaseSensitive), QList<int>());
+        QCOMPARE(model.archivedLine(1234), QString("archived line 1234"));
+        QCOMPARE(model.archivedLine(4989), QString("archived line 4989"));
+        QVERIFY(model.archivedLine(4990).isNull());
+    }
+
+    void test_TruncateOversizedLine()
+    {
+        // the arena budget of a small model is 1 MiB, the cut lands in the middle of the two bytes of 'é'
+        LogModel model;
+        model.setMaxLines(10);
+        QString prefix(1024 * 1024 - 1, 'x');
+        model.append(MessageLevel::Info, prefix + QString("é and more"));
+        QCOMPARE(lineAt(model, 0), prefix);
+
+        // lines holding several lines of text are cut after the last one that fits
+        model.append(MessageLevel::Info, QString("first\n") + prefix + "yy");
+        QCOMPARE(lineAt(model, 0), QString("first"));
+    }
+
+    void test_ShrinkMaxLines()
+    {
+        LogModel model;
+        model.setMaxLines(10);
+        for(int i = 0; i < 15; i++)
+        {
+            model.append(MessageLevel::Info, QString::number(i));
+        }
+        model.setMaxLines(4);
+        QCOMPARE(model.rowCount(), 4);
+        QCOMPARE(lineAt(model, 0), QString("11"));
+        QCOMPARE(lineAt(model, 3), QString("14"));
+        model.append(MessageLevel::Info, "15");
+        QCOMPARE(lineAt(model, 0), QString("12"));
+        QCOMPARE(lineAt(model, 3), QString("15"));
+    }
+};
+
+QTEST_GUILESS_MAIN(LogModelTest)
+
+#include "LogModel_test.moc"
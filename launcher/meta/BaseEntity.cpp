@@ -19,6 +19,8 @@
 #include "net/HttpMetaCache.h"
 #include "net/NetJob.h"
 #include "Json.h"
+#include "JsonFormat.h"
+#include "Snapshot.h"
 
 #include "BuildConfig.h"
 #include "Application.h"
@@ -78,6 +80,28 @@ QUrl Meta::BaseEntity::url() const
     return QUrl(BuildConfig.META_URL).resolved(localFilename());
 }
 
+bool Meta::BaseEntity::hasSnapshot() const
+{
+    return false;
+}
+
+bool Meta::BaseEntity::writeSnapshot(QDataStream &) const
+{
+    return false;
+}
+
+void Meta::BaseEntity::readSnapshot(QDataStream &)
+{
+    throw ParseException(QObject::tr("%1 has no snapshot format").arg(localFilename()));
+}
+
+QString Meta::BaseEntity::snapshotFilename() const
+{
+    auto fname = localFilename();
+    fname.chop(QString(".json").size());
+    return QDir("cache/meta").absoluteFilePath(fname + ".bin");
+}
+
 bool Meta::BaseEntity::loadLocalFile()
 {
     const QString fname = QDir("meta").absoluteFilePath(localFilename());
@@ -85,12 +109,20 @@ bool Meta::BaseEntity::loadLocalFile()
     {
         return false;
     }
+    if (hasSnapshot() && loadSnapshot(snapshotFilename(), fname, this))
+    {
+        return true;
+    }
     // TODO: check if the file has the expected checksum
     try
     {
         auto doc = Json::requireDocument(fname, fname);
         auto obj = Json::requireObject(doc, fname);
         parse(obj);
+        if (hasSnapshot())
+        {
+            saveSnapshot(snapshotFilename(), fname, this);
+        }
         return true;
     }
     catch (const Exception &e)
@@ -134,6 +166,11 @@ void Meta::BaseEntity::load(Net::Mode loadType)
         m_loadStatus = LoadStatus::Remote;
         m_updateStatus = UpdateStatus::Succeeded;
         m_updateTask.reset();
+        // the file on disk now matches what was parsed
+        if(hasSnapshot())
+        {
+            saveSnapshot(snapshotFilename(), QDir("meta").absoluteFilePath(localFilename()), this);
+        }
     });
     QObject::connect(m_updateTask.get(), &NetJob::failed, [&]()
     {
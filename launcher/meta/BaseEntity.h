@@ -17,6 +17,8 @@
 
 #include <QJsonObject>
 #include <QObject>
+
+class QDataStream;
 #include "QObjectPtr.h"
 
 #include "net/Mode.h"
@@ -47,6 +49,11 @@ public:
 
     virtual void parse(const QJsonObject &obj) = 0;
 
+    /// Binary form of the parsed data, see Snapshot.h. Only used by entities that have one.
+    virtual bool hasSnapshot() const;
+    virtual bool writeSnapshot(QDataStream &out) const;
+    virtual void readSnapshot(QDataStream &in);
+
     virtual QString localFilename() const = 0;
     virtual QUrl url() const;
 
@@ -58,6 +65,7 @@ public:
 
 protected: /* methods */
     bool loadLocalFile();
+    QString snapshotFilename() const;
 
 private:
     LoadStatus m_loadStatus = LoadStatus::NotLoaded;
@@ -17,6 +17,7 @@
 
 #include "VersionList.h"
 #include "JsonFormat.h"
+#include "Snapshot.h"
 
 namespace Meta
 {
@@ -103,6 +104,17 @@ void Index::parse(const QJsonObject& obj)
     parseIndex(obj, this);
 }
 
+bool Index::writeSnapshot(QDataStream &out) const
+{
+    writeIndexSnapshot(out, this);
+    return true;
+}
+
+void Index::readSnapshot(QDataStream &in)
+{
+    readIndexSnapshot(in, this);
+}
+
 void Index::merge(const std::shared_ptr<Index> &other)
 {
     const QVector<VersionListPtr> lists = std::dynamic_pointer_cast<Index>(other)->m_lists;
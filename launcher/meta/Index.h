@@ -58,6 +58,12 @@ public:
 public: // for usage by parsers only
     void merge(const std::shared_ptr<Index> &other);
     void parse(const QJsonObject &obj) override;
+    bool hasSnapshot() const override
+    {
+        return true;
+    }
+    bool writeSnapshot(QDataStream &out) const override;
+    void readSnapshot(QDataStream &in) override;
 
 private:
     QVector<VersionListPtr> m_lists;
@@ -0,0 +1,241 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Snapshot.h"
+
+#include <climits>
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "FileSystem.h"
+#include "Index.h"
+#include "JsonFormat.h"
+#include "Version.h"
+#include "VersionList.h"
+
+namespace Meta
+{
+namespace
+{
+const quint32 snapshotMagic = 0x4d4d4353;
+// bump when the layout of the snapshots changes
+const quint32 snapshotVersion = 1;
+
+// true if the stream holds a snapshot header matching the source file
+bool readHeader(QDataStream &in, const QFileInfo &source)
+{
+    quint32 magic = 0, version = 0;
+    qint64 size = 0, modified = 0;
+    in >> magic >> version >> size >> modified;
+    return in.status() == QDataStream::Ok && magic == snapshotMagic && version == snapshotVersion && size == source.size()
+        && modified == source.lastModified().toMSecsSinceEpoch();
+}
+
+void checkStatus(QDataStream &in)
+{
+    if(in.status() != QDataStream::Ok)
+    {
+        throw ParseException(QObject::tr("Truncated metadata snapshot"));
+    }
+}
+
+// guards against allocating for counts the remaining data cannot hold
+quint32 readCount(QDataStream &in)
+{
+    quint32 count = 0;
+    in >> count;
+    checkStatus(in);
+    if(count > quint32(in.device()->bytesAvailable()))
+    {
+        throw ParseException(QObject::tr("Corrupt metadata snapshot"));
+    }
+    return count;
+}
+
+void writeRequires(QDataStream &out, const RequireSet &requires)
+{
+    out << quint32(requires.size());
+    for(auto &require: requires)
+    {
+        out << require.uid << require.equalsVersion << require.suggests;
+    }
+}
+
+RequireSet readRequires(QDataStream &in)
+{
+    RequireSet requires;
+    auto count = readCount(in);
+    for(quint32 i = 0; i < count; i++)
+    {
+        Require require;
+        in >> require.uid >> require.equalsVersion >> require.suggests;
+        requires.insert(require);
+    }
+    return requires;
+}
+}
+
+bool loadSnapshot(const QString &path, const QString &sourcePath, BaseEntity *entity)
+{
+    QFileInfo source(sourcePath);
+    QFile file(path);
+    if(!source.exists() || !file.open(QIODevice::ReadOnly) || file.size() == 0 || file.size() > INT_MAX)
+    {
+        return false;
+    }
+    auto mapped = file.map(0, file.size());
+    if(!mapped)
+    {
+        return false;
+    }
+    auto data = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), int(file.size()));
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_0);
+    bool loaded = false;
+    if(readHeader(in, source))
+    {
+        try
+        {
+            entity->readSnapshot(in);
+            loaded = true;
+        }
+        catch (const Exception &e)
+        {
+            qWarning() << "Unable to load metadata snapshot" << path << ":" << e.cause();
+        }
+    }
+    file.unmap(mapped);
+    return loaded;
+}
+
+bool saveSnapshot(const QString &path, const QString &sourcePath, const BaseEntity *entity)
+{
+    QFileInfo source(sourcePath);
+    if(!source.exists())
+    {
+        return false;
+    }
+    {
+        // nothing to do if the source did not change since the last snapshot
+        QFile existing(path);
+        if(existing.open(QIODevice::ReadOnly))
+        {
+            QDataStream in(&existing);
+            in.setVersion(QDataStream::Qt_5_0);
+            if(readHeader(in, source))
+            {
+                return true;
+            }
+        }
+    }
+    if(!FS::ensureFilePathExists(path))
+    {
+        return false;
+    }
+    QSaveFile file(path);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Unable to write metadata snapshot" << path << ":" << file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << snapshotMagic << snapshotVersion << qint64(source.size()) << qint64(source.lastModified().toMSecsSinceEpoch());
+    if(!entity->writeSnapshot(out) || out.status() != QDataStream::Ok)
+    {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+void writeIndexSnapshot(QDataStream &out, const Index *ptr)
+{
+    auto lists = ptr->lists();
+    out << quint32(lists.size());
+    for(auto &list: lists)
+    {
+        out << list->uid() << list->name();
+    }
+}
+
+void readIndexSnapshot(QDataStream &in, Index *ptr)
+{
+    auto count = readCount(in);
+    QVector<VersionListPtr> lists;
+    lists.reserve(count);
+    for(quint32 i = 0; i < count; i++)
+    {
+        QString uid, name;
+        in >> uid >> name;
+        auto list = std::make_shared<VersionList>(uid);
+        list->setName(name);
+        lists.append(list);
+    }
+    checkStatus(in);
+    ptr->merge(std::make_shared<Index>(lists));
+}
+
+void writeVersionListSnapshot(QDataStream &out, const VersionList *ptr)
+{
+    auto versions = ptr->versions();
+    out << ptr->uid() << ptr->name() << quint32(versions.size());
+    for(auto &version: versions)
+    {
+        out << version->version() << version->type() << qint64(version->rawTime()) << version->isRecommended()
+            << version->isVolatile();
+        writeRequires(out, version->requires());
+        writeRequires(out, version->conflicts());
+    }
+}
+
+void readVersionListSnapshot(QDataStream &in, VersionList *ptr)
+{
+    QString uid, name;
+    in >> uid >> name;
+    if(uid != ptr->uid())
+    {
+        throw ParseException(QObject::tr("Metadata snapshot of %1 holds %2").arg(ptr->uid(), uid));
+    }
+    auto count = readCount(in);
+    QVector<VersionPtr> versions;
+    versions.reserve(count);
+    for(quint32 i = 0; i < count; i++)
+    {
+        QString id, type;
+        qint64 time = 0;
+        bool recommended = false, volatile_ = false;
+        in >> id >> type >> time >> recommended >> volatile_;
+        auto version = std::make_shared<Version>(uid, id);
+        version->setType(type);
+        version->setTime(time);
+        version->setRecommended(recommended);
+        version->setVolatile(volatile_);
+        auto requires = readRequires(in);
+        version->setRequires(requires, readRequires(in));
+        version->setProvidesRecommendations();
+        versions.append(version);
+    }
+    checkStatus(in);
+    auto list = std::make_shared<VersionList>(uid);
+    list->setName(name);
+    list->setVersions(versions);
+    ptr->merge(list);
+}
+}
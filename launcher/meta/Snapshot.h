@@ -0,0 +1,48 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QString>
+
+class QDataStream;
+
+namespace Meta
+{
+class BaseEntity;
+class Index;
+class VersionList;
+
+/*
+ * Binary snapshots of parsed metadata.
+ *
+ * Parsing the index and the big version lists from JSON is a noticeable part of opening the version selector, so the
+ * parsed form is kept in a compact binary file next to it. A snapshot records the size and modification time of the
+ * JSON file it was made from and is ignored once that file changes.
+ */
+
+/// Load the snapshot at path into the entity, if it was made from sourcePath as it is now.
+bool loadSnapshot(const QString &path, const QString &sourcePath, BaseEntity *entity);
+
+/// Write a snapshot of the entity, made from sourcePath, to path.
+bool saveSnapshot(const QString &path, const QString &sourcePath, const BaseEntity *entity);
+
+void writeIndexSnapshot(QDataStream &out, const Index *ptr);
+void writeVersionListSnapshot(QDataStream &out, const VersionList *ptr);
+
+// these throw ParseException on corrupt data
+void readIndexSnapshot(QDataStream &in, Index *ptr);
+void readVersionListSnapshot(QDataStream &in, VersionList *ptr);
+}
@@ -0,0 +1,125 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "meta/Index.h"
+#include "meta/Snapshot.h"
+#include "meta/Version.h"
+#include "meta/VersionList.h"
+
+namespace {
+Meta::VersionPtr makeVersion(const QString &version, const QString &type, qint64 time, bool recommended)
+{
+    auto out = std::make_shared<Meta::Version>("net.minecraftforge", version);
+    out->setType(type);
+    out->setTime(time);
+    out->setRecommended(recommended);
+    out->setRequires({{"net.minecraft", "1.12.2", QString()}}, {{"org.lwjgl3", QString(), QString()}});
+    out->setProvidesRecommendations();
+    return out;
+}
+
+std::shared_ptr<Meta::VersionList> makeList()
+{
+    auto list = std::make_shared<Meta::VersionList>("net.minecraftforge");
+    list->setName("Forge");
+    list->setVersions({makeVersion("14.23.5.2854", "release", 1600000000, true), makeVersion("14.23.5.2855", "snapshot", 1600000100, false)});
+    return list;
+}
+}
+
+class SnapshotTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_VersionListRoundTrip()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto source = FS::PathCombine(temp.path(), "meta", "index.json");
+        auto snapshot = FS::PathCombine(temp.path(), "cache", "index.bin");
+        FS::write(source, "{}");
+
+        QVERIFY(Meta::saveSnapshot(snapshot, source, makeList().get()));
+        Meta::VersionList loaded("net.minecraftforge");
+        QVERIFY(Meta::loadSnapshot(snapshot, source, &loaded));
+        QCOMPARE(loaded.name(), QString("Forge"));
+        QCOMPARE(loaded.count(), 2);
+        auto newest = loaded.versions().first();
+        QCOMPARE(newest->version(), QString("14.23.5.2855"));
+        QCOMPARE(newest->type(), QString("snapshot"));
+        QCOMPARE(newest->rawTime(), qint64(1600000100));
+        auto recommended = loaded.versions().last();
+        QVERIFY(recommended->isRecommended());
+        QCOMPARE(recommended->requires().size(), size_t(1));
+        QCOMPARE(recommended->requires().begin()->equalsVersion, QString("1.12.2"));
+        QCOMPARE(recommended->conflicts().begin()->uid, QString("org.lwjgl3"));
+
+        // snapshots of another list are not used
+        Meta::VersionList other("net.fabricmc.fabric-loader");
+        QVERIFY(!Meta::loadSnapshot(snapshot, source, &other));
+        QCOMPARE(other.count(), 0);
+    }
+
+    void test_IndexRoundTrip()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto source = FS::PathCombine(temp.path(), "index.json");
+        auto snapshot = FS::PathCombine(temp.path(), "index.bin");
+        FS::write(source, "{}");
+
+        auto list = std::make_shared<Meta::VersionList>("net.minecraft");
+        list->setName("Minecraft");
+        Meta::Index index({list, std::make_shared<Meta::VersionList>("net.minecraftforge")});
+        QVERIFY(Meta::saveSnapshot(snapshot, source, &index));
+
+        Meta::Index loaded;
+        QVERIFY(Meta::loadSnapshot(snapshot, source, &loaded));
+        QCOMPARE(loaded.lists().size(), 2);
+        QVERIFY(loaded.hasUid("net.minecraftforge"));
+        QCOMPARE(loaded.get("net.minecraft")->name(), QString("Minecraft"));
+    }
+
+    void test_Stale()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto source = FS::PathCombine(temp.path(), "index.json");
+        auto snapshot = FS::PathCombine(temp.path(), "index.bin");
+        FS::write(source, "{}");
+        QVERIFY(Meta::saveSnapshot(snapshot, source, makeList().get()));
+
+        // the source changed, so the snapshot is outdated
+        FS::write(source, "{\"uid\": \"net.minecraftforge\"}");
+        Meta::VersionList loaded("net.minecraftforge");
+        QVERIFY(!Meta::loadSnapshot(snapshot, source, &loaded));
+
+        // and gets replaced
+        QVERIFY(Meta::saveSnapshot(snapshot, source, makeList().get()));
+        QVERIFY(Meta::loadSnapshot(snapshot, source, &loaded));
+        QCOMPARE(loaded.count(), 2);
+    }
+
+    void test_Truncated()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto source = FS::PathCombine(temp.path(), "index.json");
+        auto snapshot = FS::PathCombine(temp.path(), "index.bin");
+        FS::write(source, "{}");
+        QVERIFY(Meta::saveSnapshot(snapshot, source, makeList().get()));
+
+        auto data = FS::read(snapshot);
+        FS::write(snapshot, data.left(data.size() - 10));
+        Meta::VersionList loaded("net.minecraftforge");
+        QVERIFY(!Meta::loadSnapshot(snapshot, source, &loaded));
+        QCOMPARE(loaded.count(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(SnapshotTest)
+
+#include "Snapshot_test.moc"
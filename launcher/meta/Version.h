@@ -65,6 +65,14 @@ public: /* con/des */
     {
         return m_requires;
     }
+    const Meta::RequireSet &conflicts() const
+    {
+        return m_conflicts;
+    }
+    bool isVolatile() const
+    {
+        return m_volatile;
+    }
     VersionFilePtr data() const
     {
         return m_data;
@@ -19,6 +19,7 @@
 
 #include "Version.h"
 #include "JsonFormat.h"
+#include "Snapshot.h"
 #include "Version.h"
 
 namespace Meta
@@ -171,6 +172,17 @@ void VersionList::parse(const QJsonObject& obj)
     parseVersionList(obj, this);
 }
 
+bool VersionList::writeSnapshot(QDataStream &out) const
+{
+    writeVersionListSnapshot(out, this);
+    return true;
+}
+
+void VersionList::readSnapshot(QDataStream &in)
+{
+    readVersionListSnapshot(in, this);
+}
+
 // FIXME: this is dumb, we have 'recommended' as part of the metadata already...
 static const Meta::VersionPtr &getBetterVersion(const Meta::VersionPtr &a, const Meta::VersionPtr &b)
 {
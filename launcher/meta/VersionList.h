@@ -78,6 +78,12 @@ public: // for usage only by parsers
     void merge(const VersionListPtr &other);
     void mergeFromIndex(const VersionListPtr &other);
     void parse(const QJsonObject &obj) override;
+    bool hasSnapshot() const override
+    {
+        return true;
+    }
+    bool writeSnapshot(QDataStream &out) const override;
+    void readSnapshot(QDataStream &in) override;
 
 signals:
     void nameChanged(const QString &name);
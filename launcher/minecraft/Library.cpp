@@ -2,7 +2,6 @@
 #include "MinecraftInstance.h"
 
 #include <net/Download.h>
-#include <net/ChecksumValidator.h>
 #include <FileSystem.h>
 #include <BuildConfig.h>
 
@@ -103,8 +102,7 @@ QList<NetAction::Ptr> Library::getDownloads(
         if(sha1.size())
         {
             auto rawSha1 = QByteArray::fromHex(sha1.toLatin1());
-            auto dl = Net::Download::makeCached(url, entry, options);
-            dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawSha1));
+            auto dl = Net::Download::makeCached(url, entry, rawSha1, options);
             qDebug() << "Checksummed Download for:" << rawName().serialize() << "storage:" << storage << "url:" << url;
             out.append(dl);
         }
@@ -28,6 +28,8 @@
 #include "minecraft/launch/ReconstructAssets.h"
 #include "minecraft/launch/ScanModFolders.h"
 #include "minecraft/launch/VerifyJavaInstall.h"
+#include "minecraft/launch/BackupWorlds.h"
+#include "minecraft/launch/PrefetchGameFiles.h"
 
 #if defined(BGL_SYSTEM_LWJGL2_PATH) || defined(BGL_SYSTEM_LWJGL3_PATH)
 #include "minecraft/launch/PatchLibraries.h"
@@ -128,6 +130,10 @@ MinecraftInstance::MinecraftInstance(SettingsObjectPtr globalSettings, SettingsO
     m_settings->registerSetting("JoinServerOnLaunch", false);
     m_settings->registerSetting("JoinServerOnLaunchAddress", "");
 
+    // Automatic world backups after the game exits, also instance-only
+    m_settings->registerSetting("AutoBackupWorlds", false);
+    m_settings->registerSetting("WorldBackupsToKeep", 10);
+
     // DEPRECATED: Read what versions the user configuration thinks should be used
     m_settings->registerSetting({"IntendedVersion", "MinecraftVersion"}, "");
     m_settings->registerSetting("LWJGLVersion", "");
@@ -216,6 +222,11 @@ QString MinecraftInstance::modsCacheLocation() const
     return FS::PathCombine(instanceRoot(), "mods.cache");
 }
 
+QString MinecraftInstance::launchManifestLocation() const
+{
+    return FS::PathCombine(instanceRoot(), "launch-manifest.json");
+}
+
 QString MinecraftInstance::coreModsDir() const
 {
     return FS::PathCombine(gameRoot(), "coremods");
@@ -251,6 +262,11 @@ QString MinecraftInstance::worldDir() const
     return FS::PathCombine(gameRoot(), "saves");
 }
 
+QString MinecraftInstance::worldBackupsDir() const
+{
+    return FS::PathCombine(instanceRoot(), "world-backups");
+}
+
 QString MinecraftInstance::resourcesDir() const
 {
     return FS::PathCombine(gameRoot(), "resources");
@@ -831,6 +847,12 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPt
         process->appendStep(new TextPrint(pptr, "Minecraft folder is:\n" + gameRoot() + "\n\n", MessageLevel::Launcher));
     }
 
+    // start warming the page cache while the rest of the launch is prepared
+    if(APPLICATION->settings()->get("PrefetchGameFiles").toBool())
+    {
+        process->appendStep(new PrefetchGameFiles(pptr));
+    }
+
     // check java
     {
         process->appendStep(new CheckJava(pptr));
@@ -946,6 +968,12 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPt
         }
     }
 
+    // snapshot the worlds the game may have changed
+    if(m_settings->get("AutoBackupWorlds").toBool())
+    {
+        process->appendStep(new BackupWorlds(pptr));
+    }
+
     // run post-exit command if that's needed
     if(getPostExitCommand().size())
     {
@@ -43,8 +43,10 @@ public:
     QString loaderModsDir() const;
     QString coreModsDir() const;
     QString modsCacheLocation() const;
+    QString launchManifestLocation() const;
     QString libDir() const;
     QString worldDir() const;
+    QString worldBackupsDir() const;
     QString resourcesDir() const;
     QDir jarmodsPath() const;
     QDir librariesPath() const;
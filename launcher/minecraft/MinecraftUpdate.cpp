@@ -27,13 +27,15 @@
 #include <FileSystem.h>
 
 #include "update/FoldersTask.h"
-#include "update/LibrariesTask.h"
+#include "update/DownloadPlanTask.h"
 #include "update/FMLLibrariesTask.h"
-#include "update/AssetUpdateTask.h"
+#include "update/LaunchManifestTask.h"
 
 #include <meta/Index.h>
 #include <meta/Version.h>
 
+#include "Application.h"
+
 MinecraftUpdate::MinecraftUpdate(MinecraftInstance *inst, QObject *parent) : Task(parent), m_inst(inst)
 {
 }
@@ -41,6 +43,27 @@ MinecraftUpdate::MinecraftUpdate(MinecraftInstance *inst, QObject *parent) : Tas
 void MinecraftUpdate::executeTask()
 {
     m_tasks.clear();
+    m_currentTask = -1;
+    m_warmLaunch = APPLICATION->settings()->get("WarmLaunch").toBool() && QFile::exists(m_inst->launchManifestLocation());
+    if(m_warmLaunch)
+    {
+        queueWarmLaunch();
+    }
+    else
+    {
+        queueUpdate();
+    }
+
+    if(!m_preFailure.isEmpty())
+    {
+        emitFailed(m_preFailure);
+        return;
+    }
+    next();
+}
+
+void MinecraftUpdate::queueUpdate()
+{
     // create folders
     {
         m_tasks.append(std::make_shared<FoldersTask>(m_inst));
@@ -57,27 +80,45 @@ void MinecraftUpdate::executeTask()
         }
     }
 
-    // libraries download
+    // libraries, FML libraries and assets, all in one go
     {
-        m_tasks.append(std::make_shared<LibrariesTask>(m_inst));
+        m_tasks.append(std::make_shared<DownloadPlanTask>(m_inst));
     }
 
-    // FML libraries download and copy into the instance
+    // remember what everything looked like, so the next launches can skip all of the above
+    if(APPLICATION->settings()->get("WarmLaunch").toBool())
     {
-        m_tasks.append(std::make_shared<FMLLibrariesTask>(m_inst));
+        m_tasks.append(std::make_shared<LaunchManifestTask>(m_inst, LaunchManifestTask::Mode::Record));
+    }
+}
+
+void MinecraftUpdate::queueWarmLaunch()
+{
+    // create folders
+    {
+        m_tasks.append(std::make_shared<FoldersTask>(m_inst));
     }
 
-    // assets update
+    // resolve the profile from the local metadata only
     {
-        m_tasks.append(std::make_shared<AssetUpdateTask>(m_inst));
+        auto components = m_inst->getPackProfile();
+        components->reload(Net::Mode::Offline);
+        auto task = components->getCurrentTask();
+        if(task)
+        {
+            m_tasks.append(task.unwrap());
+        }
     }
 
-    if(!m_preFailure.isEmpty())
+    // check the files against what the last update left behind
     {
-        emitFailed(m_preFailure);
-        return;
+        m_tasks.append(std::make_shared<LaunchManifestTask>(m_inst, LaunchManifestTask::Mode::Verify));
+    }
+
+    // this only goes to the network if the files are missing from the instance
+    {
+        m_tasks.append(std::make_shared<FMLLibrariesTask>(m_inst));
     }
-    next();
 }
 
 void MinecraftUpdate::next()
@@ -157,6 +198,20 @@ void MinecraftUpdate::subtaskFailed(QString error)
         m_fail_reason = error;
         return;
     }
+    if(m_warmLaunch && !m_abort)
+    {
+        qDebug() << "MinecraftUpdate: Cannot skip the update:" << error;
+        disconnect(currentTask, &Task::succeeded, this, &MinecraftUpdate::subtaskSucceeded);
+        disconnect(currentTask, &Task::failed, this, &MinecraftUpdate::subtaskFailed);
+        disconnect(currentTask, &Task::progress, this, &MinecraftUpdate::progress);
+        disconnect(currentTask, &Task::status, this, &MinecraftUpdate::setStatus);
+        m_warmLaunch = false;
+        m_tasks.clear();
+        m_currentTask = -1;
+        queueUpdate();
+        next();
+        return;
+    }
     emitFailed(error);
 }
 
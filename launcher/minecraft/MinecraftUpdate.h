@@ -44,6 +44,8 @@ slots:
     void subtaskFailed(QString error);
 
 private:
+    void queueUpdate();
+    void queueWarmLaunch();
     void next();
 
 private:
@@ -52,6 +54,7 @@ private:
     QString m_preFailure;
     int m_currentTask = -1;
     bool m_abort = false;
+    bool m_warmLaunch = false;
     bool m_failed_out_of_order = false;
     QString m_fail_reason;
 };
@@ -0,0 +1,503 @@
+/* Copyright 2015-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NbtScanner.h"
+
+#include <QIODevice>
+#include <QtEndian>
+#include <zlib.h>
+#include <cstring>
+
+namespace {
+const int chunkSize = 64 * 1024;
+// same limit as the one Minecraft itself enforces
+const int maxDepth = 512;
+
+int fixedPayloadSize(NbtScanner::TagType type)
+{
+    switch(type)
+    {
+        case NbtScanner::End:
+            return 0;
+        case NbtScanner::Byte:
+            return 1;
+        case NbtScanner::Short:
+            return 2;
+        case NbtScanner::Int:
+        case NbtScanner::Float:
+            return 4;
+        case NbtScanner::Long:
+        case NbtScanner::Double:
+            return 8;
+        default:
+            return -1;
+    }
+}
+}
+
+/**
+ * Inflates the input device chunk by chunk, so only a small window of the decompressed data exists at any time.
+ */
+class NbtScanner::Input
+{
+public:
+    explicit Input(QIODevice & device) : m_device(device)
+    {
+        memset(&m_stream, 0, sizeof(m_stream));
+        m_in.resize(chunkSize);
+        m_out.resize(chunkSize);
+    }
+    ~Input()
+    {
+        if(m_initialized)
+        {
+            inflateEnd(&m_stream);
+        }
+    }
+
+    bool init()
+    {
+        // 16 + MAX_WBITS: expect a gzip header, like GZip::unzip does
+        m_initialized = inflateInit2(&m_stream, 16 + MAX_WBITS) == Z_OK;
+        return m_initialized;
+    }
+
+    bool read(char * out, qint64 size)
+    {
+        while(size > 0)
+        {
+            if(m_pos == m_avail && !fill())
+            {
+                return false;
+            }
+            int n = qMin<qint64>(size, m_avail - m_pos);
+            memcpy(out, m_out.constData() + m_pos, n);
+            m_pos += n;
+            out += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    bool skip(qint64 size)
+    {
+        while(size > 0)
+        {
+            if(m_pos == m_avail && !fill())
+            {
+                return false;
+            }
+            int n = qMin<qint64>(size, m_avail - m_pos);
+            m_pos += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool readBE(T & value)
+    {
+        uchar buf[sizeof(T)];
+        if(!read(reinterpret_cast<char *>(buf), sizeof(T)))
+        {
+            return false;
+        }
+        value = qFromBigEndian<T>(buf);
+        return true;
+    }
+
+private:
+    bool fill()
+    {
+        m_pos = 0;
+        m_avail = 0;
+        while(!m_finished)
+        {
+            if(m_stream.avail_in == 0)
+            {
+                auto got = m_device.read(m_in.data(), m_in.size());
+                if(got <= 0)
+                {
+                    // truncated or unreadable input
+                    return false;
+                }
+                m_stream.next_in = reinterpret_cast<Bytef *>(m_in.data());
+                m_stream.avail_in = got;
+            }
+            m_stream.next_out = reinterpret_cast<Bytef *>(m_out.data());
+            m_stream.avail_out = m_out.size();
+            auto err = inflate(&m_stream, Z_NO_FLUSH);
+            if(err == Z_STREAM_END)
+            {
+                m_finished = true;
+            }
+            else if(err != Z_OK && err != Z_BUF_ERROR)
+            {
+                return false;
+            }
+            m_avail = m_out.size() - m_stream.avail_out;
+            if(m_avail > 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    QIODevice & m_device;
+    z_stream m_stream;
+    bool m_initialized = false;
+    bool m_finished = false;
+    QByteArray m_in;
+    QByteArray m_out;
+    int m_pos = 0;
+    int m_avail = 0;
+};
+
+NbtScanner::NbtScanner(const QStringList& paths)
+{
+    for(auto & entry: paths)
+    {
+        auto alternatives = entry.split('|', QString::SkipEmptyParts);
+        m_entries.append(alternatives);
+        m_paths.append(alternatives);
+    }
+    m_paths.removeDuplicates();
+}
+
+bool NbtScanner::foundAll() const
+{
+    for(auto & alternatives: m_entries)
+    {
+        bool found = false;
+        for(auto & path: alternatives)
+        {
+            if(m_values.contains(path))
+            {
+                found = true;
+                break;
+            }
+        }
+        if(!found)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NbtScanner::fail(const QString& error)
+{
+    m_error = error;
+    return false;
+}
+
+bool NbtScanner::wantsPrefix(const QString& path) const
+{
+    for(auto & wanted: m_paths)
+    {
+        if(wanted.size() > path.size() && wanted.startsWith(path) && wanted[path.size()] == '/')
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NbtScanner::scan(QIODevice& device)
+{
+    m_values.clear();
+    m_error.clear();
+
+    Input in(device);
+    if(!in.init())
+    {
+        return fail("Could not initialize zlib");
+    }
+    quint8 type;
+    quint16 nameLength;
+    if(!in.readBE(type) || !in.readBE(nameLength) || !in.skip(nameLength))
+    {
+        return fail("NBT data is truncated or not gzip compressed");
+    }
+    if(type != Compound)
+    {
+        return fail("The root NBT tag is not a compound");
+    }
+    return readCompound(in, QString(), 0);
+}
+
+bool NbtScanner::readCompound(NbtScanner::Input& in, const QString& prefix, int depth)
+{
+    if(depth > maxDepth)
+    {
+        return fail("NBT data is nested too deeply");
+    }
+    while(!foundAll())
+    {
+        quint8 type;
+        quint16 nameLength;
+        if(!in.readBE(type))
+        {
+            return fail("NBT data is truncated");
+        }
+        if(type == End)
+        {
+            return true;
+        }
+        if(type > LongArray)
+        {
+            return fail(QString("Unknown NBT tag type %1").arg(int(type)));
+        }
+        QByteArray name;
+        if(!in.readBE(nameLength))
+        {
+            return fail("NBT data is truncated");
+        }
+        name.resize(nameLength);
+        if(!in.read(name.data(), nameLength))
+        {
+            return fail("NBT data is truncated");
+        }
+        auto path = prefix.isEmpty() ? QString::fromUtf8(name) : prefix + '/' + QString::fromUtf8(name);
+        if(type == Compound && wantsPrefix(path))
+        {
+            if(m_paths.contains(path))
+            {
+                m_values.insert(path, Value{Compound, QVariant()});
+            }
+            if(!readCompound(in, path, depth + 1))
+            {
+                return false;
+            }
+        }
+        else if(m_paths.contains(path))
+        {
+            if(!readValue(in, TagType(type), path))
+            {
+                return false;
+            }
+        }
+        else if(!skipPayload(in, TagType(type), depth + 1))
+        {
+            return false;
+        }
+    }
+    // everything we wanted has been found, the rest of the data does not need to be read
+    return true;
+}
+
+bool NbtScanner::readValue(NbtScanner::Input& in, NbtScanner::TagType type, const QString& path)
+{
+    Value value;
+    value.type = type;
+    bool ok = true;
+    switch(type)
+    {
+        case Byte:
+        {
+            qint8 v;
+            ok = in.readBE(v);
+            value.value = qlonglong(v);
+            break;
+        }
+        case Short:
+        {
+            qint16 v;
+            ok = in.readBE(v);
+            value.value = qlonglong(v);
+            break;
+        }
+        case Int:
+        {
+            qint32 v;
+            ok = in.readBE(v);
+            value.value = qlonglong(v);
+            break;
+        }
+        case Long:
+        {
+            qint64 v;
+            ok = in.readBE(v);
+            value.value = qlonglong(v);
+            break;
+        }
+        case Float:
+        {
+            quint32 bits;
+            float v;
+            ok = in.readBE(bits);
+            memcpy(&v, &bits, sizeof(v));
+            value.value = v;
+            break;
+        }
+        case Double:
+        {
+            quint64 bits;
+            double v;
+            ok = in.readBE(bits);
+            memcpy(&v, &bits, sizeof(v));
+            value.value = v;
+            break;
+        }
+        case String:
+        {
+            quint16 length;
+            QByteArray bytes;
+            ok = in.readBE(length);
+            if(ok)
+            {
+                bytes.resize(length);
+                ok = in.read(bytes.data(), length);
+            }
+            value.value = QString::fromUtf8(bytes);
+            break;
+        }
+        default:
+        {
+            // only scalar values are extracted, containers are just noted as present
+            ok = skipPayload(in, type, 0);
+            break;
+        }
+    }
+    if(!ok)
+    {
+        return m_error.isEmpty() ? fail("NBT data is truncated") : false;
+    }
+    m_values.insert(path, value);
+    return true;
+}
+
+bool NbtScanner::skipPayload(NbtScanner::Input& in, NbtScanner::TagType type, int depth)
+{
+    if(depth > maxDepth)
+    {
+        return fail("NBT data is nested too deeply");
+    }
+    auto fixed = fixedPayloadSize(type);
+    if(fixed >= 0)
+    {
+        return in.skip(fixed) || fail("NBT data is truncated");
+    }
+    switch(type)
+    {
+        case ByteArray:
+        case IntArray:
+        case LongArray:
+        {
+            qint32 length;
+            if(!in.readBE(length) || length < 0)
+            {
+                return fail("Invalid NBT array length");
+            }
+            qint64 elementSize = type == ByteArray ? 1 : (type == IntArray ? 4 : 8);
+            return in.skip(elementSize * length) || fail("NBT data is truncated");
+        }
+        case String:
+        {
+            quint16 length;
+            return (in.readBE(length) && in.skip(length)) || fail("NBT data is truncated");
+        }
+        case List:
+        {
+            quint8 elementType;
+            qint32 count;
+            if(!in.readBE(elementType) || !in.readBE(count) || count < 0 || elementType > LongArray)
+            {
+                return fail("Invalid NBT list header");
+            }
+            auto elementSize = fixedPayloadSize(TagType(elementType));
+            if(elementSize >= 0)
+            {
+                return in.skip(qint64(elementSize) * count) || fail("NBT data is truncated");
+            }
+            for(qint32 i = 0; i < count; i++)
+            {
+                if(!skipPayload(in, TagType(elementType), depth + 1))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case Compound:
+        {
+            while(true)
+            {
+                quint8 childType;
+                quint16 nameLength;
+                if(!in.readBE(childType))
+                {
+                    return fail("NBT data is truncated");
+                }
+                if(childType == End)
+                {
+                    return true;
+                }
+                if(childType > LongArray)
+                {
+                    return fail(QString("Unknown NBT tag type %1").arg(int(childType)));
+                }
+                if(!in.readBE(nameLength) || !in.skip(nameLength))
+                {
+                    return fail("NBT data is truncated");
+                }
+                if(!skipPayload(in, TagType(childType), depth + 1))
+                {
+                    return false;
+                }
+            }
+        }
+        default:
+            return fail(QString("Unknown NBT tag type %1").arg(int(type)));
+    }
+}
+
+bool NbtScanner::isCompound(const QString& path) const
+{
+    auto iter = m_values.find(path);
+    return iter != m_values.end() && iter->type == Compound;
+}
+
+nonstd::optional<QString> NbtScanner::getString(const QString& path) const
+{
+    auto iter = m_values.find(path);
+    if(iter == m_values.end() || iter->type != String)
+    {
+        return nonstd::nullopt;
+    }
+    return iter->value.toString();
+}
+
+nonstd::optional<int64_t> NbtScanner::getLong(const QString& path) const
+{
+    auto iter = m_values.find(path);
+    if(iter == m_values.end() || iter->type != Long)
+    {
+        return nonstd::nullopt;
+    }
+    return int64_t(iter->value.toLongLong());
+}
+
+nonstd::optional<int> NbtScanner::getInt(const QString& path) const
+{
+    auto iter = m_values.find(path);
+    if(iter == m_values.end() || iter->type != Int)
+    {
+        return nonstd::nullopt;
+    }
+    return iter->value.toInt();
+}
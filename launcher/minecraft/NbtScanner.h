@@ -0,0 +1,101 @@
+/* Copyright 2015-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <nonstd/optional>
+
+class QIODevice;
+
+/**
+ * Streaming reader that pulls a few values out of a gzip compressed NBT file without building the whole tree.
+ *
+ * Paths are '/' separated names of nested compound tags, relative to the root compound, e.g. "Data/LevelName".
+ * Compounds can be requested too, to check that they exist. An entry can also list alternatives separated by '|',
+ * for values that moved between format versions, e.g. "Data/WorldGenSettings/seed|Data/RandomSeed".
+ * Input is inflated incrementally, subtrees that cannot contain any of the requested paths are skipped,
+ * and reading stops as soon as one path of every requested entry has been seen.
+ */
+class NbtScanner
+{
+public:
+    enum TagType
+    {
+        End = 0,
+        Byte,
+        Short,
+        Int,
+        Long,
+        Float,
+        Double,
+        ByteArray,
+        String,
+        List,
+        Compound,
+        IntArray,
+        LongArray
+    };
+
+    explicit NbtScanner(const QStringList & paths);
+
+    /// Scan gzip compressed NBT data from the device. Returns false if the data is not valid NBT.
+    bool scan(QIODevice & device);
+
+    QString errorString() const
+    {
+        return m_error;
+    }
+
+    bool contains(const QString & path) const
+    {
+        return m_values.contains(path);
+    }
+
+    bool isCompound(const QString & path) const;
+
+    /// The value is only returned if the tag had exactly the requested type, like nbt::value::as would
+    nonstd::optional<QString> getString(const QString & path) const;
+    nonstd::optional<int64_t> getLong(const QString & path) const;
+    nonstd::optional<int> getInt(const QString & path) const;
+
+private: /* types */
+    struct Value
+    {
+        TagType type;
+        QVariant value;
+    };
+    class Input;
+
+private: /* methods */
+    bool readCompound(Input & in, const QString & prefix, int depth);
+    bool readValue(Input & in, TagType type, const QString & path);
+    bool skipPayload(Input & in, TagType type, int depth);
+    bool wantsPrefix(const QString & path) const;
+    bool foundAll() const;
+    bool fail(const QString & error);
+
+private: /* data */
+    // every path that is looked for
+    QStringList m_paths;
+    // the requested entries, each satisfied by any one of its paths
+    QList<QStringList> m_entries;
+    QHash<QString, Value> m_values;
+    QString m_error;
+};
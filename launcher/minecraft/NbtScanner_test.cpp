@@ -0,0 +1,175 @@
+#include <QTest>
+#include <QBuffer>
+#include <QDataStream>
+#include "TestUtil.h"
+
+#include "GZip.h"
+#include "minecraft/NbtScanner.h"
+
+namespace {
+// QDataStream is big endian by default, just like NBT
+class NbtWriter
+{
+public:
+    NbtWriter() : m_stream(&m_data, QIODevice::WriteOnly) {}
+
+    void name(quint8 type, const QByteArray & name)
+    {
+        m_stream << type;
+        string(name);
+    }
+    void string(const QByteArray & value)
+    {
+        m_stream << quint16(value.size());
+        m_stream.writeRawData(value.constData(), value.size());
+    }
+    void end()
+    {
+        m_stream << quint8(NbtScanner::End);
+    }
+    QDataStream & stream()
+    {
+        return m_stream;
+    }
+    QByteArray compressed()
+    {
+        QByteArray out;
+        GZip::zip(m_data, out);
+        return out;
+    }
+
+private:
+    QByteArray m_data;
+    QDataStream m_stream;
+};
+
+QByteArray levelDat(bool byteGameType)
+{
+    NbtWriter w;
+    w.name(NbtScanner::Compound, "");
+    w.name(NbtScanner::Compound, "Data");
+
+    // a bulky subtree in front of the interesting values, which should be skipped
+    w.name(NbtScanner::Compound, "FML");
+    w.name(NbtScanner::List, "Registries");
+    w.stream() << quint8(NbtScanner::Compound) << qint32(2000);
+    for(int i = 0; i < 2000; i++)
+    {
+        w.name(NbtScanner::String, "K");
+        w.string(QByteArray("minecraft:thing_") + QByteArray::number(i));
+        w.name(NbtScanner::IntArray, "ids");
+        w.stream() << qint32(3) << qint32(i) << qint32(i + 1) << qint32(i + 2);
+        w.name(NbtScanner::Double, "weight");
+        w.stream() << double(i);
+        w.end();
+    }
+    w.name(NbtScanner::LongArray, "LevelName");
+    w.stream() << qint32(1) << qint64(1);
+    w.end();
+
+    w.name(NbtScanner::String, "LevelName");
+    w.string("Test World \xc3\xa9");
+    w.name(NbtScanner::Long, "LastPlayed");
+    w.stream() << qint64(1600000000000LL);
+    if(byteGameType)
+    {
+        w.name(NbtScanner::Byte, "GameType");
+        w.stream() << qint8(1);
+    }
+    else
+    {
+        w.name(NbtScanner::Int, "GameType");
+        w.stream() << qint32(1);
+    }
+    w.name(NbtScanner::Compound, "WorldGenSettings");
+    w.name(NbtScanner::Compound, "dimensions");
+    w.name(NbtScanner::ByteArray, "junk");
+    w.stream() << qint32(4) << qint32(0);
+    w.end();
+    w.name(NbtScanner::Long, "seed");
+    w.stream() << qint64(-1234567890123LL);
+    w.end();
+
+    w.end();
+    w.end();
+    return w.compressed();
+}
+}
+
+class NbtScannerTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_Scan()
+    {
+        auto data = levelDat(false);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        NbtScanner scanner({"Data", "Data/LevelName", "Data/LastPlayed", "Data/GameType", "Data/WorldGenSettings/seed", "Data/Missing"});
+        QVERIFY(scanner.scan(buffer));
+        QVERIFY(scanner.isCompound("Data"));
+        QCOMPARE(*scanner.getString("Data/LevelName"), QString::fromUtf8("Test World \xc3\xa9"));
+        QCOMPARE(*scanner.getLong("Data/LastPlayed"), int64_t(1600000000000LL));
+        QCOMPARE(*scanner.getInt("Data/GameType"), 1);
+        QCOMPARE(*scanner.getLong("Data/WorldGenSettings/seed"), int64_t(-1234567890123LL));
+        QVERIFY(!scanner.contains("Data/Missing"));
+        QVERIFY(!scanner.getString("Data/LastPlayed"));
+    }
+
+    void test_StopsEarly()
+    {
+        auto data = levelDat(false);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        NbtScanner scanner({"Data/LevelName"});
+        QVERIFY(scanner.scan(buffer));
+        QCOMPARE(*scanner.getString("Data/LevelName"), QString::fromUtf8("Test World \xc3\xa9"));
+        QVERIFY(!scanner.contains("Data/LastPlayed"));
+    }
+
+    void test_Alternatives()
+    {
+        auto data = levelDat(false);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        // the old location does not exist, finding the new one is enough
+        NbtScanner scanner({"Data/WorldGenSettings/seed|Data/RandomSeed", "Data/LevelName"});
+        QVERIFY(scanner.scan(buffer));
+        QCOMPARE(*scanner.getLong("Data/WorldGenSettings/seed"), int64_t(-1234567890123LL));
+        QVERIFY(!scanner.contains("Data/RandomSeed"));
+
+        // the first alternative that shows up ends the scan, the seed comes after the name
+        buffer.seek(0);
+        NbtScanner first({"Data/LevelName|Data/WorldGenSettings/seed"});
+        QVERIFY(first.scan(buffer));
+        QVERIFY(first.contains("Data/LevelName"));
+        QVERIFY(!first.contains("Data/WorldGenSettings/seed"));
+    }
+
+    void test_TypeMismatch()
+    {
+        auto data = levelDat(true);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        NbtScanner scanner({"Data/GameType"});
+        QVERIFY(scanner.scan(buffer));
+        QVERIFY(scanner.contains("Data/GameType"));
+        QVERIFY(!scanner.getInt("Data/GameType"));
+    }
+
+    void test_Truncated()
+    {
+        auto data = levelDat(false);
+        data.truncate(data.size() / 2);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        NbtScanner scanner({"Data/WorldGenSettings/seed"});
+        QVERIFY(!scanner.scan(buffer));
+        QVERIFY(!scanner.errorString().isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(NbtScannerTest)
+
+#include "NbtScanner_test.moc"
@@ -225,6 +225,11 @@ bool PackProfile::saveIsScheduled() const
     return d->dirty;
 }
 
+bool PackProfile::isLoaded() const
+{
+    return d->loaded;
+}
+
 void PackProfile::buildingFromScratch()
 {
     d->loaded = true;
@@ -58,6 +58,9 @@ public:
     /// call this to explicitly mark the component list as loaded - this is used to build a new component list from scratch.
     void buildingFromScratch();
 
+    /// true once the component list has been read from disk or built from scratch
+    bool isLoaded() const;
+
     /// install more jar mods
     void installJarMods(QStringList selectedFiles);
 
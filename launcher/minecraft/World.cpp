@@ -20,6 +20,7 @@
 #include "World.h"
 
 #include "GZip.h"
+#include "NbtScanner.h"
 #include <MMCZip.h>
 #include <FileSystem.h>
 #include <sstream>
@@ -225,14 +226,20 @@ bool World::resetIcon()
 
 void World::readFromFS(const QFileInfo &file)
 {
-    auto bytes = getLevelDatDataFromFS(file);
-    if(bytes.isEmpty())
+    auto fullFilePath = getLevelDatFromFS(file);
+    if(fullFilePath.isNull())
+    {
+        is_valid = false;
+        return;
+    }
+    QFile f(fullFilePath);
+    if(!f.open(QIODevice::ReadOnly))
     {
         is_valid = false;
         return;
     }
-    loadFromLevelDat(bytes);
     levelDatTime = file.lastModified();
+    loadFromLevelDat(f);
 }
 
 void World::readFromZip(const QFileInfo &file)
@@ -270,7 +277,7 @@ void World::readFromZip(const QFileInfo &file)
     {
         return;
     }
-    loadFromLevelDat(zippedFile.readAll());
+    loadFromLevelDat(zippedFile);
     zippedFile.close();
 }
 
@@ -348,132 +355,42 @@ bool World::rename(const QString &newName)
     return true;
 }
 
-namespace {
-
-optional<QString> read_string (nbt::value& parent, const char * name)
+void World::loadFromLevelDat(QIODevice &levelDat)
 {
-    try
-    {
-        auto &namedValue = parent.at(name);
-        if(namedValue.get_type() != nbt::tag_type::String)
-        {
-            return nullopt;
-        }
-        auto & tag_str = namedValue.as<nbt::tag_string>();
-        return QString::fromStdString(tag_str.get());
-    }
-    catch (const std::out_of_range &e)
-    {
-        // fallback for old world formats
-        qWarning() << "String NBT tag" << name << "could not be found.";
-        return nullopt;
-    }
-    catch (const std::bad_cast &e)
-    {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to string.";
-        return nullopt;
-    }
-}
-
-optional<int64_t> read_long (nbt::value& parent, const char * name)
-{
-    try
-    {
-        auto &namedValue = parent.at(name);
-        if(namedValue.get_type() != nbt::tag_type::Long)
-        {
-            return nullopt;
-        }
-        auto & tag_str = namedValue.as<nbt::tag_long>();
-        return tag_str.get();
-    }
-    catch (const std::out_of_range &e)
-    {
-        // fallback for old world formats
-        qWarning() << "Long NBT tag" << name << "could not be found.";
-        return nullopt;
-    }
-    catch (const std::bad_cast &e)
-    {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to long.";
-        return nullopt;
-    }
-}
-
-optional<int> read_int (nbt::value& parent, const char * name)
-{
-    try
-    {
-        auto &namedValue = parent.at(name);
-        if(namedValue.get_type() != nbt::tag_type::Int)
-        {
-            return nullopt;
-        }
-        auto & tag_str = namedValue.as<nbt::tag_int>();
-        return tag_str.get();
-    }
-    catch (const std::out_of_range &e)
-    {
-        // fallback for old world formats
-        qWarning() << "Int NBT tag" << name << "could not be found.";
-        return nullopt;
-    }
-    catch (const std::bad_cast &e)
-    {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to int.";
-        return nullopt;
-    }
-}
-
-GameType read_gametype(nbt::value& parent, const char * name) {
-    return GameType(read_int(parent, name));
-}
-
-}
-
-void World::loadFromLevelDat(QByteArray data)
-{
-    auto levelData = parseLevelDat(data);
-    if(!levelData)
-    {
-        is_valid = false;
-        return;
-    }
-
-    nbt::value * valPtr = nullptr;
-    try {
-        valPtr = &levelData->at("Data");
-    }
-    catch (const std::out_of_range &e) {
-        qWarning() << "Unable to read NBT tags from " << m_folderName << ":" << e.what();
+    // only these are needed, everything else in level.dat is skipped without being decoded
+    NbtScanner scanner({
+        "Data",
+        "Data/LevelName",
+        "Data/LastPlayed",
+        "Data/GameType",
+        // 1.16 moved the seed
+        "Data/WorldGenSettings/seed|Data/RandomSeed"
+    });
+    if(!scanner.scan(levelDat))
+    {
+        qWarning() << "Unable to parse level.dat of" << m_folderName << ":" << scanner.errorString();
         is_valid = false;
         return;
     }
-    nbt::value &val = *valPtr;
 
-    is_valid = val.get_type() == nbt::tag_type::Compound;
+    is_valid = scanner.isCompound("Data");
     if(!is_valid)
+    {
+        qWarning() << "Unable to read NBT tags from " << m_folderName << ": missing Data compound";
         return;
+    }
 
-    auto name = read_string(val, "LevelName");
+    auto name = scanner.getString("Data/LevelName");
     m_actualName = name ? *name : m_folderName;
 
-    auto timestamp = read_long(val, "LastPlayed");
+    auto timestamp = scanner.getLong("Data/LastPlayed");
     m_lastPlayed = timestamp ? QDateTime::fromMSecsSinceEpoch(*timestamp) : levelDatTime;
 
-    m_gameType = read_gametype(val, "GameType");
+    m_gameType = GameType(scanner.getInt("Data/GameType"));
 
-    optional<int64_t> randomSeed;
-    try {
-        auto &WorldGen_val = val.at("WorldGenSettings");
-        randomSeed = read_long(WorldGen_val, "seed");
-    }
-    catch (const std::out_of_range &) {}
+    optional<int64_t> randomSeed = scanner.getLong("Data/WorldGenSettings/seed");
     if(!randomSeed) {
-        randomSeed = read_long(val, "RandomSeed");
+        randomSeed = scanner.getLong("Data/RandomSeed");
     }
     m_randomSeed = randomSeed ? *randomSeed : 0;
 
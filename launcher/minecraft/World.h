@@ -18,6 +18,8 @@
 #include <QDateTime>
 #include <nonstd/optional>
 
+class QIODevice;
+
 struct GameType {
     GameType() = default;
     GameType (nonstd::optional<int> original);
@@ -94,7 +96,7 @@ public:
 private:
     void readFromZip(const QFileInfo &file);
     void readFromFS(const QFileInfo &file);
-    void loadFromLevelDat(QByteArray data);
+    void loadFromLevelDat(QIODevice &levelDat);
 
 protected:
 
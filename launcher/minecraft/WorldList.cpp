@@ -20,7 +20,10 @@
 #include <QUuid>
 #include <QString>
 #include <QFileSystemWatcher>
+#include <QThreadPool>
 #include <QDebug>
+#include <algorithm>
+#include "MMCStrings.h"
 
 WorldList::WorldList(const QString &dir)
     : QAbstractListModel(), m_dir(dir)
@@ -34,6 +37,14 @@ WorldList::WorldList(const QString &dir)
             SLOT(directoryChanged(QString)));
 }
 
+WorldList::~WorldList()
+{
+    for(auto & ticket: activeSizeTickets)
+    {
+        ticket->canceled = true;
+    }
+}
+
 void WorldList::startWatching()
 {
     if(is_watching)
@@ -58,6 +69,12 @@ void WorldList::stopWatching()
     {
         return;
     }
+    // nobody is looking at the sizes now, they will be measured again once watching starts again
+    for(auto & ticket: activeSizeTickets)
+    {
+        ticket->canceled = true;
+    }
+    activeSizeTickets.clear();
     is_watching = !m_watcher->removePath(m_dir.absolutePath());
     if (!is_watching)
     {
@@ -74,25 +91,188 @@ bool WorldList::update()
     if (!isValid())
         return false;
 
-    QList<World> newWorlds;
-    m_dir.refresh();
-    auto folderContents = m_dir.entryInfoList();
-    // if there are any untracked files...
-    for (QFileInfo entry : folderContents)
+    if(m_update) {
+        scheduled_update = true;
+        return true;
+    }
+
+    auto task = new WorldListLoadTask(m_dir);
+    m_update = task->result();
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    connect(task, &WorldListLoadTask::succeeded, this, &WorldList::finishUpdate);
+    threadPool->start(task);
+    return true;
+}
+
+void WorldList::finishUpdate()
+{
+    auto & entries = m_update->entries;
+
+    // remove worlds no longer present
     {
-        if(!entry.isDir())
+        QList<int> removedRows;
+        for(auto iter = worldsIndex.begin(); iter != worldsIndex.end(); iter++) {
+            if(!entries.contains(iter.key())) {
+                removedRows.append(iter.value());
+            }
+        }
+        std::sort(removedRows.begin(), removedRows.end(), std::greater<int>());
+        for(auto removedIndex: removedRows) {
+            beginRemoveRows(QModelIndex(), removedIndex, removedIndex);
+            worlds.removeAt(removedIndex);
+            endRemoveRows();
+        }
+        rebuildIndex();
+    }
+
+    // forget everything else about them, including the ones that were still being read
+    for(auto iter = m_stamps.begin(); iter != m_stamps.end();) {
+        if(entries.contains(iter.key())) {
+            iter++;
             continue;
+        }
+        cancelMeasurements(iter.key());
+        worldSizes.remove(iter.key());
+        iter = m_stamps.erase(iter);
+    }
+    for(auto iter = activeParseTickets.begin(); iter != activeParseTickets.end();) {
+        if(entries.contains((*iter)->folderName)) {
+            iter++;
+            continue;
+        }
+        iter = activeParseTickets.erase(iter);
+    }
 
-        World w(entry);
-        if(w.isValid())
-        {
-            newWorlds.append(w);
+    // read the worlds that are new or changed since they were last read
+    for(auto iter = entries.begin(); iter != entries.end(); iter++) {
+        auto known = m_stamps.find(iter.key());
+        if(known != m_stamps.end() && *known == iter->stamp) {
+            // measuring may have been interrupted by stopWatching()
+            if(worldsIndex.contains(iter.key()) && !worldSizes.contains(iter.key())) {
+                measureWorld(iter.key());
+            }
+            continue;
         }
+        m_stamps[iter.key()] = iter->stamp;
+        parseWorld(iter->file);
+    }
+
+    m_update.reset();
+
+    emit updateFinished();
+
+    if(scheduled_update) {
+        scheduled_update = false;
+        update();
+    }
+}
+
+void WorldList::parseWorld(const QFileInfo& file)
+{
+    auto folderName = file.fileName();
+    // a newer read supersedes any older one that is still running
+    for(auto iter = activeParseTickets.begin(); iter != activeParseTickets.end();) {
+        if((*iter)->folderName == folderName) {
+            iter = activeParseTickets.erase(iter);
+        }
+        else {
+            iter++;
+        }
+    }
+    auto task = new WorldParseTask(nextTicket, file);
+    activeParseTickets.insert(nextTicket, task->result());
+    nextTicket++;
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    connect(task, &WorldParseTask::finished, this, &WorldList::finishWorldParse);
+    threadPool->start(task);
+}
+
+void WorldList::finishWorldParse(int token)
+{
+    auto iter = activeParseTickets.find(token);
+    if(iter == activeParseTickets.end()) {
+        return;
+    }
+    auto result = *iter;
+    activeParseTickets.erase(iter);
+
+    auto & folderName = result->folderName;
+    auto existing = worldsIndex.find(folderName);
+    if(result->world->isValid()) {
+        if(existing != worldsIndex.end()) {
+            int row = *existing;
+            worlds[row] = *result->world;
+            emit dataChanged(index(row, 0), index(row, NUM_COLUMNS - 1));
+        }
+        else {
+            int row = worlds.size();
+            beginInsertRows(QModelIndex(), row, row);
+            worlds.append(*result->world);
+            worldsIndex[folderName] = row;
+            endInsertRows();
+        }
+        measureWorld(folderName);
+    }
+    else if(existing != worldsIndex.end()) {
+        int row = *existing;
+        beginRemoveRows(QModelIndex(), row, row);
+        worlds.removeAt(row);
+        endRemoveRows();
+        rebuildIndex();
+        cancelMeasurements(folderName);
+        worldSizes.remove(folderName);
+    }
+}
+
+void WorldList::measureWorld(const QString& folderName)
+{
+    cancelMeasurements(folderName);
+    auto task = new WorldSizeTask(nextTicket, folderName, m_dir.absoluteFilePath(folderName));
+    activeSizeTickets.insert(nextTicket, task->result());
+    nextTicket++;
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    connect(task, &WorldSizeTask::finished, this, &WorldList::finishWorldSize);
+    threadPool->start(task);
+}
+
+void WorldList::cancelMeasurements(const QString& folderName)
+{
+    for(auto iter = activeSizeTickets.begin(); iter != activeSizeTickets.end();) {
+        if((*iter)->folderName == folderName) {
+            (*iter)->canceled = true;
+            iter = activeSizeTickets.erase(iter);
+        }
+        else {
+            iter++;
+        }
+    }
+}
+
+void WorldList::finishWorldSize(int token)
+{
+    auto iter = activeSizeTickets.find(token);
+    if(iter == activeSizeTickets.end()) {
+        return;
+    }
+    auto result = *iter;
+    activeSizeTickets.erase(iter);
+
+    worldSizes[result->folderName] = result->size;
+    auto existing = worldsIndex.find(result->folderName);
+    if(existing != worldsIndex.end()) {
+        int row = *existing;
+        emit dataChanged(index(row, SizeColumn), index(row, SizeColumn), {Qt::DisplayRole, WorldList::SizeRole});
+    }
+}
+
+void WorldList::rebuildIndex()
+{
+    worldsIndex.clear();
+    int idx = 0;
+    for(auto & world: worlds) {
+        worldsIndex[world.folderName()] = idx;
+        idx++;
     }
-    beginResetModel();
-    worlds.swap(newWorlds);
-    endResetModel();
-    return true;
 }
 
 void WorldList::directoryChanged(QString path)
@@ -112,9 +292,14 @@ bool WorldList::deleteWorld(int index)
     World &m = worlds[index];
     if (m.destroy())
     {
+        auto folderName = m.folderName();
         beginRemoveRows(QModelIndex(), index, index);
         worlds.removeAt(index);
         endRemoveRows();
+        rebuildIndex();
+        m_stamps.remove(folderName);
+        cancelMeasurements(folderName);
+        worldSizes.remove(folderName);
         emit changed();
         return true;
     }
@@ -127,10 +312,14 @@ bool WorldList::deleteWorlds(int first, int last)
     {
         World &m = worlds[i];
         m.destroy();
+        m_stamps.remove(m.folderName());
+        cancelMeasurements(m.folderName());
+        worldSizes.remove(m.folderName());
     }
     beginRemoveRows(QModelIndex(), first, last);
     worlds.erase(worlds.begin() + first, worlds.begin() + last + 1);
     endRemoveRows();
+    rebuildIndex();
     emit changed();
     return true;
 }
@@ -150,7 +339,7 @@ bool WorldList::resetIcon(int row)
 
 int WorldList::columnCount(const QModelIndex &parent) const
 {
-    return 3;
+    return NUM_COLUMNS;
 }
 
 QVariant WorldList::data(const QModelIndex &index, int role) const
@@ -179,6 +368,16 @@ QVariant WorldList::data(const QModelIndex &index, int role) const
         case LastPlayedColumn:
             return world.lastPlayed();
 
+        case SizeColumn:
+        {
+            auto size = worldSizes.find(world.folderName());
+            if(size == worldSizes.end())
+            {
+                return QVariant();
+            }
+            return Strings::humanReadableFileSize(*size);
+        }
+
         default:
             return QVariant();
         }
@@ -211,6 +410,15 @@ QVariant WorldList::data(const QModelIndex &index, int role) const
     {
         return world.iconFile();
     }
+    case SizeRole:
+    {
+        auto size = worldSizes.find(world.folderName());
+        if(size == worldSizes.end())
+        {
+            return QVariant();
+        }
+        return qlonglong(*size);
+    }
     default:
         return QVariant();
     }
@@ -229,6 +437,8 @@ QVariant WorldList::headerData(int section, Qt::Orientation orientation, int rol
             return tr("Game Mode");
         case LastPlayedColumn:
             return tr("Last Played");
+        case SizeColumn:
+            return tr("Size");
         default:
             return QVariant();
         }
@@ -242,6 +452,8 @@ QVariant WorldList::headerData(int section, Qt::Orientation orientation, int rol
             return tr("Game mode of the world.");
         case LastPlayedColumn:
             return tr("Date and time the world was last played.");
+        case SizeColumn:
+            return tr("Space the world takes up on disk.");
         default:
             return QVariant();
         }
@@ -21,6 +21,9 @@
 #include <QAbstractListModel>
 #include <QMimeData>
 #include "minecraft/World.h"
+#include "minecraft/WorldListLoadTask.h"
+#include "minecraft/WorldParseTask.h"
+#include "minecraft/WorldSizeTask.h"
 
 class QFileSystemWatcher;
 
@@ -32,7 +35,9 @@ public:
     {
         NameColumn,
         GameModeColumn,
-        LastPlayedColumn
+        LastPlayedColumn,
+        SizeColumn,
+        NUM_COLUMNS
     };
 
     enum Roles
@@ -43,10 +48,12 @@ public:
         NameRole,
         GameModeRole,
         LastPlayedRole,
-        IconFileRole
+        IconFileRole,
+        SizeRole
     };
 
     WorldList(const QString &dir);
+    virtual ~WorldList();
 
     virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
 
@@ -71,7 +78,10 @@ public:
         return worlds[index];
     }
 
-    /// Reloads the mod list and returns true if the list changed.
+    /**
+     * Starts reloading the world list in the background.
+     * Only worlds whose level.dat or icon changed since they were last read are parsed again.
+     */
     virtual bool update();
 
     /// Install a world from location
@@ -117,13 +127,33 @@ public:
 
 private slots:
     void directoryChanged(QString path);
+    void finishUpdate();
+    void finishWorldParse(int token);
+    void finishWorldSize(int token);
 
 signals:
     void changed();
+    void updateFinished();
+
+private:
+    void parseWorld(const QFileInfo &file);
+    void measureWorld(const QString &folderName);
+    void cancelMeasurements(const QString &folderName);
+    void rebuildIndex();
 
 protected:
     QFileSystemWatcher *m_watcher;
     bool is_watching;
     QDir m_dir;
     QList<World> worlds;
+
+    WorldListLoadTask::ResultPtr m_update;
+    bool scheduled_update = false;
+    // what the worlds were read from, by folder name
+    QMap<QString, WorldListLoadTask::Stamp> m_stamps;
+    QMap<QString, int> worldsIndex;
+    QMap<QString, qint64> worldSizes;
+    QMap<int, WorldParseTask::ResultPtr> activeParseTickets;
+    QMap<int, WorldSizeTask::ResultPtr> activeSizeTickets;
+    int nextTicket = 0;
 };
@@ -0,0 +1,33 @@
+#include "WorldListLoadTask.h"
+
+WorldListLoadTask::WorldListLoadTask(QDir dir) :
+    m_dir(dir), m_result(new Result())
+{
+}
+
+void WorldListLoadTask::run()
+{
+    m_dir.refresh();
+    for (auto entry : m_dir.entryInfoList())
+    {
+        if(!entry.isDir())
+            continue;
+
+        Entry e;
+        e.file = entry;
+        QDir worldDir(entry.filePath());
+        QFileInfo levelDat(worldDir.filePath("level.dat"));
+        if(levelDat.exists())
+        {
+            e.stamp.levelDatModified = levelDat.lastModified();
+            e.stamp.levelDatSize = levelDat.size();
+        }
+        QFileInfo icon(worldDir.filePath("icon.png"));
+        if(icon.exists())
+        {
+            e.stamp.iconModified = icon.lastModified();
+        }
+        m_result->entries[entry.fileName()] = e;
+    }
+    emit succeeded();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <QRunnable>
+#include <QObject>
+#include <QDir>
+#include <QMap>
+#include <QDateTime>
+#include <memory>
+
+/**
+ * Lists the world folders and stats the files a World is read from, without parsing anything.
+ * The stamps are used by WorldList to decide which worlds need to be read again.
+ */
+class WorldListLoadTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+public:
+    struct Stamp {
+        QDateTime levelDatModified;
+        qint64 levelDatSize = -1;
+        QDateTime iconModified;
+
+        bool operator==(const Stamp &other) const
+        {
+            return levelDatSize == other.levelDatSize && levelDatModified == other.levelDatModified && iconModified == other.iconModified;
+        }
+        bool operator!=(const Stamp &other) const
+        {
+            return !(*this == other);
+        }
+    };
+    struct Entry {
+        QFileInfo file;
+        Stamp stamp;
+    };
+    struct Result {
+        QMap<QString, Entry> entries;
+    };
+    using ResultPtr = std::shared_ptr<Result>;
+    ResultPtr result() const {
+        return m_result;
+    }
+
+public:
+    WorldListLoadTask(QDir dir);
+    void run();
+signals:
+    void succeeded();
+private:
+    QDir m_dir;
+    ResultPtr m_result;
+};
@@ -0,0 +1,15 @@
+#include "WorldParseTask.h"
+
+WorldParseTask::WorldParseTask(int token, const QFileInfo& worldDir) :
+    m_token(token),
+    m_worldDir(worldDir),
+    m_result(new Result())
+{
+    m_result->folderName = worldDir.fileName();
+}
+
+void WorldParseTask::run()
+{
+    m_result->world = std::make_shared<World>(m_worldDir);
+    emit finished(m_token);
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <QRunnable>
+#include <QObject>
+#include <QFileInfo>
+#include <memory>
+#include "World.h"
+
+/**
+ * Reads a single world (its level.dat and icon) on a worker thread.
+ */
+class WorldParseTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+public:
+    struct Result {
+        QString folderName;
+        std::shared_ptr<World> world;
+    };
+    using ResultPtr = std::shared_ptr<Result>;
+    ResultPtr result() const {
+        return m_result;
+    }
+
+    WorldParseTask(int token, const QFileInfo & worldDir);
+    void run();
+
+signals:
+    void finished(int token);
+
+private:
+    int m_token;
+    QFileInfo m_worldDir;
+    ResultPtr m_result;
+};
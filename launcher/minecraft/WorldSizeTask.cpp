@@ -0,0 +1,27 @@
+#include "WorldSizeTask.h"
+#include <QDirIterator>
+
+WorldSizeTask::WorldSizeTask(int token, const QString& folderName, const QString& path) :
+    m_token(token),
+    m_path(path),
+    m_result(new Result())
+{
+    m_result->folderName = folderName;
+}
+
+void WorldSizeTask::run()
+{
+    qint64 total = 0;
+    QDirIterator iter(m_path, QDir::Files | QDir::Hidden | QDir::System | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (iter.hasNext())
+    {
+        if(m_result->canceled)
+        {
+            return;
+        }
+        iter.next();
+        total += iter.fileInfo().size();
+    }
+    m_result->size = total;
+    emit finished(m_token);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <QRunnable>
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+/**
+ * Adds up the size of all the files in a world folder on a worker thread.
+ * Setting the canceled flag of the result makes it stop early.
+ */
+class WorldSizeTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+public:
+    struct Result {
+        QString folderName;
+        qint64 size = 0;
+        std::atomic<bool> canceled;
+        Result() : canceled(false) {}
+    };
+    using ResultPtr = std::shared_ptr<Result>;
+    ResultPtr result() const {
+        return m_result;
+    }
+
+    WorldSizeTask(int token, const QString & folderName, const QString & path);
+    void run();
+
+signals:
+    void finished(int token);
+
+private:
+    int m_token;
+    QString m_path;
+    ResultPtr m_result;
+};
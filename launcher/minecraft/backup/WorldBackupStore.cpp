@@ -0,0 +1,452 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WorldBackupStore.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QtEndian>
+#include <QDebug>
+
+#include "Exception.h"
+#include "FileSystem.h"
+#include "Json.h"
+#include "MultiHash.h"
+
+namespace {
+const int formatVersion = 1;
+
+// region files start with 1024 chunk locations followed by 1024 timestamps, and are allocated in 4 KiB sectors
+const qint64 sectorSize = 4096;
+const int chunksPerRegion = 1024;
+const qint64 regionHeaderSize = 2 * sectorSize;
+
+// first byte of every stored object
+enum ObjectEncoding : char
+{
+    Raw = 0,
+    Compressed = 1
+};
+
+bool isCompressedChunk(quint8 compression)
+{
+    // gzip, zlib and lz4 compressed chunks would not get any smaller
+    compression &= 0x7f;
+    return compression == 1 || compression == 2 || compression == 4;
+}
+
+QString setError(QString *error, const QString &message)
+{
+    if(error)
+    {
+        *error = message;
+    }
+    qWarning() << message;
+    return QString();
+}
+}
+
+WorldBackupStore::WorldBackupStore(const QString &root) : m_root(root)
+{
+}
+
+QString WorldBackupStore::objectPath(const QString &hash) const
+{
+    return FS::PathCombine(m_root, "objects", hash.left(2), hash.mid(2));
+}
+
+QString WorldBackupStore::manifestPath(const QString &worldFolder, const QString &snapshotId) const
+{
+    return FS::PathCombine(m_root, "snapshots", worldFolder, snapshotId + ".json");
+}
+
+bool WorldBackupStore::loadManifest(const QString &path, QJsonObject &manifest) const
+{
+    try
+    {
+        manifest = Json::requireObject(Json::requireDocument(path, "Backup manifest"), "Backup manifest");
+        if(Json::requireInteger(manifest, "formatVersion") != formatVersion)
+        {
+            qWarning() << "Unsupported backup manifest version in" << path;
+            return false;
+        }
+        return true;
+    }
+    catch(const Exception &e)
+    {
+        qWarning() << "Couldn't read backup manifest" << path << ":" << e.cause();
+        return false;
+    }
+}
+
+QString WorldBackupStore::storeObject(const char *data, int size, bool compress)
+{
+    auto hash = QString::fromLatin1(MultiHash::hash(QByteArray::fromRawData(data, size), QCryptographicHash::Sha1).toHex());
+    auto path = objectPath(hash);
+    if(QFile::exists(path))
+    {
+        m_stats.objectsDeduplicated++;
+        return hash;
+    }
+    QByteArray out;
+    if(compress)
+    {
+        out = qCompress(reinterpret_cast<const uchar *>(data), size);
+        out.prepend(char(Compressed));
+    }
+    else
+    {
+        out.reserve(size + 1);
+        out.append(char(Raw));
+        out.append(data, size);
+    }
+    FS::write(path, out);
+    m_stats.objectsWritten++;
+    m_stats.bytesWritten += out.size();
+    return hash;
+}
+
+QByteArray WorldBackupStore::loadObject(const QString &hash) const
+{
+    auto stored = FS::read(objectPath(hash));
+    if(stored.isEmpty())
+    {
+        throw Exception("Backup object " + hash + " is empty");
+    }
+    QByteArray data;
+    if(stored[0] == char(Compressed))
+    {
+        data = qUncompress(reinterpret_cast<const uchar *>(stored.constData()) + 1, stored.size() - 1);
+    }
+    else
+    {
+        data = stored.mid(1);
+    }
+    if(MultiHash::hash(data, QCryptographicHash::Sha1).toHex() != hash.toLatin1())
+    {
+        throw Exception("Backup object " + hash + " is corrupted");
+    }
+    return data;
+}
+
+bool WorldBackupStore::backupRegion(QFile &file, QJsonArray &chunks)
+{
+    const qint64 size = file.size();
+    QByteArray contents;
+    const uchar *data = file.map(0, size);
+    if(!data)
+    {
+        contents = file.readAll();
+        if(contents.size() != size)
+        {
+            return false;
+        }
+        data = reinterpret_cast<const uchar *>(contents.constData());
+    }
+    bool valid = true;
+    for(int i = 0; i < chunksPerRegion; i++)
+    {
+        const quint32 location = qFromBigEndian<quint32>(data + i * 4);
+        if(!location)
+        {
+            continue;
+        }
+        const qint64 offset = qint64(location >> 8) * sectorSize;
+        if(offset < regionHeaderSize || offset + 5 > size)
+        {
+            valid = false;
+            break;
+        }
+        // the stored chunk includes its length prefix and compression type
+        const qint64 length = qint64(qFromBigEndian<quint32>(data + offset)) + 4;
+        if(length < 5 || offset + length > size)
+        {
+            valid = false;
+            break;
+        }
+        const quint32 timestamp = qFromBigEndian<quint32>(data + sectorSize + i * 4);
+        auto hash = storeObject(reinterpret_cast<const char *>(data + offset), int(length), !isCompressedChunk(data[offset + 4]));
+        chunks.append(QJsonArray{i, double(timestamp), hash});
+    }
+    if(contents.isNull())
+    {
+        file.unmap(const_cast<uchar *>(data));
+    }
+    if(!valid)
+    {
+        qWarning() << "Region file" << file.fileName() << "has invalid chunk locations, storing it as a whole";
+        chunks = QJsonArray();
+    }
+    return valid;
+}
+
+QByteArray WorldBackupStore::restoreRegion(const QJsonArray &chunks) const
+{
+    QByteArray out(int(regionHeaderSize), 0);
+    for(auto value: chunks)
+    {
+        auto chunk = Json::requireArray(value, "Region chunk");
+        if(chunk.size() != 3)
+        {
+            throw JsonException("Region chunk entry is malformed");
+        }
+        const int index = Json::requireInteger(chunk.at(0), "Chunk index");
+        const quint32 timestamp = quint32(Json::requireDouble(chunk.at(1), "Chunk timestamp"));
+        if(index < 0 || index >= chunksPerRegion)
+        {
+            throw JsonException("Chunk index is out of range");
+        }
+        auto payload = loadObject(Json::requireString(chunk.at(2), "Chunk object"));
+        const qint64 sectors = (payload.size() + sectorSize - 1) / sectorSize;
+        const qint64 firstSector = out.size() / sectorSize;
+        if(sectors > 255 || firstSector > 0xffffff)
+        {
+            throw Exception("Chunk does not fit into a region file");
+        }
+        auto header = reinterpret_cast<uchar *>(out.data());
+        qToBigEndian<quint32>(quint32(firstSector << 8 | sectors), header + index * 4);
+        qToBigEndian<quint32>(timestamp, header + sectorSize + index * 4);
+        out.append(payload);
+        out.append(QByteArray(int(sectors * sectorSize - payload.size()), 0));
+    }
+    return out;
+}
+
+QString WorldBackupStore::backup(const QString &worldPath, QString *error)
+{
+    m_stats = Stats();
+    QDir worldDir(worldPath);
+    if(!worldDir.exists())
+    {
+        return setError(error, QString("World folder %1 does not exist").arg(worldPath));
+    }
+    auto worldFolder = QFileInfo(worldPath).fileName();
+
+    // entries of the previous snapshot, to skip files that did not change since then
+    QHash<QString, QJsonObject> previous;
+    auto ids = snapshots(worldFolder);
+    QJsonObject lastManifest;
+    if(!ids.isEmpty() && loadManifest(manifestPath(worldFolder, ids.last()), lastManifest))
+    {
+        for(auto value: lastManifest.value("files").toArray())
+        {
+            auto entry = value.toObject();
+            previous.insert(entry.value("path").toString(), entry);
+        }
+    }
+
+    auto id = QDateTime::currentDateTimeUtc().toString("yyyyMMdd-HHmmss-zzz");
+    try
+    {
+        QJsonArray files;
+        QDirIterator iter(worldPath, QDir::Files | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+        while(iter.hasNext())
+        {
+            iter.next();
+            auto info = iter.fileInfo();
+            auto relative = worldDir.relativeFilePath(info.filePath());
+            // held by the game while the world is open, and meaningless in a backup
+            if(relative == "session.lock")
+            {
+                continue;
+            }
+            const double size = info.size();
+            const double modified = info.lastModified().toMSecsSinceEpoch();
+
+            auto prev = previous.constFind(relative);
+            if(prev != previous.constEnd() && prev->value("size").toDouble(-1) == size &&
+               prev->value("modified").toDouble(-1) == modified)
+            {
+                files.append(*prev);
+                m_stats.filesReused++;
+                continue;
+            }
+
+            QFile file(info.filePath());
+            if(!file.open(QIODevice::ReadOnly))
+            {
+                throw Exception(QString("Couldn't read %1: %2").arg(info.filePath(), file.errorString()));
+            }
+            m_stats.filesRead++;
+
+            QJsonObject entry;
+            entry.insert("path", relative);
+            entry.insert("size", size);
+            entry.insert("modified", modified);
+            QJsonArray chunks;
+            if(info.suffix() == "mca" && file.size() >= regionHeaderSize && backupRegion(file, chunks))
+            {
+                entry.insert("chunks", chunks);
+            }
+            else
+            {
+                file.seek(0);
+                auto data = file.readAll();
+                if(data.size() != file.size())
+                {
+                    throw Exception(QString("Couldn't read %1: %2").arg(info.filePath(), file.errorString()));
+                }
+                entry.insert("object", storeObject(data.constData(), data.size(), true));
+            }
+            files.append(entry);
+        }
+
+        QJsonObject manifest;
+        manifest.insert("formatVersion", formatVersion);
+        manifest.insert("world", worldFolder);
+        manifest.insert("created", Json::toJson(QDateTime::currentDateTimeUtc()));
+        manifest.insert("files", files);
+        Json::write(manifest, manifestPath(worldFolder, id));
+    }
+    catch(const Exception &e)
+    {
+        return setError(error, QString("Backup of %1 failed: %2").arg(worldFolder, e.cause()));
+    }
+    return id;
+}
+
+QStringList WorldBackupStore::snapshots(const QString &worldFolder) const
+{
+    QDir dir(FS::PathCombine(m_root, "snapshots", worldFolder));
+    QStringList ids;
+    // ids are timestamps, so sorting by name sorts them by age
+    for(auto &name: dir.entryList({"*.json"}, QDir::Files, QDir::Name))
+    {
+        ids.append(name.left(name.size() - 5));
+    }
+    return ids;
+}
+
+bool WorldBackupStore::restore(const QString &worldFolder, const QString &snapshotId, const QString &targetPath, QString *error)
+{
+    if(QFileInfo::exists(targetPath))
+    {
+        setError(error, QString("Cannot restore into %1, it already exists").arg(targetPath));
+        return false;
+    }
+    QJsonObject manifest;
+    if(!loadManifest(manifestPath(worldFolder, snapshotId), manifest))
+    {
+        setError(error, QString("Snapshot %1 of %2 cannot be read").arg(snapshotId, worldFolder));
+        return false;
+    }
+    QDir target(targetPath);
+    const auto targetRoot = QDir::cleanPath(target.absolutePath()) + '/';
+    try
+    {
+        // empty folders are not part of snapshots, the game creates them as needed
+        FS::ensureFolderPathExists(targetPath);
+        for(auto value: Json::requireArray(manifest, "files"))
+        {
+            auto entry = Json::requireObject(value, "Backup file entry");
+            auto path = QDir::cleanPath(target.absoluteFilePath(Json::requireString(entry, "path")));
+            if(!path.startsWith(targetRoot))
+            {
+                throw Exception("Snapshot contains a path outside of the world: " + path);
+            }
+            if(entry.contains("chunks"))
+            {
+                FS::write(path, restoreRegion(Json::requireArray(entry, "chunks")));
+            }
+            else
+            {
+                FS::write(path, loadObject(Json::requireString(entry, "object")));
+            }
+        }
+    }
+    catch(const Exception &e)
+    {
+        FS::deletePath(targetPath);
+        setError(error, QString("Restoring %1 failed: %2").arg(worldFolder, e.cause()));
+        return false;
+    }
+    return true;
+}
+
+bool WorldBackupStore::prune(const QString &worldFolder, int keep, QString *error)
+{
+    auto ids = snapshots(worldFolder);
+    if(ids.size() <= keep)
+    {
+        return true;
+    }
+    for(int i = 0; i < ids.size() - qMax(keep, 0); i++)
+    {
+        auto path = manifestPath(worldFolder, ids[i]);
+        if(!QFile::remove(path))
+        {
+            setError(error, QString("Couldn't remove old snapshot %1").arg(path));
+            return false;
+        }
+    }
+    try
+    {
+        collectGarbage();
+    }
+    catch(const Exception &e)
+    {
+        setError(error, e.cause());
+        return false;
+    }
+    return true;
+}
+
+void WorldBackupStore::collectGarbage()
+{
+    // objects can be shared between all snapshots of all worlds in the store
+    QSet<QString> referenced;
+    QDirIterator manifests(FS::PathCombine(m_root, "snapshots"), {"*.json"}, QDir::Files, QDirIterator::Subdirectories);
+    while(manifests.hasNext())
+    {
+        QJsonObject manifest;
+        if(!loadManifest(manifests.next(), manifest))
+        {
+            // deleting objects a snapshot might still need would be far worse than wasting some space
+            throw Exception("Not collecting unused backup objects, a snapshot manifest is unreadable");
+        }
+        for(auto value: manifest.value("files").toArray())
+        {
+            auto entry = value.toObject();
+            if(entry.contains("chunks"))
+            {
+                for(auto chunk: entry.value("chunks").toArray())
+                {
+                    referenced.insert(chunk.toArray().at(2).toString());
+                }
+            }
+            else
+            {
+                referenced.insert(entry.value("object").toString());
+            }
+        }
+    }
+
+    QDirIterator objects(FS::PathCombine(m_root, "objects"), QDir::Files, QDirIterator::Subdirectories);
+    while(objects.hasNext())
+    {
+        objects.next();
+        auto info = objects.fileInfo();
+        auto hash = info.dir().dirName() + info.fileName();
+        if(!referenced.contains(hash))
+        {
+            QFile::remove(info.filePath());
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QJsonArray>
+#include <QJsonObject>
+
+class QFile;
+
+/**
+ * Deduplicating store of world snapshots.
+ *
+ * Layout of the store folder:
+ *  - objects/xx/yyyy...: content addressed (SHA-1) blobs, one per file or per region chunk
+ *  - snapshots/<world folder>/<snapshot id>.json: manifests listing the objects that make up each file
+ *
+ * Region files (*.mca) are split into their chunks, so a snapshot only adds the chunks that changed since any earlier
+ * snapshot. Files that did not change size or modification time since the previous snapshot of the same world are not
+ * read at all.
+ *
+ * All methods do blocking I/O and are meant to be used from a worker thread.
+ */
+class WorldBackupStore
+{
+public:
+    struct Stats
+    {
+        int filesReused = 0;
+        int filesRead = 0;
+        int objectsWritten = 0;
+        int objectsDeduplicated = 0;
+        qint64 bytesWritten = 0;
+    };
+
+    explicit WorldBackupStore(const QString &root);
+
+    /// Snapshot the world folder. Returns the new snapshot id, or an empty string on failure.
+    QString backup(const QString &worldPath, QString *error = nullptr);
+
+    /// Snapshot ids of a world, oldest first
+    QStringList snapshots(const QString &worldFolder) const;
+
+    /// Rebuild the world folder as it was in the snapshot. The target folder must not exist yet.
+    bool restore(const QString &worldFolder, const QString &snapshotId, const QString &targetPath, QString *error = nullptr);
+
+    /// Remove all but the newest `keep` snapshots of the world and delete objects nothing refers to anymore
+    bool prune(const QString &worldFolder, int keep, QString *error = nullptr);
+
+    Stats lastStats() const
+    {
+        return m_stats;
+    }
+
+private:
+    QString objectPath(const QString &hash) const;
+    QString manifestPath(const QString &worldFolder, const QString &snapshotId) const;
+    bool loadManifest(const QString &path, QJsonObject &manifest) const;
+
+    // these throw Exception on I/O errors or corrupt data
+    QString storeObject(const char *data, int size, bool compress);
+    QByteArray loadObject(const QString &hash) const;
+    bool backupRegion(QFile &file, QJsonArray &chunks);
+    QByteArray restoreRegion(const QJsonArray &chunks) const;
+    void collectGarbage();
+
+private:
+    QString m_root;
+    Stats m_stats;
+};
@@ -0,0 +1,120 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "minecraft/backup/WorldBackupStore.h"
+
+namespace {
+// region file with the chunks packed one after another from sector 2, which is also how restore lays them out
+QByteArray region(const QMap<int, QByteArray> &chunks)
+{
+    QByteArray out(8192, 0);
+    for(auto iter = chunks.begin(); iter != chunks.end(); iter++)
+    {
+        QByteArray chunk(4, 0);
+        qToBigEndian<quint32>(quint32(iter.value().size() + 1), reinterpret_cast<uchar *>(chunk.data()));
+        chunk.append(char(2));
+        chunk.append(iter.value());
+        int sectors = (chunk.size() + 4095) / 4096;
+        auto header = reinterpret_cast<uchar *>(out.data());
+        qToBigEndian<quint32>(quint32((out.size() / 4096) << 8 | sectors), header + iter.key() * 4);
+        qToBigEndian<quint32>(quint32(1600000000 + iter.key()), header + 4096 + iter.key() * 4);
+        out.append(chunk);
+        out.append(QByteArray(sectors * 4096 - chunk.size(), 0));
+    }
+    return out;
+}
+
+QByteArray chunkData(int seed, int size)
+{
+    QByteArray data(size, 0);
+    for(int i = 0; i < size; i++)
+    {
+        data[i] = char((i * 31 + seed * 7) & 0xff);
+    }
+    return data;
+}
+}
+
+class WorldBackupStoreTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_IncrementalRoundTrip()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto world = FS::PathCombine(temp.path(), "saves", "World");
+        auto regionPath = FS::PathCombine(world, "region", "r.0.0.mca");
+
+        QMap<int, QByteArray> chunks;
+        chunks[0] = chunkData(0, 5000);
+        chunks[1] = chunkData(1, 100);
+        chunks[513] = chunkData(2, 9000);
+        FS::write(regionPath, region(chunks));
+        FS::write(FS::PathCombine(world, "level.dat"), "level");
+        FS::write(FS::PathCombine(world, "session.lock"), "lock");
+
+        WorldBackupStore store(FS::PathCombine(temp.path(), "backups"));
+        auto first = store.backup(world);
+        QVERIFY(!first.isEmpty());
+        QCOMPARE(store.lastStats().filesRead, 2);
+        QCOMPARE(store.lastStats().objectsWritten, 4);
+
+        // grow a single chunk, the others must be deduplicated
+        QTest::qWait(5);
+        chunks[1] = chunkData(3, 6000);
+        auto changed = region(chunks);
+        FS::write(regionPath, changed);
+        QTest::qWait(5);
+        auto second = store.backup(world);
+        QVERIFY(!second.isEmpty());
+        QVERIFY(first != second);
+        QCOMPARE(store.lastStats().filesReused, 1);
+        QCOMPARE(store.lastStats().objectsWritten, 1);
+        QCOMPARE(store.lastStats().objectsDeduplicated, 2);
+        QCOMPARE(store.snapshots("World"), QStringList() << first << second);
+
+        auto restored = FS::PathCombine(temp.path(), "restored");
+        QVERIFY(store.restore("World", second, restored));
+        QCOMPARE(FS::read(FS::PathCombine(restored, "region", "r.0.0.mca")), changed);
+        QCOMPARE(FS::read(FS::PathCombine(restored, "level.dat")), QByteArray("level"));
+        QVERIFY(!QFile::exists(FS::PathCombine(restored, "session.lock")));
+
+        // the restore target has to be a new folder
+        QVERIFY(!store.restore("World", second, restored));
+
+        // pruning drops the first snapshot and the chunk only it referenced
+        QVERIFY(store.prune("World", 1));
+        QCOMPARE(store.snapshots("World"), QStringList() << second);
+        auto again = FS::PathCombine(temp.path(), "again");
+        QVERIFY(store.restore("World", second, again));
+        QCOMPARE(FS::read(FS::PathCombine(again, "region", "r.0.0.mca")), changed);
+    }
+
+    void test_InvalidRegion()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto world = FS::PathCombine(temp.path(), "World");
+        // a location pointing past the end of the file, stored as a whole file instead
+        QByteArray broken(8192, 0);
+        broken[2] = 0x10;
+        broken[3] = 0x01;
+        FS::write(FS::PathCombine(world, "region", "r.1.1.mca"), broken);
+
+        WorldBackupStore store(FS::PathCombine(temp.path(), "backups"));
+        auto id = store.backup(world);
+        QVERIFY(!id.isEmpty());
+        auto restored = FS::PathCombine(temp.path(), "restored");
+        QVERIFY(store.restore("World", id, restored));
+        QCOMPARE(FS::read(FS::PathCombine(restored, "region", "r.1.1.mca")), broken);
+    }
+};
+
+QTEST_GUILESS_MAIN(WorldBackupStoreTest)
+
+#include "WorldBackupStore_test.moc"
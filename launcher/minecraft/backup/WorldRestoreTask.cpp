@@ -0,0 +1,53 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WorldRestoreTask.h"
+#include "WorldBackupStore.h"
+
+#include <QtConcurrentRun>
+
+namespace {
+QString restoreWorld(const QString &storePath, const QString &worldFolder, const QString &snapshotId, const QString &targetPath)
+{
+    WorldBackupStore store(storePath);
+    QString error;
+    store.restore(worldFolder, snapshotId, targetPath, &error);
+    return error;
+}
+}
+
+WorldRestoreTask::WorldRestoreTask(const QString &storePath, const QString &worldFolder, const QString &snapshotId, const QString &targetPath)
+    : m_storePath(storePath), m_worldFolder(worldFolder), m_snapshotId(snapshotId), m_targetPath(targetPath)
+{
+}
+
+void WorldRestoreTask::executeTask()
+{
+    setStatus(tr("Restoring world %1 from backup %2").arg(m_worldFolder, m_snapshotId));
+    m_future = QtConcurrent::run(QThreadPool::globalInstance(), restoreWorld, m_storePath, m_worldFolder, m_snapshotId, m_targetPath);
+    connect(&m_futureWatcher, &QFutureWatcher<QString>::finished, this, &WorldRestoreTask::restoreFinished);
+    m_futureWatcher.setFuture(m_future);
+}
+
+void WorldRestoreTask::restoreFinished()
+{
+    auto error = m_future.result();
+    if(!error.isEmpty())
+    {
+        emitFailed(error);
+        return;
+    }
+    emitSucceeded();
+}
@@ -0,0 +1,44 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "tasks/Task.h"
+#include <QFuture>
+#include <QFutureWatcher>
+
+/**
+ * Rebuilds a world from a snapshot in the world backup store, into a new world folder.
+ */
+class WorldRestoreTask : public Task
+{
+    Q_OBJECT
+public:
+    WorldRestoreTask(const QString &storePath, const QString &worldFolder, const QString &snapshotId, const QString &targetPath);
+
+protected:
+    virtual void executeTask() override;
+
+private slots:
+    void restoreFinished();
+
+private:
+    QString m_storePath;
+    QString m_worldFolder;
+    QString m_snapshotId;
+    QString m_targetPath;
+    QFuture<QString> m_future;
+    QFutureWatcher<QString> m_futureWatcher;
+};
@@ -0,0 +1,90 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BackupWorlds.h"
+#include "launch/LaunchTask.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/backup/WorldBackupStore.h"
+#include "MMCStrings.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QtConcurrentRun>
+
+void BackupWorlds::executeTask()
+{
+    auto instance = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    auto keep = instance->settings()->get("WorldBackupsToKeep").toInt();
+    emit logLine(tr("Backing up worlds..."), MessageLevel::Launcher);
+
+    m_future = QtConcurrent::run(QThreadPool::globalInstance(), &BackupWorlds::backupWorlds, instance->worldDir(), instance->worldBackupsDir(), keep);
+    connect(&m_futureWatcher, &QFutureWatcher<Report>::finished, this, &BackupWorlds::backupsFinished);
+    m_futureWatcher.setFuture(m_future);
+}
+
+void BackupWorlds::backupsFinished()
+{
+    auto report = m_future.result();
+    if(!report.messages.isEmpty())
+    {
+        emit logLines(report.messages, MessageLevel::Launcher);
+    }
+    if(!report.warnings.isEmpty())
+    {
+        emit logLines(report.warnings, MessageLevel::Warning);
+    }
+    emitSucceeded();
+}
+
+BackupWorlds::Report BackupWorlds::backupWorlds(const QString &worldsPath, const QString &storePath, int keep)
+{
+    Report report;
+    WorldBackupStore store(storePath);
+    QDir worlds(worldsPath);
+    for(auto &folder: worlds.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        auto worldPath = worlds.absoluteFilePath(folder);
+        if(!QFileInfo::exists(QDir(worldPath).absoluteFilePath("level.dat")))
+        {
+            continue;
+        }
+        QElapsedTimer timer;
+        timer.start();
+        QString error;
+        auto id = store.backup(worldPath, &error);
+        if(id.isEmpty())
+        {
+            report.warnings.append(error);
+            continue;
+        }
+        auto stats = store.lastStats();
+        report.messages.append(
+            tr("World %1: snapshot %2 in %3 ms, %4 files unchanged, %5 files read, %6 new objects (%7), %8 already stored")
+                .arg(folder, id)
+                .arg(timer.elapsed())
+                .arg(stats.filesReused)
+                .arg(stats.filesRead)
+                .arg(stats.objectsWritten)
+                .arg(Strings::humanReadableFileSize(stats.bytesWritten))
+                .arg(stats.objectsDeduplicated)
+        );
+        if(keep > 0 && !store.prune(folder, keep, &error))
+        {
+            report.warnings.append(error);
+        }
+    }
+    return report;
+}
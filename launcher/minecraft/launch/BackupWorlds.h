@@ -0,0 +1,53 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <launch/LaunchStep.h>
+#include <QFuture>
+#include <QFutureWatcher>
+
+/**
+ * Adds a snapshot of every world of the instance to its world backup store, then prunes old snapshots.
+ * Failing to back up a world is reported in the log, but does not fail the launch.
+ */
+class BackupWorlds: public LaunchStep
+{
+    Q_OBJECT
+public:
+    explicit BackupWorlds(LaunchTask *parent) : LaunchStep(parent) {};
+    virtual ~BackupWorlds(){};
+
+    virtual void executeTask() override;
+    virtual bool canAbort() const override
+    {
+        return false;
+    }
+
+private slots:
+    void backupsFinished();
+
+private:
+    struct Report
+    {
+        QStringList messages;
+        QStringList warnings;
+    };
+    static Report backupWorlds(const QString &worldsPath, const QString &storePath, int keep);
+
+private:
+    QFuture<Report> m_future;
+    QFutureWatcher<Report> m_futureWatcher;
+};
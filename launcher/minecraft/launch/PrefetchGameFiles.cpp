@@ -0,0 +1,300 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PrefetchGameFiles.h"
+#include "launch/LaunchTask.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "Application.h"
+#include "FileSystem.h"
+#include "MMCStrings.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <climits>
+#include <vector>
+#endif
+
+namespace {
+struct Prefetched
+{
+    qint64 bytes = 0;
+    qint64 resident = 0;
+};
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+#if defined(Q_OS_LINUX)
+typedef unsigned char MincoreVec;
+#else
+typedef char MincoreVec;
+#endif
+
+// how much of the file is in the page cache already
+qint64 residentBytes(int fd, off_t size)
+{
+    void *map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if(map == MAP_FAILED)
+    {
+        return 0;
+    }
+    const qint64 pageSize = sysconf(_SC_PAGESIZE);
+    std::vector<MincoreVec> pages((size + pageSize - 1) / pageSize);
+    qint64 resident = 0;
+    if(mincore(map, size, pages.data()) == 0)
+    {
+        for(auto page: pages)
+        {
+            if(page & 1)
+            {
+                resident += pageSize;
+            }
+        }
+    }
+    munmap(map, size);
+    return qMin<qint64>(resident, size);
+}
+
+Prefetched prefetchFile(const QString &path)
+{
+    Prefetched result;
+    int fd = open(QFile::encodeName(path).constData(), O_RDONLY);
+    if(fd < 0)
+    {
+        return result;
+    }
+    struct stat info;
+    if(fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        result.bytes = info.st_size;
+        result.resident = residentBytes(fd, info.st_size);
+        if(result.resident < result.bytes)
+        {
+            // queue the reads and return, the kernel does the rest in the background
+#if defined(Q_OS_LINUX)
+            posix_fadvise(fd, 0, info.st_size, POSIX_FADV_WILLNEED);
+#else
+            radvisory advice;
+            advice.ra_offset = 0;
+            advice.ra_count = int(qMin<off_t>(info.st_size, INT_MAX));
+            fcntl(fd, F_RDADVISE, &advice);
+#endif
+        }
+    }
+    close(fd);
+    return result;
+}
+#else
+// no portable readahead hint here, so just read the file and let the cache keep it
+Prefetched prefetchFile(const QString &path)
+{
+    Prefetched result;
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return result;
+    }
+    QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+    qint64 got;
+    while((got = file.read(buffer.data(), buffer.size())) > 0)
+    {
+        result.bytes += got;
+    }
+    return result;
+}
+#endif
+
+struct PrefetchFunctor
+{
+    typedef Prefetched result_type;
+
+    Prefetched operator()(const QString &path) const
+    {
+        if(*canceled)
+        {
+            return Prefetched();
+        }
+        return prefetchFile(path);
+    }
+    std::shared_ptr<std::atomic<bool>> canceled;
+};
+
+QStringList modFiles(const QString &path)
+{
+    QStringList files;
+    QDir dir(path);
+    for(auto &info: dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot, QDir::Name))
+    {
+        if(info.suffix() != "disabled")
+        {
+            files.append(info.absoluteFilePath());
+        }
+    }
+    return files;
+}
+}
+
+PrefetchGameFiles::~PrefetchGameFiles()
+{
+    if(m_canceled)
+    {
+        *m_canceled = true;
+    }
+}
+
+QString PrefetchGameFiles::fileListPath() const
+{
+    return FS::PathCombine(m_parent->instance()->instanceRoot(), "prefetch-files.txt");
+}
+
+QStringList PrefetchGameFiles::gameFiles(bool &complete) const
+{
+    QStringList files;
+    auto instance = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    auto components = instance->getPackProfile();
+    complete = components->isLoaded() && components->getProfile();
+    if(complete)
+    {
+        files << instance->getClassPath() << instance->getNativeJars();
+    }
+    return files;
+}
+
+void PrefetchGameFiles::executeTask()
+{
+    auto instance = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    bool complete = false;
+    auto files = gameFiles(complete);
+    if(!complete)
+    {
+        try
+        {
+            auto recorded = QString::fromUtf8(FS::read(fileListPath()));
+            files = recorded.split('\n', QString::SkipEmptyParts);
+        }
+        catch(const Exception &)
+        {
+            // first launch, nothing recorded yet
+        }
+    }
+    // the classpath is needed first, mods only once the game loads them
+    files << modFiles(instance->coreModsDir()) << modFiles(instance->loaderModsDir());
+    if(files.isEmpty())
+    {
+        emitSucceeded();
+        return;
+    }
+
+    auto budget = APPLICATION->settings()->get("PrefetchBudgetMiB").toLongLong() * 1024 * 1024;
+    m_canceled = std::make_shared<std::atomic<bool>>(false);
+    m_future = QtConcurrent::run(QThreadPool::globalInstance(), &PrefetchGameFiles::prefetch, files, budget, m_canceled);
+    connect(&m_futureWatcher, &QFutureWatcher<Result>::finished, this, &PrefetchGameFiles::prefetchFinished);
+    m_futureWatcher.setFuture(m_future);
+    // do not wait for it, the point is to overlap with the rest of the launch
+    emitSucceeded();
+}
+
+void PrefetchGameFiles::prefetchFinished()
+{
+    auto result = m_future.result();
+    if(!result.files)
+    {
+        return;
+    }
+    QString message = tr("Prefetched %1 game files (%2), %3 of it was already in memory.")
+                          .arg(result.files)
+                          .arg(Strings::humanReadableFileSize(result.bytes))
+                          .arg(Strings::humanReadableFileSize(result.resident));
+    if(result.budgetExceeded)
+    {
+        message += ' ' + tr("Some files were skipped to stay within the prefetch limit.");
+    }
+    emit logLine(message, MessageLevel::Launcher);
+}
+
+void PrefetchGameFiles::finalize()
+{
+    if(m_canceled)
+    {
+        *m_canceled = true;
+    }
+    // the launch has loaded the profile by now, remember its files for the next cold start
+    bool complete = false;
+    auto files = gameFiles(complete);
+    if(!complete)
+    {
+        return;
+    }
+    try
+    {
+        FS::write(fileListPath(), files.join('\n').toUtf8());
+    }
+    catch(const Exception &e)
+    {
+        qWarning() << "Couldn't record the files to prefetch:" << e.cause();
+    }
+}
+
+PrefetchGameFiles::Result PrefetchGameFiles::prefetch(const QStringList &files, qint64 budget, std::shared_ptr<std::atomic<bool>> canceled)
+{
+    Result result;
+    QStringList selected;
+    QSet<QString> seen;
+    qint64 total = 0;
+    for(auto &file: files)
+    {
+        if(seen.contains(file))
+        {
+            continue;
+        }
+        seen.insert(file);
+        QFileInfo info(file);
+        if(!info.isFile())
+        {
+            continue;
+        }
+        // keep going, smaller files further down may still fit
+        if(total + info.size() > budget)
+        {
+            result.budgetExceeded = true;
+            continue;
+        }
+        total += info.size();
+        selected.append(file);
+    }
+
+    PrefetchFunctor functor;
+    functor.canceled = canceled;
+    auto prefetched = QtConcurrent::blockingMapped<QVector<Prefetched>>(selected, functor);
+    for(auto &file: prefetched)
+    {
+        if(file.bytes)
+        {
+            result.files++;
+            result.bytes += file.bytes;
+            result.resident += file.resident;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,66 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <launch/LaunchStep.h>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <atomic>
+#include <memory>
+
+/**
+ * Asks the OS to start reading the libraries, natives and mods of the instance into the page cache.
+ *
+ * The step finishes right away and the prefetching continues in the background while the following launch steps
+ * run. When the launch profile has not been loaded yet, the file list recorded by the previous launch is used.
+ */
+class PrefetchGameFiles: public LaunchStep
+{
+    Q_OBJECT
+public:
+    explicit PrefetchGameFiles(LaunchTask *parent) : LaunchStep(parent) {};
+    virtual ~PrefetchGameFiles();
+
+    virtual void executeTask() override;
+    virtual bool canAbort() const override
+    {
+        return false;
+    }
+    virtual void finalize() override;
+
+public:
+    struct Result
+    {
+        int files = 0;
+        qint64 bytes = 0;
+        qint64 resident = 0;
+        bool budgetExceeded = false;
+    };
+    /// Prefetch the files in order, until the budget runs out
+    static Result prefetch(const QStringList &files, qint64 budget, std::shared_ptr<std::atomic<bool>> canceled);
+
+private slots:
+    void prefetchFinished();
+
+private:
+    QStringList gameFiles(bool &complete) const;
+    QString fileListPath() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_canceled;
+    QFuture<Result> m_future;
+    QFutureWatcher<Result> m_futureWatcher;
+};
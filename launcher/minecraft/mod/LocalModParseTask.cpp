@@ -474,5 +474,5 @@ void LocalModParseTask::run()
         default:
             break;
     }
-    emit finished(m_token);
+    emit finished(m_token, m_schedulerSlot);
 }
@@ -21,8 +21,13 @@ public:
     LocalModParseTask(int token, Mod::ModType type, const QFileInfo & modFile);
     void run();
 
+    /// The TaskScheduler request this runs under, handed back with finished() so its slot can be given back
+    void setSchedulerSlot(quint64 slot) {
+        m_schedulerSlot = slot;
+    }
+
 signals:
-    void finished(int token);
+    void finished(int token, quint64 schedulerSlot);
 
 private:
     void processAsZip();
@@ -31,6 +36,7 @@ private:
 
 private:
     int m_token;
+    quint64 m_schedulerSlot = 0;
     Mod::ModType m_type;
     QFileInfo m_modFile;
     ResultPtr m_result;
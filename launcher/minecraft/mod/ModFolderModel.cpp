@@ -25,6 +25,7 @@
 #include <QThreadPool>
 #include <algorithm>
 #include "LocalModParseTask.h"
+#include "tasks/TaskScheduler.h"
 
 ModFolderModel::ModFolderModel(const QString &dir) : QAbstractListModel(), m_dir(dir)
 {
@@ -180,13 +181,23 @@ void ModFolderModel::resolveMod(Mod& m)
     activeTickets.insert(nextResolutionTicket, result);
     m.setResolving(true, nextResolutionTicket);
     nextResolutionTicket++;
-    QThreadPool *threadPool = QThreadPool::globalInstance();
     connect(task, &LocalModParseTask::finished, this, &ModFolderModel::finishModParse);
-    threadPool->start(task);
+    // the model is the context, so its slots are given back when it goes away before the task finishes.
+    // a task that never started is deleted along with its request.
+    // it only reads a few small entries of each jar, so it takes no Disk slot and does not queue behind bulk file work.
+    auto pending = std::make_shared<std::unique_ptr<LocalModParseTask>>(task);
+    auto slot = TaskScheduler::instance()->request(this, tr("Reading mod %1").arg(m.filename().fileName()),
+                                                   TaskScheduler::Priority::Background, TaskScheduler::Cpu, [pending]()
+    {
+        QThreadPool::globalInstance()->start(pending->release());
+    });
+    // the task starts from the event loop at the earliest, so it has its slot before it runs
+    task->setSchedulerSlot(slot);
 }
 
-void ModFolderModel::finishModParse(int token)
+void ModFolderModel::finishModParse(int token, quint64 schedulerSlot)
 {
+    TaskScheduler::instance()->release(schedulerSlot);
     auto iter = activeTickets.find(token);
     if(iter == activeTickets.end()) {
         return;
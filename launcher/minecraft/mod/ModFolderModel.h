@@ -125,7 +125,7 @@ private
 slots:
     void directoryChanged(QString path);
     void finishUpdate();
-    void finishModParse(int token);
+    void finishModParse(int token, quint64 schedulerSlot);
 
 signals:
     void updateFinished();
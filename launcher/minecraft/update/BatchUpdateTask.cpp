@@ -0,0 +1,253 @@
+#include "BatchUpdateTask.h"
+
+#include <QJsonArray>
+
+#include "DownloadPlanTask.h"
+#include "FoldersTask.h"
+#include "LaunchManifestTask.h"
+#include "net/NetworkStats.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+
+#include "Application.h"
+
+BatchUpdateTask::BatchUpdateTask(const QList<InstancePtr> & instances, int maxConcurrentDownloads)
+    : m_maxConcurrentDownloads(maxConcurrentDownloads)
+{
+    for(auto inst: instances)
+    {
+        Entry entry;
+        entry.inst = inst;
+        entry.minecraft = dynamic_cast<MinecraftInstance *>(inst.get());
+        if(!entry.minecraft)
+        {
+            entry.error = tr("Only Minecraft instances can be updated.");
+        }
+        m_entries.append(entry);
+    }
+}
+
+void BatchUpdateTask::executeTask()
+{
+    m_totalTimer.start();
+    m_current = -1;
+    prepareNext();
+}
+
+void BatchUpdateTask::prepareNext()
+{
+    m_current++;
+    if(m_aborted)
+    {
+        finish();
+        return;
+    }
+    if(m_current == m_entries.size())
+    {
+        startDownloads();
+        return;
+    }
+    auto &entry = m_entries[m_current];
+    if(!entry.error.isEmpty())
+    {
+        prepareNext();
+        return;
+    }
+    setStatus(tr("Updating metadata of %1...").arg(entry.inst->name()));
+    setProgress(m_current, m_entries.size());
+    m_stepTimer.start();
+
+    FoldersTask folders(entry.minecraft);
+    folders.start();
+    if(!folders.wasSuccessful())
+    {
+        entry.error = folders.failReason();
+        prepareNext();
+        return;
+    }
+
+    auto components = entry.minecraft->getPackProfile();
+    components->reload(Net::Mode::Online);
+    m_task = components->getCurrentTask();
+    if(!m_task)
+    {
+        prepareFinished();
+        return;
+    }
+    connect(m_task.get(), &Task::finished, this, &BatchUpdateTask::prepareFinished);
+    if(m_task->isFinished())
+    {
+        prepareFinished();
+    }
+    else if(!m_task->isRunning())
+    {
+        m_task->start();
+    }
+}
+
+void BatchUpdateTask::prepareFinished()
+{
+    auto &entry = m_entries[m_current];
+    entry.metadataMs = m_stepTimer.elapsed();
+    if(m_task)
+    {
+        m_task->disconnect(this);
+        if(!m_task->wasSuccessful())
+        {
+            entry.error = m_task->failReason();
+        }
+        m_task.reset();
+    }
+    prepareNext();
+}
+
+void BatchUpdateTask::startDownloads()
+{
+    QList<MinecraftInstance *> instances;
+    for(int i = 0; i < m_entries.size(); i++)
+    {
+        if(m_entries[i].error.isEmpty())
+        {
+            m_planned.append(i);
+            instances.append(m_entries[i].minecraft);
+        }
+    }
+    if(instances.isEmpty())
+    {
+        finish();
+        return;
+    }
+    m_stepTimer.start();
+    m_plan.reset(new DownloadPlanTask(instances));
+    m_plan->setMaxConcurrentDownloads(m_maxConcurrentDownloads);
+    connect(m_plan.get(), &Task::finished, this, &BatchUpdateTask::downloadsFinished);
+    connect(m_plan.get(), &Task::progress, this, &BatchUpdateTask::setProgress);
+    connect(m_plan.get(), &Task::status, this, &BatchUpdateTask::setStatus);
+    m_plan->start();
+}
+
+void BatchUpdateTask::downloadsFinished()
+{
+    m_downloadMs = m_stepTimer.elapsed();
+    m_requestedDownloads = m_plan->requestedDownloads();
+    m_plannedDownloads = m_plan->plannedDownloads();
+    for(int i = 0; i < m_planned.size(); i++)
+    {
+        auto &entry = m_entries[m_planned[i]];
+        entry.downloads = m_plan->instanceDownloads(i);
+        entry.error = m_plan->instanceError(i);
+    }
+    m_plan->disconnect(this);
+    m_plan.reset();
+
+    if(!APPLICATION->settings()->get("WarmLaunch").toBool())
+    {
+        finish();
+        return;
+    }
+    m_current = -1;
+    recordNext();
+}
+
+void BatchUpdateTask::recordNext()
+{
+    m_current++;
+    while(m_current < m_entries.size() && !m_entries[m_current].error.isEmpty())
+    {
+        m_current++;
+    }
+    if(m_aborted || m_current == m_entries.size())
+    {
+        finish();
+        return;
+    }
+    auto &entry = m_entries[m_current];
+    setStatus(tr("Recording the game files of %1...").arg(entry.inst->name()));
+    m_stepTimer.start();
+    m_task.reset(new LaunchManifestTask(entry.minecraft, LaunchManifestTask::Mode::Record));
+    connect(m_task.get(), &Task::finished, this, &BatchUpdateTask::recordFinished);
+    m_task->start();
+}
+
+void BatchUpdateTask::recordFinished()
+{
+    m_entries[m_current].manifestMs = m_stepTimer.elapsed();
+    m_task->disconnect(this);
+    m_task.reset();
+    recordNext();
+}
+
+void BatchUpdateTask::finish()
+{
+    int failed = 0;
+    for(auto &entry: m_entries)
+    {
+        if(!entry.error.isEmpty())
+        {
+            failed++;
+        }
+    }
+    if(m_aborted)
+    {
+        emitAborted();
+    }
+    else if(failed)
+    {
+        emitFailed(tr("%1 of %2 instances could not be updated.").arg(failed).arg(m_entries.size()));
+    }
+    else
+    {
+        emitSucceeded();
+    }
+}
+
+QJsonObject BatchUpdateTask::report() const
+{
+    QJsonArray instances;
+    for(auto &entry: m_entries)
+    {
+        QJsonObject object;
+        object.insert("id", entry.inst->id());
+        object.insert("name", entry.inst->name());
+        object.insert("succeeded", entry.error.isEmpty());
+        if(!entry.error.isEmpty())
+        {
+            object.insert("error", entry.error);
+        }
+        object.insert("metadataMs", double(entry.metadataMs));
+        object.insert("downloads", entry.downloads);
+        object.insert("manifestMs", double(entry.manifestMs));
+        instances.append(object);
+    }
+    QJsonObject downloads;
+    downloads.insert("requested", m_requestedDownloads);
+    downloads.insert("planned", m_plannedDownloads);
+    downloads.insert("ms", double(m_downloadMs));
+    downloads.insert("hosts", Net::NetworkStats::instance()->hostsToJson());
+
+    QJsonObject root;
+    root.insert("succeeded", wasSuccessful());
+    root.insert("totalMs", double(m_totalTimer.isValid() ? m_totalTimer.elapsed() : 0));
+    root.insert("downloads", downloads);
+    root.insert("instances", instances);
+    return root;
+}
+
+bool BatchUpdateTask::canAbort() const
+{
+    return true;
+}
+
+bool BatchUpdateTask::abort()
+{
+    m_aborted = true;
+    if(m_plan)
+    {
+        return m_plan->abort();
+    }
+    if(m_task && m_task->canAbort())
+    {
+        return m_task->abort();
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "tasks/Task.h"
+#include "BaseInstance.h"
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+
+class MinecraftInstance;
+class DownloadPlanTask;
+
+/**
+ * Updates several instances in one go, used by the --update command line mode.
+ *
+ * The metadata of the instances is refreshed one instance at a time. Then the game files of all of them are fetched as
+ * a single download plan, so files shared by the instances are only downloaded and checked once. An instance failing
+ * does not stop the others.
+ */
+class BatchUpdateTask : public Task
+{
+    Q_OBJECT
+public:
+    explicit BatchUpdateTask(const QList<InstancePtr> & instances, int maxConcurrentDownloads = 6);
+    virtual ~BatchUpdateTask() {};
+
+    void executeTask() override;
+
+    bool canAbort() const override;
+
+    /// Results and timings of every instance, and of the shared downloads
+    QJsonObject report() const;
+
+public slots:
+    bool abort() override;
+
+private:
+    void prepareNext();
+    void prepareFinished();
+    void startDownloads();
+    void downloadsFinished();
+    void recordNext();
+    void recordFinished();
+    void finish();
+
+private:
+    struct Entry
+    {
+        InstancePtr inst;
+        MinecraftInstance *minecraft = nullptr;
+        QString error;
+        qint64 metadataMs = 0;
+        qint64 manifestMs = 0;
+        int downloads = 0;
+    };
+    QList<Entry> m_entries;
+    int m_current = -1;
+    int m_maxConcurrentDownloads;
+    bool m_aborted = false;
+    Task::Ptr m_task;
+    shared_qobject_ptr<DownloadPlanTask> m_plan;
+    QList<int> m_planned;
+    QElapsedTimer m_totalTimer;
+    QElapsedTimer m_stepTimer;
+    qint64 m_downloadMs = 0;
+    int m_requestedDownloads = 0;
+    int m_plannedDownloads = 0;
+};
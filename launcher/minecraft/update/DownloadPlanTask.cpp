@@ -0,0 +1,340 @@
+#include "DownloadPlanTask.h"
+#include "FMLLibrariesTask.h"
+
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "minecraft/AssetsUtils.h"
+#include "net/NetworkStats.h"
+
+#include "BuildConfig.h"
+#include "Application.h"
+
+DownloadPlanTask::DownloadPlanTask(MinecraftInstance * inst) : DownloadPlanTask(QList<MinecraftInstance *>() << inst)
+{
+}
+
+DownloadPlanTask::DownloadPlanTask(const QList<MinecraftInstance *> & instances)
+{
+    for(auto inst: instances)
+    {
+        InstanceState state;
+        state.inst = inst;
+        m_instances.append(state);
+    }
+}
+
+void DownloadPlanTask::executeTask()
+{
+    setStatus(tr("Downloading game files..."));
+    if(m_instances.size() == 1)
+    {
+        m_job.reset(new NetJob(tr("Game files for instance %1").arg(m_instances[0].inst->name())));
+    }
+    else
+    {
+        m_job.reset(new NetJob(tr("Game files for %1 instances").arg(m_instances.size())));
+    }
+    m_job->setMaxConcurrentParts(m_maxConcurrent);
+    // somebody is waiting to play
+    m_job->setPriority(TaskScheduler::Priority::Interactive);
+    m_allowOptionalFailures = APPLICATION->settings()->get("AllowOptionalDownloadFailures").toBool();
+    m_job->setAllowOptionalFailures(m_allowOptionalFailures);
+
+    bool anyPlanned = false;
+    for(int i = 0; i < m_instances.size(); i++)
+    {
+        if(!planLibraries(i))
+        {
+            continue;
+        }
+        planFMLLibraries(i);
+        planAssetIndex(i);
+        anyPlanned = true;
+    }
+    if(!anyPlanned)
+    {
+        m_job.reset();
+        finish();
+        return;
+    }
+
+    connect(m_job.get(), &NetJob::succeeded, this, &DownloadPlanTask::downloadsFinished);
+    connect(m_job.get(), &NetJob::failed, this, &DownloadPlanTask::downloadsFailed);
+    connect(m_job.get(), &NetJob::progress, this, &DownloadPlanTask::progress);
+
+    qDebug() << "Starting" << m_planned.size() << "of" << m_requested << "requested downloads";
+    m_job->start(APPLICATION->network());
+}
+
+int DownloadPlanTask::plan(NetAction::Ptr action, int index, bool optional)
+{
+    m_requested++;
+    m_instances[index].downloads++;
+
+    // cached downloads are identified by where they end up, everything else by where it comes from
+    QString key;
+    auto dl = dynamic_cast<Net::Download *>(action.get());
+    if(dl)
+    {
+        key = dl->getTargetFilepath();
+    }
+    if(key.isEmpty())
+    {
+        key = action->url().toString();
+    }
+    auto iter = m_keys.find(key);
+    if(iter != m_keys.end())
+    {
+        auto &planned = m_planned[*iter];
+        if(!planned.users.contains(index))
+        {
+            planned.users.append(index);
+        }
+        return *iter;
+    }
+    Planned planned;
+    planned.action = action;
+    planned.optional = optional;
+    planned.users.append(index);
+    m_keys.insert(key, m_planned.size());
+    m_planned.append(planned);
+    m_job->addNetAction(action, optional);
+    return m_planned.size() - 1;
+}
+
+bool DownloadPlanTask::planLibraries(int index)
+{
+    auto &state = m_instances[index];
+    auto components = state.inst->getPackProfile();
+    auto profile = components->getProfile();
+    auto metacache = APPLICATION->metacache();
+
+    auto processArtifactPool = [&](const QList<LibraryPtr> & pool, QStringList & errors, const QString & localPath)
+    {
+        for (auto lib : pool)
+        {
+            if(!lib)
+            {
+                state.error = tr("Null jar is specified in the metadata, aborting.");
+                return false;
+            }
+            auto dls = lib->getDownloads(currentSystem, metacache.get(), errors, localPath);
+            for(auto dl : dls)
+            {
+                plan(dl, index);
+            }
+        }
+        return true;
+    };
+
+    QStringList failedLocalLibraries;
+    QList<LibraryPtr> libArtifactPool;
+    libArtifactPool.append(profile->getLibraries());
+    libArtifactPool.append(profile->getNativeLibraries());
+    libArtifactPool.append(profile->getMavenFiles());
+    libArtifactPool.append(profile->getMainJar());
+    if(!processArtifactPool(libArtifactPool, failedLocalLibraries, state.inst->getLocalLibraryPath()))
+    {
+        return false;
+    }
+
+    QStringList failedLocalJarMods;
+    if(!processArtifactPool(profile->getJarMods(), failedLocalJarMods, state.inst->jarModsDir()))
+    {
+        return false;
+    }
+
+    if (!failedLocalJarMods.empty() || !failedLocalLibraries.empty())
+    {
+        QString failed_all = (failedLocalLibraries + failedLocalJarMods).join("\n");
+        state.error = tr("Some artifacts marked as 'local' are missing their files:\n%1\n\nYou need to either add the files, or removed the packages that require them.\nYou'll have to correct this problem manually.").arg(failed_all);
+        return false;
+    }
+    return true;
+}
+
+void DownloadPlanTask::planFMLLibraries(int index)
+{
+    auto &state = m_instances[index];
+    state.fmlLibs = FMLLibrariesTask::missingLibraries(state.inst);
+    auto metacache = APPLICATION->metacache();
+    for (auto &lib : state.fmlLibs)
+    {
+        auto entry = metacache->resolveEntry("fmllibs", lib.filename);
+        QString urlString = BuildConfig.FMLLIBS_BASE_URL + lib.filename;
+        plan(Net::Download::makeCached(QUrl(urlString), entry), index);
+    }
+}
+
+void DownloadPlanTask::planAssetIndex(int index)
+{
+    auto components = m_instances[index].inst->getPackProfile();
+    auto profile = components->getProfile();
+    auto assets = profile->getMinecraftAssets();
+    QUrl indexUrl = assets->url;
+    QString localPath = assets->id + ".json";
+
+    auto metacache = APPLICATION->metacache();
+    auto entry = metacache->resolveEntry("asset_indexes", localPath);
+    auto key = entry->getFullPath();
+    if(m_keys.contains(key))
+    {
+        // another instance already fetches this index, and with it the assets
+        plan(Net::Download::makeCached(indexUrl, entry), index);
+        return;
+    }
+    entry->setStale(true);
+    auto hexSha1 = assets->sha1.toLatin1();
+    qDebug() << "Asset index SHA1:" << hexSha1;
+    auto rawSha1 = QByteArray::fromHex(assets->sha1.toLatin1());
+    auto dl = Net::Download::makeCached(indexUrl, entry, rawSha1);
+
+    int planned = plan(dl, index);
+    QString assetsId = assets->id;
+    // Slots run in the order they were connected, so this runs before the job sees the download finish.
+    // The assets it adds keep the job going.
+    connect(dl.get(), &NetAction::succeeded, this, [this, planned, assetsId]()
+    {
+        assetIndexDownloaded(planned, assetsId);
+    });
+}
+
+void DownloadPlanTask::assetIndexDownloaded(int planned, QString assetsId)
+{
+    AssetsIndex index;
+    qDebug() << "Finished asset index download for" << assetsId;
+
+    auto users = m_planned[planned].users;
+    QString asset_fname = "assets/indexes/" + assetsId + ".json";
+    // FIXME: this looks like a job for a generic validator based on json schema?
+    if (!AssetsUtils::loadAssetsIndexJson(assetsId, asset_fname, index))
+    {
+        auto metacache = APPLICATION->metacache();
+        auto entry = metacache->resolveEntry("asset_indexes", assetsId + ".json");
+        metacache->evictEntry(entry);
+        for(auto user: users)
+        {
+            m_instances[user].error = tr("Failed to read the assets index!");
+        }
+        return;
+    }
+
+    int before = m_planned.size();
+    for (auto &object : index.objects)
+    {
+        auto dl = object.getDownloadAction();
+        if(!dl)
+        {
+            continue;
+        }
+        // a missing sound or translation does not keep the game from starting
+        for(auto user: users)
+        {
+            plan(dl, user, true);
+        }
+    }
+    qDebug() << m_planned.size() - before << "assets to download for" << assetsId;
+}
+
+void DownloadPlanTask::downloadsFinished()
+{
+    finish();
+}
+
+void DownloadPlanTask::downloadsFailed(QString reason)
+{
+    qWarning() << "Some game files could not be downloaded:" << reason;
+    finish();
+}
+
+void DownloadPlanTask::finish()
+{
+    m_job.reset();
+    Net::NetworkStats::instance()->log();
+
+    QHash<int, QStringList> failedFiles;
+    QStringList skippedFiles;
+    for(auto &planned: m_planned)
+    {
+        if(planned.action->wasSuccessful())
+        {
+            continue;
+        }
+        if(planned.optional && m_allowOptionalFailures)
+        {
+            skippedFiles.append(planned.action->url().toString());
+            continue;
+        }
+        for(auto user: planned.users)
+        {
+            failedFiles[user].append(planned.action->url().toString());
+        }
+    }
+
+    if(!skippedFiles.isEmpty())
+    {
+        qWarning() << "Continuing without" << skippedFiles.size() << "optional files:" << skippedFiles;
+    }
+
+    int failed = 0;
+    for(int i = 0; i < m_instances.size(); i++)
+    {
+        auto &state = m_instances[i];
+        if(state.error.isEmpty() && failedFiles.contains(i))
+        {
+            auto files = failedFiles[i];
+            files.sort();
+            state.error = tr("Game update failed: it was impossible to fetch the required files.\nReason:\n%1").arg(files.join("\n"));
+        }
+        if(state.error.isEmpty() && !state.fmlLibs.isEmpty())
+        {
+            setStatus(tr("Copying FML libraries into the instance..."));
+            FMLLibrariesTask::installLibraries(state.inst, state.fmlLibs, state.error);
+        }
+        if(!state.error.isEmpty())
+        {
+            failed++;
+        }
+    }
+
+    if(!failed)
+    {
+        emitSucceeded();
+    }
+    else if(m_instances.size() == 1)
+    {
+        emitFailed(m_instances[0].error);
+    }
+    else
+    {
+        emitFailed(tr("%1 of %2 instances could not be updated.").arg(failed).arg(m_instances.size()));
+    }
+}
+
+QString DownloadPlanTask::instanceError(int index) const
+{
+    return m_instances[index].error;
+}
+
+int DownloadPlanTask::instanceDownloads(int index) const
+{
+    return m_instances[index].downloads;
+}
+
+bool DownloadPlanTask::canAbort() const
+{
+    return true;
+}
+
+bool DownloadPlanTask::abort()
+{
+    if(m_job)
+    {
+        return m_job->abort();
+    }
+    else
+    {
+        qWarning() << "Prematurely aborted DownloadPlanTask";
+    }
+    return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "tasks/Task.h"
+#include "net/NetJob.h"
+#include "minecraft/VersionFilterData.h"
+
+#include <QHash>
+
+class MinecraftInstance;
+
+/**
+ * Downloads every file of one or more resolved profiles as a single job: libraries, natives, jar mods, FML libraries,
+ * the asset indexes and the assets.
+ *
+ * The assets are added to the running job as soon as their index arrives, so they do not wait for the libraries.
+ * Files wanted by more than one part of a profile, or by more than one instance, are only downloaded once.
+ *
+ * With several instances, a file that could not be downloaded only fails the instances that needed it. The task
+ * itself fails if any of the instances did. Assets that could not be downloaded fail nobody while the
+ * AllowOptionalDownloadFailures setting is on.
+ */
+class DownloadPlanTask : public Task
+{
+    Q_OBJECT
+public:
+    explicit DownloadPlanTask(MinecraftInstance * inst);
+    explicit DownloadPlanTask(const QList<MinecraftInstance *> & instances);
+    virtual ~DownloadPlanTask() {};
+
+    void executeTask() override;
+
+    bool canAbort() const override;
+
+    /// How many downloads run at the same time
+    void setMaxConcurrentDownloads(int count)
+    {
+        m_maxConcurrent = count;
+    }
+
+    /// Why the files of the instance at `index` could not be updated, empty if they were
+    QString instanceError(int index) const;
+
+    /// Downloads the instance at `index` needed, including the ones shared with other instances
+    int instanceDownloads(int index) const;
+
+    /// Downloads asked for by all instances, and how many were left after removing duplicates
+    int requestedDownloads() const
+    {
+        return m_requested;
+    }
+    int plannedDownloads() const
+    {
+        return m_planned.size();
+    }
+
+private slots:
+    void downloadsFinished();
+    void downloadsFailed(QString reason);
+
+public slots:
+    bool abort() override;
+
+private:
+    bool planLibraries(int index);
+    void planFMLLibraries(int index);
+    void planAssetIndex(int index);
+    int plan(NetAction::Ptr action, int index, bool optional = false);
+    void assetIndexDownloaded(int planned, QString assetsId);
+    void finish();
+
+private:
+    struct Planned
+    {
+        NetAction::Ptr action;
+        bool optional = false;
+        QList<int> users;
+    };
+    struct InstanceState
+    {
+        MinecraftInstance *inst = nullptr;
+        QList<FMLlib> fmlLibs;
+        QString error;
+        int downloads = 0;
+    };
+    QList<InstanceState> m_instances;
+    NetJob::Ptr m_job;
+    QHash<QString, int> m_keys;
+    QList<Planned> m_planned;
+    int m_requested = 0;
+    int m_maxConcurrent = 6;
+    bool m_allowOptionalFailures = false;
+};
@@ -12,45 +12,67 @@ FMLLibrariesTask::FMLLibrariesTask(MinecraftInstance * inst)
 {
     m_inst = inst;
 }
-void FMLLibrariesTask::executeTask()
+
+QList<FMLlib> FMLLibrariesTask::missingLibraries(MinecraftInstance * inst)
 {
-    // Get the mod list
-    MinecraftInstance *inst = (MinecraftInstance *)m_inst;
+    QList<FMLlib> missing;
     auto components = inst->getPackProfile();
     auto profile = components->getProfile();
 
     if (!profile->hasTrait("legacyFML"))
     {
-        emitSucceeded();
-        return;
+        return missing;
     }
 
     QString version = components->getComponentVersion("net.minecraft");
     auto &fmlLibsMapping = g_VersionFilterData.fmlLibsMapping;
     if (!fmlLibsMapping.contains(version))
     {
-        emitSucceeded();
-        return;
+        return missing;
     }
 
-    auto &libList = fmlLibsMapping[version];
-
     // determine if we need some libs for FML or forge
-    setStatus(tr("Checking for FML libraries..."));
     if(!components->getComponent("net.minecraftforge"))
     {
-        emitSucceeded();
-        return;
+        return missing;
     }
 
     // now check the lib folder inside the instance for files.
-    for (auto &lib : libList)
+    for (auto &lib : fmlLibsMapping[version])
     {
         QFileInfo libInfo(FS::PathCombine(inst->libDir(), lib.filename));
         if (libInfo.exists())
             continue;
-        fmlLibsToProcess.append(lib);
+        missing.append(lib);
     }
+    return missing;
+}
+
+bool FMLLibrariesTask::installLibraries(MinecraftInstance * inst, const QList<FMLlib> & libs, QString & error)
+{
+    auto metacache = APPLICATION->metacache();
+    for (auto &lib : libs)
+    {
+        auto entry = metacache->resolveEntry("fmllibs", lib.filename);
+        auto path = FS::PathCombine(inst->libDir(), lib.filename);
+        if (!FS::ensureFilePathExists(path))
+        {
+            error = tr("Failed creating FML library folder inside the instance.");
+            return false;
+        }
+        if (!QFile::copy(entry->getFullPath(), path))
+        {
+            error = tr("Failed copying Forge/FML library: %1.").arg(lib.filename);
+            return false;
+        }
+    }
+    return true;
+}
+
+void FMLLibrariesTask::executeTask()
+{
+    setStatus(tr("Checking for FML libraries..."));
+    fmlLibsToProcess = missingLibraries(m_inst);
 
     // if everything is in place, there's nothing to do here...
     if (fmlLibsToProcess.isEmpty())
@@ -62,6 +84,7 @@ void FMLLibrariesTask::executeTask()
     // download missing libs to our place
     setStatus(tr("Downloading FML libraries..."));
     auto dljob = new NetJob("FML libraries");
+    dljob->setPriority(TaskScheduler::Priority::Interactive);
     auto metacache = APPLICATION->metacache();
     for (auto &lib : fmlLibsToProcess)
     {
@@ -88,27 +111,12 @@ void FMLLibrariesTask::fmllibsFinished()
     if (!fmlLibsToProcess.isEmpty())
     {
         setStatus(tr("Copying FML libraries into the instance..."));
-        MinecraftInstance *inst = (MinecraftInstance *)m_inst;
-        auto metacache = APPLICATION->metacache();
-        int index = 0;
-        for (auto &lib : fmlLibsToProcess)
+        QString error;
+        if (!installLibraries(m_inst, fmlLibsToProcess, error))
         {
-            progress(index, fmlLibsToProcess.size());
-            auto entry = metacache->resolveEntry("fmllibs", lib.filename);
-            auto path = FS::PathCombine(inst->libDir(), lib.filename);
-            if (!FS::ensureFilePathExists(path))
-            {
-                emitFailed(tr("Failed creating FML library folder inside the instance."));
-                return;
-            }
-            if (!QFile::copy(entry->getFullPath(), FS::PathCombine(inst->libDir(), lib.filename)))
-            {
-                emitFailed(tr("Failed copying Forge/FML library: %1.").arg(lib.filename));
-                return;
-            }
-            index++;
+            emitFailed(error);
+            return;
         }
-        progress(index, fmlLibsToProcess.size());
     }
     emitSucceeded();
 }
@@ -16,6 +16,12 @@ public:
 
     bool canAbort() const override;
 
+    /// FML libraries the instance needs, but does not have in its lib folder yet
+    static QList<FMLlib> missingLibraries(MinecraftInstance * inst);
+
+    /// Copy FML libraries downloaded into the metadata cache into the instance
+    static bool installLibraries(MinecraftInstance * inst, const QList<FMLlib> & libs, QString & error);
+
 private slots:
     void fmllibsFinished();
     void fmllibsFailed(QString reason);
@@ -0,0 +1,189 @@
+#include "LaunchManifest.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+#include "Exception.h"
+#include "Json.h"
+#include "MultiHash.h"
+
+namespace {
+struct BuildItem
+{
+    LaunchManifest::File file;
+    bool known = false;
+    QString error;
+};
+
+void inspect(BuildItem &item)
+{
+    QFileInfo info(item.file.path);
+    if(!info.isFile())
+    {
+        item.error = QObject::tr("%1 is missing").arg(item.file.path);
+        return;
+    }
+    auto size = info.size();
+    auto modified = info.lastModified().toMSecsSinceEpoch();
+    if(item.known && item.file.size == size && item.file.modified == modified)
+    {
+        return;
+    }
+    item.file.size = size;
+    item.file.modified = modified;
+    item.file.sha1 = MultiHash::hashFile(item.file.path, QCryptographicHash::Sha1);
+    if(item.file.sha1.isEmpty())
+    {
+        item.error = QObject::tr("%1 could not be read").arg(item.file.path);
+    }
+}
+
+QString check(const LaunchManifest::File &file)
+{
+    QFileInfo info(file.path);
+    if(!info.isFile() || info.size() != file.size)
+    {
+        return file.path;
+    }
+    if(info.lastModified().toMSecsSinceEpoch() == file.modified)
+    {
+        return QString();
+    }
+    if(MultiHash::hashFile(file.path, QCryptographicHash::Sha1) != file.sha1)
+    {
+        return file.path;
+    }
+    return QString();
+}
+}
+
+bool LaunchManifest::build(const QByteArray &fingerprint, const QStringList &paths, const LaunchManifest &previous,
+                           LaunchManifest &out, QString *error)
+{
+    QHash<QString, const File *> known;
+    for(auto &file: previous.files)
+    {
+        known.insert(file.path, &file);
+    }
+
+    QVector<BuildItem> items;
+    items.reserve(paths.size());
+    for(auto &path: paths)
+    {
+        BuildItem item;
+        auto iter = known.find(path);
+        if(iter != known.end())
+        {
+            item.file = **iter;
+            item.known = true;
+        }
+        else
+        {
+            item.file.path = path;
+        }
+        items.append(item);
+    }
+
+    QtConcurrent::blockingMap(items, inspect);
+
+    out = LaunchManifest();
+    out.fingerprint = fingerprint;
+    out.updated = QDateTime::currentDateTimeUtc();
+    for(auto &item: items)
+    {
+        if(!item.error.isEmpty())
+        {
+            if(error)
+            {
+                *error = item.error;
+            }
+            return false;
+        }
+        out.files.append(item.file);
+    }
+    return true;
+}
+
+QStringList LaunchManifest::verify() const
+{
+    auto results = QtConcurrent::blockingMapped<QStringList>(files, check);
+    results.removeAll(QString());
+    return results;
+}
+
+bool LaunchManifest::isFresh(qint64 maxAgeSecs) const
+{
+    if(!updated.isValid())
+    {
+        return false;
+    }
+    // a clock that went backwards makes the age meaningless, so that does not count as fresh either
+    auto age = updated.secsTo(QDateTime::currentDateTimeUtc());
+    return age >= 0 && age < maxAgeSecs;
+}
+
+bool LaunchManifest::load(const QString &path, LaunchManifest &out)
+{
+    out = LaunchManifest();
+    if(!QFile::exists(path))
+    {
+        return false;
+    }
+    try
+    {
+        auto root = Json::requireObject(Json::requireDocument(path, "Launch manifest"), "Launch manifest");
+        if(Json::requireInteger(root, "formatVersion") != 1)
+        {
+            return false;
+        }
+        out.fingerprint = QByteArray::fromHex(Json::requireString(root, "fingerprint").toLatin1());
+        out.updated = QDateTime::fromMSecsSinceEpoch(qint64(Json::requireDouble(root, "updated")), Qt::UTC);
+        for(auto value: Json::requireArray(root, "files"))
+        {
+            auto object = Json::requireObject(value);
+            File file;
+            file.path = Json::requireString(object, "path");
+            file.size = Json::requireDouble(object, "size");
+            file.modified = Json::requireDouble(object, "modified");
+            file.sha1 = QByteArray::fromHex(Json::requireString(object, "sha1").toLatin1());
+            out.files.append(file);
+        }
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << "Ignoring broken launch manifest" << path << ":" << e.cause();
+        out = LaunchManifest();
+        return false;
+    }
+    return true;
+}
+
+bool LaunchManifest::save(const QString &path) const
+{
+    QJsonArray filesArray;
+    for(auto &file: files)
+    {
+        QJsonObject object;
+        object.insert("path", file.path);
+        object.insert("size", double(file.size));
+        object.insert("modified", double(file.modified));
+        object.insert("sha1", QString::fromLatin1(file.sha1.toHex()));
+        filesArray.append(object);
+    }
+    QJsonObject root;
+    root.insert("formatVersion", 1);
+    root.insert("fingerprint", QString::fromLatin1(fingerprint.toHex()));
+    root.insert("updated", double(updated.toMSecsSinceEpoch()));
+    root.insert("files", filesArray);
+    try
+    {
+        Json::write(root, path);
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << "Could not save launch manifest" << path << ":" << e.cause();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Record of every file a launch needed, as it was after the last successful online update of an instance.
+ *
+ * When the resolved profile still has the same fingerprint and the record is recent enough, checking the files against
+ * it is enough to know the instance can start, without asking any server whether something changed.
+ */
+struct LaunchManifest
+{
+    struct File
+    {
+        QString path;
+        qint64 size = 0;
+        qint64 modified = 0;
+        QByteArray sha1;
+    };
+
+    /**
+     * Record the given files as they are on disk now. Hashes of files that did not change size or modification time
+     * since `previous` was built are reused, everything else is hashed in parallel.
+     * Fails if any of the files is missing or unreadable.
+     */
+    static bool build(const QByteArray &fingerprint, const QStringList &paths, const LaunchManifest &previous,
+                      LaunchManifest &out, QString *error = nullptr);
+
+    /**
+     * Check the files on disk, in parallel. Returns the files that are missing or changed.
+     * Files with a different modification time but the same size are hashed again, so touching a file does not
+     * count as a change.
+     */
+    QStringList verify() const;
+
+    /// true if the manifest was built less than `maxAgeSecs` ago
+    bool isFresh(qint64 maxAgeSecs) const;
+
+    static bool load(const QString &path, LaunchManifest &out);
+    bool save(const QString &path) const;
+
+    QByteArray fingerprint;
+    QDateTime updated;
+    QList<File> files;
+};
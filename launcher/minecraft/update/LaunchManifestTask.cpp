@@ -0,0 +1,184 @@
+#include "LaunchManifestTask.h"
+
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "minecraft/Component.h"
+#include "minecraft/AssetsUtils.h"
+#include "minecraft/OpSys.h"
+
+#include "Application.h"
+
+LaunchManifestTask::LaunchManifestTask(MinecraftInstance * inst, Mode mode)
+{
+    m_inst = inst;
+    m_mode = mode;
+}
+
+void LaunchManifestTask::executeTask()
+{
+    if(m_mode == Mode::Verify)
+    {
+        setStatus(tr("Checking game files..."));
+    }
+    auto components = m_inst->getPackProfile();
+    auto profile = components->getProfile();
+    if(!profile)
+    {
+        emitFailed(tr("The instance has no resolved profile."));
+        return;
+    }
+    m_manifestPath = m_inst->launchManifestLocation();
+    m_maxAgeSecs = qint64(APPLICATION->settings()->get("WarmLaunchMaxAgeHours").toInt()) * 3600;
+
+    // the same files DownloadPlanTask::planLibraries fetches
+    auto addLibraries = [&](const QList<LibraryPtr> & pool, const QString & overridePath)
+    {
+        for(auto lib: pool)
+        {
+            if(!lib)
+            {
+                continue;
+            }
+            QStringList native32, native64;
+            lib->getApplicableFiles(currentSystem, m_required, m_required, native32, native64, overridePath);
+            // only the variants that actually have downloads end up on disk
+            m_optional += native32;
+            m_optional += native64;
+        }
+    };
+    QList<LibraryPtr> libraries;
+    libraries.append(profile->getLibraries());
+    libraries.append(profile->getNativeLibraries());
+    libraries.append(profile->getMavenFiles());
+    libraries.append(profile->getMainJar());
+    addLibraries(libraries, m_inst->getLocalLibraryPath());
+    addLibraries(profile->getJarMods(), m_inst->jarModsDir());
+    m_required.sort();
+    m_required.removeDuplicates();
+
+    auto assets = profile->getMinecraftAssets();
+    if(assets)
+    {
+        m_assetsId = assets->id;
+        m_assetIndexPath = "assets/indexes/" + assets->id + ".json";
+    }
+
+    QCryptographicHash fingerprint(QCryptographicHash::Sha1);
+    for(int i = 0; i < components->rowCount(); i++)
+    {
+        auto component = components->getComponent(i);
+        fingerprint.addData((component->getID() + '=' + component->getVersion() + '\n').toUtf8());
+    }
+    for(auto &path: m_required)
+    {
+        fingerprint.addData((path + '\n').toUtf8());
+    }
+    if(assets)
+    {
+        fingerprint.addData((assets->id + '=' + assets->sha1 + '\n').toUtf8());
+    }
+    m_fingerprint = fingerprint.result();
+
+    connect(&m_watcher, &QFutureWatcher<QString>::finished, this, &LaunchManifestTask::workFinished);
+    m_future = QtConcurrent::run(this, &LaunchManifestTask::work);
+    m_watcher.setFuture(m_future);
+}
+
+QString LaunchManifestTask::work()
+{
+    return m_mode == Mode::Verify ? verify() : record();
+}
+
+QString LaunchManifestTask::verify()
+{
+    LaunchManifest manifest;
+    if(!LaunchManifest::load(m_manifestPath, manifest))
+    {
+        return tr("There is no launch manifest.");
+    }
+    if(!manifest.isFresh(m_maxAgeSecs))
+    {
+        return tr("The launch manifest is too old.");
+    }
+    if(manifest.fingerprint != m_fingerprint)
+    {
+        return tr("The instance changed since the last update.");
+    }
+    auto changed = manifest.verify();
+    if(!changed.isEmpty())
+    {
+        return tr("Some game files are missing or changed:\n%1").arg(changed.join("\n"));
+    }
+    return QString();
+}
+
+QString LaunchManifestTask::record()
+{
+    auto paths = m_required;
+    for(auto &path: m_optional)
+    {
+        if(QFileInfo(path).isFile())
+        {
+            paths.append(path);
+        }
+    }
+    if(!m_assetIndexPath.isEmpty())
+    {
+        AssetsIndex index;
+        if(!AssetsUtils::loadAssetsIndexJson(m_assetsId, m_assetIndexPath, index))
+        {
+            return tr("Failed to read the assets index!");
+        }
+        paths.append(m_assetIndexPath);
+        // asset objects are optional downloads, the update may have succeeded without some of them
+        for(auto &object: index.objects)
+        {
+            auto path = object.getLocalPath();
+            if(QFileInfo(path).isFile())
+            {
+                paths.append(path);
+            }
+        }
+        paths.removeDuplicates();
+    }
+
+    LaunchManifest previous;
+    LaunchManifest::load(m_manifestPath, previous);
+    LaunchManifest manifest;
+    QString error;
+    if(!LaunchManifest::build(m_fingerprint, paths, previous, manifest, &error))
+    {
+        return error;
+    }
+    if(!manifest.save(m_manifestPath))
+    {
+        return tr("Could not save the launch manifest.");
+    }
+    return QString();
+}
+
+void LaunchManifestTask::workFinished()
+{
+    auto error = m_future.result();
+    if(m_mode == Mode::Record)
+    {
+        // without a manifest the next launch just takes the slow path, so this is not worth failing the update over
+        if(!error.isEmpty())
+        {
+            qWarning() << m_inst->name() << ": Could not record the launch manifest:" << error;
+            QFile::remove(m_manifestPath);
+        }
+        emitSucceeded();
+        return;
+    }
+    if(!error.isEmpty())
+    {
+        emitFailed(error);
+        return;
+    }
+    emitSucceeded();
+}
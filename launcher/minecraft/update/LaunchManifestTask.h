@@ -0,0 +1,51 @@
+#pragma once
+#include "tasks/Task.h"
+#include "LaunchManifest.h"
+
+#include <QFuture>
+#include <QFutureWatcher>
+
+class MinecraftInstance;
+
+/**
+ * Checks the instance's files against its launch manifest (Verify), or writes a new manifest after a successful
+ * online update (Record).
+ *
+ * Verify fails if the manifest is missing, too old, was made for a different profile, or any file changed.
+ */
+class LaunchManifestTask : public Task
+{
+    Q_OBJECT
+public:
+    enum class Mode
+    {
+        Verify,
+        Record
+    };
+
+    LaunchManifestTask(MinecraftInstance * inst, Mode mode);
+    virtual ~LaunchManifestTask() {};
+
+    void executeTask() override;
+
+private slots:
+    void workFinished();
+
+private:
+    QString work();
+    QString verify();
+    QString record();
+
+private:
+    MinecraftInstance *m_inst;
+    Mode m_mode;
+    QString m_manifestPath;
+    qint64 m_maxAgeSecs = 0;
+    QByteArray m_fingerprint;
+    QStringList m_required;
+    QStringList m_optional;
+    QString m_assetsId;
+    QString m_assetIndexPath;
+    QFuture<QString> m_future;
+    QFutureWatcher<QString> m_watcher;
+};
@@ -0,0 +1,115 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "MultiHash.h"
+#include "minecraft/update/LaunchManifest.h"
+
+namespace {
+QStringList writeFiles(const QString &root)
+{
+    QStringList paths;
+    paths << FS::PathCombine(root, "libraries", "a.jar");
+    paths << FS::PathCombine(root, "assets", "objects", "ab", "abcd");
+    FS::write(paths[0], "library contents");
+    FS::write(paths[1], "asset");
+    return paths;
+}
+}
+
+class LaunchManifestTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_RoundTrip()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto paths = writeFiles(temp.path());
+
+        LaunchManifest manifest;
+        QVERIFY(LaunchManifest::build("fingerprint", paths, LaunchManifest(), manifest));
+        QCOMPARE(manifest.files.size(), 2);
+        QCOMPARE(manifest.files[0].size, qint64(16));
+        QCOMPARE(manifest.files[0].sha1, MultiHash::hash("library contents", QCryptographicHash::Sha1));
+        QVERIFY(manifest.verify().isEmpty());
+
+        auto path = FS::PathCombine(temp.path(), "launch-manifest.json");
+        QVERIFY(manifest.save(path));
+        LaunchManifest loaded;
+        QVERIFY(LaunchManifest::load(path, loaded));
+        QCOMPARE(loaded.fingerprint, QByteArray("fingerprint"));
+        QCOMPARE(loaded.updated, manifest.updated);
+        QCOMPARE(loaded.files.size(), 2);
+        QCOMPARE(loaded.files[1].path, paths[1]);
+        QCOMPARE(loaded.files[1].sha1, manifest.files[1].sha1);
+        QCOMPARE(loaded.files[1].modified, manifest.files[1].modified);
+        QVERIFY(loaded.verify().isEmpty());
+
+        FS::write(path, "{ broken");
+        QVERIFY(!LaunchManifest::load(path, loaded));
+        QVERIFY(!LaunchManifest::load(FS::PathCombine(temp.path(), "missing.json"), loaded));
+    }
+
+    void test_Changes()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto paths = writeFiles(temp.path());
+        LaunchManifest manifest;
+        QVERIFY(LaunchManifest::build("fingerprint", paths, LaunchManifest(), manifest));
+
+        // same size, different contents
+        QTest::qWait(10);
+        FS::write(paths[0], "library CONTENTS");
+        QCOMPARE(manifest.verify(), QStringList() << paths[0]);
+
+        // rewritten with the same contents only changes the modification time
+        QTest::qWait(10);
+        FS::write(paths[0], "library contents");
+        QVERIFY(manifest.verify().isEmpty());
+
+        QVERIFY(QFile::remove(paths[1]));
+        QCOMPARE(manifest.verify(), QStringList() << paths[1]);
+
+        QString error;
+        LaunchManifest rebuilt;
+        QVERIFY(!LaunchManifest::build("fingerprint", paths, manifest, rebuilt, &error));
+        QVERIFY(error.contains(paths[1]));
+    }
+
+    void test_ReusesHashes()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto paths = writeFiles(temp.path());
+        LaunchManifest previous;
+        QVERIFY(LaunchManifest::build("old", paths, LaunchManifest(), previous));
+        previous.files[0].sha1 = "not rehashed";
+        QTest::qWait(10);
+        FS::write(paths[1], "other");
+
+        LaunchManifest manifest;
+        QVERIFY(LaunchManifest::build("new", paths, previous, manifest));
+        QCOMPARE(manifest.fingerprint, QByteArray("new"));
+        QCOMPARE(manifest.files[0].sha1, QByteArray("not rehashed"));
+        QCOMPARE(manifest.files[1].sha1, MultiHash::hash("other", QCryptographicHash::Sha1));
+    }
+
+    void test_Freshness()
+    {
+        LaunchManifest manifest;
+        QVERIFY(!manifest.isFresh(3600));
+        manifest.updated = QDateTime::currentDateTimeUtc().addSecs(-60);
+        QVERIFY(manifest.isFresh(3600));
+        QVERIFY(!manifest.isFresh(30));
+        manifest.updated = QDateTime::currentDateTimeUtc().addSecs(3600);
+        QVERIFY(!manifest.isFresh(7200));
+    }
+};
+
+QTEST_GUILESS_MAIN(LaunchManifestTest)
+
+#include "LaunchManifest_test.moc"
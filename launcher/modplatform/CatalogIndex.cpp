@@ -0,0 +1,231 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CatalogIndex.h"
+
+#include <QSet>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+const double titleWeight = 3.0;
+const double textWeight = 1.0;
+const double prefixScore = 0.8;
+// below this similarity two words are considered unrelated
+const double minimumSimilarity = 0.6;
+// words differing more in length than this are not checked for typos
+const int maximumLengthDifference = 2;
+
+// edit distance counting swapped neighbours as a single edit, the most common typo
+int editDistance(const QString &a, const QString &b)
+{
+    const int n = a.size();
+    const int m = b.size();
+    QVector<QVector<int>> d(n + 1, QVector<int>(m + 1));
+    for(int i = 0; i <= n; i++)
+        d[i][0] = i;
+    for(int j = 0; j <= m; j++)
+        d[0][j] = j;
+    for(int i = 1; i <= n; i++)
+    {
+        for(int j = 1; j <= m; j++)
+        {
+            int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + cost});
+            if(i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+            {
+                d[i][j] = std::min(d[i][j], d[i - 2][j - 2] + 1);
+            }
+        }
+    }
+    return d[n][m];
+}
+
+QStringList trigrams(const QString &token)
+{
+    // padding makes the start and end of words count, and gives short words some trigrams too
+    QString padded = QChar('^') + token + QChar('$');
+    QStringList out;
+    for(int i = 0; i + 3 <= padded.size(); i++)
+    {
+        auto trigram = padded.mid(i, 3);
+        if(!out.contains(trigram))
+        {
+            out.append(trigram);
+        }
+    }
+    return out;
+}
+}
+
+QStringList CatalogIndex::tokenize(const QString &text)
+{
+    QStringList tokens;
+    QString current;
+    for(auto c: text)
+    {
+        if(c.isLetterOrNumber())
+        {
+            current.append(c.toLower());
+        }
+        else if(!current.isEmpty())
+        {
+            tokens.append(current);
+            current.clear();
+        }
+    }
+    if(!current.isEmpty())
+    {
+        tokens.append(current);
+    }
+    return tokens;
+}
+
+void CatalogIndex::clear()
+{
+    m_tokens.clear();
+    m_trigrams.clear();
+    m_added = 0;
+}
+
+void CatalogIndex::add(int id, const QString &title, const QString &text)
+{
+    int order = m_added++;
+    addTokens(id, order, title, titleWeight);
+    addTokens(id, order, text, textWeight);
+}
+
+void CatalogIndex::addTokens(int id, int order, const QString &text, double weight)
+{
+    QSet<QString> seen;
+    for(auto &token: tokenize(text))
+    {
+        if(seen.contains(token))
+        {
+            continue;
+        }
+        seen.insert(token);
+        auto grams = trigrams(token);
+        int index = m_tokens.size();
+        m_tokens.append({token, id, order, weight, grams.size()});
+        for(auto &gram: grams)
+        {
+            m_trigrams[gram].append(index);
+        }
+    }
+}
+
+QVector<CatalogIndex::Match> CatalogIndex::search(const QString &query) const
+{
+    struct Result
+    {
+        double score = 0;
+        int words = 0;
+        int order = 0;
+    };
+    QHash<int, Result> results;
+
+    auto words = tokenize(query);
+    words.removeDuplicates();
+    for(auto &word: words)
+    {
+        auto grams = trigrams(word);
+        // how many trigrams every candidate token shares with the word
+        QHash<int, int> shared;
+        for(auto &gram: grams)
+        {
+            auto found = m_trigrams.find(gram);
+            if(found == m_trigrams.end())
+            {
+                continue;
+            }
+            for(auto index: found.value())
+            {
+                shared[index]++;
+            }
+        }
+        // single letters only have the one trigram of a whole word, look for prefixes the hard way
+        if(word.size() == 1)
+        {
+            for(int index = 0; index < m_tokens.size(); index++)
+            {
+                if(m_tokens[index].text.startsWith(word) && !shared.contains(index))
+                {
+                    shared.insert(index, 0);
+                }
+            }
+        }
+
+        QHash<int, double> best;
+        for(auto iter = shared.begin(); iter != shared.end(); iter++)
+        {
+            const auto &token = m_tokens[iter.key()];
+            double score;
+            if(token.text == word)
+            {
+                score = 1.0;
+            }
+            else if(token.text.startsWith(word))
+            {
+                score = prefixScore;
+            }
+            else
+            {
+                double similarity = double(iter.value()) / double(grams.size() + token.trigrams - iter.value());
+                // trigrams alone are harsh on typos in short words, which is what people search with
+                if(std::abs(token.text.size() - word.size()) <= maximumLengthDifference)
+                {
+                    int longest = std::max(token.text.size(), word.size());
+                    similarity = std::max(similarity, 1.0 - double(editDistance(token.text, word)) / longest);
+                }
+                if(similarity < minimumSimilarity)
+                {
+                    continue;
+                }
+                // a typo is never as good as the real thing
+                score = similarity * prefixScore;
+            }
+            score *= token.weight;
+            auto &current = best[token.id];
+            current = std::max(current, score);
+            results[token.id].order = token.order;
+        }
+        for(auto iter = best.begin(); iter != best.end(); iter++)
+        {
+            auto &result = results[iter.key()];
+            result.score += iter.value();
+            result.words++;
+        }
+    }
+
+    QVector<Match> matches;
+    for(auto iter = results.begin(); iter != results.end(); iter++)
+    {
+        // every word has to match something
+        if(iter.value().words == words.size())
+        {
+            matches.append({iter.key(), iter.value().score});
+        }
+    }
+    std::sort(matches.begin(), matches.end(), [&](const Match &a, const Match &b)
+    {
+        if(a.score != b.score)
+        {
+            return a.score > b.score;
+        }
+        return results.value(a.id).order < results.value(b.id).order;
+    });
+    return matches;
+}
@@ -0,0 +1,70 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * In-memory search index over the packs of a catalog.
+ *
+ * Texts are split into lower case tokens, and every token into trigrams. A query matches a pack when each of its
+ * words matches some token of the pack exactly, as a prefix, or closely enough by shared trigrams, which takes care of
+ * typos. Matches in the title weigh more than matches in the rest of the text.
+ */
+class CatalogIndex
+{
+public:
+    struct Match
+    {
+        int id;
+        double score;
+    };
+
+    void clear();
+
+    /// Index a pack. Ids are the caller's business, the row in the model usually.
+    void add(int id, const QString &title, const QString &text = QString());
+
+    /// Matching ids, best first. Equally good matches keep the order they were added in.
+    QVector<Match> search(const QString &query) const;
+
+    bool isEmpty() const
+    {
+        return m_tokens.isEmpty();
+    }
+
+    static QStringList tokenize(const QString &text);
+
+private:
+    struct Token
+    {
+        QString text;
+        int id;
+        int order;
+        double weight;
+        int trigrams;
+    };
+
+    void addTokens(int id, int order, const QString &text, double weight);
+
+private:
+    QVector<Token> m_tokens;
+    QHash<QString, QVector<int>> m_trigrams;
+    int m_added = 0;
+};
@@ -0,0 +1,63 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "modplatform/CatalogIndex.h"
+
+class CatalogIndexTest : public QObject
+{
+    Q_OBJECT
+
+    QList<int> ids(const QVector<CatalogIndex::Match> &matches)
+    {
+        QList<int> out;
+        for(auto &match: matches)
+        {
+            out.append(match.id);
+        }
+        return out;
+    }
+
+    CatalogIndex sample()
+    {
+        CatalogIndex index;
+        index.add(0, "SkyFactory 4", "Sky block pack with prestige");
+        index.add(1, "FTB Skies", "An expert skyblock experience");
+        index.add(2, "Direwolf20 1.16", "Direwolf's pack of tech and magic");
+        index.add(3, "RLCraft", "Hardcore survival with dragons");
+        index.add(4, "Tech World", "A skyblock for tech lovers");
+        return index;
+    }
+
+private
+slots:
+    void test_Tokenize()
+    {
+        QCOMPARE(CatalogIndex::tokenize("FTB: Sky-Factory 4!"), QStringList({"ftb", "sky", "factory", "4"}));
+    }
+
+    void test_Ranking()
+    {
+        auto index = sample();
+        // title matches first, then description only
+        QCOMPARE(ids(index.search("sky")), QList<int>({0, 1, 4}));
+        QCOMPARE(ids(index.search("skyblock")), QList<int>({1, 4}));
+        QCOMPARE(ids(index.search("tech")), QList<int>({4, 2}));
+        // prefixes
+        QCOMPARE(ids(index.search("dire")), QList<int>({2}));
+        // all words have to match
+        QCOMPARE(ids(index.search("tech magic")), QList<int>({2}));
+        QVERIFY(index.search("nothing like this").isEmpty());
+    }
+
+    void test_Typos()
+    {
+        auto index = sample();
+        QCOMPARE(ids(index.search("direwolf02")), QList<int>({2}));
+        QCOMPARE(ids(index.search("rlcarft")), QList<int>({3}));
+        QCOMPARE(ids(index.search("hardcroe")), QList<int>({3}));
+    }
+};
+
+QTEST_GUILESS_MAIN(CatalogIndexTest)
+
+#include "CatalogIndex_test.moc"
@@ -0,0 +1,47 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CatalogStore.h"
+
+#include "Application.h"
+#include "FileSystem.h"
+
+#include <QDebug>
+#include <QFile>
+
+Net::Download::Ptr CatalogStore::makeDownload(const QString &base, const QString &path, const QUrl &url)
+{
+    auto entry = APPLICATION->metacache()->resolveEntry(base, path);
+    entry->setStale(true);
+    return Net::Download::makeCached(url, entry, Net::Download::Option::AcceptLocalFiles);
+}
+
+QByteArray CatalogStore::read(const QString &base, const QString &path)
+{
+    auto filename = APPLICATION->metacache()->resolveEntry(base, path)->getFullPath();
+    if(!QFile::exists(filename))
+    {
+        return QByteArray();
+    }
+    try
+    {
+        return FS::read(filename);
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << "Could not read cached catalog" << filename << ":" << e.cause();
+        return QByteArray();
+    }
+}
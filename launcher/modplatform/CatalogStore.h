@@ -0,0 +1,40 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "net/Download.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+
+/**
+ * On-disk copies of the pack catalogs, kept in the meta cache.
+ *
+ * The pack pages show the cached copy right away and refresh it in the background, so browsing works instantly and
+ * without a network connection after the first sync.
+ */
+namespace CatalogStore
+{
+    /**
+     * Download of a catalog document into the cache. The cached copy is always revalidated with the server, and used as
+     * is when the server can't be reached.
+     */
+    Net::Download::Ptr makeDownload(const QString &base, const QString &path, const QUrl &url);
+
+    /// The cached copy of a catalog document, empty if there is none
+    QByteArray read(const QString &base, const QString &path);
+}
@@ -0,0 +1,210 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ExtractPipeline.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QThread>
+#include <QtConcurrentRun>
+#include <QDebug>
+
+#include "FileSystem.h"
+
+ExtractPipeline::ExtractPipeline(const QString &targetRoot, const QString &workRoot, int jobCount, QObject *parent)
+    : QObject(parent), m_targetRoot(targetRoot), m_workRoot(workRoot), m_jobCount(jobCount)
+{
+    m_pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+    m_maxBacklog = 4 * m_pool.maxThreadCount();
+}
+
+ExtractPipeline::~ExtractPipeline()
+{
+    m_stopped = true;
+    m_pending.clear();
+    m_pool.waitForDone();
+}
+
+QString ExtractPipeline::outputRoot(int index) const
+{
+    return FS::PathCombine(m_workRoot, QString::number(index));
+}
+
+void ExtractPipeline::submit(int index, const QString &name, ExtractPipeline::Job job)
+{
+    if(m_stopped || index < m_nextCommit || index >= m_jobCount)
+    {
+        return;
+    }
+    m_names.insert(index, name);
+    m_pending[index] = job;
+    scheduleMore();
+}
+
+void ExtractPipeline::abort()
+{
+    m_stopped = true;
+    m_pending.clear();
+}
+
+void ExtractPipeline::fail(const QString &reason)
+{
+    if(m_stopped)
+    {
+        return;
+    }
+    m_stopped = true;
+    m_pending.clear();
+    emit failed(reason);
+}
+
+void ExtractPipeline::scheduleMore()
+{
+    while(!m_stopped && !m_pending.empty() && m_running < m_pool.maxThreadCount())
+    {
+        auto iter = m_pending.begin();
+        // the job everything else waits for always runs, the ones further ahead only while the backlog is small
+        if(iter->first != m_nextCommit && m_running + m_extracted.size() >= m_maxBacklog)
+        {
+            break;
+        }
+        const int index = iter->first;
+        auto job = iter->second;
+        m_pending.erase(iter);
+        m_running++;
+
+        auto output = outputRoot(index);
+        auto watcher = new QFutureWatcher<bool>(this);
+        connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, index]()
+        {
+            auto ok = watcher->result();
+            watcher->deleteLater();
+            jobFinished(index, ok);
+        });
+        watcher->setFuture(QtConcurrent::run(&m_pool, [job, output]()
+        {
+            return FS::ensureFolderPathExists(output) && job(output);
+        }));
+    }
+}
+
+void ExtractPipeline::jobFinished(int index, bool ok)
+{
+    m_running--;
+    if(!ok)
+    {
+        fail(tr("Failed to extract %1").arg(m_names.value(index)));
+        return;
+    }
+    m_extracted.insert(index);
+    commitMore();
+    scheduleMore();
+}
+
+void ExtractPipeline::commitMore()
+{
+    if(m_stopped || m_committing || !m_extracted.contains(m_nextCommit))
+    {
+        return;
+    }
+    m_committing = true;
+    const int index = m_nextCommit;
+    auto from = outputRoot(index);
+    auto to = m_targetRoot;
+    auto watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, index]()
+    {
+        auto ok = watcher->result();
+        watcher->deleteLater();
+        commitFinished(index, ok);
+    });
+    watcher->setFuture(QtConcurrent::run(&m_pool, [from, to]()
+    {
+        return moveTree(from, to);
+    }));
+}
+
+void ExtractPipeline::commitFinished(int index, bool ok)
+{
+    m_committing = false;
+    m_extracted.remove(index);
+    if(!ok)
+    {
+        fail(tr("Failed to install the files of %1").arg(m_names.value(index)));
+        return;
+    }
+    m_names.remove(index);
+    m_nextCommit++;
+    emit progress(m_nextCommit, m_jobCount);
+    if(m_nextCommit == m_jobCount)
+    {
+        FS::deletePath(m_workRoot);
+        emit succeeded();
+        return;
+    }
+    commitMore();
+    scheduleMore();
+}
+
+bool ExtractPipeline::moveTree(const QString &from, const QString &to)
+{
+    QDir source(from);
+    QStringList dirs;
+    QStringList files;
+    // collect first, moving entries out of a folder while iterating it is not reliable everywhere
+    QDirIterator iter(from, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        iter.next();
+        auto info = iter.fileInfo();
+        auto relative = source.relativeFilePath(info.filePath());
+        if(info.isDir() && !info.isSymLink())
+        {
+            dirs.append(relative);
+        }
+        else
+        {
+            files.append(relative);
+        }
+    }
+    for(auto &dir: dirs)
+    {
+        if(!FS::ensureFolderPathExists(FS::PathCombine(to, dir)))
+        {
+            qWarning() << "Couldn't create folder" << dir << "in" << to;
+            return false;
+        }
+    }
+    for(auto &file: files)
+    {
+        auto src = FS::PathCombine(from, file);
+        auto dst = FS::PathCombine(to, file);
+        QFileInfo existing(dst);
+        if((existing.exists() || existing.isSymLink()) && !QFile::remove(dst))
+        {
+            qWarning() << "Couldn't replace" << dst;
+            return false;
+        }
+        if(!QFile::rename(src, dst) && !QFile::copy(src, dst))
+        {
+            qWarning() << "Couldn't move" << src << "to" << dst;
+            return false;
+        }
+    }
+    return FS::deletePath(from);
+}
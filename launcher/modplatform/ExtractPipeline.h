@@ -0,0 +1,85 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+#include <functional>
+#include <map>
+
+/**
+ * Runs the extraction of downloaded pack files while the rest of the pack is still downloading.
+ *
+ * Jobs are numbered up front. Each job is submitted as soon as its input is available, in any order, and runs on a
+ * worker pool writing into a private output folder. The outputs are then moved into the target folder strictly in job
+ * order, so a later job overwrites files of an earlier one, exactly as if the jobs had run one after another.
+ *
+ * To bound the disk space used by extracted but not yet committed outputs, jobs far ahead of the next one to commit
+ * wait until it catches up.
+ */
+class ExtractPipeline : public QObject
+{
+    Q_OBJECT
+public:
+    /// Writes the job's files into outputRoot, which mirrors the target folder. Runs on a worker thread.
+    using Job = std::function<bool(const QString &outputRoot)>;
+
+    /// workRoot has to be on the same filesystem as targetRoot, so outputs can be moved instead of copied
+    ExtractPipeline(const QString &targetRoot, const QString &workRoot, int jobCount, QObject *parent = nullptr);
+    virtual ~ExtractPipeline();
+
+    void submit(int index, const QString &name, Job job);
+    void abort();
+
+    bool isFinished() const
+    {
+        return m_nextCommit == m_jobCount;
+    }
+
+signals:
+    void progress(qint64 committed, qint64 total);
+    void succeeded();
+    void failed(QString reason);
+
+private:
+    QString outputRoot(int index) const;
+    void scheduleMore();
+    void jobFinished(int index, bool ok);
+    void commitMore();
+    void commitFinished(int index, bool ok);
+    void fail(const QString &reason);
+    static bool moveTree(const QString &from, const QString &to);
+
+private:
+    QString m_targetRoot;
+    QString m_workRoot;
+    int m_jobCount;
+    int m_maxBacklog;
+    QThreadPool m_pool;
+
+    // ordered, so the jobs closest to being committed start first
+    std::map<int, Job> m_pending;
+    QHash<int, QString> m_names;
+    QSet<int> m_extracted;
+    int m_running = 0;
+    int m_nextCommit = 0;
+    bool m_committing = false;
+    bool m_stopped = false;
+};
@@ -0,0 +1,75 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "modplatform/ExtractPipeline.h"
+
+namespace {
+ExtractPipeline::Job writeFiles(int index)
+{
+    return [index](const QString &root)
+    {
+        // later jobs finish first, to shake out ordering problems
+        QThread::msleep(20 - index * 2);
+        FS::write(FS::PathCombine(root, "config", "shared.cfg"), QByteArray::number(index));
+        FS::write(FS::PathCombine(root, "mods", QString("mod%1.jar").arg(index)), QByteArray::number(index));
+        return true;
+    };
+}
+}
+
+class ExtractPipelineTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_OverlayOrder()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto target = FS::PathCombine(temp.path(), "minecraft");
+        auto work = FS::PathCombine(temp.path(), "work");
+        FS::write(FS::PathCombine(target, "config", "shared.cfg"), "original");
+
+        ExtractPipeline pipeline(target, work, 8);
+        QSignalSpy succeeded(&pipeline, &ExtractPipeline::succeeded);
+        QSignalSpy failed(&pipeline, &ExtractPipeline::failed);
+        for(int index: {5, 7, 1, 0, 6, 3, 2, 4})
+        {
+            pipeline.submit(index, QString::number(index), writeFiles(index));
+        }
+        QVERIFY(succeeded.wait(5000));
+        QCOMPARE(failed.count(), 0);
+        QVERIFY(pipeline.isFinished());
+
+        QCOMPARE(FS::read(FS::PathCombine(target, "config", "shared.cfg")), QByteArray("7"));
+        for(int i = 0; i < 8; i++)
+        {
+            QVERIFY(QFile::exists(FS::PathCombine(target, "mods", QString("mod%1.jar").arg(i))));
+        }
+        QVERIFY(!QFile::exists(work));
+    }
+
+    void test_Failure()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        ExtractPipeline pipeline(FS::PathCombine(temp.path(), "minecraft"), FS::PathCombine(temp.path(), "work"), 3);
+        QSignalSpy succeeded(&pipeline, &ExtractPipeline::succeeded);
+        QSignalSpy failed(&pipeline, &ExtractPipeline::failed);
+        pipeline.submit(0, "good", writeFiles(0));
+        pipeline.submit(1, "broken.zip", [](const QString &) { return false; });
+        pipeline.submit(2, "good", writeFiles(2));
+        QVERIFY(failed.wait(5000));
+        QCOMPARE(failed.count(), 1);
+        QVERIFY(failed.first().first().toString().contains("broken.zip"));
+        QCOMPARE(succeeded.count(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(ExtractPipelineTest)
+
+#include "ExtractPipeline_test.moc"
@@ -33,6 +33,10 @@ bool PackInstallTask::abort()
 {
     if(abortable)
     {
+        if(m_modExtractPipeline)
+        {
+            m_modExtractPipeline->abort();
+        }
         return jobPtr->abort();
     }
     return false;
@@ -415,11 +419,7 @@ void PackInstallTask::installConfigs()
     auto entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", path);
     entry->setStale(true);
 
-    auto dl = Net::Download::makeCached(url, entry);
-    if (!m_version.configs.sha1.isEmpty()) {
-        auto rawSha1 = QByteArray::fromHex(m_version.configs.sha1.toLatin1());
-        dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawSha1));
-    }
+    auto dl = Net::Download::makeCached(url, entry, QByteArray::fromHex(m_version.configs.sha1.toLatin1()));
     jobPtr->addNetAction(dl);
     archivePath = entry->getFullPath();
 
@@ -492,6 +492,7 @@ void PackInstallTask::downloadMods()
 
     jarmods.clear();
     jobPtr.reset(new NetJob(tr("Mod download")));
+    QHash<QString, NetAction::Ptr> downloads;
     for(const auto& mod : m_version.mods) {
         // skip non-client mods
         if(!mod.client) continue;
@@ -529,6 +530,7 @@ void PackInstallTask::downloadMods()
                 dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
             }
             jobPtr->addNetAction(dl);
+            downloads.insert(entry->getFullPath(), dl);
         }
         else if(mod.type == ModType::Decomp) {
             auto entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", cacheName);
@@ -541,6 +543,7 @@ void PackInstallTask::downloadMods()
                 dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
             }
             jobPtr->addNetAction(dl);
+            downloads.insert(entry->getFullPath(), dl);
         }
         else {
             auto relpath = getDirForModType(mod.type, mod.type_raw);
@@ -555,6 +558,7 @@ void PackInstallTask::downloadMods()
                 dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
             }
             jobPtr->addNetAction(dl);
+            downloads.insert(entry->getFullPath(), dl);
 
             auto path = FS::PathCombine(m_stagingPath, "minecraft", relpath, mod.file);
             qDebug() << "Will download" << url << "to" << path;
@@ -583,10 +587,16 @@ void PackInstallTask::downloadMods()
         }
     }
 
+    setupModExtraction(downloads);
+
     connect(jobPtr.get(), &NetJob::succeeded, this, &PackInstallTask::onModsDownloaded);
     connect(jobPtr.get(), &NetJob::failed, [&](QString reason)
     {
         abortable = false;
+        if(m_modExtractPipeline)
+        {
+            m_modExtractPipeline->abort();
+        }
         jobPtr.reset();
         emitFailed(reason);
     });
@@ -599,46 +609,17 @@ void PackInstallTask::downloadMods()
     jobPtr->start(APPLICATION->network());
 }
 
-void PackInstallTask::onModsDownloaded() {
-    abortable = false;
-
-    qDebug() << "PackInstallTask::onModsDownloaded: " << QThread::currentThreadId();
-    jobPtr.reset();
-
-    if(!modsToExtract.empty() || !modsToDecomp.empty() || !modsToCopy.empty()) {
-        m_modExtractFuture = QtConcurrent::run(QThreadPool::globalInstance(), this, &PackInstallTask::extractMods, modsToExtract, modsToDecomp, modsToCopy);
-        connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onModsExtracted);
-        connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, [&]()
-        {
-            emitAborted();
-        });
-        m_modExtractFutureWatcher.setFuture(m_modExtractFuture);
-    }
-    else {
-        install();
-    }
-}
-
-void PackInstallTask::onModsExtracted() {
-    qDebug() << "PackInstallTask::onModsExtracted: " << QThread::currentThreadId();
-    if(m_modExtractFuture.result()) {
-        install();
-    }
-    else {
-        emitFailed(tr("Failed to extract mods..."));
-    }
-}
-
-bool PackInstallTask::extractMods(
-    const QMap<QString, VersionMod> &toExtract,
-    const QMap<QString, VersionMod> &toDecomp,
-    const QMap<QString, QString> &toCopy
-) {
-    qDebug() << "PackInstallTask::extractMods: " << QThread::currentThreadId();
-
-    setStatus(tr("Extracting mods..."));
-    for (auto iter = toExtract.begin(); iter != toExtract.end(); iter++) {
-        auto &modPath = iter.key();
+void PackInstallTask::setupModExtraction(const QHash<QString, NetAction::Ptr> &downloads)
+{
+    // Jobs are numbered in the order the files used to be extracted one after another, so the pipeline resolves
+    // overlapping files the same way: extracted mods by cache path, then single decompressed files, then copies.
+    QString minecraftRoot = FS::PathCombine(m_stagingPath, "minecraft");
+    QVector<ExtractPipeline::Job> jobs;
+    QStringList names;
+    QMultiHash<QString, int> jobsByPath;
+
+    for (auto iter = modsToExtract.begin(); iter != modsToExtract.end(); iter++) {
+        auto modPath = iter.key();
         auto &mod = iter.value();
 
         QString extractToDir;
@@ -652,47 +633,108 @@ bool PackInstallTask::extractMods(
             extractToDir = FS::PathCombine("resourcepacks", "extracted");
         }
 
-        QDir extractDir(m_stagingPath);
-        auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir);
-
         QString folderToExtract = "";
         if(mod.type == ModType::Extract) {
             folderToExtract = mod.extractFolder;
             folderToExtract.remove(QRegExp("^/"));
         }
 
-        qDebug() << "Extracting " + mod.file + " to " + extractToDir;
-        if(!MMCZip::extractDir(modPath, folderToExtract, extractToPath)) {
-            // assume error
-            return false;
-        }
+        qDebug() << "Will extract " + mod.file + " to " + extractToDir;
+        jobsByPath.insert(modPath, jobs.size());
+        names.append(mod.file);
+        jobs.append([modPath, folderToExtract, extractToDir](const QString &root) {
+            return MMCZip::extractDir(modPath, folderToExtract, FS::PathCombine(root, extractToDir)).has_value();
+        });
     }
 
-    for (auto iter = toDecomp.begin(); iter != toDecomp.end(); iter++) {
-        auto &modPath = iter.key();
+    for (auto iter = modsToDecomp.begin(); iter != modsToDecomp.end(); iter++) {
+        auto modPath = iter.key();
         auto &mod = iter.value();
         auto extractToDir = getDirForModType(mod.decompType, mod.decompType_raw);
+        auto decompFile = mod.decompFile;
+
+        qDebug() << "Will extract " + mod.decompFile + " to " + extractToDir;
+        jobsByPath.insert(modPath, jobs.size());
+        names.append(mod.decompFile);
+        jobs.append([modPath, decompFile, extractToDir](const QString &root) {
+            if(!MMCZip::extractFile(modPath, decompFile, FS::PathCombine(root, extractToDir, decompFile))) {
+                qWarning() << "Failed to extract" << decompFile;
+                return false;
+            }
+            return true;
+        });
+    }
 
-        QDir extractDir(m_stagingPath);
-        auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir, mod.decompFile);
+    for (auto iter = modsToCopy.begin(); iter != modsToCopy.end(); iter++) {
+        auto from = iter.key();
+        auto relative = QDir(minecraftRoot).relativeFilePath(iter.value());
+        jobsByPath.insert(from, jobs.size());
+        names.append(QFileInfo(from).fileName());
+        jobs.append([from, relative](const QString &root) {
+            auto to = FS::PathCombine(root, relative);
+            FS::copy fileCopyOperation(from, to);
+            if(!fileCopyOperation()) {
+                qWarning() << "Failed to copy" << from << "to" << to;
+                return false;
+            }
+            return true;
+        });
+    }
 
-        qDebug() << "Extracting " + mod.decompFile + " to " + extractToDir;
-        if(!MMCZip::extractFile(modPath, mod.decompFile, extractToPath)) {
-            qWarning() << "Failed to extract" << mod.decompFile;
-            return false;
-        }
+    m_modsExtracted = jobs.isEmpty();
+    if(jobs.isEmpty()) {
+        return;
     }
 
-    for (auto iter = toCopy.begin(); iter != toCopy.end(); iter++) {
-        auto &from = iter.key();
-        auto &to = iter.value();
-        FS::copy fileCopyOperation(from, to);
-        if(!fileCopyOperation()) {
-            qWarning() << "Failed to copy" << from << "to" << to;
-            return false;
+    m_modExtractPipeline.reset(new ExtractPipeline(minecraftRoot, FS::PathCombine(m_stagingPath, ".extracting"), jobs.size()));
+    connect(m_modExtractPipeline.get(), &ExtractPipeline::succeeded, this, &PackInstallTask::onModsExtracted);
+    connect(m_modExtractPipeline.get(), &ExtractPipeline::failed, this, &PackInstallTask::onModExtractionFailed);
+
+    // hand each file to the pipeline as soon as it is downloaded and validated
+    for (auto path : jobsByPath.uniqueKeys()) {
+        auto dl = downloads.value(path);
+        if(!dl) {
+            continue;
         }
+        QList<int> indexes = jobsByPath.values(path);
+        connect(dl.get(), &NetAction::succeeded, this, [this, indexes, names, jobs](int) {
+            for (auto index : indexes) {
+                m_modExtractPipeline->submit(index, names[index], jobs[index]);
+            }
+        });
     }
-    return true;
+}
+
+void PackInstallTask::onModsDownloaded() {
+    abortable = false;
+
+    qDebug() << "PackInstallTask::onModsDownloaded: " << QThread::currentThreadId();
+    jobPtr.reset();
+    m_modsDownloaded = true;
+
+    if(m_modsExtracted) {
+        install();
+    }
+    else {
+        setStatus(tr("Extracting mods..."));
+    }
+}
+
+void PackInstallTask::onModsExtracted() {
+    qDebug() << "PackInstallTask::onModsExtracted: " << QThread::currentThreadId();
+    m_modsExtracted = true;
+    // every file has been handled, but the download job may not have reported success yet
+    if(m_modsDownloaded) {
+        install();
+    }
+}
+
+void PackInstallTask::onModExtractionFailed(QString reason) {
+    abortable = false;
+    if(jobPtr) {
+        jobPtr->abort();
+    }
+    emitFailed(tr("Failed to extract mods: %1").arg(reason));
 }
 
 void PackInstallTask::install()
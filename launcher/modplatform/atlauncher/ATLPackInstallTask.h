@@ -5,6 +5,7 @@
 
 #include "InstanceTask.h"
 #include "net/NetJob.h"
+#include "modplatform/ExtractPipeline.h"
 #include "settings/INISettingsObject.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
@@ -50,6 +51,7 @@ private slots:
 
     void onModsDownloaded();
     void onModsExtracted();
+    void onModExtractionFailed(QString reason);
 
 private:
     QString getDirForModType(ModType type, QString raw);
@@ -62,11 +64,7 @@ private:
     void installConfigs();
     void extractConfigs();
     void downloadMods();
-    bool extractMods(
-        const QMap<QString, VersionMod> &toExtract,
-        const QMap<QString, VersionMod> &toDecomp,
-        const QMap<QString, QString> &toCopy
-    );
+    void setupModExtraction(const QHash<QString, NetAction::Ptr> &downloads);
     void install();
 
 private:
@@ -93,8 +91,9 @@ private:
     QFuture<nonstd::optional<QStringList>> m_extractFuture;
     QFutureWatcher<nonstd::optional<QStringList>> m_extractFutureWatcher;
 
-    QFuture<bool> m_modExtractFuture;
-    QFutureWatcher<bool> m_modExtractFutureWatcher;
+    unique_qobject_ptr<ExtractPipeline> m_modExtractPipeline;
+    bool m_modsDownloaded = false;
+    bool m_modsExtracted = false;
 
 };
 
@@ -1,12 +1,26 @@
 #include "FileResolvingTask.h"
 #include "Json.h"
+#include "FileSystem.h"
+#include "BuildConfig.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
 
 namespace {
     const char * metabase = "https://cursemeta.dries007.net";
+    const char * cacheBase = "FlameMeta";
+    // nothing tells us when the metadata of a file changes, so entries older than this are fetched or revalidated again
+    const qint64 maxCacheAge = 7LL * 24 * 60 * 60 * 1000;
+
+    QString resourcePath(const Flame::File &file)
+    {
+        return QString("%1/%2.json").arg(file.projectId).arg(file.fileId);
+    }
 }
 
-Flame::FileResolvingTask::FileResolvingTask(shared_qobject_ptr<QNetworkAccessManager> network, Flame::Manifest& toProcess)
-    : m_network(network), m_toProcess(toProcess)
+Flame::FileResolvingTask::FileResolvingTask(shared_qobject_ptr<QNetworkAccessManager> network, Flame::Manifest& toProcess, HttpMetaCache * cache)
+    : m_network(network), m_toProcess(toProcess), m_cache(cache), m_metaUrl(metabase)
 {
 }
 
@@ -14,50 +28,288 @@ void Flame::FileResolvingTask::executeTask()
 {
     setStatus(tr("Resolving mod IDs..."));
     setProgress(0, m_toProcess.files.size());
-    m_dljob = new NetJob("Mod id resolver");
-    results.resize(m_toProcess.files.size());
-    int index = 0;
-    for(auto & file: m_toProcess.files)
-    {
-        auto projectIdStr = QString::number(file.projectId);
-        auto fileIdStr = QString::number(file.fileId);
-        QString metaurl = QString("%1/%2/%3.json").arg(metabase, projectIdStr, fileIdStr);
-        auto dl = Net::Download::makeByteArray(QUrl(metaurl), &results[index]);
-        m_dljob->addNetAction(dl);
-        index ++;
+    m_pending.clear();
+    m_expired.clear();
+    m_handled.clear();
+    m_failures = 0;
+
+    // files resolved by an earlier import don't need any network access at all
+    for(int index = 0; index < m_toProcess.files.size(); index++)
+    {
+        switch(loadFromCache(index))
+        {
+            case CacheState::Fresh:
+                break;
+            case CacheState::Expired:
+                m_expired.insert(index);
+                m_pending.append(index);
+                break;
+            case CacheState::Missing:
+                m_pending.append(index);
+                break;
+        }
     }
-    connect(m_dljob.get(), &NetJob::finished, this, &Flame::FileResolvingTask::netJobFinished);
-    m_dljob->start(m_network);
+    qDebug() << "Resolved" << m_toProcess.files.size() - m_pending.size() << "of" << m_toProcess.files.size()
+             << "Flame files from the cache," << m_expired.size() << "more need refreshing";
+    if(m_pending.isEmpty())
+    {
+        finish();
+        return;
+    }
+
+    if(!m_batchUrl.isEmpty())
+    {
+        QNetworkRequest request(m_batchUrl);
+        request.setHeader(QNetworkRequest::UserAgentHeader, BuildConfig.USER_AGENT);
+        QNetworkReply *reply;
+        if(m_batchUrl.isLocalFile())
+        {
+            reply = m_network->get(request);
+        }
+        else
+        {
+            QJsonArray files;
+            for(auto index: m_pending)
+            {
+                auto &file = m_toProcess.files[index];
+                QJsonObject object;
+                object.insert("projectID", file.projectId);
+                object.insert("fileID", file.fileId);
+                files.append(object);
+            }
+            QJsonObject body;
+            body.insert("files", files);
+            request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+            reply = m_network->post(request, QJsonDocument(body).toJson(QJsonDocument::Compact));
+        }
+        m_batchReply.reset(reply);
+        connect(reply, &QNetworkReply::finished, this, &Flame::FileResolvingTask::batchFinished);
+        return;
+    }
+    startDownloads();
 }
 
-void Flame::FileResolvingTask::netJobFinished()
+MetaEntryPtr Flame::FileResolvingTask::cacheEntry(int index) const
+{
+    return m_cache->resolveEntry(cacheBase, resourcePath(m_toProcess.files[index]));
+}
+
+Flame::FileResolvingTask::CacheState Flame::FileResolvingTask::loadFromCache(int index)
+{
+    auto entry = cacheEntry(index);
+    if(entry->isStale())
+    {
+        return CacheState::Missing;
+    }
+    QByteArray bytes;
+    try
+    {
+        bytes = FS::read(entry->getFullPath());
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << e.cause();
+    }
+    if(!parse(index, bytes) || !m_toProcess.files[index].resolved)
+    {
+        // whatever is in there is of no use, get a fresh copy instead of revalidating it
+        m_handled.remove(index);
+        QFile::remove(entry->getFullPath());
+        m_cache->evictEntry(entry);
+        return CacheState::Missing;
+    }
+    if(QDateTime::currentMSecsSinceEpoch() - entry->getLocalChangedTimestamp() > maxCacheAge)
+    {
+        // the answer stays in use until a new one arrives. entries from the single file endpoint have an ETag and
+        // only get revalidated, batch answers are fetched again.
+        entry->setStale(true);
+        return CacheState::Expired;
+    }
+    return CacheState::Fresh;
+}
+
+bool Flame::FileResolvingTask::parse(int index, const QByteArray &bytes)
+{
+    auto & out = m_toProcess.files[index];
+    auto candidate = out;
+    try
+    {
+        candidate.parseFromBytes(bytes);
+    }
+    catch (const JSONValidationError &e)
+    {
+        qCritical() << "Resolving of" << out.projectId << out.fileId << "failed because of a parsing error:";
+        qCritical() << e.cause();
+        qCritical() << "JSON:";
+        qCritical() << bytes;
+        return false;
+    }
+    out = candidate;
+    m_handled.insert(index);
+    setProgress(m_handled.size(), m_toProcess.files.size());
+    return true;
+}
+
+void Flame::FileResolvingTask::store(int index, const QByteArray &bytes)
 {
-    bool failed = false;
-    int index = 0;
-    for(auto & bytes: results)
+    auto entry = cacheEntry(index);
+    auto path = entry->getFullPath();
+    try
     {
-        auto & out = m_toProcess.files[index];
-        try
+        FS::write(path, bytes);
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << "Could not cache Flame file metadata:" << e.cause();
+        return;
+    }
+    entry->setMD5Sum(QCryptographicHash::hash(bytes, QCryptographicHash::Md5).toHex().constData());
+    entry->setETag(QString());
+    entry->setLocalChangedTimestamp(QFileInfo(path).lastModified().toUTC().toMSecsSinceEpoch());
+    entry->setStale(false);
+    m_cache->updateEntry(entry);
+}
+
+void Flame::FileResolvingTask::batchFinished()
+{
+    auto reply = std::move(m_batchReply);
+    if(reply->error() != QNetworkReply::NoError)
+    {
+        qWarning() << "Batch resolving of Flame files failed, resolving them one by one:" << reply->errorString();
+        resolveRemaining(m_pending);
+        return;
+    }
+
+    QVector<int> remaining;
+    try
+    {
+        auto answers = Json::requireObject(Json::requireDocument(reply->readAll(), "Batch response"), "Batch response");
+        for(auto index: m_pending)
         {
-            failed &= (!out.parseFromBytes(bytes));
+            auto &file = m_toProcess.files[index];
+            auto key = QString("%1/%2").arg(file.projectId).arg(file.fileId);
+            auto answer = answers.value(key);
+            if(!answer.isObject())
+            {
+                remaining.append(index);
+                continue;
+            }
+            auto bytes = QJsonDocument(answer.toObject()).toJson(QJsonDocument::Compact);
+            // negative answers are left for the single file endpoint, so they are never cached
+            auto previous = file;
+            if(!parse(index, bytes) || !file.resolved)
+            {
+                file = previous;
+                if(!m_expired.contains(index))
+                {
+                    m_handled.remove(index);
+                }
+                remaining.append(index);
+                continue;
+            }
+            m_expired.remove(index);
+            store(index, bytes);
         }
-        catch (const JSONValidationError &e)
+    }
+    catch (const JSONValidationError &e)
+    {
+        qWarning() << "Could not read the batch response, resolving Flame files one by one:" << e.cause();
+        remaining.clear();
+        for(auto index: m_pending)
         {
+            if(!m_toProcess.files[index].resolved)
+            {
+                remaining.append(index);
+            }
+        }
+    }
+    resolveRemaining(remaining);
+}
 
-            qCritical() << "Resolving of" << out.projectId << out.fileId << "failed because of a parsing error:";
-            qCritical() << e.cause();
-            qCritical() << "JSON:";
-            qCritical() << bytes;
-            failed = true;
+void Flame::FileResolvingTask::resolveRemaining(const QVector<int> &remaining)
+{
+    // expired answers the batch did not refresh are still good enough, asking for them one by one is what the batch
+    // is there to avoid
+    m_pending.clear();
+    for(auto index: remaining)
+    {
+        if(!m_expired.contains(index))
+        {
+            m_pending.append(index);
         }
-        index++;
     }
-    if(!failed)
+    if(m_pending.isEmpty())
+    {
+        finish();
+        return;
+    }
+    startDownloads();
+}
+
+void Flame::FileResolvingTask::startDownloads()
+{
+    m_dljob = new NetJob("Mod id resolver");
+    for(auto index: m_pending)
     {
-        emitSucceeded();
+        auto entry = cacheEntry(index);
+        QString metaurl = QString("%1/%2").arg(m_metaUrl.toString(), resourcePath(m_toProcess.files[index]));
+        auto dl = Net::Download::makeCached(QUrl(metaurl), entry);
+        // parse right away instead of holding on to all the responses until the end
+        connect(dl.get(), &NetAction::succeeded, this, [this, index, entry]()
+        {
+            fileDownloaded(index, entry);
+        });
+        m_dljob->addNetAction(dl);
     }
-    else
+    connect(m_dljob.get(), &NetJob::finished, this, &Flame::FileResolvingTask::netJobFinished);
+    m_dljob->start(m_network);
+}
+
+void Flame::FileResolvingTask::fileDownloaded(int index, MetaEntryPtr entry)
+{
+    m_handled.insert(index);
+    QByteArray bytes;
+    try
+    {
+        bytes = FS::read(entry->getFullPath());
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << e.cause();
+    }
+    bool ok = parse(index, bytes);
+    if(!ok)
+    {
+        m_failures++;
+    }
+    if(!ok || !m_toProcess.files[index].resolved)
+    {
+        // broken or negative results may be temporary, don't keep them around
+        QFile::remove(entry->getFullPath());
+        m_cache->evictEntry(entry);
+    }
+}
+
+void Flame::FileResolvingTask::netJobFinished()
+{
+    m_dljob.reset();
+    for(auto index: m_pending)
+    {
+        if(!m_handled.contains(index))
+        {
+            // the download itself failed
+            m_failures++;
+        }
+    }
+    finish();
+}
+
+void Flame::FileResolvingTask::finish()
+{
+    if(m_failures)
     {
         emitFailed(tr("Some mod ID resolving tasks failed."));
+        return;
     }
+    emitSucceeded();
 }
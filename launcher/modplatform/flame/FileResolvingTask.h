@@ -2,17 +2,61 @@
 
 #include "tasks/Task.h"
 #include "net/NetJob.h"
+#include "net/HttpMetaCache.h"
 #include "PackManifest.h"
 
+#include <QSet>
+
 namespace Flame
 {
+/**
+ * Turns the project and file IDs of a manifest into file names and download URLs.
+ *
+ * Metadata of every file is kept in the meta cache, keyed by project and file ID, so anything resolved before is
+ * answered locally. The rest is fetched from a batch endpoint when one is configured, and one request per file
+ * otherwise. Responses are parsed as they arrive.
+ *
+ * Cached metadata older than a week is refreshed. With a batch endpoint it simply goes along with the next batch,
+ * and whatever the batch has no answer for keeps using the cached copy until the next import.
+ */
 class FileResolvingTask : public Task
 {
     Q_OBJECT
 public:
-    explicit FileResolvingTask(shared_qobject_ptr<QNetworkAccessManager> network, Flame::Manifest &toProcess);
+    explicit FileResolvingTask(shared_qobject_ptr<QNetworkAccessManager> network, Flame::Manifest &toProcess, HttpMetaCache * cache);
     virtual ~FileResolvingTask() {};
 
+    /**
+     * Resolve all files missing from the cache with a single request to this URL.
+     *
+     * The batch protocol is our own, Flame and cursemeta do not offer anything like it. It is meant for a small
+     * self-hosted service, or a mirror that has the per-file metadata at hand anyway:
+     *
+     * - The request is a POST with a JSON body: {"files": [{"projectID": 1, "fileID": 2}, ...]}
+     * - The answer is a JSON object with a key "projectID/fileID" for every file it knows, for example "1/2". The value
+     *   is the same file object the per-file endpoint returns, with "FileNameOnDisk", "DownloadURL" and optionally
+     *   "_Project".
+     * - Files without a key, and values that are not objects, count as unknown. So does a negative answer, an object
+     *   with a "code" as the per-file endpoint sends it. Unknown files are resolved one by one afterwards and negative
+     *   answers are never cached.
+     * - If the request fails or the answer is not a JSON object, all files missing from the cache are resolved one by
+     *   one. Expired cached answers are never asked for one by one after a batch, they are kept until the next import.
+     * - Answers have no ETag, they are kept for a week and then asked for again.
+     *
+     * A local file URL is read instead of posted to and has to hold an answer in the same format. That makes for an
+     * easy stand-in.
+     */
+    void setBatchUrl(const QUrl &url)
+    {
+        m_batchUrl = url;
+    }
+
+    /// Base URL of the per-file endpoint, which has the metadata of every file at <base>/<projectID>/<fileID>.json
+    void setMetaUrl(const QUrl &url)
+    {
+        m_metaUrl = url;
+    }
+
     const Flame::Manifest &getResults() const
     {
         return m_toProcess;
@@ -22,12 +66,37 @@ protected:
     virtual void executeTask() override;
 
 protected slots:
+    void batchFinished();
     void netJobFinished();
 
+private:
+    enum class CacheState
+    {
+        Fresh,
+        Expired,
+        Missing
+    };
+    MetaEntryPtr cacheEntry(int index) const;
+    CacheState loadFromCache(int index);
+    void resolveRemaining(const QVector<int> &remaining);
+    bool parse(int index, const QByteArray &bytes);
+    void store(int index, const QByteArray &bytes);
+    void fileDownloaded(int index, MetaEntryPtr entry);
+    void startDownloads();
+    void finish();
+
 private: /* data */
     shared_qobject_ptr<QNetworkAccessManager> m_network;
     Flame::Manifest m_toProcess;
-    QVector<QByteArray> results;
+    HttpMetaCache * m_cache;
+    QUrl m_batchUrl;
+    QUrl m_metaUrl;
+    QVector<int> m_pending;
+    // pending files that still have a usable, but old, answer from the cache
+    QSet<int> m_expired;
+    QSet<int> m_handled;
+    int m_failures = 0;
+    unique_qobject_ptr<QNetworkReply> m_batchReply;
     NetJob::Ptr m_dljob;
 };
 }
@@ -0,0 +1,187 @@
+#include <QTest>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "modplatform/flame/FileResolvingTask.h"
+
+namespace {
+QJsonObject fileObject(const QString &name)
+{
+    QJsonObject object;
+    object.insert("FileNameOnDisk", name);
+    object.insert("DownloadURL", "https://example.com/files/" + name);
+    return object;
+}
+
+Flame::Manifest manifest(int count)
+{
+    Flame::Manifest out;
+    for(int i = 1; i <= count; i++)
+    {
+        Flame::File file;
+        file.projectId = i;
+        file.fileId = 100 + i;
+        out.files.append(file);
+    }
+    return out;
+}
+
+QString key(int projectId)
+{
+    return QString("%1/%2").arg(projectId).arg(100 + projectId);
+}
+}
+
+class FileResolvingTaskTest : public QObject
+{
+    Q_OBJECT
+private:
+    QTemporaryDir temp;
+    std::unique_ptr<HttpMetaCache> cache;
+    QString metaDir;
+    QString batchFile;
+
+    // answers of the per-file endpoint
+    void writeMeta(int projectId, const QString &name)
+    {
+        FS::write(FS::PathCombine(metaDir, key(projectId) + ".json"), QJsonDocument(fileObject(name)).toJson());
+    }
+
+    void writeBatch(const QJsonObject &answers)
+    {
+        FS::write(batchFile, QJsonDocument(answers).toJson());
+    }
+
+    bool resolve(Flame::Manifest &pack, bool batch)
+    {
+        Flame::FileResolvingTask task(shared_qobject_ptr<QNetworkAccessManager>(new QNetworkAccessManager()), pack, cache.get());
+        if(batch)
+        {
+            task.setBatchUrl(QUrl::fromLocalFile(batchFile));
+        }
+        task.setMetaUrl(QUrl::fromLocalFile(metaDir));
+        QSignalSpy finished(&task, &Task::finished);
+        task.start();
+        if(!finished.count() && !finished.wait(10000))
+        {
+            return false;
+        }
+        pack = task.getResults();
+        return task.wasSuccessful();
+    }
+
+private
+slots:
+    void init()
+    {
+        QVERIFY(temp.isValid());
+        auto root = FS::PathCombine(temp.path(), QString::number(QDateTime::currentMSecsSinceEpoch()));
+        metaDir = FS::PathCombine(root, "meta");
+        batchFile = FS::PathCombine(root, "batch.json");
+        QVERIFY(FS::ensureFolderPathExists(metaDir));
+        cache.reset(new HttpMetaCache());
+        cache->addBase("FlameMeta", FS::PathCombine(root, "cache"));
+    }
+
+    void test_Batch()
+    {
+        QJsonObject answers;
+        answers.insert(key(1), fileObject("one.jar"));
+        answers.insert(key(2), fileObject("two.jar"));
+        writeBatch(answers);
+
+        // nothing at the per-file endpoint, the batch has to answer everything
+        auto pack = manifest(2);
+        QVERIFY(resolve(pack, true));
+        QCOMPARE(pack.files[0].fileName, QString("one.jar"));
+        QCOMPARE(pack.files[1].fileName, QString("two.jar"));
+        QCOMPARE(pack.files[1].url, QUrl("https://example.com/files/two.jar"));
+
+        // the answers are cached, so there is no need to ask again
+        QFile::remove(batchFile);
+        auto again = manifest(2);
+        QVERIFY(resolve(again, true));
+        QCOMPARE(again.files[0].fileName, QString("one.jar"));
+        QCOMPARE(again.files[1].fileName, QString("two.jar"));
+    }
+
+    void test_OneByOneFallback()
+    {
+        // the batch knows one file and has a negative answer for another
+        QJsonObject answers;
+        answers.insert(key(1), fileObject("one.jar"));
+        QJsonObject negative;
+        negative.insert("code", "NotFound");
+        answers.insert(key(2), negative);
+        writeBatch(answers);
+        writeMeta(2, "two.jar");
+        writeMeta(3, "three.jar");
+
+        auto pack = manifest(3);
+        QVERIFY(resolve(pack, true));
+        QCOMPARE(pack.files[0].fileName, QString("one.jar"));
+        QCOMPARE(pack.files[1].fileName, QString("two.jar"));
+        QCOMPARE(pack.files[2].fileName, QString("three.jar"));
+    }
+
+    void test_BrokenBatch()
+    {
+        FS::write(batchFile, "not json");
+        writeMeta(1, "one.jar");
+
+        auto pack = manifest(1);
+        QVERIFY(resolve(pack, true));
+        QCOMPARE(pack.files[0].fileName, QString("one.jar"));
+    }
+
+    void test_NoBatch()
+    {
+        writeMeta(1, "one.jar");
+        auto pack = manifest(2);
+        // nothing anywhere for the second file
+        QVERIFY(!resolve(pack, false));
+        QCOMPARE(pack.files[0].fileName, QString("one.jar"));
+        QVERIFY(!pack.files[1].resolved);
+    }
+
+    void test_ExpiredGoesToBatch()
+    {
+#if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
+        QSKIP("Needs QFileDevice::setFileTime, which Qt only has since 5.10");
+#else
+        QJsonObject answers;
+        answers.insert(key(1), fileObject("one.jar"));
+        answers.insert(key(2), fileObject("two.jar"));
+        writeBatch(answers);
+        auto pack = manifest(2);
+        QVERIFY(resolve(pack, true));
+
+        // age the cached answers past their maximum age
+        for(int projectId: {1, 2})
+        {
+            QFile file(FS::PathCombine(cache->getBasePath("FlameMeta"), key(projectId) + ".json"));
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.setFileTime(QDateTime::currentDateTimeUtc().addDays(-30), QFileDevice::FileModificationTime));
+        }
+
+        // the batch refreshes one of them. the other keeps its cached answer instead of going to the per-file
+        // endpoint, which has nothing and would fail the task.
+        QJsonObject refreshed;
+        refreshed.insert(key(1), fileObject("one-new.jar"));
+        writeBatch(refreshed);
+        auto again = manifest(2);
+        QVERIFY(resolve(again, true));
+        QCOMPARE(again.files[0].fileName, QString("one-new.jar"));
+        QCOMPARE(again.files[1].fileName, QString("two.jar"));
+#endif
+    }
+};
+
+QTEST_GUILESS_MAIN(FileResolvingTaskTest)
+
+#include "FileResolvingTask_test.moc"
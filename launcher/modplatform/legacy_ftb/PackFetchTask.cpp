@@ -4,6 +4,7 @@
 #include <QDomDocument>
 #include "BuildConfig.h"
 #include "Application.h"
+#include "modplatform/CatalogStore.h"
 
 namespace LegacyFTB {
 
@@ -16,11 +17,11 @@ void PackFetchTask::fetch()
 
     QUrl publicPacksUrl = QUrl(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/modpacks.xml");
     qDebug() << "Downloading public version info from" << publicPacksUrl.toString();
-    jobPtr->addNetAction(Net::Download::makeByteArray(publicPacksUrl, &publicModpacksXmlFileData));
+    jobPtr->addNetAction(CatalogStore::makeDownload("FTBPacks", "modpacks.xml", publicPacksUrl));
 
     QUrl thirdPartyUrl = QUrl(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/thirdparty.xml");
     qDebug() << "Downloading thirdparty version info from" << thirdPartyUrl.toString();
-    jobPtr->addNetAction(Net::Download::makeByteArray(thirdPartyUrl, &thirdPartyModpacksXmlFileData));
+    jobPtr->addNetAction(CatalogStore::makeDownload("FTBPacks", "thirdparty.xml", thirdPartyUrl));
 
     QObject::connect(jobPtr.get(), &NetJob::succeeded, this, &PackFetchTask::fileDownloadFinished);
     QObject::connect(jobPtr.get(), &NetJob::failed, this, &PackFetchTask::fileDownloadFailed);
@@ -71,6 +72,10 @@ void PackFetchTask::fileDownloadFinished()
 {
     jobPtr.reset();
 
+    // the lists from the last sync are kept when the server can't be reached
+    publicModpacksXmlFileData = CatalogStore::read("FTBPacks", "modpacks.xml");
+    thirdPartyModpacksXmlFileData = CatalogStore::read("FTBPacks", "thirdparty.xml");
+
     QStringList failedLists;
 
     if(!parseAndAddPacks(publicModpacksXmlFileData, PackType::Public, publicPacks))
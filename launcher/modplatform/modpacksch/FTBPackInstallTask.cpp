@@ -4,7 +4,6 @@
 #include "Json.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
-#include "net/ChecksumValidator.h"
 #include "settings/INISettingsObject.h"
 
 #include "BuildConfig.h"
@@ -116,11 +115,7 @@ void PackInstallTask::downloadPack()
         qDebug() << "Will download" << file.url << "to" << path;
         filesToCopy[path] = entry->getFullPath();
 
-        auto dl = Net::Download::makeCached(file.url, entry);
-        if (!file.sha1.isEmpty()) {
-            auto rawSha1 = QByteArray::fromHex(file.sha1.toLatin1());
-            dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawSha1));
-        }
+        auto dl = Net::Download::makeCached(file.url, entry, QByteArray::fromHex(file.sha1.toLatin1()));
         jobPtr->addNetAction(dl);
     }
 
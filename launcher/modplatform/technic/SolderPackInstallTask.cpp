@@ -34,6 +34,10 @@ Technic::SolderPackInstallTask::SolderPackInstallTask(
 bool Technic::SolderPackInstallTask::abort() {
     if(m_abortable)
     {
+        if(m_extractPipeline)
+        {
+            m_extractPipeline->abort();
+        }
         return m_filesNetJob->abort();
     }
     return false;
@@ -100,16 +104,36 @@ void Technic::SolderPackInstallTask::fileListSucceeded()
         return;
     }
     m_filesNetJob.reset(new NetJob(tr("Downloading modpack")));
+    m_modCount = modUrls.size();
+
+    // archives are extracted while the rest is still downloading, and later archives still overwrite earlier ones
+    QString extractDir = FS::PathCombine(m_stagingPath, ".minecraft");
+    FS::ensureFolderPathExists(extractDir);
+    m_extractPipeline.reset(new ExtractPipeline(extractDir, FS::PathCombine(m_stagingPath, ".extracting"), m_modCount));
+    connect(m_extractPipeline.get(), &ExtractPipeline::succeeded, this, &Technic::SolderPackInstallTask::extractFinished);
+    connect(m_extractPipeline.get(), &ExtractPipeline::failed, this, &Technic::SolderPackInstallTask::extractFailed);
+    m_extractDone = m_modCount == 0;
+
     int i = 0;
     for (auto &modUrl: modUrls)
     {
         auto path = FS::PathCombine(m_outputDir.path(), QString("%1").arg(i));
-        m_filesNetJob->addNetAction(Net::Download::makeFile(modUrl, path));
+        auto dl = Net::Download::makeFile(modUrl, path);
+        auto name = QUrl(modUrl).fileName();
+        connect(dl.get(), &NetAction::succeeded, this, [this, i, path, name](int)
+        {
+            m_extractPipeline->submit(i, name, [path](const QString &outputRoot)
+            {
+                bool ok = MMCZip::extractDir(path, outputRoot).has_value();
+                // not needed anymore, keep the temporary folder small
+                QFile::remove(path);
+                return ok;
+            });
+        });
+        m_filesNetJob->addNetAction(dl);
         i++;
     }
 
-    m_modCount = modUrls.size();
-
     connect(m_filesNetJob.get(), &NetJob::succeeded, this, &Technic::SolderPackInstallTask::downloadSucceeded);
     connect(m_filesNetJob.get(), &NetJob::progress, this, &Technic::SolderPackInstallTask::downloadProgressChanged);
     connect(m_filesNetJob.get(), &NetJob::failed, this, &Technic::SolderPackInstallTask::downloadFailed);
@@ -119,34 +143,23 @@ void Technic::SolderPackInstallTask::fileListSucceeded()
 void Technic::SolderPackInstallTask::downloadSucceeded()
 {
     m_abortable = false;
-
-    setStatus(tr("Extracting modpack"));
+    m_downloadDone = true;
     m_filesNetJob.reset();
-    m_extractFuture = QtConcurrent::run([this]()
+    if(m_extractDone)
     {
-        int i = 0;
-        QString extractDir = FS::PathCombine(m_stagingPath, ".minecraft");
-        FS::ensureFolderPathExists(extractDir);
-
-        while (m_modCount > i)
-        {
-            auto path = FS::PathCombine(m_outputDir.path(), QString("%1").arg(i));
-            if (!MMCZip::extractDir(path, extractDir))
-            {
-                return false;
-            }
-            i++;
-        }
-        return true;
-    });
-    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &Technic::SolderPackInstallTask::extractFinished);
-    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &Technic::SolderPackInstallTask::extractAborted);
-    m_extractFutureWatcher.setFuture(m_extractFuture);
+        processPack();
+        return;
+    }
+    setStatus(tr("Extracting modpack"));
 }
 
 void Technic::SolderPackInstallTask::downloadFailed(QString reason)
 {
     m_abortable = false;
+    if(m_extractPipeline)
+    {
+        m_extractPipeline->abort();
+    }
     emitFailed(reason);
     m_filesNetJob.reset();
 }
@@ -159,53 +172,28 @@ void Technic::SolderPackInstallTask::downloadProgressChanged(qint64 current, qin
 
 void Technic::SolderPackInstallTask::extractFinished()
 {
-    if (!m_extractFuture.result())
+    m_extractDone = true;
+    // every archive is in place, but the job itself may not have reported success yet
+    if(m_downloadDone)
     {
-        emitFailed(tr("Failed to extract modpack"));
-        return;
+        processPack();
     }
-    QDir extractDir(m_stagingPath);
+}
 
-    qDebug() << "Fixing permissions for extracted pack files...";
-    QDirIterator it(extractDir, QDirIterator::Subdirectories);
-    while (it.hasNext())
+void Technic::SolderPackInstallTask::extractFailed(QString reason)
+{
+    m_abortable = false;
+    if(m_filesNetJob)
     {
-        auto filepath = it.next();
-        QFileInfo file(filepath);
-        auto permissions = QFile::permissions(filepath);
-        auto origPermissions = permissions;
-        if(file.isDir())
-        {
-            // Folder +rwx for current user
-            permissions |= QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser;
-        }
-        else
-        {
-            // File +rw for current user
-            permissions |= QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser;
-        }
-        if(origPermissions != permissions)
-        {
-            if(!QFile::setPermissions(filepath, permissions))
-            {
-                logWarning(tr("Could not fix permissions for %1").arg(filepath));
-            }
-            else
-            {
-                qDebug() << "Fixed" << filepath;
-            }
-        }
+        m_filesNetJob->abort();
     }
+    emitFailed(tr("Failed to extract modpack: %1").arg(reason));
+}
 
+void Technic::SolderPackInstallTask::processPack()
+{
     shared_qobject_ptr<Technic::TechnicPackProcessor> packProcessor = new Technic::TechnicPackProcessor();
     connect(packProcessor.get(), &Technic::TechnicPackProcessor::succeeded, this, &Technic::SolderPackInstallTask::emitSucceeded);
     connect(packProcessor.get(), &Technic::TechnicPackProcessor::failed, this, &Technic::SolderPackInstallTask::emitFailed);
     packProcessor->run(m_globalSettings, m_instName, m_instIcon, m_stagingPath, m_minecraftVersion, true);
 }
-
-void Technic::SolderPackInstallTask::extractAborted()
-{
-    emitFailed(tr("Instance import has been aborted."));
-    return;
-}
-
@@ -18,6 +18,7 @@
 #include <InstanceTask.h>
 #include <net/NetJob.h>
 #include <tasks/Task.h>
+#include <modplatform/ExtractPipeline.h>
 
 #include <QUrl>
 
@@ -43,7 +44,10 @@ namespace Technic
         void downloadFailed(QString reason);
         void downloadProgressChanged(qint64 current, qint64 total);
         void extractFinished();
-        void extractAborted();
+        void extractFailed(QString reason);
+
+    private:
+        void processPack();
 
     private:
         bool m_abortable = false;
@@ -56,7 +60,8 @@ namespace Technic
         QByteArray m_response;
         QTemporaryDir m_outputDir;
         int m_modCount;
-        QFuture<bool> m_extractFuture;
-        QFutureWatcher<bool> m_extractFutureWatcher;
+        unique_qobject_ptr<ExtractPipeline> m_extractPipeline;
+        bool m_downloadDone = false;
+        bool m_extractDone = false;
     };
 }
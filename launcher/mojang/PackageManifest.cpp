@@ -3,7 +3,10 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QDebug>
+#include <QtConcurrent>
+#include "MultiHash.h"
 
 #ifndef Q_OS_WIN32
 #include <unistd.h>
@@ -123,7 +126,9 @@ void fromJson(QJsonDocument & doc, Package & out) {
                     source.compression = Compression::Raw;
                 }
                 else if (compression == "lzma") {
-                    source.compression = Compression::Lzma;
+                    // these are in the LZMA alone format, which the bundled xz decoder can't read. Mojang always
+                    // provides a raw download next to them.
+                    continue;
                 }
                 else {
                     continue;
@@ -226,13 +231,92 @@ bool actually_read_symlink_target(const QString & filepath, Path & out)
 }
 #endif
 
+InspectionCache InspectionCache::load(const QString &path)
+{
+    InspectionCache out;
+    if(!QFile::exists(path))
+    {
+        return out;
+    }
+    try
+    {
+        auto root = Json::requireObject(Json::requireDocument(path, "Inspection cache"), "Inspection cache");
+        auto files = Json::ensureObject(root, "files");
+        for(auto iter = files.begin(); iter != files.end(); iter++)
+        {
+            auto object = Json::requireObject(iter.value());
+            Entry entry;
+            entry.size = Json::requireDouble(object, "size");
+            entry.modified = Json::requireDouble(object, "modified");
+            entry.hash = Json::requireString(object, "sha1");
+            out.entries[Path(iter.key())] = entry;
+        }
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << "Ignoring broken inspection cache" << path << ":" << e.cause();
+        out.entries.clear();
+    }
+    return out;
+}
+
+bool InspectionCache::save(const QString &path) const
+{
+    QJsonObject files;
+    for(auto &entry: entries)
+    {
+        QJsonObject object;
+        object.insert("size", double(entry.second.size));
+        object.insert("modified", double(entry.second.modified));
+        object.insert("sha1", entry.second.hash);
+        files.insert(entry.first.toString(), object);
+    }
+    QJsonObject root;
+    root.insert("files", files);
+    try
+    {
+        Json::write(root, path);
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << "Could not save inspection cache" << path << ":" << e.cause();
+        return false;
+    }
+    return true;
+}
+
+namespace {
+struct InspectedFile
+{
+    Path path;
+    QString filePath;
+    qint64 modified = 0;
+    File file;
+    bool failed = false;
+};
+
+void hashFile(InspectedFile &inspected)
+{
+    MultiHash hash(QCryptographicHash::Sha1);
+    if(!hash.addFile(inspected.filePath))
+    {
+        qCritical() << "Folder inspection: Failed to read file:" << inspected.filePath;
+        inspected.failed = true;
+        return;
+    }
+    inspected.file.hash = hash.result().toHex().constData();
+}
+}
+
 // FIXME: Qt filesystem abstraction is bad, but ... let's hope it doesn't break too much?
 // FIXME: The error handling is just DEFICIENT
-Package Package::fromInspectedFolder(const QString& folderPath)
+Package Package::fromInspectedFolder(const QString& folderPath, InspectionCache *cache)
 {
     QDir root(folderPath);
 
     Package out;
+    QVector<InspectedFile> toHash;
+    QVector<InspectedFile> known;
     QDirIterator iterator(folderPath, QDir::NoDotAndDotDot | QDir::AllEntries | QDir::System | QDir::Hidden, QDirIterator::Subdirectories);
     while(iterator.hasNext()) {
         iterator.next();
@@ -258,18 +342,23 @@ Package Package::fromInspectedFolder(const QString& folderPath)
             out.addFolder(relPath);
         }
         else if(fileInfo.isFile()) {
-            File f;
-            f.executable = fileInfo.isExecutable();
-            f.size = fileInfo.size();
-            // FIXME: async / optimize the hashing
-            QFile input(fileInfo.absoluteFilePath());
-            if(!input.open(QIODevice::ReadOnly)) {
-                qCritical() << "Folder inspection: Failed to open file:" << fileInfo.absoluteFilePath();
-                out.valid = false;
-                break;
+            InspectedFile inspected;
+            inspected.path = Path(relPath);
+            inspected.filePath = fileInfo.absoluteFilePath();
+            inspected.modified = fileInfo.lastModified().toMSecsSinceEpoch();
+            inspected.file.executable = fileInfo.isExecutable();
+            inspected.file.size = fileInfo.size();
+            if(cache)
+            {
+                auto iter = cache->entries.find(inspected.path);
+                if(iter != cache->entries.end() && iter->second.size == inspected.file.size && iter->second.modified == inspected.modified)
+                {
+                    inspected.file.hash = iter->second.hash;
+                    known.append(inspected);
+                    continue;
+                }
             }
-            f.hash = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Sha1).toHex().constData();
-            out.addFile(relPath, f);
+            toHash.append(inspected);
         }
         else {
             // Something else... oh my
@@ -278,8 +367,35 @@ Package Package::fromInspectedFolder(const QString& folderPath)
             break;
         }
     }
+
+    // a runtime is a few hundred files, spread the hashing over all cores
+    QtConcurrent::blockingMap(toHash, hashFile);
+
+    if(cache)
+    {
+        cache->entries.clear();
+    }
+    for(auto list: {&known, &toHash})
+    {
+        for(auto &inspected: *list)
+        {
+            if(inspected.failed)
+            {
+                out.valid = false;
+                continue;
+            }
+            out.addFile(inspected.path, inspected.file);
+            if(cache)
+            {
+                InspectionCache::Entry entry;
+                entry.size = inspected.file.size;
+                entry.modified = inspected.modified;
+                entry.hash = inspected.file.hash;
+                cache->entries[inspected.path] = entry;
+            }
+        }
+    }
     out.folders.insert(Path("."));
-    out.valid = true;
     return out;
 }
 
@@ -127,8 +127,22 @@ struct File
     std::uint64_t size = 0;
 };
 
+/// Hashes of previously inspected files, reused while their size and modification time stay the same
+struct InspectionCache {
+    struct Entry {
+        std::uint64_t size = 0;
+        qint64 modified = 0;
+        Hash hash;
+    };
+
+    static InspectionCache load(const QString &path);
+    bool save(const QString &path) const;
+
+    std::map<Path, Entry> entries;
+};
+
 struct Package {
-    static Package fromInspectedFolder(const QString &folderPath);
+    static Package fromInspectedFolder(const QString &folderPath, InspectionCache *cache = nullptr);
     static Package fromManifestFile(const QString &path);
     static Package fromManifestContents(const QByteArray& contents);
 
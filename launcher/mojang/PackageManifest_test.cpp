@@ -1,7 +1,9 @@
 #include <QTest>
 #include <QDebug>
+#include <QTemporaryDir>
 #include "TestUtil.h"
 
+#include "FileSystem.h"
 #include "mojang/PackageManifest.h"
 
 using namespace mojang_files;
@@ -23,6 +25,7 @@ private slots:
 #ifndef Q_OS_WIN32
     void test_inspect_symlinks();
 #endif
+    void test_inspect_cache();
     void mkdir_deep();
     void rmdir_deep();
 
@@ -86,6 +89,11 @@ void PackageManifestTest::test_parse_file() {
     auto path = QFINDTESTDATA("testdata/1.8.0_202-x64.json");
     auto manifest = Package::fromManifestFile(path);
     QVERIFY(manifest.valid == true);
+    // every file has to be downloadable by its hash
+    for(auto &file: manifest.files)
+    {
+        QVERIFY(manifest.sources.count(file.second.hash));
+    }
 }
 
 
@@ -133,6 +141,36 @@ void PackageManifestTest::test_inspect_symlinks() {
 }
 #endif
 
+void PackageManifestTest::test_inspect_cache() {
+    QTemporaryDir temp;
+    QTemporaryDir cacheDir;
+    QVERIFY(temp.isValid() && cacheDir.isValid());
+    auto filePath = FS::PathCombine(temp.path(), "a", "b.txt");
+    FS::write(filePath, "b");
+    auto cachePath = FS::PathCombine(cacheDir.path(), "cache.json");
+
+    InspectionCache cache;
+    auto manifest = Package::fromInspectedFolder(temp.path(), &cache);
+    QVERIFY(manifest.valid == true);
+    QVERIFY(manifest.files[Path("a/b.txt")].hash == "e9d71f5ee7c92d6dc9e92ffdad17b8bd49418f98");
+    QVERIFY(cache.entries.count(Path("a/b.txt")));
+    QVERIFY(cache.save(cachePath));
+
+    // a cached hash is trusted as long as size and modification time match
+    auto loaded = InspectionCache::load(cachePath);
+    QVERIFY(loaded.entries.size() == 1);
+    loaded.entries[Path("a/b.txt")].hash = "0000000000000000000000000000000000000000";
+    manifest = Package::fromInspectedFolder(temp.path(), &loaded);
+    QVERIFY(manifest.files[Path("a/b.txt")].hash == "0000000000000000000000000000000000000000");
+
+    // and the file is hashed again once it changed
+    QTest::qWait(20);
+    FS::write(filePath, "c");
+    manifest = Package::fromInspectedFolder(temp.path(), &loaded);
+    QVERIFY(manifest.files[Path("a/b.txt")].hash == "84a516841ba77a5b4648de2cd0dfcb30ea46dbb4");
+    QVERIFY(loaded.entries[Path("a/b.txt")].hash == "84a516841ba77a5b4648de2cd0dfcb30ea46dbb4");
+}
+
 void PackageManifestTest::mkdir_deep() {
 
     Package from;
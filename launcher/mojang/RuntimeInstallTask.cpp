@@ -0,0 +1,344 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RuntimeInstallTask.h"
+
+#include "FileSystem.h"
+#include "net/ChecksumValidator.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+using namespace mojang_files;
+
+namespace {
+bool setExecutable(const QString &path, bool executable)
+{
+    QFile file(path);
+    auto permissions = file.permissions();
+    const auto exec = QFileDevice::ExeOwner | QFileDevice::ExeUser | QFileDevice::ExeGroup | QFileDevice::ExeOther;
+    return file.setPermissions(executable ? permissions | exec : permissions & ~exec);
+}
+}
+
+RuntimeInstallTask::RuntimeInstallTask(const QUrl &manifestUrl, const QString &manifestHash, const QString &target,
+                                       shared_qobject_ptr<QNetworkAccessManager> network)
+    : m_manifestUrl(manifestUrl), m_manifestHash(manifestHash), m_target(target), m_network(network)
+{
+}
+
+QString RuntimeInstallTask::cachePath() const
+{
+    return m_target + ".inspection.json";
+}
+
+QString RuntimeInstallTask::stagingPath() const
+{
+    return m_target + ".download";
+}
+
+bool RuntimeInstallTask::abort()
+{
+    m_aborted = true;
+    if(m_job)
+    {
+        return m_job->abort();
+    }
+    // the install stops before swapping in the new runtime, the inspection is picked up once it is done
+    return true;
+}
+
+void RuntimeInstallTask::executeTask()
+{
+    setStatus(tr("Downloading runtime manifest..."));
+    m_job = new NetJob(tr("Runtime manifest"));
+    auto download = Net::Download::makeByteArray(m_manifestUrl, &m_manifestData);
+    if(!m_manifestHash.isEmpty())
+    {
+        download->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(m_manifestHash.toLatin1())));
+    }
+    m_job->addNetAction(download);
+    connect(m_job.get(), &NetJob::succeeded, this, &RuntimeInstallTask::manifestDownloaded);
+    connect(m_job.get(), &NetJob::failed, this, &RuntimeInstallTask::downloadFailed);
+    m_job->start(m_network);
+}
+
+void RuntimeInstallTask::manifestDownloaded()
+{
+    m_job.reset();
+    if(m_aborted)
+    {
+        emitAborted();
+        return;
+    }
+    m_to = Package::fromManifestContents(m_manifestData);
+    if(!m_to.valid)
+    {
+        emitFailed(tr("The runtime manifest is not valid."));
+        return;
+    }
+
+    setStatus(tr("Checking installed runtime..."));
+    connect(&m_inspectWatcher, &QFutureWatcher<Package>::finished, this, &RuntimeInstallTask::inspectionFinished);
+    m_inspectFuture = QtConcurrent::run(this, &RuntimeInstallTask::inspect);
+    m_inspectWatcher.setFuture(m_inspectFuture);
+}
+
+Package RuntimeInstallTask::inspect()
+{
+    auto newPath = m_target + ".new";
+    if(!QFileInfo::exists(m_target) && QFileInfo::exists(newPath))
+    {
+        // the last install stopped right between moving the old runtime out and the new one in
+        QDir().rename(newPath, m_target);
+    }
+    FS::deletePath(newPath);
+    FS::deletePath(m_target + ".old");
+    FS::deletePath(stagingPath());
+
+    auto cache = InspectionCache::load(cachePath());
+    auto package = Package::fromInspectedFolder(m_target, &cache);
+    if(package.valid)
+    {
+        cache.save(cachePath());
+    }
+    return package;
+}
+
+void RuntimeInstallTask::inspectionFinished()
+{
+    if(m_aborted)
+    {
+        emitAborted();
+        return;
+    }
+    m_from = m_inspectFuture.result();
+    m_operations = UpdateOperations::resolve(m_from, m_to);
+    if(!m_operations.valid)
+    {
+        emitFailed(tr("Could not check the installed runtime in %1.").arg(m_target));
+        return;
+    }
+    if(m_operations.downloads.empty())
+    {
+        downloadsFinished();
+        return;
+    }
+
+    // identical files share one download
+    std::set<Hash> objects;
+    qint64 total = 0;
+    m_job = new NetJob(tr("Runtime files"));
+    for(auto &download: m_operations.downloads)
+    {
+        if(!objects.insert(download.second.hash).second)
+        {
+            continue;
+        }
+        auto action = Net::Download::makeFile(download.second.url, FS::PathCombine(stagingPath(), download.second.hash));
+        action->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(download.second.hash.toLatin1())));
+        m_job->addNetAction(action);
+        total += download.second.size;
+    }
+    qDebug() << "Runtime update for" << m_target << "downloads" << objects.size() << "files," << total << "bytes";
+
+    setStatus(tr("Downloading runtime files..."));
+    connect(m_job.get(), &NetJob::succeeded, this, &RuntimeInstallTask::downloadsFinished);
+    connect(m_job.get(), &NetJob::failed, this, &RuntimeInstallTask::downloadFailed);
+    connect(m_job.get(), &NetJob::progress, this, &RuntimeInstallTask::setProgress);
+    m_job->start(m_network);
+}
+
+void RuntimeInstallTask::downloadFailed(QString reason)
+{
+    m_job.reset();
+    if(m_aborted)
+    {
+        emitAborted();
+        return;
+    }
+    emitFailed(reason);
+}
+
+void RuntimeInstallTask::downloadsFinished()
+{
+    m_job.reset();
+    if(m_aborted)
+    {
+        emitAborted();
+        return;
+    }
+    setStatus(tr("Installing runtime..."));
+    connect(&m_installWatcher, &QFutureWatcher<QString>::finished, this, &RuntimeInstallTask::installFinished);
+    m_installFuture = QtConcurrent::run(this, &RuntimeInstallTask::install);
+    m_installWatcher.setFuture(m_installFuture);
+}
+
+QString RuntimeInstallTask::install()
+{
+    const auto &ops = m_operations;
+    if(ops.deletes.empty() && ops.rmdirs.empty() && ops.mkdirs.empty() && ops.downloads.empty() && ops.mklinks.empty())
+    {
+        // nothing to move around when at most the permissions changed
+        for(auto &fix: ops.executable_fixes)
+        {
+            if(!setExecutable(FS::PathCombine(m_target, fix.first.toString()), fix.second))
+            {
+                return tr("Could not change the permissions of %1.").arg(fix.first.toString());
+            }
+        }
+        return QString();
+    }
+
+    auto newPath = m_target + ".new";
+    auto oldPath = m_target + ".old";
+    QString error;
+    for(auto &folder: m_to.folders)
+    {
+        if(m_aborted)
+        {
+            error = tr("Aborted");
+            break;
+        }
+        if(!FS::ensureFolderPathExists(FS::PathCombine(newPath, folder.toString())))
+        {
+            error = tr("Could not create folder %1.").arg(folder.toString());
+            break;
+        }
+    }
+
+    // the last file using a downloaded object gets it moved, the others a copy
+    std::map<Hash, int> uses;
+    for(auto &download: ops.downloads)
+    {
+        uses[download.second.hash]++;
+    }
+    // unchanged files moved over from the installed runtime, moved back if anything goes wrong
+    std::vector<std::pair<QString, QString>> moved;
+    for(auto iter = m_to.files.begin(); error.isEmpty() && iter != m_to.files.end(); iter++)
+    {
+        if(m_aborted)
+        {
+            error = tr("Aborted");
+            break;
+        }
+        auto path = iter->first.toString();
+        auto destination = FS::PathCombine(newPath, path);
+        auto download = ops.downloads.find(iter->first);
+        if(download == ops.downloads.end())
+        {
+            auto source = FS::PathCombine(m_target, path);
+            if(!QFile::rename(source, destination))
+            {
+                error = tr("Could not move %1 to the updated runtime.").arg(path);
+                break;
+            }
+            moved.emplace_back(source, destination);
+        }
+        else
+        {
+            auto object = FS::PathCombine(stagingPath(), download->second.hash);
+            bool last = --uses[download->second.hash] == 0;
+            if(!(last ? QFile::rename(object, destination) : QFile::copy(object, destination)))
+            {
+                error = tr("Could not install %1.").arg(path);
+                break;
+            }
+        }
+        if(!setExecutable(destination, iter->second.executable))
+        {
+            error = tr("Could not change the permissions of %1.").arg(path);
+        }
+    }
+#ifndef Q_OS_WIN32
+    for(auto iter = m_to.symlinks.begin(); error.isEmpty() && iter != m_to.symlinks.end(); iter++)
+    {
+        if(!QFile::link(iter->second.toString(), FS::PathCombine(newPath, iter->first.toString())))
+        {
+            error = tr("Could not create link %1.").arg(iter->first.toString());
+        }
+    }
+#endif
+
+    // past this point the new runtime is swapped in and the install runs to the end
+    if(error.isEmpty() && m_aborted)
+    {
+        error = tr("Aborted");
+    }
+    if(error.isEmpty())
+    {
+        QDir dir;
+        bool hadOld = QFileInfo::exists(m_target);
+        if(hadOld && !dir.rename(m_target, oldPath))
+        {
+            error = tr("Could not move the old runtime out of the way.");
+        }
+        else if(!dir.rename(newPath, m_target))
+        {
+            if(hadOld)
+            {
+                dir.rename(oldPath, m_target);
+            }
+            error = tr("Could not move the updated runtime into place.");
+        }
+    }
+
+    if(!error.isEmpty())
+    {
+        for(auto &move: moved)
+        {
+            QFile::rename(move.second, move.first);
+        }
+        FS::deletePath(newPath);
+        return error;
+    }
+
+    FS::deletePath(oldPath);
+    FS::deletePath(stagingPath());
+
+    // downloaded files are hashed already, and moved files kept their timestamps
+    InspectionCache cache;
+    for(auto &file: m_to.files)
+    {
+        QFileInfo info(FS::PathCombine(m_target, file.first.toString()));
+        InspectionCache::Entry entry;
+        entry.size = info.size();
+        entry.modified = info.lastModified().toMSecsSinceEpoch();
+        entry.hash = file.second.hash;
+        cache.entries[file.first] = entry;
+    }
+    cache.save(cachePath());
+    return QString();
+}
+
+void RuntimeInstallTask::installFinished()
+{
+    auto error = m_installFuture.result();
+    // an abort that came too late to stop the swap changes nothing, the new runtime is in place
+    if(error.isEmpty())
+    {
+        emitSucceeded();
+        return;
+    }
+    if(m_aborted)
+    {
+        emitAborted();
+        return;
+    }
+    emitFailed(error);
+}
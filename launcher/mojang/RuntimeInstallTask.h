@@ -0,0 +1,91 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PackageManifest.h"
+#include "net/NetJob.h"
+#include "tasks/Task.h"
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QNetworkAccessManager>
+#include <QUrl>
+
+#include <atomic>
+
+/**
+ * Installs or updates a Java runtime from one of Mojang's runtime file manifests.
+ *
+ * The installed folder is compared against the manifest, and only files that are missing or differ get downloaded.
+ * File hashes of the installed runtime are remembered next to it, so only files that changed on disk since the last run
+ * are hashed again. The updated runtime is put together in a separate folder, reusing the unchanged files, and then
+ * swapped in place of the old one, so the target folder always holds either the old or the new runtime.
+ */
+class RuntimeInstallTask : public Task
+{
+    Q_OBJECT
+public:
+    /**
+     * \param manifestUrl Where to get the runtime's file manifest.
+     * \param manifestHash SHA-1 of the manifest, checked if not empty.
+     * \param target The folder the runtime is installed in.
+     */
+    RuntimeInstallTask(const QUrl &manifestUrl, const QString &manifestHash, const QString &target,
+                       shared_qobject_ptr<QNetworkAccessManager> network);
+
+    bool canAbort() const override
+    {
+        return true;
+    }
+
+public slots:
+    bool abort() override;
+
+protected:
+    virtual void executeTask() override;
+
+private slots:
+    void manifestDownloaded();
+    void inspectionFinished();
+    void downloadsFinished();
+    void downloadFailed(QString reason);
+    void installFinished();
+
+private:
+    mojang_files::Package inspect();
+    QString install();
+    QString cachePath() const;
+    QString stagingPath() const;
+
+private:
+    QUrl m_manifestUrl;
+    QString m_manifestHash;
+    QString m_target;
+    shared_qobject_ptr<QNetworkAccessManager> m_network;
+    // also read by the install running on a worker thread
+    std::atomic<bool> m_aborted{false};
+
+    NetJob::Ptr m_job;
+    QByteArray m_manifestData;
+    mojang_files::Package m_to;
+    mojang_files::Package m_from;
+    mojang_files::UpdateOperations m_operations;
+
+    QFuture<mojang_files::Package> m_inspectFuture;
+    QFutureWatcher<mojang_files::Package> m_inspectWatcher;
+    QFuture<QString> m_installFuture;
+    QFutureWatcher<QString> m_installWatcher;
+};
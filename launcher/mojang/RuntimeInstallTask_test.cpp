@@ -0,0 +1,142 @@
+#include <QTest>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "Json.h"
+#include "mojang/RuntimeInstallTask.h"
+
+namespace {
+QString sha1(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+// writes the files into the server folder and returns the URL of a manifest listing them
+QUrl publish(const QString &server, const QString &name, const QMap<QString, QByteArray> &files, const QString &executable,
+             bool badHash = false)
+{
+    QJsonObject entries;
+    for(auto iter = files.begin(); iter != files.end(); iter++)
+    {
+        auto hash = sha1(iter.value());
+        auto objectPath = FS::PathCombine(server, "objects", hash);
+        FS::write(objectPath, iter.value());
+        QJsonObject raw;
+        raw.insert("sha1", badHash ? sha1("something else") : hash);
+        raw.insert("size", iter.value().size());
+        raw.insert("url", QUrl::fromLocalFile(objectPath).toString());
+        QJsonObject downloads;
+        downloads.insert("raw", raw);
+        QJsonObject entry;
+        entry.insert("type", "file");
+        entry.insert("executable", iter.key() == executable);
+        entry.insert("downloads", downloads);
+        entries.insert(iter.key(), entry);
+    }
+    QJsonObject folder;
+    folder.insert("type", "directory");
+    entries.insert("legal", folder);
+#ifndef Q_OS_WIN32
+    QJsonObject link;
+    link.insert("type", "link");
+    link.insert("target", "../lib/b.txt");
+    entries.insert("bin/b.txt", link);
+#endif
+    QJsonObject root;
+    root.insert("files", entries);
+    auto path = FS::PathCombine(server, name);
+    Json::write(root, path);
+    return QUrl::fromLocalFile(path);
+}
+
+bool run(const QUrl &manifest, const QString &target)
+{
+    shared_qobject_ptr<QNetworkAccessManager> network(new QNetworkAccessManager());
+    RuntimeInstallTask task(manifest, QString(), target, network);
+    QSignalSpy finished(&task, &Task::finished);
+    task.start();
+    if(!finished.count() && !finished.wait(10000))
+    {
+        return false;
+    }
+    return task.wasSuccessful();
+}
+}
+
+class RuntimeInstallTaskTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_InstallAndUpdate()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto server = FS::PathCombine(temp.path(), "server");
+        auto target = FS::PathCombine(temp.path(), "runtime", "java-runtime-alpha");
+
+        QMap<QString, QByteArray> files;
+        files["bin/java"] = "java 1";
+        files["lib/a.txt"] = "a";
+        files["lib/b.txt"] = "b";
+        files["lib/copy.txt"] = "a";
+        QVERIFY(run(publish(server, "v1.json", files, "bin/java"), target));
+        QCOMPARE(FS::read(FS::PathCombine(target, "bin", "java")), QByteArray("java 1"));
+        QCOMPARE(FS::read(FS::PathCombine(target, "lib", "copy.txt")), QByteArray("a"));
+        QVERIFY(QFileInfo(FS::PathCombine(target, "bin", "java")).isExecutable());
+        QVERIFY(!QFileInfo(FS::PathCombine(target, "lib", "a.txt")).isExecutable());
+        QVERIFY(QFileInfo(FS::PathCombine(target, "legal")).isDir());
+#ifndef Q_OS_WIN32
+        QCOMPARE(FS::read(FS::PathCombine(target, "bin", "b.txt")), QByteArray("b"));
+#endif
+
+        // a user touched the runtime, which gets repaired
+        FS::write(FS::PathCombine(target, "lib", "copy.txt"), "changed");
+        auto unchanged = QFileInfo(FS::PathCombine(target, "lib", "b.txt")).lastModified();
+        QTest::qWait(20);
+
+        files["bin/java"] = "java 2";
+        files.remove("lib/a.txt");
+        QVERIFY(run(publish(server, "v2.json", files, "bin/java"), target));
+        QCOMPARE(FS::read(FS::PathCombine(target, "bin", "java")), QByteArray("java 2"));
+        QCOMPARE(FS::read(FS::PathCombine(target, "lib", "copy.txt")), QByteArray("a"));
+        QVERIFY(!QFile::exists(FS::PathCombine(target, "lib", "a.txt")));
+        QVERIFY(QFileInfo(FS::PathCombine(target, "bin", "java")).isExecutable());
+        // moved over, not downloaded again
+        QCOMPARE(QFileInfo(FS::PathCombine(target, "lib", "b.txt")).lastModified(), unchanged);
+        QVERIFY(!QFile::exists(target + ".new"));
+        QVERIFY(!QFile::exists(target + ".old"));
+        QVERIFY(!QFile::exists(target + ".download"));
+
+        // nothing to do the second time
+        QVERIFY(run(publish(server, "v2.json", files, "bin/java"), target));
+        QCOMPARE(FS::read(FS::PathCombine(target, "bin", "java")), QByteArray("java 2"));
+    }
+
+    void test_BadDownload()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto server = FS::PathCombine(temp.path(), "server");
+        auto target = FS::PathCombine(temp.path(), "runtime");
+
+        QMap<QString, QByteArray> files;
+        files["bin/java"] = "java 1";
+        files["lib/b.txt"] = "b";
+        QVERIFY(run(publish(server, "v1.json", files, "bin/java"), target));
+
+        files["bin/java"] = "java 2";
+        QVERIFY(!run(publish(server, "v2.json", files, "bin/java", true), target));
+        // the installed runtime is untouched
+        QCOMPARE(FS::read(FS::PathCombine(target, "bin", "java")), QByteArray("java 1"));
+        QCOMPARE(FS::read(FS::PathCombine(target, "lib", "b.txt")), QByteArray("b"));
+    }
+};
+
+QTEST_GUILESS_MAIN(RuntimeInstallTaskTest)
+
+#include "RuntimeInstallTask_test.moc"
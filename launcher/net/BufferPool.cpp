@@ -0,0 +1,44 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BufferPool.h"
+
+namespace {
+// transfers read synchronously, so only a few buffers are ever out at the same time
+const int maxFree = 4;
+}
+
+namespace Net {
+
+QByteArray BufferPool::take()
+{
+    if(!m_free.isEmpty())
+    {
+        return m_free.takeLast();
+    }
+    return QByteArray(bufferSize, Qt::Uninitialized);
+}
+
+void BufferPool::give(QByteArray buffer)
+{
+    if(m_free.size() >= maxFree)
+    {
+        return;
+    }
+    // growing back within the capacity the buffer already has does not reallocate
+    buffer.resize(bufferSize);
+    m_free.append(buffer);
+}
+}
@@ -0,0 +1,42 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+
+namespace Net {
+
+/**
+ * Fixed size buffers that transfers read the network data into. They are given back after every read, so a running
+ * download does not allocate anything for the data passing through it.
+ *
+ * Not thread safe, it belongs to the network thread.
+ */
+class BufferPool
+{
+public:
+    static const int bufferSize = 64 * 1024;
+
+    /// A buffer of bufferSize bytes, with undefined contents
+    QByteArray take();
+    /// Hand a buffer back for reuse. It may have been resized in the meantime.
+    void give(QByteArray buffer);
+
+private:
+    QList<QByteArray> m_free;
+};
+}
@@ -29,6 +29,16 @@ public:
         return Job_Failed;
     };
 
+    void expectSize(qint64 size) override
+    {
+        // one allocation for the whole response, instead of growing it chunk by chunk.
+        // a bogus size only costs a reallocation, but it should not be able to make us ask for gigabytes.
+        if(size > 0 && size <= maxExpectedSize)
+        {
+            m_output->reserve(int(size));
+        }
+    }
+
     JobStatus write(QByteArray & data) override
     {
         m_output->append(data);
@@ -57,6 +67,7 @@ public:
     }
 
 private:
+    static const qint64 maxExpectedSize = 256 * 1024 * 1024;
     QByteArray * m_output;
 };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Validator.h"
+#include "MultiHash.h"
 #include <QCryptographicHash>
 #include <memory>
 #include <QFile>
@@ -10,7 +11,12 @@ class ChecksumValidator: public Validator
 {
 public: /* con/des */
     ChecksumValidator(QCryptographicHash::Algorithm algorithm, QByteArray expected = QByteArray())
-        :m_checksum(algorithm), m_expected(expected)
+        :m_checksum(algorithm), m_algorithm(algorithm), m_expected(expected)
+    {
+    };
+    /// Also computes the digest of the extra algorithm in the same pass over the data, see hash(algorithm)
+    ChecksumValidator(QCryptographicHash::Algorithm algorithm, QByteArray expected, QCryptographicHash::Algorithm extra)
+        :m_checksum({algorithm, extra}), m_algorithm(algorithm), m_expected(expected)
     {
     };
     virtual ~ChecksumValidator() {};
@@ -41,7 +47,11 @@ public: /* methods */
     }
     QByteArray hash()
     {
-        return m_checksum.result();
+        return m_checksum.result(m_algorithm);
+    }
+    QByteArray hash(QCryptographicHash::Algorithm algorithm)
+    {
+        return m_checksum.result(algorithm);
     }
     void setExpected(QByteArray expected)
     {
@@ -49,7 +59,8 @@ public: /* methods */
     }
 
 private: /* data */
-    QCryptographicHash m_checksum;
+    MultiHash m_checksum;
+    QCryptographicHash::Algorithm m_algorithm;
     QByteArray m_expected;
 };
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CircuitBreaker.h"
+
+#include <QDebug>
+
+namespace Net {
+
+CircuitBreaker::CircuitBreaker(int threshold, qint64 cooldownMs) : m_threshold(threshold), m_cooldownMs(cooldownMs)
+{
+    m_clock.start();
+}
+
+CircuitBreaker *CircuitBreaker::instance()
+{
+    static CircuitBreaker breaker;
+    return &breaker;
+}
+
+QString CircuitBreaker::key(const QUrl &url)
+{
+    return url.host() + ":" + QString::number(url.port());
+}
+
+bool CircuitBreaker::allows(const QUrl &url)
+{
+    if(url.isLocalFile())
+    {
+        return true;
+    }
+    auto iter = m_servers.find(key(url));
+    if(iter == m_servers.end() || iter->openedAt < 0)
+    {
+        return true;
+    }
+    auto now = m_clock.elapsed();
+    if(now - iter->openedAt < m_cooldownMs)
+    {
+        return false;
+    }
+    // one request at a time gets to find out whether the server is back
+    if(iter->trialAt >= 0 && now - iter->trialAt < m_cooldownMs)
+    {
+        return false;
+    }
+    iter->trialAt = now;
+    return true;
+}
+
+void CircuitBreaker::succeeded(const QUrl &url)
+{
+    if(url.isLocalFile())
+    {
+        return;
+    }
+    auto iter = m_servers.find(key(url));
+    if(iter == m_servers.end())
+    {
+        return;
+    }
+    if(iter->openedAt >= 0)
+    {
+        qDebug() << "Server" << iter.key() << "is answering again";
+    }
+    m_servers.erase(iter);
+}
+
+void CircuitBreaker::failed(const QUrl &url)
+{
+    if(url.isLocalFile())
+    {
+        return;
+    }
+    auto &server = m_servers[key(url)];
+    server.failures++;
+    auto now = m_clock.elapsed();
+    if(server.openedAt >= 0)
+    {
+        // still failing, leave it alone for a while longer
+        server.openedAt = now;
+        server.trialAt = -1;
+    }
+    else if(server.failures >= m_threshold)
+    {
+        qWarning() << "Server" << key(url) << "failed" << server.failures << "times in a row, not using it for"
+                   << m_cooldownMs << "ms";
+        server.openedAt = now;
+    }
+}
+
+qint64 CircuitBreaker::retryIn(const QUrl &url) const
+{
+    auto iter = m_servers.find(key(url));
+    if(url.isLocalFile() || iter == m_servers.end() || iter->openedAt < 0)
+    {
+        return 0;
+    }
+    auto now = m_clock.elapsed();
+    auto since = qMax(iter->openedAt, iter->trialAt);
+    return qMax<qint64>(0, m_cooldownMs - (now - since));
+}
+}
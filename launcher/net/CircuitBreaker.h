@@ -0,0 +1,65 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QUrl>
+
+namespace Net {
+
+/**
+ * Stops sending requests to a server that keeps failing.
+ *
+ * After `threshold` failed requests in a row, a server is left alone for the cool-down time. After that a single
+ * request may try it again: if it works the server is used normally again, if it fails the cool-down starts over.
+ * Servers are told apart by host and port. Local files are never held back.
+ *
+ * Used from the thread downloads run on.
+ */
+class CircuitBreaker
+{
+public:
+    explicit CircuitBreaker(int threshold = 5, qint64 cooldownMs = 10000);
+
+    static CircuitBreaker *instance();
+
+    /// Whether a request to the server of `url` may be made now
+    bool allows(const QUrl &url);
+    /// The server of `url` answered
+    void succeeded(const QUrl &url);
+    /// A request to the server of `url` got no usable answer
+    void failed(const QUrl &url);
+    /// How long until the server of `url` may be tried again, 0 if it may be tried now
+    qint64 retryIn(const QUrl &url) const;
+
+private:
+    struct Server
+    {
+        int failures = 0;
+        qint64 openedAt = -1;
+        qint64 trialAt = -1;
+    };
+    static QString key(const QUrl &url);
+
+private:
+    QHash<QString, Server> m_servers;
+    int m_threshold;
+    qint64 m_cooldownMs;
+    QElapsedTimer m_clock;
+};
+}
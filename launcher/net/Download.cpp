@@ -23,6 +23,9 @@
 #include "ChecksumValidator.h"
 #include "MetaCacheSink.h"
 #include "ByteArraySink.h"
+#include "NetworkThread.h"
+#include "NetworkStats.h"
+#include "CircuitBreaker.h"
 
 #include "BuildConfig.h"
 
@@ -33,12 +36,35 @@ Download::Download():NetAction()
     m_status = Job_NotStarted;
 }
 
+Download::~Download()
+{
+    if(m_transfer)
+    {
+        QMetaObject::invokeMethod(m_transfer, "abort", Qt::QueuedConnection);
+        m_transfer->deleteLater();
+    }
+}
+
 Download::Ptr Download::makeCached(QUrl url, MetaEntryPtr entry, Options options)
+{
+    return makeCached(url, entry, QByteArray(), options);
+}
+
+Download::Ptr Download::makeCached(QUrl url, MetaEntryPtr entry, QByteArray sha1, Options options)
 {
     Download * dl = new Download();
     dl->m_url = url;
     dl->m_options = options;
-    auto md5Node = new ChecksumValidator(QCryptographicHash::Md5);
+    ChecksumValidator * md5Node;
+    if(sha1.isEmpty())
+    {
+        md5Node = new ChecksumValidator(QCryptographicHash::Md5);
+    }
+    else
+    {
+        // one validator computes both, instead of a second one going over the same data again
+        md5Node = new ChecksumValidator(QCryptographicHash::Sha1, sha1, QCryptographicHash::Md5);
+    }
     auto cachedNode = new MetaCacheSink(entry, md5Node);
     dl->m_sink.reset(cachedNode);
     dl->m_target_path = entry->getFullPath();
@@ -76,11 +102,13 @@ void Download::startImpl()
         emit aborted(m_index_within_job);
         return;
     }
+    m_error = QNetworkReply::NoError;
     QNetworkRequest request(m_url);
     m_status = m_sink->init(request);
     switch(m_status)
     {
         case Job_Finished:
+            NetworkStats::instance()->recordCacheHit(m_url);
             emit succeeded(m_index_within_job);
             qDebug() << "Download cache hit " << m_url.toString();
             return;
@@ -97,15 +125,65 @@ void Download::startImpl()
     }
 
     request.setHeader(QNetworkRequest::UserAgentHeader, BuildConfig.USER_AGENT);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    // many small files come from the same few hosts. HTTP/2 sends them all over one connection where the server
+    // offers it, otherwise they go through Qt's pool of keep-alive HTTP/1.1 connections.
+    // only over TLS, where it is negotiated during the handshake instead of upgrading plain HTTP connections.
+    if(m_url.scheme() == "https")
+    {
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    }
+#endif
+
+    m_transfer = new Transfer(request, m_network->proxy(), m_sink);
+    m_transfer->moveToThread(NetworkThread::instance());
+    connect(m_transfer, &Transfer::progress, this, &Download::downloadProgress);
+    connect(m_transfer, &Transfer::finished, this, &Download::transferFinished);
+    QMetaObject::invokeMethod(m_transfer, "start", Qt::QueuedConnection);
+}
 
-    QNetworkReply *rep = m_network->get(request);
+void Download::transferFinished()
+{
+    auto transfer = m_transfer;
+    m_transfer = nullptr;
+    // the network thread is done with the reply and the sink, they can be used from here on
+    m_reply.reset(transfer->takeReply());
+    auto error = transfer->error();
+    auto status = transfer->status();
+    transfer->deleteLater();
 
-    m_reply.reset(rep);
-    connect(rep, SIGNAL(downloadProgress(qint64, qint64)), SLOT(downloadProgress(qint64, qint64)));
-    connect(rep, SIGNAL(finished()), SLOT(downloadFinished()));
-    connect(rep, SIGNAL(error(QNetworkReply::NetworkError)), SLOT(downloadError(QNetworkReply::NetworkError)));
-    connect(rep, &QNetworkReply::sslErrors, this, &Download::sslErrors);
-    connect(rep, &QNetworkReply::readyRead, this, &Download::downloadReadyRead);
+    if(!m_reply)
+    {
+        // aborted before the request was even made
+        m_status = Job_Aborted;
+        m_sink->abort();
+        emit aborted(m_index_within_job);
+        return;
+    }
+    // only count what says something about the server. a missing file or one that fails validation still came
+    // from a server that answers, connection problems and 5xx answers did not.
+    if(error != QNetworkReply::OperationCanceledError)
+    {
+        bool serverFailed = error != QNetworkReply::NoError &&
+            (error < QNetworkReply::ContentAccessDenied || error >= QNetworkReply::InternalServerError);
+        if(serverFailed)
+        {
+            CircuitBreaker::instance()->failed(m_url);
+        }
+        else
+        {
+            CircuitBreaker::instance()->succeeded(m_url);
+        }
+    }
+    if(error != QNetworkReply::NoError)
+    {
+        downloadError(error);
+    }
+    else if(status == Job_Failed)
+    {
+        m_status = Job_Failed;
+    }
+    downloadFinished();
 }
 
 void Download::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
@@ -117,6 +195,7 @@ void Download::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
 
 void Download::downloadError(QNetworkReply::NetworkError error)
 {
+    m_error = error;
     if(error == QNetworkReply::OperationCanceledError)
     {
         qCritical() << "Aborted " << m_url.toString();
@@ -138,18 +217,6 @@ void Download::downloadError(QNetworkReply::NetworkError error)
     }
 }
 
-void Download::sslErrors(const QList<QSslError> & errors)
-{
-    int i = 1;
-    for (auto error : errors)
-    {
-        qCritical() << "Download" << m_url.toString() << "SSL Error #" << i << " : " << error.errorString();
-        auto cert = error.certificate();
-        qCritical() << "Certificate in question:\n" << cert.toText();
-        i++;
-    }
-}
-
 bool Download::handleRedirect()
 {
     QUrl redirect = m_reply->header(QNetworkRequest::LocationHeader).toUrl();
@@ -248,15 +315,7 @@ void Download::downloadFinished()
         return;
     }
 
-    // make sure we got all the remaining data, if any
-    auto data = m_reply->readAll();
-    if(data.size())
-    {
-        qDebug() << "Writing extra" << data.size() << "bytes to" << m_target_path;
-        m_status = m_sink->write(data);
-    }
-
-    // otherwise, finalize the whole graph
+    // the transfer wrote all the data, finalize the whole graph
     m_status = m_sink->finalize(*m_reply.get());
     if (m_status != Job_Finished)
     {
@@ -271,31 +330,13 @@ void Download::downloadFinished()
     emit succeeded(m_index_within_job);
 }
 
-void Download::downloadReadyRead()
-{
-    if(m_status == Job_InProgress)
-    {
-        auto data = m_reply->readAll();
-        m_status = m_sink->write(data);
-        if(m_status == Job_Failed)
-        {
-            qCritical() << "Failed to process response chunk for " << m_target_path;
-        }
-        // qDebug() << "Download" << m_url.toString() << "gained" << data.size() << "bytes";
-    }
-    else
-    {
-        qCritical() << "Cannot write to " << m_target_path << ", illegal status" << m_status;
-    }
-}
-
 }
 
 bool Net::Download::abort()
 {
-    if(m_reply)
+    if(m_transfer)
     {
-        m_reply->abort();
+        QMetaObject::invokeMethod(m_transfer, "abort", Qt::QueuedConnection);
     }
     else
     {
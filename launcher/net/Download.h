@@ -23,6 +23,14 @@
 #include "QObjectPtr.h"
 
 namespace Net {
+class Transfer;
+
+/**
+ * Download of a single URL into a sink.
+ *
+ * The request itself and the writes into the sink happen on the network thread, see NetworkThread. Initializing and
+ * finalizing the sink, which may touch the metadata cache or parse the result, happens on the download's own thread.
+ */
 class Download : public NetAction
 {
     Q_OBJECT
@@ -39,8 +47,10 @@ public: /* types */
 protected: /* con/des */
     explicit Download();
 public:
-    virtual ~Download(){};
+    virtual ~Download();
     static Download::Ptr makeCached(QUrl url, MetaEntryPtr entry, Options options = Option::NoOptions);
+    /// Cached download that is checked against a SHA-1, hashed in the same pass as the MD5 of the cache entry
+    static Download::Ptr makeCached(QUrl url, MetaEntryPtr entry, QByteArray sha1, Options options = Option::NoOptions);
     static Download::Ptr makeByteArray(QUrl url, QByteArray *output, Options options = Option::NoOptions);
     static Download::Ptr makeFile(QUrl url, QString path, Options options = Option::NoOptions);
 
@@ -59,9 +69,8 @@ private: /* methods */
 protected slots:
     void downloadProgress(qint64 bytesReceived, qint64 bytesTotal) override;
     void downloadError(QNetworkReply::NetworkError error) override;
-    void sslErrors(const QList<QSslError> & errors);
     void downloadFinished() override;
-    void downloadReadyRead() override;
+    void transferFinished();
 
 public slots:
     void startImpl() override;
@@ -69,8 +78,10 @@ public slots:
 private: /* data */
     // FIXME: remove this, it has no business being here.
     QString m_target_path;
-    std::unique_ptr<Sink> m_sink;
+    // shared with the transfer, which writes into it
+    std::shared_ptr<Sink> m_sink;
     Options m_options;
+    Transfer *m_transfer = nullptr;
 };
 }
 
@@ -15,6 +15,7 @@
 
 #include "HttpMetaCache.h"
 #include "FileSystem.h"
+#include "MultiHash.h"
 
 #include <QFileInfo>
 #include <QFile>
@@ -95,11 +96,7 @@ MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path, QS
     qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
     if (file_last_changed != entry->local_changed_timestamp)
     {
-        QFile input(real_path);
-        input.open(QIODevice::ReadOnly);
-        QString md5sum = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Md5)
-                             .toHex()
-                             .constData();
+        QString md5sum = MultiHash::hashFile(real_path, QCryptographicHash::Md5).toHex().constData();
         if (entry->md5sum != md5sum)
         {
             selected_base.entry_list.remove(resource_path);
@@ -147,6 +144,7 @@ bool HttpMetaCache::evictEntry(MetaEntryPtr entry)
 MetaEntryPtr HttpMetaCache::staleEntry(QString base, QString resource_path)
 {
     auto foo = new MetaEntry();
+    foo->cache = this;
     foo->baseId = base;
     foo->basePath = getBasePath(base);
     foo->relativePath = resource_path;
@@ -209,6 +207,7 @@ void HttpMetaCache::Load()
             continue;
         auto &entrymap = m_entries[base];
         auto foo = new MetaEntry();
+        foo->cache = this;
         foo->baseId = base;
         QString path = foo->relativePath = element_obj.value("path").toString();
         foo->md5sum = element_obj.value("md5sum").toString();
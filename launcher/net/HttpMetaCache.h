@@ -36,6 +36,11 @@ public:
         this->stale = stale;
     }
     QString getFullPath();
+    /// The cache this entry belongs to and goes back to once it is updated
+    HttpMetaCache * getCache()
+    {
+        return cache;
+    }
     QString getRemoteChangedTimestamp()
     {
         return remote_changed_timestamp;
@@ -44,6 +49,10 @@ public:
     {
         this->remote_changed_timestamp = remote_changed_timestamp;
     }
+    qint64 getLocalChangedTimestamp()
+    {
+        return local_changed_timestamp;
+    }
     void setLocalChangedTimestamp(qint64 timestamp)
     {
         local_changed_timestamp = timestamp;
@@ -65,6 +74,7 @@ public:
         this->md5sum = md5sum;
     }
 protected:
+    HttpMetaCache * cache = nullptr;
     QString baseId;
     QString basePath;
     QString relativePath;
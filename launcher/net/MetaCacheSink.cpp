@@ -2,7 +2,6 @@
 #include <QFile>
 #include <QFileInfo>
 #include "FileSystem.h"
-#include "Application.h"
 
 namespace Net {
 
@@ -44,7 +43,7 @@ JobStatus MetaCacheSink::finalizeCache(QNetworkReply & reply)
     QFileInfo output_file_info(m_filename);
     if(wroteAnyData)
     {
-        m_entry->setMD5Sum(m_md5Node->hash().toHex().constData());
+        m_entry->setMD5Sum(m_md5Node->hash(QCryptographicHash::Md5).toHex().constData());
     }
     m_entry->setETag(reply.rawHeader("ETag").constData());
     if (reply.hasRawHeader("Last-Modified"))
@@ -53,7 +52,7 @@ JobStatus MetaCacheSink::finalizeCache(QNetworkReply & reply)
     }
     m_entry->setLocalChangedTimestamp(output_file_info.lastModified().toUTC().toMSecsSinceEpoch());
     m_entry->setStale(false);
-    APPLICATION->metacache()->updateEntry(m_entry);
+    m_entry->getCache()->updateEntry(m_entry);
     return Job_Finished;
 }
 
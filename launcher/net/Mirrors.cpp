@@ -0,0 +1,86 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Mirrors.h"
+
+namespace {
+QString withSlash(QString base)
+{
+    if(!base.endsWith('/'))
+    {
+        base.append('/');
+    }
+    return base;
+}
+}
+
+namespace Net {
+
+Mirrors *Mirrors::instance()
+{
+    static Mirrors mirrors;
+    return &mirrors;
+}
+
+void Mirrors::setMirrors(const QString &primaryBase, const QStringList &mirrors)
+{
+    if(primaryBase.isEmpty())
+    {
+        return;
+    }
+    auto primary = withSlash(primaryBase);
+    for(int i = 0; i < m_mirrors.size(); i++)
+    {
+        if(m_mirrors[i].first == primary)
+        {
+            m_mirrors.removeAt(i);
+            break;
+        }
+    }
+    QStringList bases;
+    for(auto &mirror: mirrors)
+    {
+        auto base = mirror.trimmed();
+        if(!base.isEmpty())
+        {
+            bases.append(withSlash(base));
+        }
+    }
+    if(!bases.isEmpty())
+    {
+        m_mirrors.append(qMakePair(primary, bases));
+    }
+}
+
+QList<QUrl> Mirrors::candidates(const QUrl &url) const
+{
+    QList<QUrl> out = {url};
+    auto urlString = url.toString();
+    for(auto &entry: m_mirrors)
+    {
+        if(!urlString.startsWith(entry.first))
+        {
+            continue;
+        }
+        auto path = urlString.mid(entry.first.size());
+        for(auto &mirror: entry.second)
+        {
+            out.append(QUrl(mirror + path));
+        }
+        break;
+    }
+    return out;
+}
+}
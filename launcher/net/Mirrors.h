@@ -0,0 +1,45 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QPair>
+#include <QStringList>
+#include <QUrl>
+
+namespace Net {
+
+/**
+ * Other places to get the same files from, for when their usual server fails.
+ *
+ * A mirror is a base URL that serves the same tree as a primary base URL, so a file below the primary base is found
+ * at the same relative path below each mirror.
+ */
+class Mirrors
+{
+public:
+    static Mirrors *instance();
+
+    /// Use `mirrors` as alternatives for everything below `primaryBase`. An empty list removes them again.
+    void setMirrors(const QString &primaryBase, const QStringList &mirrors);
+
+    /// The URL itself, followed by the same file on every mirror
+    QList<QUrl> candidates(const QUrl &url) const;
+
+private:
+    QList<QPair<QString, QStringList>> m_mirrors;
+};
+}
@@ -79,6 +79,11 @@ public:
     {
         return m_url;
     }
+    /// The network error of the last attempt, if it had one
+    QNetworkReply::NetworkError error() const
+    {
+        return m_error;
+    }
 
 signals:
     void started(int index);
@@ -91,7 +96,6 @@ protected slots:
     virtual void downloadProgress(qint64 bytesReceived, qint64 bytesTotal) = 0;
     virtual void downloadError(QNetworkReply::NetworkError error) = 0;
     virtual void downloadFinished() = 0;
-    virtual void downloadReadyRead() = 0;
 
 public slots:
     void start(shared_qobject_ptr<QNetworkAccessManager> network) {
@@ -119,4 +123,5 @@ public:
 
 protected:
     JobStatus m_status = Job_NotStarted;
+    QNetworkReply::NetworkError m_error = QNetworkReply::NoError;
 };
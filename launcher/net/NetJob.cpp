@@ -15,8 +15,48 @@
 
 #include "NetJob.h"
 #include "Download.h"
+#include "NetworkStats.h"
+#include "Mirrors.h"
+#include "CircuitBreaker.h"
 
 #include <QDebug>
+#include <QTimer>
+
+#include <memory>
+#include <random>
+
+namespace {
+// how often a part is retried after it was tried on every mirror
+const int maxRetries = 3;
+// retries are never further apart than this, in milliseconds
+const int maxRetryDelay = 30000;
+
+// errors that will not go away by asking the same server again
+bool isPermanent(QNetworkReply::NetworkError error)
+{
+    switch(error)
+    {
+        case QNetworkReply::ContentAccessDenied:
+        case QNetworkReply::ContentOperationNotPermittedError:
+        case QNetworkReply::ContentNotFoundError:
+        case QNetworkReply::ContentGoneError:
+        case QNetworkReply::AuthenticationRequiredError:
+        case QNetworkReply::ProtocolUnknownError:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// exponential backoff with jitter, so parts that failed together do not all come back at the same time
+int backoff(int initialDelay, int retry)
+{
+    static std::default_random_engine engine((std::random_device())());
+    qint64 delay = qMin<qint64>(qint64(initialDelay) << qMin(retry - 1, 20), maxRetryDelay);
+    std::uniform_int_distribution<qint64> jitter(0, delay / 2);
+    return int(delay - delay / 2 + jitter(engine));
+}
+}
 
 void NetJob::partSucceeded(int index)
 {
@@ -24,63 +64,138 @@ void NetJob::partSucceeded(int index)
     auto &slot = parts_progress[index];
     partProgress(index, slot.total_progress, slot.total_progress);
 
-    m_doing.remove(index);
+    setActive(index, false);
     m_done.insert(index);
+    releaseSlot(index);
     downloads[index].get()->disconnect(this);
     startMoreParts();
 }
 
 void NetJob::partFailed(int index)
 {
-    m_doing.remove(index);
+    setActive(index, false);
+    releaseSlot(index);
+    auto part = downloads[index];
+    part.get()->disconnect(this);
+
     auto &slot = parts_progress[index];
-    if (slot.failures == 3)
+    if(slot.mirrors.isEmpty())
     {
-        m_failed.insert(index);
+        slot.mirrors = Net::Mirrors::instance()->candidates(part->m_url);
     }
-    else
+    slot.failures++;
+    int mirrors = slot.mirrors.size();
+    if(slot.failures < mirrors)
     {
-        slot.failures++;
+        // every mirror gets a try right away, before waiting for any of them
+        part->m_url = slot.mirrors[slot.failures];
+        qDebug() << "Trying mirror" << part->m_url.toString();
         m_todo.enqueue(index);
     }
-    downloads[index].get()->disconnect(this);
+    // without a network error, the data arrived and was refused by the sink or a validator, like a checksum mismatch.
+    // another mirror may have a good copy, but asking the same one again gives the same answer.
+    else if(slot.failures - mirrors < maxRetries && part->error() != QNetworkReply::NoError && !isPermanent(part->error()))
+    {
+        part->m_url = slot.mirrors[slot.failures % mirrors];
+        Net::NetworkStats::instance()->recordRetry(part->m_url);
+        retryLater(index, backoff(m_retryDelay, slot.failures - mirrors + 1));
+    }
+    else
+    {
+        m_failed.insert(index);
+    }
     startMoreParts();
 }
 
+void NetJob::retryLater(int index, int delay)
+{
+    m_waiting.insert(index);
+    QTimer::singleShot(delay, this, [this, index]()
+    {
+        // gone if the job was aborted in the meantime
+        if(!m_waiting.remove(index))
+        {
+            return;
+        }
+        m_todo.enqueue(index);
+        startMoreParts();
+    });
+}
+
+bool NetJob::useWorkingMirror(int index)
+{
+    auto part = downloads[index];
+    auto &slot = parts_progress[index];
+    if(slot.mirrors.isEmpty())
+    {
+        slot.mirrors = Net::Mirrors::instance()->candidates(part->m_url);
+    }
+    for(auto &mirror: slot.mirrors)
+    {
+        if(mirror != part->m_url && Net::CircuitBreaker::instance()->allows(mirror))
+        {
+            part->m_url = mirror;
+            return true;
+        }
+    }
+    return false;
+}
+
 void NetJob::partAborted(int index)
 {
     m_aborted = true;
-    m_doing.remove(index);
+    setActive(index, false);
     m_failed.insert(index);
+    releaseSlot(index);
     downloads[index].get()->disconnect(this);
     startMoreParts();
 }
 
+void NetJob::countActive(const part_info &part, int sign)
+{
+    // do not count parts with unknown/nonsensical total size
+    if(part.total_progress <= 0)
+    {
+        return;
+    }
+    m_activeBytes += sign * part.current_progress;
+    m_activeTotal += sign * part.total_progress;
+}
+
+void NetJob::setActive(int index, bool active)
+{
+    if(active)
+    {
+        m_doing.insert(index);
+        countActive(parts_progress[index], 1);
+    }
+    else if(m_doing.remove(index))
+    {
+        countActive(parts_progress[index], -1);
+    }
+}
+
 void NetJob::partProgress(int index, qint64 bytesReceived, qint64 bytesTotal)
 {
+    // the sums over the active parts are kept up to date, instead of adding them up again for every progress update
     auto &slot = parts_progress[index];
+    bool active = m_doing.contains(index);
+    if(active)
+    {
+        countActive(slot, -1);
+    }
     slot.current_progress = bytesReceived;
     slot.total_progress = bytesTotal;
+    if(active)
+    {
+        countActive(slot, 1);
+    }
 
     int done = m_done.size();
     int doing = m_doing.size();
     int all = parts_progress.size();
 
-    qint64 bytesAll = 0;
-    qint64 bytesTotalAll = 0;
-    for(auto & partIdx: m_doing)
-    {
-        auto part = parts_progress[partIdx];
-        // do not count parts with unknown/nonsensical total size
-        if(part.total_progress <= 0)
-        {
-            continue;
-        }
-        bytesAll += part.current_progress;
-        bytesTotalAll += part.total_progress;
-    }
-
-    qint64 inprogress = (bytesTotalAll == 0) ? 0 : (bytesAll * 1000) / bytesTotalAll;
+    qint64 inprogress = (m_activeTotal == 0) ? 0 : (m_activeBytes * 1000) / m_activeTotal;
     auto current = done * 1000 + doing * inprogress;
     auto current_total = all * 1000;
     // HACK: make sure it never jumps backwards.
@@ -113,7 +228,7 @@ void NetJob::startMoreParts()
     // Check for final conditions if there's nothing in the queue.
     if(!m_todo.size())
     {
-        if(!m_doing.size())
+        if(!m_doing.size() && !m_waiting.size())
         {
             if(!m_failed.size())
             {
@@ -123,6 +238,11 @@ void NetJob::startMoreParts()
             {
                 emitAborted();
             }
+            else if(m_allowOptionalFailures && (m_failed - m_optional).isEmpty())
+            {
+                qWarning() << "Job" << objectName() << "finished without optional files:" << getFailedFiles();
+                emitSucceeded();
+            }
             else
             {
                 emitFailed(tr("Job '%1' failed to process:\n%2").arg(objectName()).arg(getFailedFiles().join("\n")));
@@ -130,24 +250,62 @@ void NetJob::startMoreParts()
         }
         return;
     }
-    // There's work to do, try to start more parts.
-    while (m_doing.size() < 6)
+    // There's work to do, ask the scheduler for a network slot for each part that fits.
+    while (m_doing.size() + m_pendingSlots.size() < m_maxConcurrentParts && m_todo.size() > m_pendingSlots.size())
     {
-        if(!m_todo.size())
-            return;
-        int doThis = m_todo.dequeue();
-        m_doing.insert(doThis);
-        auto part = downloads[doThis];
-        // connect signals :D
-        connect(part.get(), SIGNAL(succeeded(int)), SLOT(partSucceeded(int)));
-        connect(part.get(), SIGNAL(failed(int)), SLOT(partFailed(int)));
-        connect(part.get(), SIGNAL(aborted(int)), SLOT(partAborted(int)));
-        connect(part.get(), SIGNAL(netActionProgress(int, qint64, qint64)),
-                SLOT(partProgress(int, qint64, qint64)));
-        part->start(m_network);
+        auto slot = std::make_shared<quint64>(0);
+        *slot = TaskScheduler::instance()->request(this, objectName(), m_priority, TaskScheduler::Network, [this, slot]()
+        {
+            slotGranted(*slot);
+        });
+        m_pendingSlots.append(*slot);
     }
 }
 
+void NetJob::slotGranted(quint64 slot)
+{
+    m_pendingSlots.removeAll(slot);
+    if(!isRunning() || !m_todo.size())
+    {
+        TaskScheduler::instance()->release(slot);
+        return;
+    }
+    int doThis = m_todo.dequeue();
+    auto part = downloads[doThis];
+    if(!Net::CircuitBreaker::instance()->allows(part->m_url) && !useWorkingMirror(doThis))
+    {
+        // the server keeps failing, wait until it may be tried again instead of adding to its failures
+        TaskScheduler::instance()->release(slot);
+        retryLater(doThis, int(qMax<qint64>(100, Net::CircuitBreaker::instance()->retryIn(part->m_url))));
+        return;
+    }
+    setActive(doThis, true);
+    m_slots.insert(doThis, slot);
+    // connect signals :D
+    connect(part.get(), SIGNAL(succeeded(int)), SLOT(partSucceeded(int)));
+    connect(part.get(), SIGNAL(failed(int)), SLOT(partFailed(int)));
+    connect(part.get(), SIGNAL(aborted(int)), SLOT(partAborted(int)));
+    connect(part.get(), SIGNAL(netActionProgress(int, qint64, qint64)),
+            SLOT(partProgress(int, qint64, qint64)));
+    part->start(m_network);
+}
+
+void NetJob::releaseSlot(int index)
+{
+    if(m_slots.contains(index))
+    {
+        TaskScheduler::instance()->release(m_slots.take(index));
+    }
+}
+
+void NetJob::releasePendingSlots()
+{
+    for(auto slot: m_pendingSlots)
+    {
+        TaskScheduler::instance()->release(slot);
+    }
+    m_pendingSlots.clear();
+}
 
 QStringList NetJob::getFailedFiles()
 {
@@ -184,6 +342,9 @@ bool NetJob::abort()
     // fail all waiting
     m_failed.unite(m_todo.toSet());
     m_todo.clear();
+    m_failed.unite(m_waiting);
+    m_waiting.clear();
+    releasePendingSlots();
     // abort active
     auto toKill = m_doing.toList();
     for(auto index: toKill)
@@ -191,11 +352,21 @@ bool NetJob::abort()
         auto part = downloads[index];
         fullyAborted &= part->abort();
     }
+    // with nothing active, no part is going to report back and finish the job
+    if(toKill.isEmpty())
+    {
+        m_aborted = true;
+        QMetaObject::invokeMethod(this, "startMoreParts", Qt::QueuedConnection);
+    }
     return fullyAborted;
 }
 
-bool NetJob::addNetAction(NetAction::Ptr action)
+bool NetJob::addNetAction(NetAction::Ptr action, bool optional)
 {
+    if(optional)
+    {
+        m_optional.insert(downloads.size());
+    }
     action->m_index_within_job = downloads.size();
     downloads.append(action);
     part_info pi;
@@ -211,6 +382,11 @@ bool NetJob::addNetAction(NetAction::Ptr action)
     else
     {
         m_todo.append(parts_progress.size() - 1);
+        // parts added to a running job start as soon as there is room for them
+        if(isRunning())
+        {
+            QMetaObject::invokeMethod(this, "startMoreParts", Qt::QueuedConnection);
+        }
     }
     return true;
 }
@@ -19,6 +19,7 @@
 #include "Download.h"
 #include "HttpMetaCache.h"
 #include "tasks/Task.h"
+#include "tasks/TaskScheduler.h"
 #include "QObjectPtr.h"
 
 class NetJob;
@@ -35,7 +36,8 @@ public:
     }
     virtual ~NetJob();
 
-    bool addNetAction(NetAction::Ptr action);
+    /// Optional parts may fail without failing the job, if the job allows it
+    bool addNetAction(NetAction::Ptr action, bool optional = false);
 
     NetAction::Ptr operator[](int index)
     {
@@ -57,6 +59,30 @@ public:
     }
     QStringList getFailedFiles();
 
+    /// How many parts are processed at the same time, 6 by default
+    void setMaxConcurrentParts(int count)
+    {
+        m_maxConcurrentParts = qMax(1, count);
+    }
+
+    /// How the parts compete with other work for network slots, Foreground by default
+    void setPriority(TaskScheduler::Priority priority)
+    {
+        m_priority = priority;
+    }
+
+    /// Whether failed optional parts still let the job succeed, false by default
+    void setAllowOptionalFailures(bool allow)
+    {
+        m_allowOptionalFailures = allow;
+    }
+
+    /// Delay before the first retry of a failed part, it doubles with every further retry
+    void setRetryDelay(int ms)
+    {
+        m_retryDelay = qMax(1, ms);
+    }
+
     bool canAbort() const override;
 
 private slots:
@@ -85,6 +111,16 @@ private slots:
     void partFailed(int index);
     void partAborted(int index);
 
+private:
+    struct part_info;
+    void countActive(const part_info &part, int sign);
+    void setActive(int index, bool active);
+    void retryLater(int index, int delay);
+    bool useWorkingMirror(int index);
+    void slotGranted(quint64 slot);
+    void releaseSlot(int index);
+    void releasePendingSlots();
+
 private:
     shared_qobject_ptr<QNetworkAccessManager> m_network;
 
@@ -93,6 +129,8 @@ private:
         qint64 current_progress = 0;
         qint64 total_progress = 1;
         int failures = 0;
+        // where the part may be downloaded from, its own URL first
+        QList<QUrl> mirrors;
     };
     QList<NetAction::Ptr> downloads;
     QList<part_info> parts_progress;
@@ -100,6 +138,19 @@ private:
     QSet<int> m_doing;
     QSet<int> m_done;
     QSet<int> m_failed;
+    // failed parts waiting to be retried
+    QSet<int> m_waiting;
+    QSet<int> m_optional;
+    bool m_allowOptionalFailures = false;
+    int m_retryDelay = 500;
     qint64 m_current_progress = 0;
     bool m_aborted = false;
+    int m_maxConcurrentParts = 6;
+    TaskScheduler::Priority m_priority = TaskScheduler::Priority::Foreground;
+    // scheduler slots asked for but not handed out yet, and the ones held by active parts
+    QList<quint64> m_pendingSlots;
+    QHash<int, quint64> m_slots;
+    // progress summed up over the active parts with a known size
+    qint64 m_activeBytes = 0;
+    qint64 m_activeTotal = 0;
 };
@@ -0,0 +1,229 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NetworkStats.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+namespace {
+// how many of the latest downloads are kept around
+const int maxRecent = 200;
+}
+
+namespace Net {
+
+double NetworkStats::Host::reuseRatio() const
+{
+    if(encryptedRequests == 0)
+    {
+        return -1;
+    }
+    return qMax(0, encryptedRequests - newConnections) / double(encryptedRequests);
+}
+
+qint64 NetworkStats::Host::averageFirstByteMs() const
+{
+    if(firstByteCount == 0)
+    {
+        return -1;
+    }
+    return firstByteMs / firstByteCount;
+}
+
+qint64 NetworkStats::Host::bytesPerSecond() const
+{
+    if(totalMs <= 0)
+    {
+        return 0;
+    }
+    return bytes * 1000 / totalMs;
+}
+
+NetworkStats *NetworkStats::instance()
+{
+    static NetworkStats stats;
+    return &stats;
+}
+
+void NetworkStats::recordRequest(const Download &download)
+{
+    QMutexLocker locker(&m_mutex);
+    auto &entry = m_hosts[download.url.host()];
+    entry.host = download.url.host();
+    entry.requests++;
+    if(download.encrypted)
+    {
+        entry.encryptedRequests++;
+    }
+    if(download.failed)
+    {
+        entry.failed++;
+    }
+    if(download.status == 304)
+    {
+        entry.notModified++;
+    }
+    else if(download.status >= 200 && download.status < 300)
+    {
+        entry.fullResponses++;
+    }
+    if(download.http2)
+    {
+        entry.http2Requests++;
+    }
+    if(download.newConnection)
+    {
+        entry.newConnections++;
+    }
+    if(download.firstByteMs >= 0)
+    {
+        entry.firstByteMs += download.firstByteMs;
+        entry.firstByteCount++;
+    }
+    entry.bytes += download.bytes;
+    entry.totalMs += download.ms;
+    addRecent(download);
+}
+
+void NetworkStats::recordCacheHit(const QUrl &url)
+{
+    QMutexLocker locker(&m_mutex);
+    auto &entry = m_hosts[url.host()];
+    entry.host = url.host();
+    entry.cacheHits++;
+    Download download;
+    download.url = url;
+    download.cacheHit = true;
+    addRecent(download);
+}
+
+void NetworkStats::recordRetry(const QUrl &url)
+{
+    QMutexLocker locker(&m_mutex);
+    auto &entry = m_hosts[url.host()];
+    entry.host = url.host();
+    entry.retries++;
+}
+
+void NetworkStats::addRecent(const Download &download)
+{
+    m_recent.append(download);
+    if(m_recent.size() > maxRecent)
+    {
+        m_recent.removeFirst();
+    }
+}
+
+QList<NetworkStats::Host> NetworkStats::hosts() const
+{
+    QList<Host> out;
+    {
+        QMutexLocker locker(&m_mutex);
+        out = m_hosts.values();
+    }
+    std::sort(out.begin(), out.end(), [](const Host &a, const Host &b)
+    {
+        return a.host < b.host;
+    });
+    return out;
+}
+
+QList<NetworkStats::Download> NetworkStats::recent() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_recent;
+}
+
+QJsonArray NetworkStats::hostsToJson() const
+{
+    QJsonArray out;
+    for(auto &host: hosts())
+    {
+        QJsonObject object;
+        object.insert("host", host.host);
+        object.insert("requests", host.requests);
+        object.insert("failed", host.failed);
+        object.insert("retries", host.retries);
+        object.insert("cacheHits", host.cacheHits);
+        object.insert("notModified", host.notModified);
+        object.insert("fullResponses", host.fullResponses);
+        object.insert("http2Requests", host.http2Requests);
+        object.insert("bytes", double(host.bytes));
+        object.insert("totalMs", double(host.totalMs));
+        object.insert("bytesPerSecond", double(host.bytesPerSecond()));
+        object.insert("averageFirstByteMs", double(host.averageFirstByteMs()));
+        if(host.encryptedRequests)
+        {
+            object.insert("encryptedRequests", host.encryptedRequests);
+            object.insert("newConnections", host.newConnections);
+            object.insert("reuseRatio", host.reuseRatio());
+        }
+        out.append(object);
+    }
+    return out;
+}
+
+QJsonArray NetworkStats::recentToJson() const
+{
+    QJsonArray out;
+    for(auto &download: recent())
+    {
+        QJsonObject object;
+        object.insert("url", download.url.toString());
+        if(download.cacheHit)
+        {
+            object.insert("cacheHit", true);
+            out.append(object);
+            continue;
+        }
+        object.insert("status", download.status);
+        object.insert("failed", download.failed);
+        object.insert("http2", download.http2);
+        object.insert("firstByteMs", double(download.firstByteMs));
+        object.insert("bytes", double(download.bytes));
+        object.insert("ms", double(download.ms));
+        out.append(object);
+    }
+    return out;
+}
+
+QJsonObject NetworkStats::toJson() const
+{
+    QJsonObject root;
+    root.insert("hosts", hostsToJson());
+    root.insert("recent", recentToJson());
+    return root;
+}
+
+void NetworkStats::log() const
+{
+    for(auto &host: hosts())
+    {
+        auto line = qDebug().nospace().noquote();
+        line << "Host " << host.host << ": " << host.requests << " requests (" << host.fullResponses << " full, "
+             << host.notModified << " not modified, " << host.http2Requests << " over HTTP/2, " << host.failed
+             << " failed, " << host.retries << " retried), " << host.cacheHits << " cache hits, " << host.bytes
+             << " bytes at " << host.bytesPerSecond() << " B/s, " << host.averageFirstByteMs() << " ms to first byte";
+        if(host.encryptedRequests)
+        {
+            line << ", " << host.newConnections << " new connections for " << host.encryptedRequests << " HTTPS requests, "
+                 << int(host.reuseRatio() * 100) << "% reused";
+        }
+    }
+}
+}
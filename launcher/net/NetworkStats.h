@@ -0,0 +1,113 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QUrl>
+
+namespace Net {
+
+/**
+ * What downloads did over the whole run of the application, per host and for the most recent downloads.
+ *
+ * Every event updates the running totals of its host and is added to a short list of recent downloads, nothing is
+ * recomputed. New connections are only counted for HTTPS, where every new connection does a TLS handshake. Plain
+ * HTTP connections are pooled just the same, but nothing tells them apart from reused ones, so plain HTTP requests
+ * are left out of the connection reuse numbers altogether.
+ *
+ * Thread safe, transfers record into it from the network thread.
+ */
+class NetworkStats
+{
+public:
+    /// One request, or one file served from the cache without a request
+    struct Download
+    {
+        QUrl url;
+        /// HTTP status code, 0 if there was no response or no request
+        int status = 0;
+        bool cacheHit = false;
+        bool failed = false;
+        bool http2 = false;
+        bool encrypted = false;
+        /// the request had to open a new encrypted connection
+        bool newConnection = false;
+        /// time to the response headers, -1 if there was no response
+        qint64 firstByteMs = -1;
+        qint64 bytes = 0;
+        qint64 ms = 0;
+    };
+
+    struct Host
+    {
+        QString host;
+        int requests = 0;
+        int failed = 0;
+        int retries = 0;
+        /// files that were still fresh in the cache, no request was made for them
+        int cacheHits = 0;
+        /// requests answered with 304, the cached file was still good
+        int notModified = 0;
+        /// requests answered with a body
+        int fullResponses = 0;
+        int http2Requests = 0;
+        /// HTTPS requests, the only ones connection reuse is known for
+        int encryptedRequests = 0;
+        int newConnections = 0;
+        qint64 bytes = 0;
+        qint64 totalMs = 0;
+        qint64 firstByteMs = 0;
+        int firstByteCount = 0;
+
+        /// Share of HTTPS requests that went over a connection that was already open, -1 without HTTPS requests
+        double reuseRatio() const;
+        /// Average time to the response headers, -1 without responses
+        qint64 averageFirstByteMs() const;
+        /// Bytes per second over the time spent in requests
+        qint64 bytesPerSecond() const;
+    };
+
+    static NetworkStats *instance();
+
+    void recordRequest(const Download &download);
+    void recordCacheHit(const QUrl &url);
+    void recordRetry(const QUrl &url);
+
+    /// Per host numbers so far, ordered by host name
+    QList<Host> hosts() const;
+    /// The most recent downloads, oldest first
+    QList<Download> recent() const;
+
+    QJsonArray hostsToJson() const;
+    QJsonArray recentToJson() const;
+    QJsonObject toJson() const;
+    /// Write a line for every host to the log
+    void log() const;
+
+private:
+    void addRecent(const Download &download);
+
+private:
+    mutable QMutex m_mutex;
+    QHash<QString, Host> m_hosts;
+    QList<Download> m_recent;
+};
+}
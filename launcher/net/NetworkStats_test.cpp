@@ -0,0 +1,86 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "net/NetworkStats.h"
+
+namespace {
+Net::NetworkStats::Download request(const QString &url, int status, qint64 bytes, qint64 ms)
+{
+    Net::NetworkStats::Download download;
+    download.url = QUrl(url);
+    download.status = status;
+    download.encrypted = download.url.scheme() == "https";
+    download.firstByteMs = ms / 2;
+    download.bytes = bytes;
+    download.ms = ms;
+    return download;
+}
+}
+
+class NetworkStatsTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_Hosts()
+    {
+        Net::NetworkStats stats;
+        auto first = request("https://resources.example.com/a", 200, 1000, 100);
+        first.newConnection = true;
+        first.http2 = true;
+        stats.recordRequest(first);
+        stats.recordRequest(request("https://resources.example.com/b", 200, 3000, 300));
+        stats.recordRequest(request("https://resources.example.com/c", 304, 0, 40));
+        auto broken = request("https://resources.example.com/d", 0, 0, 60);
+        broken.failed = true;
+        broken.firstByteMs = -1;
+        stats.recordRequest(broken);
+        stats.recordRetry(QUrl("https://resources.example.com/d"));
+        stats.recordCacheHit(QUrl("https://resources.example.com/e"));
+        stats.recordRequest(request("http://libraries.example.com/f", 200, 10, 10));
+        // plain HTTP to a host that is also used over HTTPS says nothing about reuse either
+        stats.recordRequest(request("http://resources.example.com/g", 200, 0, 0));
+
+        auto hosts = stats.hosts();
+        QCOMPARE(hosts.size(), 2);
+        QCOMPARE(hosts[0].host, QString("libraries.example.com"));
+        QCOMPARE(hosts[0].reuseRatio(), -1.0);
+
+        auto &host = hosts[1];
+        QCOMPARE(host.host, QString("resources.example.com"));
+        QCOMPARE(host.requests, 5);
+        QCOMPARE(host.encryptedRequests, 4);
+        QCOMPARE(host.fullResponses, 3);
+        QCOMPARE(host.notModified, 1);
+        QCOMPARE(host.failed, 1);
+        QCOMPARE(host.retries, 1);
+        QCOMPARE(host.cacheHits, 1);
+        QCOMPARE(host.http2Requests, 1);
+        QCOMPARE(host.reuseRatio(), 0.75);
+        QCOMPARE(host.bytesPerSecond(), qint64(8000));
+        // the failed request never got an answer
+        QCOMPARE(host.averageFirstByteMs(), qint64((50 + 150 + 20 + 0) / 4));
+
+        auto recent = stats.recent();
+        QCOMPARE(recent.size(), 7);
+        QVERIFY(recent[4].cacheHit);
+        QCOMPARE(stats.toJson().value("hosts").toArray().size(), 2);
+    }
+
+    void test_RecentIsCapped()
+    {
+        Net::NetworkStats stats;
+        for(int i = 0; i < 500; i++)
+        {
+            stats.recordRequest(request(QString("https://example.com/%1").arg(i), 200, 1, 1));
+        }
+        auto recent = stats.recent();
+        QVERIFY(recent.size() < 500);
+        QCOMPARE(recent.last().url, QUrl("https://example.com/499"));
+        QCOMPARE(stats.hosts().first().requests, 500);
+    }
+};
+
+QTEST_GUILESS_MAIN(NetworkStatsTest)
+
+#include "NetworkStats_test.moc"
@@ -0,0 +1,216 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NetworkThread.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QNetworkAccessManager>
+#include <QSslCertificate>
+
+#include "Sink.h"
+#include "NetworkStats.h"
+
+namespace {
+// progress of a transfer is passed on at most this often, in milliseconds
+const qint64 progressInterval = 100;
+
+void stopNetworkThread()
+{
+    auto thread = Net::NetworkThread::instance();
+    thread->quit();
+    thread->wait();
+}
+}
+
+namespace Net {
+
+NetworkThread *NetworkThread::instance()
+{
+    static NetworkThread *thread = []()
+    {
+        auto created = new NetworkThread();
+        created->setObjectName("Network");
+        created->start();
+        qAddPostRoutine(stopNetworkThread);
+        return created;
+    }();
+    return thread;
+}
+
+void NetworkThread::run()
+{
+    // lives and dies on this thread, taking any leftover replies with it
+    QNetworkAccessManager network;
+    m_network = &network;
+    exec();
+    m_network = nullptr;
+}
+
+Transfer::Transfer(const QNetworkRequest &request, const QNetworkProxy &proxy, std::shared_ptr<Sink> sink)
+    : m_request(request), m_proxy(proxy), m_sink(sink)
+{
+}
+
+Transfer::~Transfer()
+{
+    if(m_reply)
+    {
+        m_reply->deleteLater();
+    }
+}
+
+QNetworkReply *Transfer::takeReply()
+{
+    QNetworkReply *reply = m_reply;
+    m_reply = nullptr;
+    return reply;
+}
+
+void Transfer::start()
+{
+    if(m_aborted)
+    {
+        m_error = QNetworkReply::OperationCanceledError;
+        emit finished();
+        return;
+    }
+    auto network = NetworkThread::instance()->network();
+    // follow the proxy settings of the network the download was started with
+    if(network->proxy() != m_proxy)
+    {
+        network->setProxy(m_proxy);
+    }
+    m_reply = network->get(m_request);
+    m_lastProgress.start();
+    m_started.start();
+    connect(m_reply.data(), &QNetworkReply::metaDataChanged, this, [this]()
+    {
+        if(m_firstByteMs < 0)
+        {
+            m_firstByteMs = m_started.elapsed();
+            bool known = false;
+            auto size = m_reply->header(QNetworkRequest::ContentLengthHeader).toLongLong(&known);
+            if(known)
+            {
+                m_sink->expectSize(size);
+            }
+        }
+    });
+    // only emitted for the request that triggered the handshake, not for later ones reusing the connection
+    connect(m_reply.data(), &QNetworkReply::encrypted, this, [this]()
+    {
+        m_newConnection = true;
+    });
+    connect(m_reply.data(), &QNetworkReply::downloadProgress, this, &Transfer::replyProgress);
+    connect(m_reply.data(), &QNetworkReply::readyRead, this, &Transfer::readyRead);
+    connect(m_reply.data(), SIGNAL(error(QNetworkReply::NetworkError)), SLOT(replyError(QNetworkReply::NetworkError)));
+    connect(m_reply.data(), &QNetworkReply::sslErrors, this, &Transfer::sslErrors);
+    connect(m_reply.data(), &QNetworkReply::finished, this, &Transfer::replyFinished);
+}
+
+void Transfer::abort()
+{
+    m_aborted = true;
+    if(m_reply)
+    {
+        m_reply->abort();
+    }
+}
+
+void Transfer::writeData(QByteArray &data)
+{
+    if(data.isEmpty() || m_status != Job_InProgress || m_error != QNetworkReply::NoError)
+    {
+        return;
+    }
+    m_bytes += data.size();
+    m_status = m_sink->write(data);
+    if(m_status == Job_Failed)
+    {
+        qCritical() << "Failed to process response chunk for" << m_request.url().toString();
+    }
+}
+
+void Transfer::drain()
+{
+    // read straight into a pooled buffer and hand that to the sink, instead of a new array for every chunk
+    auto pool = NetworkThread::instance()->buffers();
+    auto buffer = pool->take();
+    qint64 read;
+    while((read = m_reply->read(buffer.data(), BufferPool::bufferSize)) > 0)
+    {
+        buffer.resize(int(read));
+        writeData(buffer);
+        buffer.resize(BufferPool::bufferSize);
+    }
+    pool->give(buffer);
+}
+
+void Transfer::readyRead()
+{
+    drain();
+}
+
+void Transfer::replyProgress(qint64 bytesReceived, qint64 bytesTotal)
+{
+    if(bytesReceived == bytesTotal || m_lastProgress.elapsed() >= progressInterval)
+    {
+        m_lastProgress.restart();
+        emit progress(bytesReceived, bytesTotal);
+    }
+}
+
+void Transfer::replyError(QNetworkReply::NetworkError error)
+{
+    m_error = error;
+}
+
+void Transfer::replyFinished()
+{
+    // make sure we got all the remaining data, if any
+    drain();
+
+    NetworkStats::Download stats;
+    stats.url = m_reply->url();
+    if(!stats.url.isLocalFile())
+    {
+        stats.status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        stats.failed = m_error != QNetworkReply::NoError || m_status == Job_Failed;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+        stats.http2 = m_reply->attribute(QNetworkRequest::HTTP2WasUsedAttribute).toBool();
+#endif
+        stats.encrypted = stats.url.scheme() == "https";
+        stats.newConnection = m_newConnection;
+        stats.firstByteMs = m_firstByteMs;
+        stats.bytes = m_bytes;
+        stats.ms = m_started.elapsed();
+        NetworkStats::instance()->recordRequest(stats);
+    }
+    emit finished();
+}
+
+void Transfer::sslErrors(const QList<QSslError> &errors)
+{
+    int i = 1;
+    for (auto error : errors)
+    {
+        qCritical() << "Download" << m_request.url().toString() << "SSL Error #" << i << " : " << error.errorString();
+        auto cert = error.certificate();
+        qCritical() << "Certificate in question:\n" << cert.toText();
+        i++;
+    }
+}
+}
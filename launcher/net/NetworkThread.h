@@ -0,0 +1,129 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QNetworkProxy>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QPointer>
+#include <QThread>
+#include <memory>
+
+#include "NetAction.h"
+#include "BufferPool.h"
+
+class QNetworkAccessManager;
+
+namespace Net {
+class Sink;
+
+/**
+ * The thread downloads do their network and disk I/O on.
+ *
+ * It has its own QNetworkAccessManager, so the replies of downloads live here, along with the writes into their sinks
+ * (files and checksums). The GUI thread only gets throttled progress and the completion of each download.
+ */
+class NetworkThread : public QThread
+{
+    Q_OBJECT
+public:
+    /// The shared network thread, started on first use and stopped when the application object goes away
+    static NetworkThread *instance();
+
+    /// Only to be used from the network thread itself
+    QNetworkAccessManager *network() const
+    {
+        return m_network;
+    }
+
+    /// Only to be used from the network thread itself
+    BufferPool *buffers()
+    {
+        return &m_buffers;
+    }
+
+protected:
+    void run() override;
+
+private:
+    NetworkThread() = default;
+
+private:
+    QNetworkAccessManager *m_network = nullptr;
+    BufferPool m_buffers;
+};
+
+/**
+ * One request made on the network thread, writing everything it receives into a sink.
+ *
+ * Created on the thread of the download and then moved to the network thread. The sink is initialized before and
+ * finalized after by the download, only the writes happen here.
+ */
+class Transfer : public QObject
+{
+    Q_OBJECT
+public:
+    Transfer(const QNetworkRequest &request, const QNetworkProxy &proxy, std::shared_ptr<Sink> sink);
+    virtual ~Transfer();
+
+    /// Status of the writes into the sink
+    JobStatus status() const
+    {
+        return m_status;
+    }
+    QNetworkReply::NetworkError error() const
+    {
+        return m_error;
+    }
+    /// Hand the reply over once finished, to be read from the download's thread and deleted with deleteLater()
+    QNetworkReply *takeReply();
+
+public slots:
+    void start();
+    void abort();
+
+signals:
+    void progress(qint64 bytesReceived, qint64 bytesTotal);
+    void finished();
+
+private slots:
+    void readyRead();
+    void replyProgress(qint64 bytesReceived, qint64 bytesTotal);
+    void replyError(QNetworkReply::NetworkError error);
+    void replyFinished();
+    void sslErrors(const QList<QSslError> &errors);
+
+private:
+    void drain();
+    void writeData(QByteArray &data);
+
+private:
+    QNetworkRequest m_request;
+    QNetworkProxy m_proxy;
+    std::shared_ptr<Sink> m_sink;
+    QPointer<QNetworkReply> m_reply;
+    JobStatus m_status = Job_InProgress;
+    QNetworkReply::NetworkError m_error = QNetworkReply::NoError;
+    bool m_aborted = false;
+    QElapsedTimer m_lastProgress;
+    QElapsedTimer m_started;
+    qint64 m_bytes = 0;
+    qint64 m_firstByteMs = -1;
+    // the reply had to open a new encrypted connection
+    bool m_newConnection = false;
+};
+}
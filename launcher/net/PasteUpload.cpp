@@ -24,12 +24,140 @@ PasteUpload::PasteUpload(QWidget *window, QString text, QString key) : m_window(
     m_jsonContent = docOut.toJson();
 }
 
+namespace {
+// the request body around the escaped text of streamed uploads
+const QByteArray bodyPrefix = "{\"description\":\"Log Upload\",\"sections\":[{\"contents\":\"";
+const QByteArray bodySuffix = "\"}]}";
+
+// JSON string escaping of UTF-8 text. Multi-byte sequences pass through untouched, so chunks can be split anywhere.
+QByteArray escapeJson(const QByteArray &chunk)
+{
+    QByteArray out;
+    out.reserve(chunk.size() + chunk.size() / 8);
+    for(char c: chunk)
+    {
+        switch(c)
+        {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                if(uchar(c) < 0x20)
+                {
+                    out.append(QString("\\u%1").arg(int(uchar(c)), 4, 16, QChar('0')).toLatin1());
+                }
+                else
+                {
+                    out.append(c);
+                }
+        }
+    }
+    return out;
+}
+}
+
+PasteUpload::PasteUpload(QWidget *window, QIODevice &text, QString key) : m_window(window)
+{
+    m_key = key;
+    m_jsonFile.reset(new QTemporaryFile());
+    if(!m_jsonFile->open())
+    {
+        qCritical() << "Could not create a temporary file for the paste upload:" << m_jsonFile->errorString();
+        m_error = m_jsonFile->errorString();
+        return;
+    }
+    // start with as much text as the limit allows and take less while escaping still makes the body too big
+    qint64 budget = maxSize() - bodyPrefix.size() - bodySuffix.size();
+    for(int attempt = 0; attempt < 4; attempt++)
+    {
+        if(!writeBody(text, budget))
+        {
+            qCritical() << "Could not write the paste upload:" << m_jsonFile->errorString();
+            m_error = m_jsonFile->errorString();
+            return;
+        }
+        if(text.isSequential() || m_jsonFile->size() <= maxSize())
+        {
+            return;
+        }
+        budget = budget * maxSize() / m_jsonFile->size() - 4096;
+    }
+}
+
+bool PasteUpload::writeBody(QIODevice &text, qint64 budget)
+{
+    if(!m_jsonFile->resize(0) || !m_jsonFile->seek(0))
+    {
+        return false;
+    }
+    // only the newest part of the log fits, so skip ahead and start at the first whole line
+    m_truncated = false;
+    if(!text.isSequential())
+    {
+        qint64 start = qMax(qint64(0), text.size() - budget);
+        qint64 pos = start;
+        if(start > 0)
+        {
+            m_truncated = true;
+            if(!text.seek(start))
+            {
+                return false;
+            }
+            bool found = false;
+            while(!found && !text.atEnd())
+            {
+                auto chunk = text.read(4096);
+                int newline = chunk.indexOf('\n');
+                found = newline >= 0;
+                pos += found ? newline + 1 : chunk.size();
+            }
+            if(!found)
+            {
+                // one enormous line, start at the next whole character instead
+                pos = start;
+                char c;
+                while(text.seek(pos) && text.getChar(&c) && (uchar(c) & 0xC0) == 0x80)
+                {
+                    pos++;
+                }
+            }
+        }
+        if(!text.seek(pos))
+        {
+            return false;
+        }
+    }
+    bool ok = m_jsonFile->write(bodyPrefix) == bodyPrefix.size();
+    if(ok && m_truncated)
+    {
+        auto note = escapeJson(tr("[Older lines were left out to stay under the paste size limit]\n").toUtf8());
+        ok = m_jsonFile->write(note) == note.size();
+    }
+    while(ok && !text.atEnd())
+    {
+        auto chunk = text.read(64 * 1024);
+        if(chunk.isEmpty())
+        {
+            break;
+        }
+        auto escaped = escapeJson(chunk);
+        ok = m_jsonFile->write(escaped) == escaped.size();
+    }
+    return ok && m_jsonFile->write(bodySuffix) == bodySuffix.size() && m_jsonFile->flush() && m_jsonFile->seek(0);
+}
+
 PasteUpload::~PasteUpload()
 {
 }
 
 bool PasteUpload::validateText()
 {
+    if(m_jsonFile)
+    {
+        return m_error.isEmpty() && m_jsonFile->size() <= maxSize();
+    }
     return m_jsonContent.size() <= maxSize();
 }
 
@@ -39,10 +167,18 @@ void PasteUpload::executeTask()
     request.setHeader(QNetworkRequest::UserAgentHeader, BuildConfig.USER_AGENT_UNCACHED);
 
     request.setRawHeader("Content-Type", "application/json");
-    request.setRawHeader("Content-Length", QByteArray::number(m_jsonContent.size()));
+    request.setRawHeader("Content-Length", QByteArray::number(m_jsonFile ? m_jsonFile->size() : m_jsonContent.size()));
     request.setRawHeader("X-Auth-Token", m_key.toStdString().c_str());
 
-    QNetworkReply *rep = APPLICATION->network()->post(request, m_jsonContent);
+    QNetworkReply *rep;
+    if(m_jsonFile)
+    {
+        rep = APPLICATION->network()->post(request, m_jsonFile.get());
+    }
+    else
+    {
+        rep = APPLICATION->network()->post(request, m_jsonContent);
+    }
 
     m_reply = std::shared_ptr<QNetworkReply>(rep);
     setStatus(tr("Uploading to paste.ee"));
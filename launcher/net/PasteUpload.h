@@ -2,6 +2,7 @@
 #include "tasks/Task.h"
 #include <QNetworkReply>
 #include <QBuffer>
+#include <QTemporaryFile>
 #include <memory>
 
 class PasteUpload : public Task
@@ -9,6 +10,11 @@ class PasteUpload : public Task
     Q_OBJECT
 public:
     PasteUpload(QWidget *window, QString text, QString key = "public");
+    /**
+     * Upload UTF-8 text read from the device, without holding all of it in memory.
+     * If the device is seekable and holds more than the paste size limit, only its newest lines are uploaded.
+     */
+    PasteUpload(QWidget *window, QIODevice &text, QString key = "public");
     virtual ~PasteUpload();
 
     QString pasteLink()
@@ -28,17 +34,26 @@ public:
         return 1024*1024*12;
     }
     bool validateText();
+    /// True if older lines of the text were left out to make it fit
+    bool truncated() const
+    {
+        return m_truncated;
+    }
 protected:
     virtual void executeTask();
 
 private:
     bool parseResult(QJsonDocument doc);
+    bool writeBody(QIODevice &text, qint64 budget);
     QString m_error;
     QWidget *m_window;
     QString m_pasteID;
     QString m_pasteLink;
     QString m_key;
     QByteArray m_jsonContent;
+    // request body of streamed uploads, used instead of m_jsonContent when set
+    std::unique_ptr<QTemporaryFile> m_jsonFile;
+    bool m_truncated = false;
     std::shared_ptr<QNetworkReply> m_reply;
 public
 slots:
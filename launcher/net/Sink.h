@@ -18,6 +18,11 @@ public: /* methods */
     virtual JobStatus finalize(QNetworkReply & reply) = 0;
     virtual bool hasLocalData() = 0;
 
+    /// Size of the response body, when the server tells it before sending any of it
+    virtual void expectSize(qint64)
+    {
+    }
+
     void addValidator(Validator * validator)
     {
         if(validator)
@@ -53,6 +53,7 @@ void NotificationChecker::checkForNotifications()
         return;
     }
     m_checkJob.reset(new NetJob("Checking for notifications"));
+    m_checkJob->setPriority(TaskScheduler::Priority::Background);
     auto entry = APPLICATION->metacache()->resolveEntry("root", "notifications.json");
     entry->setStale(true);
     m_checkJob->addNetAction(m_download = Net::Download::makeCached(m_notificationsUrl, entry));
@@ -17,7 +17,6 @@ slots:
     void downloadProgress(qint64 bytesReceived, qint64 bytesTotal) override;
     void downloadError(QNetworkReply::NetworkError error) override;
     void downloadFinished() override;
-    void downloadReadyRead() override {}
 
 public
 slots:
@@ -0,0 +1,250 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ThumbnailStore.h"
+
+#include "FileSystem.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QSaveFile>
+
+namespace {
+const quint32 storeMagic = 0x4d4d4354; // "MMCT"
+const quint32 storeVersion = 1;
+// don't bother rewriting the store for less than this
+const qint64 minGarbage = 4 * 1024 * 1024;
+}
+
+ThumbnailStore::ThumbnailStore(const QString &storePath, const QString &folder)
+    : m_storePath(storePath), m_folder(folder)
+{
+}
+
+QImage ThumbnailStore::get(const QFileInfo &file)
+{
+    QMutexLocker locker(&m_mutex);
+    if(!load())
+    {
+        return QImage();
+    }
+    auto iter = m_entries.constFind(file.fileName());
+    if(iter == m_entries.constEnd() || iter->size != file.size()
+       || iter->modified != file.lastModified().toMSecsSinceEpoch())
+    {
+        return QImage();
+    }
+    if(!m_file.seek(iter->offset))
+    {
+        return QImage();
+    }
+    auto data = m_file.read(iter->length);
+    QImage image;
+    if(data.size() != int(iter->length) || !image.loadFromData(data, "PNG"))
+    {
+        qWarning() << "Unreadable thumbnail of" << file.fileName() << "in" << m_storePath;
+        return QImage();
+    }
+    return image;
+}
+
+void ThumbnailStore::put(const QFileInfo &file, const QImage &thumbnail)
+{
+    QByteArray data;
+    {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        if(!thumbnail.save(&buffer, "PNG"))
+        {
+            return;
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if(!load())
+    {
+        return;
+    }
+    auto name = file.fileName();
+    Entry entry;
+    entry.size = file.size();
+    entry.modified = file.lastModified().toMSecsSinceEpoch();
+    entry.length = data.size();
+
+    QDataStream out(&m_file);
+    out.setVersion(QDataStream::Qt_5_0);
+    auto start = m_file.size();
+    m_file.seek(start);
+    out << name << entry.size << entry.modified << entry.length;
+    entry.offset = m_file.pos();
+    if(out.writeRawData(data.constData(), data.size()) != data.size() || !m_file.flush())
+    {
+        qWarning() << "Could not write to thumbnail store" << m_storePath << ":" << m_file.errorString();
+        m_file.resize(start);
+        return;
+    }
+
+    auto old = m_entries.constFind(name);
+    if(old != m_entries.constEnd())
+    {
+        m_garbage += old->length;
+    }
+    m_entries.insert(name, entry);
+}
+
+bool ThumbnailStore::load()
+{
+    if(m_loaded)
+    {
+        return m_file.isOpen();
+    }
+    m_loaded = true;
+
+    m_file.setFileName(m_storePath);
+    if(!FS::ensureFilePathExists(m_storePath) || !m_file.open(QIODevice::ReadWrite))
+    {
+        qWarning() << "Could not open thumbnail store" << m_storePath << ":" << m_file.errorString();
+        return false;
+    }
+
+    QDataStream in(&m_file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if(in.status() != QDataStream::Ok || magic != storeMagic || version != storeVersion)
+    {
+        return reset();
+    }
+
+    auto fileSize = m_file.size();
+    auto end = m_file.pos();
+    while(!in.atEnd())
+    {
+        QString name;
+        Entry entry;
+        in >> name >> entry.size >> entry.modified >> entry.length;
+        entry.offset = m_file.pos();
+        if(in.status() != QDataStream::Ok || entry.offset + entry.length > fileSize || !m_file.seek(entry.offset + entry.length))
+        {
+            break;
+        }
+        auto old = m_entries.constFind(name);
+        if(old != m_entries.constEnd())
+        {
+            m_garbage += old->length;
+        }
+        m_entries.insert(name, entry);
+        end = m_file.pos();
+    }
+    if(end != fileSize)
+    {
+        // the launcher stopped while adding a thumbnail
+        qWarning() << "Dropping incomplete thumbnail at the end of" << m_storePath;
+        m_file.resize(end);
+    }
+
+    for(auto iter = m_entries.begin(); iter != m_entries.end();)
+    {
+        if(QFile::exists(FS::PathCombine(m_folder, iter.key())))
+        {
+            iter++;
+            continue;
+        }
+        m_garbage += iter->length;
+        iter = m_entries.erase(iter);
+    }
+    if(m_garbage > minGarbage && m_garbage > m_file.size() / 2)
+    {
+        compact();
+    }
+    return m_file.isOpen();
+}
+
+bool ThumbnailStore::reset()
+{
+    m_entries.clear();
+    m_garbage = 0;
+    bool ok = m_file.resize(0) && m_file.seek(0);
+    if(ok)
+    {
+        QDataStream out(&m_file);
+        out.setVersion(QDataStream::Qt_5_0);
+        out << storeMagic << storeVersion;
+        ok = out.status() == QDataStream::Ok && m_file.flush();
+    }
+    if(!ok)
+    {
+        qWarning() << "Could not create thumbnail store" << m_storePath << ":" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void ThumbnailStore::compact()
+{
+    QSaveFile output(m_storePath);
+    if(!output.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Could not compact thumbnail store" << m_storePath << ":" << output.errorString();
+        return;
+    }
+    QDataStream out(&output);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << storeMagic << storeVersion;
+
+    QHash<QString, Entry> entries;
+    for(auto iter = m_entries.constBegin(); iter != m_entries.constEnd(); iter++)
+    {
+        if(!m_file.seek(iter->offset))
+        {
+            return;
+        }
+        auto data = m_file.read(iter->length);
+        if(data.size() != int(iter->length))
+        {
+            return;
+        }
+        Entry entry = *iter;
+        out << iter.key() << entry.size << entry.modified << entry.length;
+        entry.offset = output.pos();
+        out.writeRawData(data.constData(), data.size());
+        entries.insert(iter.key(), entry);
+    }
+    if(out.status() != QDataStream::Ok)
+    {
+        return;
+    }
+
+    m_file.close();
+    if(!output.commit())
+    {
+        qWarning() << "Could not compact thumbnail store" << m_storePath << ":" << output.errorString();
+    }
+    else
+    {
+        qDebug() << "Compacted thumbnail store" << m_storePath << ", dropped" << m_garbage << "bytes";
+        m_entries = entries;
+        m_garbage = 0;
+    }
+    if(!m_file.open(QIODevice::ReadWrite))
+    {
+        qWarning() << "Could not reopen thumbnail store" << m_storePath << ":" << m_file.errorString();
+    }
+}
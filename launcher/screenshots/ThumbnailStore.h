@@ -0,0 +1,67 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+
+/**
+ * Thumbnails of the screenshots in one folder, packed into a single file.
+ *
+ * Thumbnails are stored by file name along with the size and modification time of the screenshot they were made from,
+ * and only returned while those still match. New thumbnails are appended to the file, and thumbnails of changed or
+ * deleted screenshots are dropped when enough of the file is taken up by them.
+ *
+ * All methods can be called from any thread.
+ */
+class ThumbnailStore
+{
+public:
+    ThumbnailStore(const QString &storePath, const QString &folder);
+
+    /// The stored thumbnail of the file, or a null image if there is none for its current contents
+    QImage get(const QFileInfo &file);
+
+    void put(const QFileInfo &file, const QImage &thumbnail);
+
+private:
+    struct Entry
+    {
+        qint64 size;
+        qint64 modified;
+        qint64 offset;
+        quint32 length;
+    };
+
+    // these expect m_mutex to be held
+    bool load();
+    bool reset();
+    void compact();
+
+private:
+    QString m_storePath;
+    QString m_folder;
+
+    QMutex m_mutex;
+    bool m_loaded = false;
+    QFile m_file;
+    QHash<QString, Entry> m_entries;
+    qint64 m_garbage = 0;
+};
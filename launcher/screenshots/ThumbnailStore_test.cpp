@@ -0,0 +1,95 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "screenshots/ThumbnailStore.h"
+
+namespace {
+QImage thumbnail(QRgb color)
+{
+    QImage image(QSize(32, 32), QImage::Format_ARGB32);
+    image.fill(color);
+    return image;
+}
+}
+
+class ThumbnailStoreTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_Persistence()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto folder = FS::PathCombine(temp.path(), "screenshots");
+        auto storePath = FS::PathCombine(temp.path(), "cache", "store.thumbs");
+        auto first = FS::PathCombine(folder, "first.png");
+        auto second = FS::PathCombine(folder, "second.png");
+        FS::write(first, "first");
+        FS::write(second, "second");
+
+        {
+            ThumbnailStore store(storePath, folder);
+            QVERIFY(store.get(QFileInfo(first)).isNull());
+            store.put(QFileInfo(first), thumbnail(qRgb(255, 0, 0)));
+            store.put(QFileInfo(second), thumbnail(qRgb(0, 255, 0)));
+            QCOMPARE(store.get(QFileInfo(first)).pixel(0, 0), qRgb(255, 0, 0));
+        }
+
+        // a changed screenshot doesn't get its old thumbnail
+        FS::write(second, "second, but longer");
+
+        ThumbnailStore store(storePath, folder);
+        QCOMPARE(store.get(QFileInfo(first)).pixel(0, 0), qRgb(255, 0, 0));
+        QVERIFY(store.get(QFileInfo(second)).isNull());
+        store.put(QFileInfo(second), thumbnail(qRgb(0, 0, 255)));
+        QCOMPARE(store.get(QFileInfo(second)).pixel(0, 0), qRgb(0, 0, 255));
+    }
+
+    void test_Truncated()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto folder = temp.path();
+        auto storePath = FS::PathCombine(temp.path(), "store.thumbs");
+        auto first = FS::PathCombine(folder, "first.png");
+        auto second = FS::PathCombine(folder, "second.png");
+        FS::write(first, "first");
+        FS::write(second, "second");
+        {
+            ThumbnailStore store(storePath, folder);
+            store.put(QFileInfo(first), thumbnail(qRgb(255, 0, 0)));
+            store.put(QFileInfo(second), thumbnail(qRgb(0, 255, 0)));
+        }
+
+        // as if the launcher was killed while writing the second thumbnail
+        QFile file(storePath);
+        QVERIFY(file.resize(file.size() - 10));
+
+        ThumbnailStore store(storePath, folder);
+        QCOMPARE(store.get(QFileInfo(first)).pixel(0, 0), qRgb(255, 0, 0));
+        QVERIFY(store.get(QFileInfo(second)).isNull());
+        store.put(QFileInfo(second), thumbnail(qRgb(0, 255, 0)));
+        QCOMPARE(store.get(QFileInfo(second)).pixel(0, 0), qRgb(0, 255, 0));
+    }
+
+    void test_Garbage()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto storePath = FS::PathCombine(temp.path(), "store.thumbs");
+        FS::write(storePath, "not a thumbnail store");
+        ThumbnailStore store(storePath, temp.path());
+        auto path = FS::PathCombine(temp.path(), "shot.png");
+        FS::write(path, "shot");
+        QVERIFY(store.get(QFileInfo(path)).isNull());
+        store.put(QFileInfo(path), thumbnail(qRgb(1, 2, 3)));
+        QCOMPARE(store.get(QFileInfo(path)).pixel(0, 0), qRgb(1, 2, 3));
+    }
+};
+
+QTEST_GUILESS_MAIN(ThumbnailStoreTest)
+
+#include "ThumbnailStore_test.moc"
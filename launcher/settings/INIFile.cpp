@@ -22,6 +22,8 @@
 #include <QSaveFile>
 #include <QDebug>
 
+#include <algorithm>
+
 INIFile::INIFile()
 {
 }
@@ -60,9 +62,22 @@ QString INIFile::unescape(QString orig)
 
 QString INIFile::escape(QString orig)
 {
+    auto special = [](QChar c)
+    {
+        return c == '\n' || c == '\t' || c == '\\' || c == '#';
+    };
+    // most values have nothing to escape
+    auto first = std::find_if(orig.cbegin(), orig.cend(), special);
+    if(first == orig.cend())
+    {
+        return orig;
+    }
     QString out;
-    for(auto c: orig)
+    out.reserve(orig.size() + 16);
+    out.append(orig.constData(), int(first - orig.cbegin()));
+    for(auto iter = first; iter != orig.cend(); iter++)
     {
+        auto c = *iter;
         if(c == '\n')
             out += "\\n";
         else if (c == '\t')
@@ -77,18 +92,21 @@ QString INIFile::escape(QString orig)
     return out;
 }
 
-bool INIFile::saveFile(QString fileName)
+void INIFile::serialize(QByteArray &out) const
 {
-    QByteArray outArray;
-    for (Iterator iter = begin(); iter != end(); iter++)
+    for (auto iter = constBegin(); iter != constEnd(); iter++)
     {
-        QString value = iter.value().toString();
-        value = escape(value);
-        outArray.append(iter.key().toUtf8());
-        outArray.append('=');
-        outArray.append(value.toUtf8());
-        outArray.append('\n');
+        out.append(iter.key().toUtf8());
+        out.append('=');
+        out.append(escape(iter.value().toString()).toUtf8());
+        out.append('\n');
     }
+}
+
+bool INIFile::saveFile(QString fileName)
+{
+    QByteArray outArray;
+    serialize(outArray);
 
     try
     {
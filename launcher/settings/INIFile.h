@@ -28,6 +28,8 @@ public:
     bool loadFile(QByteArray file);
     bool loadFile(QString fileName);
     bool saveFile(QString fileName);
+    /// Append the file contents to out
+    void serialize(QByteArray &out) const;
 
     QVariant get(QString key, QVariant def) const;
     void set(QString key, QVariant val);
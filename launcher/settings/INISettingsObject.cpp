@@ -16,20 +16,127 @@
 #include "INISettingsObject.h"
 #include "Setting.h"
 
+#include "FileSystem.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+namespace {
+// a single thread, so the writes of a file land in the order they were made
+class SettingsWriter : public QThreadPool
+{
+public:
+    SettingsWriter()
+    {
+        setMaxThreadCount(1);
+    }
+};
+
+SettingsWriter &writer()
+{
+    static SettingsWriter pool;
+    return pool;
+}
+
+QSet<INISettingsObject *> &delayedObjects()
+{
+    static QSet<INISettingsObject *> objects;
+    return objects;
+}
+
+void writeSettings(const QString &path, const QByteArray &data)
+{
+    // the instance was deleted in the meantime, don't bring its folder back
+    if(!QFileInfo(path).absoluteDir().exists())
+    {
+        qWarning() << "Not saving settings to" << path << "because its folder is gone";
+        return;
+    }
+    try
+    {
+        FS::write(path, data);
+    }
+    catch (const Exception &e)
+    {
+        qCritical() << e.what();
+    }
+}
+}
+
 INISettingsObject::INISettingsObject(const QString &path, QObject *parent)
     : SettingsObject(parent)
 {
     m_filePath = path;
     m_ini.loadFile(path);
+    m_saveTimer.setSingleShot(true);
+    connect(&m_saveTimer, &QTimer::timeout, this, &INISettingsObject::queueSave);
+}
+
+INISettingsObject::~INISettingsObject()
+{
+    if(delayedObjects().remove(this))
+    {
+        flush();
+    }
 }
 
 void INISettingsObject::setFilePath(const QString &filePath)
 {
+    flush();
     m_filePath = filePath;
 }
 
+void INISettingsObject::setSaveDelay(int milliseconds)
+{
+    m_saveTimer.setInterval(milliseconds);
+    if(milliseconds > 0)
+    {
+        delayedObjects().insert(this);
+        // from now on the buffer keeps its capacity between saves
+        m_buffer.reserve(4096);
+    }
+    else
+    {
+        delayedObjects().remove(this);
+        flush();
+    }
+}
+
+void INISettingsObject::flush()
+{
+    m_saveTimer.stop();
+    queueSave();
+    m_lastWrite.waitForFinished();
+}
+
+void INISettingsObject::flushAll()
+{
+    for(auto object: delayedObjects())
+    {
+        object->flush();
+    }
+}
+
+void INISettingsObject::queueSave()
+{
+    if(!m_dirty)
+    {
+        return;
+    }
+    m_dirty = false;
+    m_buffer.resize(0);
+    m_ini.serialize(m_buffer);
+    m_lastWrite = QtConcurrent::run(&writer(), writeSettings, m_filePath, m_buffer);
+}
+
 bool INISettingsObject::reload()
 {
+    // keep the changes that are not on disk yet
+    flush();
     return m_ini.loadFile(m_filePath) && SettingsObject::reload();
 }
 
@@ -43,7 +150,17 @@ void INISettingsObject::resumeSave()
     m_suspendSave = false;
     if(m_doSave)
     {
-        m_ini.saveFile(m_filePath);
+        m_doSave = false;
+        // whoever suspended saving is done with a batch of changes and expects them on disk now
+        if(m_saveTimer.interval() > 0)
+        {
+            m_dirty = true;
+            flush();
+        }
+        else
+        {
+            m_ini.saveFile(m_filePath);
+        }
     }
 }
 
@@ -75,6 +192,11 @@ void INISettingsObject::doSave()
     {
         m_doSave = true;
     }
+    else if(m_saveTimer.interval() > 0)
+    {
+        m_dirty = true;
+        m_saveTimer.start();
+    }
     else
     {
         m_ini.saveFile(m_filePath);
@@ -15,7 +15,9 @@
 
 #pragma once
 
+#include <QFuture>
 #include <QObject>
+#include <QTimer>
 
 #include "settings/INIFile.h"
 
@@ -29,6 +31,7 @@ class INISettingsObject : public SettingsObject
     Q_OBJECT
 public:
     explicit INISettingsObject(const QString &path, QObject *parent = 0);
+    virtual ~INISettingsObject();
 
     /*!
      * \brief Gets the path to the INI file.
@@ -50,10 +53,31 @@ public:
     void suspendSave() override;
     void resumeSave() override;
 
+    /*!
+     * \brief Write changes on a background thread instead of right away.
+     * Changes made within the delay of each other are written together. Only use this for settings that stay in
+     * the same place while they are in use, and not for ones being put together in a staging folder.
+     * \param milliseconds How long to wait for further changes before writing.
+     */
+    void setSaveDelay(int milliseconds = 250);
+
+    /*!
+     * \brief Writes pending changes and waits until they are on disk.
+     */
+    void flush();
+
+    /*!
+     * \brief Flushes all settings objects with delayed saving. Used on shutdown.
+     */
+    static void flushAll();
+
 protected slots:
     virtual void changeSetting(const Setting &setting, QVariant value) override;
     virtual void resetSetting(const Setting &setting) override;
 
+private slots:
+    void queueSave();
+
 protected:
     virtual QVariant retrieveValue(const Setting &setting) override;
     void doSave();
@@ -61,4 +85,11 @@ protected:
 protected:
     INIFile m_ini;
     QString m_filePath;
+
+private:
+    QTimer m_saveTimer;
+    bool m_dirty = false;
+    // reused between saves, the writer only holds a shared copy
+    QByteArray m_buffer;
+    QFuture<void> m_lastWrite;
 };
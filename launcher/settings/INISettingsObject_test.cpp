@@ -0,0 +1,91 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "settings/INIFile.h"
+#include "settings/INISettingsObject.h"
+
+namespace {
+QVariant readBack(const QString &path, const QString &key)
+{
+    INIFile file;
+    file.loadFile(path);
+    return file.get(key, QVariant());
+}
+}
+
+class INISettingsObjectTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_Immediate()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto path = FS::PathCombine(temp.path(), "instance.cfg");
+        INISettingsObject settings(path);
+        settings.registerSetting("name", QString());
+        settings.set("name", "first");
+        QCOMPARE(readBack(path, "name").toString(), QString("first"));
+    }
+
+    void test_Delayed()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto path = FS::PathCombine(temp.path(), "instance.cfg");
+        INISettingsObject settings(path);
+        settings.setSaveDelay(50);
+        settings.registerSetting("JavaVersion", QString());
+        settings.registerSetting("lastLaunchTime", 0);
+
+        settings.set("JavaVersion", "1.8.0_51");
+        settings.set("lastLaunchTime", 1234);
+        QVERIFY(!QFile::exists(path));
+        QTRY_COMPARE(readBack(path, "lastLaunchTime").toInt(), 1234);
+        QCOMPARE(readBack(path, "JavaVersion").toString(), QString("1.8.0_51"));
+
+        settings.set("JavaVersion", "16.0.1");
+        settings.flush();
+        QCOMPARE(readBack(path, "JavaVersion").toString(), QString("16.0.1"));
+    }
+
+    void test_SuspendedBatch()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto path = FS::PathCombine(temp.path(), "instance.cfg");
+        INISettingsObject settings(path);
+        settings.setSaveDelay(10000);
+        settings.registerSetting("a", 0);
+        settings.suspendSave();
+        settings.set("a", 1);
+        QVERIFY(!QFile::exists(path));
+        // the batch is written as soon as saving resumes
+        settings.resumeSave();
+        QCOMPARE(readBack(path, "a").toInt(), 1);
+    }
+
+    void test_FolderGone()
+    {
+        QTemporaryDir temp;
+        QVERIFY(temp.isValid());
+        auto folder = FS::PathCombine(temp.path(), "instance");
+        auto path = FS::PathCombine(folder, "instance.cfg");
+        FS::write(path, "a=0\n");
+        {
+            INISettingsObject settings(path);
+            settings.setSaveDelay(10000);
+            settings.registerSetting("a", 0);
+            settings.set("a", 1);
+            QVERIFY(FS::deletePath(folder));
+        }
+        QVERIFY(!QFile::exists(folder));
+    }
+};
+
+QTEST_GUILESS_MAIN(INISettingsObjectTest)
+
+#include "INISettingsObject_test.moc"
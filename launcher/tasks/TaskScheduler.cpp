@@ -0,0 +1,272 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TaskScheduler.h"
+
+#include <QThread>
+
+namespace {
+int resourceIndex(TaskScheduler::Resource resource)
+{
+    switch(resource)
+    {
+        case TaskScheduler::Network:
+            return 0;
+        case TaskScheduler::Disk:
+            return 1;
+        case TaskScheduler::Cpu:
+            return 2;
+    }
+    return 0;
+}
+
+const TaskScheduler::Resource allResources[] = { TaskScheduler::Network, TaskScheduler::Disk, TaskScheduler::Cpu };
+const TaskScheduler::Priority allPriorities[] = {
+    TaskScheduler::Priority::Interactive,
+    TaskScheduler::Priority::Foreground,
+    TaskScheduler::Priority::Background
+};
+}
+
+TaskScheduler::TaskScheduler(QObject *parent) : QObject(parent)
+{
+    m_budget[resourceIndex(Network)] = 12;
+    m_budget[resourceIndex(Disk)] = 2;
+    m_budget[resourceIndex(Cpu)] = qMax(1, QThread::idealThreadCount());
+    m_clock.start();
+}
+
+TaskScheduler *TaskScheduler::instance()
+{
+    // never destroyed, work may still give back slots while the application shuts down
+    static TaskScheduler *scheduler = new TaskScheduler();
+    return scheduler;
+}
+
+quint64 TaskScheduler::request(QObject *context, const QString &name, Priority priority, Resources resources,
+                               std::function<void()> start)
+{
+    Request request;
+    request.entry.id = m_nextId++;
+    request.entry.name = name;
+    request.entry.priority = priority;
+    request.entry.resources = resources;
+    request.context = context;
+    request.start = start;
+    request.since = m_clock.elapsed();
+    m_requests.append(request);
+
+    if(context && !m_contexts.contains(context))
+    {
+        m_contexts.append(context);
+        connect(context, &QObject::destroyed, this, &TaskScheduler::contextDestroyed);
+    }
+    queueSchedule();
+    emit changed();
+    return request.entry.id;
+}
+
+void TaskScheduler::release(quint64 id)
+{
+    for(int i = 0; i < m_requests.size(); i++)
+    {
+        if(m_requests[i].entry.id != id)
+        {
+            continue;
+        }
+        if(m_requests[i].entry.running)
+        {
+            take(m_requests[i].entry.resources, -1);
+        }
+        m_requests.removeAt(i);
+        queueSchedule();
+        emit changed();
+        return;
+    }
+}
+
+void TaskScheduler::contextDestroyed(QObject *context)
+{
+    m_contexts.removeAll(context);
+    for(int i = 0; i < m_requests.size();)
+    {
+        if(m_requests[i].context != context)
+        {
+            i++;
+            continue;
+        }
+        if(m_requests[i].entry.running)
+        {
+            take(m_requests[i].entry.resources, -1);
+        }
+        m_requests.removeAt(i);
+    }
+    queueSchedule();
+    emit changed();
+}
+
+void TaskScheduler::take(Resources resources, int delta)
+{
+    for(auto resource: allResources)
+    {
+        if(resources & resource)
+        {
+            m_used[resourceIndex(resource)] += delta;
+        }
+    }
+}
+
+void TaskScheduler::queueSchedule()
+{
+    if(m_scheduleQueued)
+    {
+        return;
+    }
+    m_scheduleQueued = true;
+    QMetaObject::invokeMethod(this, "schedule", Qt::QueuedConnection);
+}
+
+void TaskScheduler::schedule()
+{
+    m_scheduleQueued = false;
+    QList<std::function<void()>> toStart;
+    // resources that more important work waits for
+    Resources blocked;
+    for(auto priority: allPriorities)
+    {
+        for(auto &request: m_requests)
+        {
+            auto &entry = request.entry;
+            if(entry.running || entry.priority != priority)
+            {
+                continue;
+            }
+            Resources missing = entry.resources & blocked;
+            for(auto resource: allResources)
+            {
+                if(!(entry.resources & resource))
+                {
+                    continue;
+                }
+                int limit = m_budget[resourceIndex(resource)];
+                if(priority == Priority::Background)
+                {
+                    limit = qMax(1, (limit + 1) / 2);
+                }
+                if(m_used[resourceIndex(resource)] >= limit)
+                {
+                    missing |= resource;
+                }
+            }
+            if(missing)
+            {
+                // only what it waits for is held back, work needing just the other resources can still go ahead
+                blocked |= missing;
+                continue;
+            }
+            take(entry.resources, 1);
+            entry.running = true;
+            request.since = m_clock.elapsed();
+            toStart.append(request.start);
+        }
+    }
+    if(toStart.isEmpty())
+    {
+        return;
+    }
+    emit changed();
+    // started work may request or release more, so only call it once the queue is consistent again
+    for(auto &start: toStart)
+    {
+        start();
+    }
+}
+
+void TaskScheduler::setBudget(Resource resource, int slots)
+{
+    m_budget[resourceIndex(resource)] = qMax(1, slots);
+    queueSchedule();
+    emit changed();
+}
+
+int TaskScheduler::budget(Resource resource) const
+{
+    return m_budget[resourceIndex(resource)];
+}
+
+int TaskScheduler::used(Resource resource) const
+{
+    return m_used[resourceIndex(resource)];
+}
+
+QList<TaskScheduler::Entry> TaskScheduler::entries() const
+{
+    QList<Entry> running;
+    QList<Entry> waiting;
+    auto now = m_clock.elapsed();
+    for(auto priority: allPriorities)
+    {
+        for(auto &request: m_requests)
+        {
+            if(request.entry.priority != priority)
+            {
+                continue;
+            }
+            auto entry = request.entry;
+            entry.elapsedMs = now - request.since;
+            if(entry.running)
+            {
+                running.append(entry);
+            }
+            else
+            {
+                waiting.append(entry);
+            }
+        }
+    }
+    return running + waiting;
+}
+
+QString TaskScheduler::priorityName(Priority priority)
+{
+    switch(priority)
+    {
+        case Priority::Interactive:
+            return tr("Interactive");
+        case Priority::Foreground:
+            return tr("Foreground");
+        case Priority::Background:
+            return tr("Background");
+    }
+    return QString();
+}
+
+QString TaskScheduler::resourceNames(Resources resources)
+{
+    QStringList names;
+    if(resources & Network)
+    {
+        names.append(tr("Network"));
+    }
+    if(resources & Disk)
+    {
+        names.append(tr("Disk"));
+    }
+    if(resources & Cpu)
+    {
+        names.append(tr("CPU"));
+    }
+    return names.join(", ");
+}
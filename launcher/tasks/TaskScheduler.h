@@ -0,0 +1,124 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+/**
+ * Hands out slots of the shared resources (network, disk and CPU) to work that asks for them, most important work first.
+ *
+ * Work asks for slots with request() and gets started once all of them are free. It has to give them back with
+ * release() once it is done, or when it no longer wants to start. Work that is waiting blocks less important work
+ * from taking the resources it waits for, and background work may only use half of every budget, so there is always
+ * room left for something the user is waiting on. Work that takes many short slots, like the parts of a NetJob, is
+ * that way overtaken by more important work at every slot boundary.
+ *
+ * Requests and releases have to happen on the scheduler's thread, which is the thread it was created on.
+ */
+class TaskScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Priority
+    {
+        // the user is waiting for it to finish, like a launch
+        Interactive,
+        // the user started it, like an instance install
+        Foreground,
+        // nobody is waiting for it, like refreshing caches or fetching icons
+        Background
+    };
+
+    enum Resource
+    {
+        Network = 0x1,
+        Disk = 0x2,
+        Cpu = 0x4
+    };
+    Q_DECLARE_FLAGS(Resources, Resource)
+
+    struct Entry
+    {
+        quint64 id = 0;
+        QString name;
+        Priority priority = Priority::Foreground;
+        Resources resources;
+        bool running = false;
+        /// for how long it waited or has been running so far
+        qint64 elapsedMs = 0;
+    };
+
+    explicit TaskScheduler(QObject *parent = nullptr);
+    virtual ~TaskScheduler() {};
+
+    /// The scheduler shared by the whole application
+    static TaskScheduler *instance();
+
+    /**
+     * Ask for one slot of each of the resources. `start` is called once they are all free, at the earliest when the
+     * event loop runs again. If `context` is destroyed, the request and its slots are dropped.
+     * Returns the id to give to release().
+     */
+    quint64 request(QObject *context, const QString &name, Priority priority, Resources resources, std::function<void()> start);
+
+    /// Give back the slots of started work, or drop a request that did not start yet
+    void release(quint64 id);
+
+    void setBudget(Resource resource, int slots);
+    int budget(Resource resource) const;
+    int used(Resource resource) const;
+
+    /// What is running and what is waiting, running first, then in the order it would start
+    QList<Entry> entries() const;
+
+    static QString priorityName(Priority priority);
+    static QString resourceNames(Resources resources);
+
+signals:
+    /// Something was queued, started or released
+    void changed();
+
+private slots:
+    void schedule();
+
+private:
+    void queueSchedule();
+    void contextDestroyed(QObject *context);
+    void take(Resources resources, int delta);
+
+private:
+    struct Request
+    {
+        Entry entry;
+        QObject *context = nullptr;
+        std::function<void()> start;
+        qint64 since = 0;
+    };
+    QList<Request> m_requests;
+    QList<QObject *> m_contexts;
+    int m_budget[3];
+    int m_used[3] = {0, 0, 0};
+    quint64 m_nextId = 1;
+    bool m_scheduleQueued = false;
+    QElapsedTimer m_clock;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(TaskScheduler::Resources)
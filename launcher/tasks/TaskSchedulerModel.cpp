@@ -0,0 +1,125 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TaskSchedulerModel.h"
+
+TaskSchedulerModel::TaskSchedulerModel(TaskScheduler *scheduler, QObject *parent)
+    : QAbstractTableModel(parent), m_scheduler(scheduler)
+{
+    m_entries = m_scheduler->entries();
+    connect(m_scheduler, &TaskScheduler::changed, this, &TaskSchedulerModel::refresh);
+    // keeps the times ticking while nothing changes
+    connect(&m_timer, &QTimer::timeout, this, &TaskSchedulerModel::refresh);
+    m_timer.start(1000);
+}
+
+int TaskSchedulerModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+int TaskSchedulerModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TaskSchedulerModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= m_entries.size())
+    {
+        return QVariant();
+    }
+    auto &entry = m_entries[index.row()];
+    if(role == Qt::DisplayRole)
+    {
+        switch(index.column())
+        {
+            case NameColumn:
+                return entry.name;
+            case PriorityColumn:
+                return TaskScheduler::priorityName(entry.priority);
+            case ResourcesColumn:
+                return TaskScheduler::resourceNames(entry.resources);
+            case StateColumn:
+                return entry.running ? tr("Running") : tr("Waiting");
+            case TimeColumn:
+                return tr("%1 s").arg(entry.elapsedMs / 1000.0, 0, 'f', 1);
+        }
+    }
+    else if(role == Qt::TextAlignmentRole && index.column() == TimeColumn)
+    {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant TaskSchedulerModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    {
+        return QVariant();
+    }
+    switch(section)
+    {
+        case NameColumn:
+            return tr("Name");
+        case PriorityColumn:
+            return tr("Priority");
+        case ResourcesColumn:
+            return tr("Resources");
+        case StateColumn:
+            return tr("State");
+        case TimeColumn:
+            return tr("Time");
+    }
+    return QVariant();
+}
+
+QString TaskSchedulerModel::usage() const
+{
+    QStringList parts;
+    for(auto resource: {TaskScheduler::Network, TaskScheduler::Disk, TaskScheduler::Cpu})
+    {
+        parts.append(tr("%1: %2 of %3").arg(TaskScheduler::resourceNames(resource))
+                         .arg(m_scheduler->used(resource))
+                         .arg(m_scheduler->budget(resource)));
+    }
+    return parts.join(", ");
+}
+
+void TaskSchedulerModel::refresh()
+{
+    auto entries = m_scheduler->entries();
+    bool sameRows = entries.size() == m_entries.size();
+    for(int i = 0; sameRows && i < entries.size(); i++)
+    {
+        sameRows = entries[i].id == m_entries[i].id && entries[i].running == m_entries[i].running;
+    }
+    if(sameRows)
+    {
+        m_entries = entries;
+        if(!m_entries.isEmpty())
+        {
+            emit dataChanged(index(0, 0), index(m_entries.size() - 1, ColumnCount - 1));
+        }
+    }
+    else
+    {
+        beginResetModel();
+        m_entries = entries;
+        endResetModel();
+    }
+    emit usageChanged(usage());
+}
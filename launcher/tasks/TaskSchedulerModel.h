@@ -0,0 +1,61 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QTimer>
+
+#include "TaskScheduler.h"
+
+/**
+ * Table of what the scheduler runs and what waits for it, for watching the queue while things happen.
+ */
+class TaskSchedulerModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column
+    {
+        NameColumn,
+        PriorityColumn,
+        ResourcesColumn,
+        StateColumn,
+        TimeColumn,
+        ColumnCount
+    };
+
+    explicit TaskSchedulerModel(TaskScheduler *scheduler, QObject *parent = nullptr);
+    virtual ~TaskSchedulerModel() {};
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+    /// Used and available slots of every resource, as one line of text
+    QString usage() const;
+
+signals:
+    void usageChanged(const QString &usage);
+
+private slots:
+    void refresh();
+
+private:
+    TaskScheduler *m_scheduler;
+    QList<TaskScheduler::Entry> m_entries;
+    QTimer m_timer;
+};
@@ -0,0 +1,131 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "tasks/TaskScheduler.h"
+
+namespace {
+// asks for a slot and writes down when it got it
+quint64 enqueue(TaskScheduler &scheduler, QStringList &started, const QString &name, TaskScheduler::Priority priority,
+                TaskScheduler::Resources resources, QObject *context = nullptr)
+{
+    return scheduler.request(context, name, priority, resources, [&started, name]()
+    {
+        started.append(name);
+    });
+}
+}
+
+class TaskSchedulerTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_Budget()
+    {
+        TaskScheduler scheduler;
+        scheduler.setBudget(TaskScheduler::Disk, 2);
+        QStringList started;
+        auto first = enqueue(scheduler, started, "a", TaskScheduler::Priority::Foreground, TaskScheduler::Disk);
+        enqueue(scheduler, started, "b", TaskScheduler::Priority::Foreground, TaskScheduler::Disk);
+        enqueue(scheduler, started, "c", TaskScheduler::Priority::Foreground, TaskScheduler::Disk | TaskScheduler::Cpu);
+        // nothing starts before the event loop runs
+        QVERIFY(started.isEmpty());
+        QTRY_COMPARE(started, QStringList() << "a" << "b");
+        QCOMPARE(scheduler.used(TaskScheduler::Disk), 2);
+        QCOMPARE(scheduler.used(TaskScheduler::Cpu), 0);
+
+        scheduler.release(first);
+        QTRY_COMPARE(started, QStringList() << "a" << "b" << "c");
+        QCOMPARE(scheduler.used(TaskScheduler::Disk), 2);
+        QCOMPARE(scheduler.used(TaskScheduler::Cpu), 1);
+    }
+
+    void test_PriorityOrder()
+    {
+        TaskScheduler scheduler;
+        scheduler.setBudget(TaskScheduler::Network, 1);
+        QStringList started;
+        auto holder = enqueue(scheduler, started, "holder", TaskScheduler::Priority::Foreground, TaskScheduler::Network);
+        QTRY_COMPARE(started.size(), 1);
+
+        auto background = enqueue(scheduler, started, "background", TaskScheduler::Priority::Background, TaskScheduler::Network);
+        auto foreground = enqueue(scheduler, started, "foreground", TaskScheduler::Priority::Foreground, TaskScheduler::Network);
+        auto interactive = enqueue(scheduler, started, "interactive", TaskScheduler::Priority::Interactive, TaskScheduler::Network);
+        // work without network is not held up by the queue
+        enqueue(scheduler, started, "cpu", TaskScheduler::Priority::Background, TaskScheduler::Cpu);
+        QTRY_COMPARE(started, QStringList() << "holder" << "cpu");
+
+        auto entries = scheduler.entries();
+        QCOMPARE(entries.size(), 5);
+        QCOMPARE(entries[2].name, QString("interactive"));
+        QVERIFY(!entries[2].running);
+
+        scheduler.release(holder);
+        QTRY_COMPARE(started.size(), 3);
+        QCOMPARE(started.last(), QString("interactive"));
+        scheduler.release(interactive);
+        QTRY_COMPARE(started.size(), 4);
+        QCOMPARE(started.last(), QString("foreground"));
+        scheduler.release(foreground);
+        QTRY_COMPARE(started.size(), 5);
+        QCOMPARE(started.last(), QString("background"));
+        scheduler.release(background);
+        QTRY_COMPARE(scheduler.used(TaskScheduler::Network), 0);
+    }
+
+    void test_OnlyMissingResourcesBlock()
+    {
+        TaskScheduler scheduler;
+        scheduler.setBudget(TaskScheduler::Disk, 1);
+        scheduler.setBudget(TaskScheduler::Cpu, 4);
+        QStringList started;
+        enqueue(scheduler, started, "disk", TaskScheduler::Priority::Foreground, TaskScheduler::Disk);
+        QTRY_COMPARE(started.size(), 1);
+
+        // waits for the disk, but that does not hold back work that only needs the CPU
+        enqueue(scheduler, started, "extract", TaskScheduler::Priority::Foreground, TaskScheduler::Disk | TaskScheduler::Cpu);
+        enqueue(scheduler, started, "parse", TaskScheduler::Priority::Background, TaskScheduler::Cpu);
+        enqueue(scheduler, started, "copy", TaskScheduler::Priority::Background, TaskScheduler::Disk);
+        QTRY_COMPARE(started, QStringList() << "disk" << "parse");
+    }
+
+    void test_BackgroundCap()
+    {
+        TaskScheduler scheduler;
+        scheduler.setBudget(TaskScheduler::Cpu, 4);
+        QStringList started;
+        for(int i = 0; i < 4; i++)
+        {
+            enqueue(scheduler, started, QString("background %1").arg(i), TaskScheduler::Priority::Background, TaskScheduler::Cpu);
+        }
+        QTRY_COMPARE(started.size(), 2);
+        QTest::qWait(20);
+        QCOMPARE(started.size(), 2);
+
+        // the other half stays free for work somebody waits on
+        enqueue(scheduler, started, "foreground", TaskScheduler::Priority::Foreground, TaskScheduler::Cpu);
+        QTRY_COMPARE(started.size(), 3);
+        QCOMPARE(started.last(), QString("foreground"));
+        QCOMPARE(scheduler.used(TaskScheduler::Cpu), 3);
+    }
+
+    void test_ContextDestroyed()
+    {
+        TaskScheduler scheduler;
+        scheduler.setBudget(TaskScheduler::Disk, 1);
+        QStringList started;
+        auto context = new QObject();
+        enqueue(scheduler, started, "running", TaskScheduler::Priority::Foreground, TaskScheduler::Disk, context);
+        enqueue(scheduler, started, "dropped", TaskScheduler::Priority::Foreground, TaskScheduler::Disk, context);
+        enqueue(scheduler, started, "other", TaskScheduler::Priority::Foreground, TaskScheduler::Disk);
+        QTRY_COMPARE(started, QStringList() << "running");
+
+        delete context;
+        QTRY_COMPARE(started, QStringList() << "running" << "other");
+        QCOMPARE(scheduler.entries().size(), 1);
+    }
+};
+
+QTEST_GUILESS_MAIN(TaskSchedulerTest)
+
+#include "TaskScheduler_test.moc"
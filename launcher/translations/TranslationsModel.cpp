@@ -9,7 +9,6 @@
 
 #include "FileSystem.h"
 #include "net/NetJob.h"
-#include "net/ChecksumValidator.h"
 #include "BuildConfig.h"
 #include "Json.h"
 
@@ -572,6 +571,7 @@ void TranslationsModel::downloadIndex()
     }
     qDebug() << "Downloading Translations Index...";
     d->m_index_job.reset(new NetJob("Translations Index"));
+    d->m_index_job->setPriority(TaskScheduler::Priority::Background);
     MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("translations", "index_v2.json");
     entry->setStale(true);
     d->m_index_task = Net::Download::makeCached(QUrl("https://files.multimc.org/translations/index_v2.json"), entry);
@@ -618,9 +618,8 @@ void TranslationsModel::downloadTranslation(QString key)
     MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("translations", "mmc_" + key + ".qm");
     entry->setStale(true);
 
-    auto dl = Net::Download::makeCached(QUrl(BuildConfig.TRANSLATIONS_BASE_URL + lang->file_name), entry);
     auto rawHash = QByteArray::fromHex(lang->file_sha1.toLatin1());
-    dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawHash));
+    auto dl = Net::Download::makeCached(QUrl(BuildConfig.TRANSLATIONS_BASE_URL + lang->file_name), entry, rawHash);
     dl->m_total_progress = lang->file_size;
 
     d->m_dl_job.reset(new NetJob("Translation for " + key));
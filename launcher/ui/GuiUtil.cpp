@@ -2,6 +2,7 @@
 
 #include <QClipboard>
 #include <QApplication>
+#include <QMimeData>
 #include <QFileDialog>
 #include <QStandardPaths>
 
@@ -14,15 +15,19 @@
 #include <DesktopServices.h>
 #include <BuildConfig.h>
 
-QString GuiUtil::uploadPaste(const QString &text, QWidget *parentWidget)
+static QString pasteKey()
 {
-    ProgressDialog dialog(parentWidget);
     auto APIKeySetting = APPLICATION->settings()->get("PasteEEAPIKey").toString();
     if(APIKeySetting == "multimc")
     {
         APIKeySetting = BuildConfig.PASTE_EE_KEY;
     }
-    std::unique_ptr<PasteUpload> paste(new PasteUpload(parentWidget, text, APIKeySetting));
+    return APIKeySetting;
+}
+
+static QString runPasteUpload(std::unique_ptr<PasteUpload> paste, QWidget *parentWidget)
+{
+    ProgressDialog dialog(parentWidget);
 
     if (!paste->validateText())
     {
@@ -47,20 +52,42 @@ QString GuiUtil::uploadPaste(const QString &text, QWidget *parentWidget)
     else
     {
         const QString link = paste->pasteLink();
-        setClipboardText(link);
+        GuiUtil::setClipboardText(link);
+        auto message = QObject::tr("The <a href=\"%1\">link to the uploaded log</a> has been placed in your clipboard.").arg(link);
+        if (paste->truncated())
+        {
+            message = QObject::tr("The log was too big to upload in full, so only its newest lines were uploaded.") + "<br/>" + message;
+        }
         CustomMessageBox::selectable(
-            parentWidget, QObject::tr("Upload finished"),
-            QObject::tr("The <a href=\"%1\">link to the uploaded log</a> has been placed in your clipboard.").arg(link),
+            parentWidget, QObject::tr("Upload finished"), message,
             QMessageBox::Information)->exec();
         return link;
     }
 }
 
+QString GuiUtil::uploadPaste(const QString &text, QWidget *parentWidget)
+{
+    return runPasteUpload(std::unique_ptr<PasteUpload>(new PasteUpload(parentWidget, text, pasteKey())), parentWidget);
+}
+
+QString GuiUtil::uploadPaste(QIODevice &text, QWidget *parentWidget)
+{
+    return runPasteUpload(std::unique_ptr<PasteUpload>(new PasteUpload(parentWidget, text, pasteKey())), parentWidget);
+}
+
 void GuiUtil::setClipboardText(const QString &text)
 {
     QApplication::clipboard()->setText(text);
 }
 
+void GuiUtil::setClipboardText(const QByteArray &utf8)
+{
+    // handed over as is, QMimeData decodes plain text data as UTF-8 only when something asks for it
+    auto mimeData = new QMimeData();
+    mimeData->setData("text/plain", utf8);
+    QApplication::clipboard()->setMimeData(mimeData);
+}
+
 static QStringList BrowseForFileInternal(QString context, QString caption, QString filter, QString defaultPath, QWidget *parentWidget, bool single)
 {
     static QMap<QString, QString> savedPaths;
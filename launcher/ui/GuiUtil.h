@@ -5,7 +5,9 @@
 namespace GuiUtil
 {
 QString uploadPaste(const QString &text, QWidget *parentWidget);
+QString uploadPaste(QIODevice &text, QWidget *parentWidget);
 void setClipboardText(const QString &text);
+void setClipboardText(const QByteArray &utf8);
 QStringList BrowseForFiles(QString context, QString caption, QString filter, QString defaultPath, QWidget *parentWidget);
 QString BrowseForFile(QString context, QString caption, QString filter, QString defaultPath, QWidget *parentWidget);
 }
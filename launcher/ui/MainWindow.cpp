@@ -73,6 +73,7 @@
 #include "ui/dialogs/NewInstanceDialog.h"
 #include "ui/dialogs/ProgressDialog.h"
 #include "ui/dialogs/AboutDialog.h"
+#include "ui/dialogs/TaskQueueDialog.h"
 #include "ui/dialogs/VersionSelectDialog.h"
 #include "ui/dialogs/CustomMessageBox.h"
 #include "ui/dialogs/IconPickerDialog.h"
@@ -227,6 +228,7 @@ public:
     TranslatedAction actionReportBug;
     TranslatedAction actionDISCORD;
     TranslatedAction actionREDDIT;
+    TranslatedAction actionTaskQueue;
     TranslatedAction actionAbout;
 
     QVector<TranslatedToolButton *> all_toolbuttons;
@@ -354,6 +356,13 @@ public:
             helpMenu->addAction(actionREDDIT);
         }
 
+        actionTaskQueue = TranslatedAction(MainWindow);
+        actionTaskQueue->setObjectName(QStringLiteral("actionTaskQueue"));
+        actionTaskQueue.setTextId(QT_TRANSLATE_NOOP("MainWindow", "Task Queue"));
+        actionTaskQueue.setTooltipId(QT_TRANSLATE_NOOP("MainWindow", "See what %1 is working on and what is waiting."));
+        all_actions.append(&actionTaskQueue);
+        helpMenu->addAction(actionTaskQueue);
+
         actionAbout = TranslatedAction(MainWindow);
         actionAbout->setObjectName(QStringLiteral("actionAbout"));
         actionAbout->setIcon(APPLICATION->getThemedIcon("about"));
@@ -1474,6 +1483,12 @@ void MainWindow::on_actionReportBug_triggered()
     DesktopServices::openUrl(QUrl(BuildConfig.BUG_TRACKER_URL));
 }
 
+void MainWindow::on_actionTaskQueue_triggered()
+{
+    TaskQueueDialog dialog(this);
+    dialog.exec();
+}
+
 void MainWindow::on_actionAbout_triggered()
 {
     AboutDialog dialog(this);
@@ -63,6 +63,8 @@ protected:
 private slots:
     void onCatToggled(bool);
 
+    void on_actionTaskQueue_triggered();
+
     void on_actionAbout_triggered();
 
     void on_actionAddInstance_triggered();
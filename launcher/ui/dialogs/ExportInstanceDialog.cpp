@@ -16,7 +16,7 @@
 #include "ExportInstanceDialog.h"
 #include "ui_ExportInstanceDialog.h"
 #include <BaseInstance.h>
-#include <MMCZip.h>
+#include <InstanceExportTask.h>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <qfilesystemmodel.h>
@@ -28,6 +28,8 @@
 #include "MMCStrings.h"
 #include "SeparatorPrefixTree.h"
 #include "Application.h"
+#include "ProgressDialog.h"
+#include "CustomMessageBox.h"
 #include <icons/IconList.h>
 #include <FileSystem.h>
 
@@ -401,11 +403,16 @@ bool ExportInstanceDialog::doExport()
 
     SaveIcon(m_instance);
 
-    auto & blocked = proxyModel->blockedPaths();
-    using std::placeholders::_1;
-    if (!JlCompress::compressDir(output, m_instance->instanceRoot(), name, std::bind(&SeparatorPrefixTree<'/'>::covers, blocked, _1)))
+    // remembers what went into the archive, so exporting the same instance again mostly copies
+    auto indexPath = FS::PathCombine("cache", "exports", m_instance->id() + ".json");
+    InstanceExportTask task(m_instance->instanceRoot(), name, proxyModel->blockedPaths(), output, indexPath);
+    ProgressDialog dialog(this);
+    if (dialog.execWithTask(&task) != QDialog::Accepted)
     {
-        QMessageBox::warning(this, tr("Error"), tr("Unable to export instance"));
+        if (!task.wasAborted())
+        {
+            CustomMessageBox::selectable(this, tr("Error"), tr("Unable to export instance: %1").arg(task.failReason()), QMessageBox::Warning)->show();
+        }
         return false;
     }
     return true;
@@ -0,0 +1,38 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TaskQueueDialog.h"
+#include "ui_TaskQueueDialog.h"
+
+#include <QHeaderView>
+
+#include "tasks/TaskSchedulerModel.h"
+
+TaskQueueDialog::TaskQueueDialog(QWidget *parent) : QDialog(parent), ui(new Ui::TaskQueueDialog)
+{
+    ui->setupUi(this);
+
+    m_model = new TaskSchedulerModel(TaskScheduler::instance(), this);
+    ui->view->setModel(m_model);
+    ui->view->header()->setSectionResizeMode(TaskSchedulerModel::NameColumn, QHeaderView::Stretch);
+    ui->view->header()->setStretchLastSection(false);
+    ui->usageLabel->setText(m_model->usage());
+    connect(m_model, &TaskSchedulerModel::usageChanged, ui->usageLabel, &QLabel::setText);
+}
+
+TaskQueueDialog::~TaskQueueDialog()
+{
+    delete ui;
+}
@@ -0,0 +1,39 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QDialog>
+
+class TaskSchedulerModel;
+
+namespace Ui
+{
+class TaskQueueDialog;
+}
+
+/// Shows what the task scheduler is running and what is waiting for it
+class TaskQueueDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit TaskQueueDialog(QWidget *parent = 0);
+    ~TaskQueueDialog();
+
+private:
+    Ui::TaskQueueDialog *ui;
+    TaskSchedulerModel *m_model;
+};
@@ -71,6 +71,25 @@ void MinecraftPage::applySettings()
     s->set("ShowGameTime", ui->showGameTime->isChecked());
     s->set("ShowGlobalGameTime", ui->showGlobalGameTime->isChecked());
     s->set("RecordGameTime", ui->recordGameTime->isChecked());
+
+    // Prefetching
+    s->set("PrefetchGameFiles", ui->prefetchGroupBox->isChecked());
+    s->set("PrefetchBudgetMiB", ui->prefetchBudgetSpinBox->value());
+
+    // Warm launch
+    s->set("WarmLaunch", ui->warmLaunchGroupBox->isChecked());
+    s->set("WarmLaunchMaxAgeHours", ui->warmLaunchMaxAgeSpinBox->value());
+
+    // Download failures
+    s->set("AllowOptionalDownloadFailures", ui->allowOptionalFailuresCheckBox->isChecked());
+    s->set("AssetsMirrors", ui->assetsMirrorsEdit->text());
+    s->set("LibrariesMirrors", ui->librariesMirrorsEdit->text());
+    s->set("MetaMirrors", ui->metaMirrorsEdit->text());
+    APPLICATION->updateDownloadMirrors(
+        ui->assetsMirrorsEdit->text(),
+        ui->librariesMirrorsEdit->text(),
+        ui->metaMirrorsEdit->text()
+    );
 }
 
 void MinecraftPage::loadSettings()
@@ -88,4 +107,15 @@ void MinecraftPage::loadSettings()
     ui->showGameTime->setChecked(s->get("ShowGameTime").toBool());
     ui->showGlobalGameTime->setChecked(s->get("ShowGlobalGameTime").toBool());
     ui->recordGameTime->setChecked(s->get("RecordGameTime").toBool());
+
+    ui->prefetchGroupBox->setChecked(s->get("PrefetchGameFiles").toBool());
+    ui->prefetchBudgetSpinBox->setValue(s->get("PrefetchBudgetMiB").toInt());
+
+    ui->warmLaunchGroupBox->setChecked(s->get("WarmLaunch").toBool());
+    ui->warmLaunchMaxAgeSpinBox->setValue(s->get("WarmLaunchMaxAgeHours").toInt());
+
+    ui->allowOptionalFailuresCheckBox->setChecked(s->get("AllowOptionalDownloadFailures").toBool());
+    ui->assetsMirrorsEdit->setText(s->get("AssetsMirrors").toString());
+    ui->librariesMirrorsEdit->setText(s->get("LibrariesMirrors").toString());
+    ui->metaMirrorsEdit->setText(s->get("MetaMirrors").toString());
 }
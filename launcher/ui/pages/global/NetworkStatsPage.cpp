@@ -0,0 +1,157 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NetworkStatsPage.h"
+
+#include <QDir>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "ui/dialogs/CustomMessageBox.h"
+#include "net/NetworkStats.h"
+#include "Exception.h"
+#include "FileSystem.h"
+#include "Json.h"
+
+namespace {
+QString formatMs(qint64 ms)
+{
+    return ms < 0 ? QString("-") : QObject::tr("%1 ms").arg(ms);
+}
+
+QString formatSize(qint64 bytes)
+{
+    if(bytes < 1024 * 1024)
+    {
+        return QObject::tr("%1 KiB").arg(bytes / 1024.0, 0, 'f', 1);
+    }
+    return QObject::tr("%1 MiB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+}
+}
+
+NetworkStatsPage::NetworkStatsPage(QWidget *parent) : QWidget(parent)
+{
+    setObjectName(QStringLiteral("networkStatsPage"));
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    layout->addWidget(new QLabel(tr("Hosts"), this));
+    m_hosts = new QTreeWidget(this);
+    m_hosts->setRootIsDecorated(false);
+    m_hosts->setHeaderLabels({tr("Host"), tr("Requests"), tr("Cache hits"), tr("Not modified"), tr("Failed"),
+                              tr("Retries"), tr("HTTP/2"), tr("Reused"), tr("First byte"), tr("Speed"), tr("Size")});
+    m_hosts->headerItem()->setToolTip(7, tr("Share of HTTPS requests that reused an open connection. Not known for plain HTTP."));
+    layout->addWidget(m_hosts);
+
+    layout->addWidget(new QLabel(tr("Latest downloads"), this));
+    m_recent = new QTreeWidget(this);
+    m_recent->setRootIsDecorated(false);
+    m_recent->setHeaderLabels({tr("URL"), tr("Result"), tr("First byte"), tr("Time"), tr("Size")});
+    m_recent->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_recent->header()->setStretchLastSection(false);
+    layout->addWidget(m_recent);
+
+    auto buttons = new QHBoxLayout();
+    buttons->addStretch();
+    auto refreshButton = new QPushButton(tr("Refresh"), this);
+    connect(refreshButton, &QPushButton::clicked, this, &NetworkStatsPage::refresh);
+    buttons->addWidget(refreshButton);
+    auto exportButton = new QPushButton(tr("Export..."), this);
+    connect(exportButton, &QPushButton::clicked, this, &NetworkStatsPage::exportJson);
+    buttons->addWidget(exportButton);
+    layout->addLayout(buttons);
+}
+
+void NetworkStatsPage::openedImpl()
+{
+    refresh();
+}
+
+void NetworkStatsPage::refresh()
+{
+    auto stats = Net::NetworkStats::instance();
+
+    m_hosts->clear();
+    for(auto &host: stats->hosts())
+    {
+        auto item = new QTreeWidgetItem(m_hosts);
+        item->setText(0, host.host);
+        item->setText(1, QString::number(host.requests));
+        item->setText(2, QString::number(host.cacheHits));
+        item->setText(3, QString::number(host.notModified));
+        item->setText(4, QString::number(host.failed));
+        item->setText(5, QString::number(host.retries));
+        item->setText(6, QString::number(host.http2Requests));
+        auto reuse = host.reuseRatio();
+        item->setText(7, reuse < 0 ? QString("-") : QString("%1%").arg(int(reuse * 100)));
+        item->setText(8, formatMs(host.averageFirstByteMs()));
+        item->setText(9, tr("%1/s").arg(formatSize(host.bytesPerSecond())));
+        item->setText(10, formatSize(host.bytes));
+    }
+    for(int i = 0; i < m_hosts->columnCount(); i++)
+    {
+        m_hosts->resizeColumnToContents(i);
+    }
+
+    m_recent->clear();
+    auto recent = stats->recent();
+    // newest first
+    for(auto iter = recent.rbegin(); iter != recent.rend(); iter++)
+    {
+        auto &download = *iter;
+        auto item = new QTreeWidgetItem(m_recent);
+        item->setText(0, download.url.toString());
+        item->setToolTip(0, download.url.toString());
+        if(download.cacheHit)
+        {
+            item->setText(1, tr("Cached"));
+            continue;
+        }
+        if(download.failed)
+        {
+            item->setText(1, download.status ? tr("Failed (%1)").arg(download.status) : tr("Failed"));
+        }
+        else
+        {
+            item->setText(1, QString::number(download.status));
+        }
+        item->setText(2, formatMs(download.firstByteMs));
+        item->setText(3, formatMs(download.ms));
+        item->setText(4, formatSize(download.bytes));
+    }
+}
+
+void NetworkStatsPage::exportJson()
+{
+    auto path = QFileDialog::getSaveFileName(this, tr("Export network statistics"),
+                                             FS::PathCombine(QDir::homePath(), "network-stats.json"), "JSON (*.json)");
+    if(path.isEmpty())
+    {
+        return;
+    }
+    try
+    {
+        Json::write(Net::NetworkStats::instance()->toJson(), path);
+    }
+    catch (const Exception &e)
+    {
+        CustomMessageBox::selectable(this, tr("Error"), e.cause(), QMessageBox::Warning)->exec();
+    }
+}
@@ -0,0 +1,55 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QWidget>
+
+#include "ui/pages/BasePage.h"
+#include <Application.h>
+
+class QTreeWidget;
+
+/// Read-only view of what the downloads did so far, per host and for the latest downloads
+class NetworkStatsPage : public QWidget, public BasePage
+{
+    Q_OBJECT
+
+public:
+    explicit NetworkStatsPage(QWidget *parent = 0);
+    virtual ~NetworkStatsPage() {};
+
+    QString displayName() const override
+    {
+        return tr("Network Statistics");
+    }
+    QIcon icon() const override
+    {
+        return APPLICATION->getThemedIcon("proxy");
+    }
+    QString id() const override
+    {
+        return "network-stats";
+    }
+    void openedImpl() override;
+
+private slots:
+    void refresh();
+    void exportJson();
+
+private:
+    QTreeWidget *m_hosts;
+    QTreeWidget *m_recent;
+};
@@ -206,6 +206,10 @@ void InstanceSettingsPage::applySettings()
     {
         m_settings->reset("JoinServerOnLaunchAddress");
     }
+
+    // World backups
+    m_settings->set("AutoBackupWorlds", ui->worldBackupGroupBox->isChecked());
+    m_settings->set("WorldBackupsToKeep", ui->worldBackupsToKeepSpinBox->value());
 }
 
 void InstanceSettingsPage::loadSettings()
@@ -275,6 +279,9 @@ void InstanceSettingsPage::loadSettings()
 
     ui->serverJoinGroupBox->setChecked(m_settings->get("JoinServerOnLaunch").toBool());
     ui->serverJoinAddress->setText(m_settings->get("JoinServerOnLaunchAddress").toString());
+
+    ui->worldBackupGroupBox->setChecked(m_settings->get("AutoBackupWorlds").toBool());
+    ui->worldBackupsToKeepSpinBox->setValue(m_settings->get("WorldBackupsToKeep").toInt());
 }
 
 void InstanceSettingsPage::on_javaDetectBtn_clicked()
@@ -3,14 +3,18 @@
 
 #include "Application.h"
 
+#include <QBuffer>
+#include <QDebug>
 #include <QIcon>
 #include <QScrollBar>
 #include <QShortcut>
+#include <QTemporaryFile>
 
 #include "launch/LaunchTask.h"
 #include "settings/Setting.h"
 
 #include "ui/GuiUtil.h"
+#include "ui/dialogs/CustomMessageBox.h"
 #include "ui/ColorCache.h"
 
 #include <BuildConfig.h>
@@ -246,7 +250,17 @@ void LogPage::on_btnPaste_clicked()
             BuildConfig.LAUNCHER_NAME
         )
     );
-    auto url = GuiUtil::uploadPaste(m_model->toPlainText(), this);
+    // the log may be mostly in the archive, so it goes through a file instead of one big string
+    QString url;
+    QTemporaryFile log;
+    if(log.open() && m_model->writeTo(log) && log.seek(0))
+    {
+        url = GuiUtil::uploadPaste(log, this);
+    }
+    else
+    {
+        qWarning() << "Could not write the log for uploading:" << log.errorString();
+    }
     if(!url.isEmpty())
     {
         m_model->append(
@@ -271,7 +285,11 @@ void LogPage::on_btnCopy_clicked()
     if(!m_model)
         return;
     m_model->append(MessageLevel::Launcher, QString("Clipboard copy at: %1").arg(QDateTime::currentDateTime().toString(Qt::RFC2822Date)));
-    GuiUtil::setClipboardText(m_model->toPlainText());
+    // only the lines shown here, archived lines can be far too many for the clipboard
+    QBuffer log;
+    log.open(QIODevice::WriteOnly);
+    m_model->writeTo(log, false);
+    GuiUtil::setClipboardText(log.data());
 }
 
 void LogPage::on_btnClear_clicked()
@@ -306,17 +324,50 @@ void LogPage::on_findButton_clicked()
 {
     auto modifiers = QApplication::keyboardModifiers();
     bool reverse = modifiers & Qt::ShiftModifier;
-    ui->text->findNext(ui->searchBar->text(), reverse);
+    find(reverse);
 }
 
 void LogPage::findNextActivated()
 {
-    ui->text->findNext(ui->searchBar->text(), false);
+    find(false);
 }
 
 void LogPage::findPreviousActivated()
 {
-    ui->text->findNext(ui->searchBar->text(), true);
+    find(true);
+}
+
+void LogPage::find(bool reverse)
+{
+    auto needle = ui->searchBar->text();
+    if(ui->text->findNext(needle, reverse) || needle.isEmpty() || !m_model || !m_model->archivedLines())
+    {
+        return;
+    }
+    // the search stops at the end of the shown lines, only look on disk if none of them match
+    if(!ui->text->document()->find(needle).isNull())
+    {
+        return;
+    }
+    // not in the lines shown, look through the older lines kept on disk
+    auto found = m_model->findArchived(needle);
+    if(found.isEmpty())
+    {
+        return;
+    }
+    const int maxShown = 20;
+    QStringList lines;
+    for(int i = 0; i < found.size() && i < maxShown; i++)
+    {
+        int lineNum = reverse ? found[found.size() - 1 - i] : found[i];
+        lines.append(QString("%1: %2").arg(lineNum + 1).arg(m_model->archivedLine(lineNum)));
+    }
+    auto message = tr("'%1' was found in %n older line(s) that are no longer shown. Upload the log to see all of it.", "", found.size()).arg(needle);
+    if(found.size() > maxShown)
+    {
+        message += "\n" + tr("The first %1 matches are listed below.").arg(maxShown);
+    }
+    CustomMessageBox::selectable(this, tr("Found in older lines"), message + "\n\n" + lines.join('\n'), QMessageBox::Information)->exec();
 }
 
 void LogPage::findActivated()
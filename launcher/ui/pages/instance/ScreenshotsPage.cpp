@@ -14,6 +14,7 @@
 #include <QClipboard>
 #include <QKeyEvent>
 #include <QMenu>
+#include <QCryptographicHash>
 
 #include <Application.h>
 
@@ -23,8 +24,10 @@
 #include "net/NetJob.h"
 #include "screenshots/ImgurUpload.h"
 #include "screenshots/ImgurAlbumCreation.h"
+#include "screenshots/ThumbnailStore.h"
 #include "tasks/SequentialTask.h"
 
+#include "ImageLoader.h"
 #include "RWStorage.h"
 #include <FileSystem.h>
 #include <DesktopServices.h>
@@ -46,42 +49,50 @@ signals:
 class ThumbnailRunnable : public QRunnable
 {
 public:
-    ThumbnailRunnable(QString path, SharedIconCachePtr cache)
+    ThumbnailRunnable(QString path, SharedIconCachePtr cache, std::shared_ptr<ThumbnailStore> store)
     {
         m_path = path;
         m_cache = cache;
+        m_store = store;
     }
     void run()
     {
+        // every path has to end in a result, the model only asks again once the pending request is answered
         QFileInfo info(m_path);
-        if (info.isDir())
-            return;
-        if ((info.suffix().compare("png", Qt::CaseInsensitive) != 0))
+        if (info.isDir() || info.suffix().compare("png", Qt::CaseInsensitive) != 0)
+        {
+            m_resultEmitter.emitResultsFailed(m_path);
             return;
+        }
         int tries = 5;
         while (tries)
         {
             if (!m_cache->stale(m_path))
+            {
+                m_resultEmitter.emitResultsReady(m_path);
                 return;
-            QImage image(m_path);
-            if (image.isNull())
+            }
+            info.refresh();
+            QImage square = m_store->get(info);
+            if (square.isNull())
             {
-                QThread::msleep(500);
-                tries--;
-                continue;
+                QImage small = ImageLoader::thumbnail(m_path, QSize(256, 256));
+                if (small.isNull())
+                {
+                    QThread::msleep(500);
+                    tries--;
+                    continue;
+                }
+                QPoint offset((256 - small.width()) / 2, (256 - small.height()) / 2);
+                square = QImage(QSize(256, 256), QImage::Format_ARGB32);
+                square.fill(Qt::transparent);
+
+                QPainter painter(&square);
+                painter.drawImage(offset, small);
+                painter.end();
+
+                m_store->put(info, square);
             }
-            QImage small;
-            if (image.width() > image.height())
-                small = image.scaledToWidth(512).scaledToWidth(256, Qt::SmoothTransformation);
-            else
-                small = image.scaledToHeight(512).scaledToHeight(256, Qt::SmoothTransformation);
-            QPoint offset((256 - small.width()) / 2, (256 - small.height()) / 2);
-            QImage square(QSize(256, 256), QImage::Format_ARGB32);
-            square.fill(Qt::transparent);
-
-            QPainter painter(&square);
-            painter.drawImage(offset, small);
-            painter.end();
 
             QIcon icon(QPixmap::fromImage(square));
             m_cache->add(m_path, icon);
@@ -92,6 +103,7 @@ public:
     }
     QString m_path;
     SharedIconCachePtr m_cache;
+    std::shared_ptr<ThumbnailStore> m_store;
     ThumbnailingResult m_resultEmitter;
 };
 
@@ -101,7 +113,7 @@ class FilterModel : public QIdentityProxyModel
 {
     Q_OBJECT
 public:
-    explicit FilterModel(QObject *parent = 0) : QIdentityProxyModel(parent)
+    explicit FilterModel(std::shared_ptr<ThumbnailStore> store, QObject *parent = 0) : QIdentityProxyModel(parent), m_store(store)
     {
         m_thumbnailingPool.setMaxThreadCount(4);
         m_thumbnailCache = std::make_shared<SharedIconCache>();
@@ -109,7 +121,11 @@ public:
         connect(&watcher, SIGNAL(fileChanged(QString)), SLOT(fileChanged(QString)));
         // FIXME: the watched file set is not updated when files are removed
     }
-    virtual ~FilterModel() { m_thumbnailingPool.waitForDone(500); }
+    virtual ~FilterModel()
+    {
+        m_thumbnailingPool.clear();
+        m_thumbnailingPool.waitForDone(500);
+    }
     virtual QVariant data(const QModelIndex &proxyIndex, int role = Qt::DisplayRole) const
     {
         auto model = sourceModel();
@@ -135,7 +151,7 @@ public:
             {
                 return temp;
             }
-            if (!m_failed.contains(filePath))
+            if (!m_failed.contains(filePath) && !m_pending.contains(filePath))
             {
                 ((FilterModel *)this)->thumbnailImage(filePath);
             }
@@ -163,16 +179,26 @@ public:
 private:
     void thumbnailImage(QString path)
     {
-        auto runnable = new ThumbnailRunnable(path, m_thumbnailCache);
+        auto runnable = new ThumbnailRunnable(path, m_thumbnailCache, m_store);
         connect(&(runnable->m_resultEmitter), SIGNAL(resultsReady(QString)),
                 SLOT(thumbnailReady(QString)));
         connect(&(runnable->m_resultEmitter), SIGNAL(resultsFailed(QString)),
                 SLOT(thumbnailFailed(QString)));
-        ((QThreadPool &)m_thumbnailingPool).start(runnable);
+        m_pending.insert(path);
+        // the view asks for the items it shows last, so the newest requests go first
+        m_thumbnailingPool.start(runnable, ++m_requests);
     }
 private slots:
-    void thumbnailReady(QString path) { emit layoutChanged(); }
-    void thumbnailFailed(QString path) { m_failed.insert(path); }
+    void thumbnailReady(QString path)
+    {
+        m_pending.remove(path);
+        emit layoutChanged();
+    }
+    void thumbnailFailed(QString path)
+    {
+        m_pending.remove(path);
+        m_failed.insert(path);
+    }
     void fileChanged(QString filepath)
     {
         m_thumbnailCache->setStale(filepath);
@@ -184,7 +210,10 @@ private slots:
 
 private:
     SharedIconCachePtr m_thumbnailCache;
+    std::shared_ptr<ThumbnailStore> m_store;
     QThreadPool m_thumbnailingPool;
+    int m_requests = 0;
+    QSet<QString> m_pending;
     QSet<QString> m_failed;
     QSet<QString> watched;
     QFileSystemWatcher watcher;
@@ -213,8 +242,12 @@ public:
 ScreenshotsPage::ScreenshotsPage(QString path, QWidget *parent)
     : QMainWindow(parent), ui(new Ui::ScreenshotsPage)
 {
+    // the thumbnails are kept in the launcher's cache, not next to the screenshots
+    auto storeName = QCryptographicHash::hash(QDir(path).absolutePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    auto store = std::make_shared<ThumbnailStore>(FS::PathCombine("cache", "screenshots", storeName + ".thumbs"), path);
+
     m_model.reset(new QFileSystemModel());
-    m_filterModel.reset(new FilterModel());
+    m_filterModel.reset(new FilterModel(store));
     m_filterModel->setSourceModel(m_model.get());
     m_model->setFilter(QDir::Files | QDir::Writable | QDir::Readable);
     m_model->setReadOnly(false);
@@ -25,6 +25,7 @@
 #include <QListView>
 #include <QString>
 #include <QUrl>
+#include <QFile>
 
 #include "VersionPage.h"
 #include "ui_VersionPage.h"
@@ -401,6 +402,8 @@ void VersionPage::on_actionDownload_All_triggered()
         return;
     }
 
+    // the user asked for everything to be checked again, so the last update's launch manifest does not count
+    QFile::remove(m_inst->launchManifestLocation());
     auto updateTask = m_inst->createUpdateTask(Net::Mode::Online);
     if (!updateTask)
     {
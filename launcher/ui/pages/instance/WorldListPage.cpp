@@ -16,6 +16,8 @@
 #include "WorldListPage.h"
 #include "ui_WorldListPage.h"
 #include "minecraft/WorldList.h"
+#include "minecraft/backup/WorldBackupStore.h"
+#include "minecraft/backup/WorldRestoreTask.h"
 
 #include <QEvent>
 #include <QMenu>
@@ -25,11 +27,14 @@
 #include <QTreeView>
 #include <QInputDialog>
 #include <QProcess>
+#include <algorithm>
 
 #include "tools/MCEditTool.h"
 #include "FileSystem.h"
 
 #include "ui/GuiUtil.h"
+#include "ui/dialogs/CustomMessageBox.h"
+#include "ui/dialogs/ProgressDialog.h"
 #include "DesktopServices.h"
 
 #include "Application.h"
@@ -59,6 +64,17 @@ public:
 
         return sourceIndex.data(role);
     }
+
+protected:
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override
+    {
+        // the size column displays formatted text, sort it by the actual number of bytes instead
+        if (left.column() == WorldList::SizeColumn)
+        {
+            return left.data(WorldList::SizeRole).toLongLong() < right.data(WorldList::SizeRole).toLongLong();
+        }
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
 };
 
 
@@ -82,6 +98,7 @@ WorldListPage::WorldListPage(BaseInstance *inst, std::shared_ptr<WorldList> worl
     auto head = ui->worldTreeView->header();
     head->setSectionResizeMode(0, QHeaderView::Stretch);
     head->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+    head->setSectionResizeMode(WorldList::SizeColumn, QHeaderView::ResizeToContents);
 
     connect(ui->worldTreeView->selectionModel(), &QItemSelectionModel::currentChanged, this, &WorldListPage::worldChanged);
     worldChanged(QModelIndex(), QModelIndex());
@@ -319,6 +336,7 @@ void WorldListPage::worldChanged(const QModelIndex &current, const QModelIndex &
     ui->actionCopy->setEnabled(enable);
     ui->actionRename->setEnabled(enable);
     ui->actionDatapacks->setEnabled(enable);
+    ui->actionRestore_Backup->setEnabled(enable);
     bool hasIcon = !index.data(WorldList::IconFileRole).isNull();
     ui->actionReset_Icon->setEnabled(enable && hasIcon);
 }
@@ -404,6 +422,49 @@ void WorldListPage::on_actionRename_triggered()
     }
 }
 
+void WorldListPage::on_actionRestore_Backup_triggered()
+{
+    QModelIndex index = getSelectedWorld();
+    if (!index.isValid())
+    {
+        return;
+    }
+    auto mcInst = dynamic_cast<MinecraftInstance *>(m_inst);
+    if (!mcInst)
+    {
+        return;
+    }
+
+    auto worldVariant = m_worlds->data(index, WorldList::ObjectRole);
+    auto world = (World *) worldVariant.value<void *>();
+    auto folder = world->folderName();
+
+    WorldBackupStore store(mcInst->worldBackupsDir());
+    auto snapshots = store.snapshots(folder);
+    if (snapshots.isEmpty())
+    {
+        CustomMessageBox::selectable(this, tr("No backups"), tr("There are no backups of this world yet."), QMessageBox::Information)->show();
+        return;
+    }
+    // newest first
+    std::reverse(snapshots.begin(), snapshots.end());
+
+    bool ok = false;
+    auto snapshot = QInputDialog::getItem(this, tr("Restore Backup"), tr("Select the backup to restore as a new world."), snapshots, 0, false, &ok);
+    if (!ok || snapshot.isEmpty())
+    {
+        return;
+    }
+
+    auto target = FS::PathCombine(m_worlds->dir().absolutePath(), FS::DirNameFromString(folder + "-" + snapshot, m_worlds->dir().absolutePath()));
+    WorldRestoreTask task(mcInst->worldBackupsDir(), folder, snapshot, target);
+    ProgressDialog dialog(this);
+    if (dialog.execWithTask(&task) != QDialog::Accepted)
+    {
+        CustomMessageBox::selectable(this, tr("Restore failed"), task.failReason(), QMessageBox::Warning)->show();
+    }
+}
+
 void WorldListPage::on_actionRefresh_triggered()
 {
     m_worlds->update();
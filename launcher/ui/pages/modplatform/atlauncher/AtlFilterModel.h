@@ -2,6 +2,8 @@
 
 #include <QtCore/QSortFilterProxyModel>
 
+#include "modplatform/CatalogIndex.h"
+
 namespace Atl {
 
 class FilterModel : public QSortFilterProxyModel
@@ -19,15 +21,26 @@ public:
     void setSorting(Sorting sorting);
     Sorting getCurrentSorting();
     void setSearchTerm(QString term);
+    void setSourceModel(QAbstractItemModel *model) override;
+
+private slots:
+    void packsChanged();
 
 protected:
     bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
 
+private:
+    void updateMatches();
+
 private:
     QMap<QString, Sorting> sortings;
     Sorting currentSorting;
     QString searchTerm;
+    // rebuilt on the next search after the packs changed
+    CatalogIndex searchIndex;
+    bool indexDirty = true;
+    QHash<int, double> matches;
 
 };
 
@@ -4,10 +4,28 @@
 #include <Application.h>
 #include <Json.h>
 
+#include "ImageLoader.h"
+#include "modplatform/CatalogStore.h"
+
+#include <QFile>
+
 namespace Atl {
 
+namespace {
+QString logoPath(const QString &logo)
+{
+    return QString("logos/%1").arg(logo.section(".", 0, 0));
+}
+
+QUrl logoDownloadUrl(const QString &logo)
+{
+    return QString(BuildConfig.ATL_DOWNLOAD_SERVER_URL + "launcher/images/%1.png").arg(logo.toLower());
+}
+}
+
 ListModel::ListModel(QObject *parent) : QAbstractListModel(parent)
 {
+    connect(APPLICATION->images().get(), &ImageLoader::loaded, this, &ListModel::logoLoaded);
 }
 
 ListModel::~ListModel()
@@ -43,16 +61,12 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
     }
     else if(role == Qt::DecorationRole)
     {
-        if(m_logoMap.contains(pack.safeName))
+        auto icon = APPLICATION->images()->icon("ATLauncherPacks", logoPath(pack.safeName), logoDownloadUrl(pack.safeName), QSize(96, 48));
+        if(!icon.isNull())
         {
-            return (m_logoMap.value(pack.safeName));
+            return icon;
         }
-        auto icon = APPLICATION->getThemedIcon("atlauncher-placeholder");
-
-        auto url = QString(BuildConfig.ATL_DOWNLOAD_SERVER_URL + "launcher/images/%1.png").arg(pack.safeName.toLower());
-        ((ListModel *)this)->requestLogo(pack.safeName, url);
-
-        return icon;
+        return APPLICATION->getThemedIcon("atlauncher-placeholder");
     }
     else if(role == Qt::UserRole)
     {
@@ -66,13 +80,12 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
 
 void ListModel::request()
 {
-    beginResetModel();
-    modpacks.clear();
-    endResetModel();
+    // show the catalog from the last sync right away, the download below only refreshes it
+    loadPacks(CatalogStore::read("ATLauncherPacks", "packsnew.json"));
 
     auto *netJob = new NetJob("Atl::Request");
     auto url = QString(BuildConfig.ATL_DOWNLOAD_SERVER_URL + "launcher/json/packsnew.json");
-    netJob->addNetAction(Net::Download::makeByteArray(QUrl(url), &response));
+    netJob->addNetAction(CatalogStore::makeDownload("ATLauncherPacks", "packsnew.json", QUrl(url)));
     jobPtr = netJob;
     jobPtr->start(APPLICATION->network());
 
@@ -84,6 +97,25 @@ void ListModel::requestFinished()
 {
     jobPtr.reset();
 
+    auto data = CatalogStore::read("ATLauncherPacks", "packsnew.json");
+    if(data != response)
+    {
+        loadPacks(data);
+    }
+}
+
+void ListModel::loadPacks(const QByteArray &data)
+{
+    response = data;
+    beginResetModel();
+    modpacks.clear();
+    endResetModel();
+
+    if(data.isEmpty())
+    {
+        return;
+    }
+
     QJsonParseError parse_error;
     QJsonDocument doc = QJsonDocument::fromJson(response, &parse_error);
     if(parse_error.error != QJsonParseError::NoError) {
@@ -119,6 +151,10 @@ void ListModel::requestFinished()
         newList.append(pack);
     }
 
+    if(newList.isEmpty())
+    {
+        return;
+    }
     beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size() + newList.size() - 1);
     modpacks.append(newList);
     endInsertRows();
@@ -131,63 +167,43 @@ void ListModel::requestFailed(QString reason)
 
 void ListModel::getLogo(const QString &logo, const QString &logoUrl, LogoCallback callback)
 {
-    if(m_logoMap.contains(logo))
+    auto fullPath = APPLICATION->images()->originalPath("ATLauncherPacks", logoPath(logo));
+    if(QFile::exists(fullPath))
     {
-        callback(APPLICATION->metacache()->resolveEntry("ATLauncherPacks", QString("logos/%1").arg(logo.section(".", 0, 0)))->getFullPath());
+        callback(fullPath);
     }
     else
     {
-        requestLogo(logo, logoUrl);
+        // only the pack selected last is waiting for its logo
+        waitingCallbacks.clear();
+        waitingCallbacks.insert(logo, callback);
+        APPLICATION->images()->icon("ATLauncherPacks", logoPath(logo), logoUrl, QSize(96, 48));
     }
 }
 
-void ListModel::logoFailed(QString logo)
-{
-    m_failedLogos.append(logo);
-    m_loadingLogos.removeAll(logo);
-}
-
-void ListModel::logoLoaded(QString logo, QIcon out)
+void ListModel::logoLoaded(const QString &base, const QString &path)
 {
-    m_loadingLogos.removeAll(logo);
-    m_logoMap.insert(logo, out);
-
+    if(base != "ATLauncherPacks")
+    {
+        return;
+    }
     for(int i = 0; i < modpacks.size(); i++) {
-        if(modpacks[i].safeName == logo) {
+        if(logoPath(modpacks[i].safeName) == path) {
             emit dataChanged(createIndex(i, 0), createIndex(i, 0), {Qt::DecorationRole});
         }
     }
-}
-
-void ListModel::requestLogo(QString file, QString url)
-{
-    if(m_loadingLogos.contains(file) || m_failedLogos.contains(file))
-    {
-        return;
-    }
-
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", QString("logos/%1").arg(file.section(".", 0, 0)));
-    NetJob *job = new NetJob(QString("ATLauncher Icon Download %1").arg(file));
-    job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
-
-    auto fullPath = entry->getFullPath();
-    QObject::connect(job, &NetJob::succeeded, this, [this, file, fullPath]
+    for(auto iter = waitingCallbacks.begin(); iter != waitingCallbacks.end();)
     {
-        emit logoLoaded(file, QIcon(fullPath));
-        if(waitingCallbacks.contains(file))
+        if(logoPath(iter.key()) == path)
         {
-            waitingCallbacks.value(file)(fullPath);
+            iter.value()(APPLICATION->images()->originalPath(base, path));
+            iter = waitingCallbacks.erase(iter);
         }
-    });
-
-    QObject::connect(job, &NetJob::failed, this, [this, file]
-    {
-        emit logoFailed(file);
-    });
-
-    job->start(APPLICATION->network());
-
-    m_loadingLogos.append(file);
+        else
+        {
+            iter++;
+        }
+    }
 }
 
 }
@@ -8,7 +8,6 @@
 
 namespace Atl {
 
-typedef QMap<QString, QIcon> LogoMap;
 typedef std::function<void(QString)> LogoCallback;
 
 class ListModel : public QAbstractListModel
@@ -31,18 +30,14 @@ private slots:
     void requestFinished();
     void requestFailed(QString reason);
 
-    void logoFailed(QString logo);
-    void logoLoaded(QString logo, QIcon out);
+    void logoLoaded(const QString &base, const QString &path);
 
 private:
-    void requestLogo(QString file, QString url);
+    void loadPacks(const QByteArray &data);
 
 private:
     QList<ATLauncher::IndexedPack> modpacks;
 
-    QStringList m_failedLogos;
-    QStringList m_loadingLogos;
-    LogoMap m_logoMap;
     QMap<QString, LogoCallback> waitingCallbacks;
 
     NetJob::Ptr jobPtr;
@@ -1,10 +1,12 @@
 #include "FlameModel.h"
 #include "Application.h"
+#include "ImageLoader.h"
 #include <Json.h>
 
 #include <MMCStrings.h>
 #include <Version.h>
 
+#include <QFile>
 #include <QtMath>
 #include <QLabel>
 
@@ -12,8 +14,16 @@
 
 namespace Flame {
 
+namespace {
+QString logoPath(const QString &logo)
+{
+    return QString("logos/%1").arg(logo.section(".", 0, 0));
+}
+}
+
 ListModel::ListModel(QObject *parent) : QAbstractListModel(parent)
 {
+    connect(APPLICATION->images().get(), &ImageLoader::loaded, this, &ListModel::logoLoaded);
 }
 
 ListModel::~ListModel()
@@ -57,13 +67,12 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
     }
     else if(role == Qt::DecorationRole)
     {
-        if(m_logoMap.contains(pack.logoName))
+        auto icon = APPLICATION->images()->icon("FlamePacks", logoPath(pack.logoName), pack.logoUrl, QSize(48, 48));
+        if(!icon.isNull())
         {
-            return (m_logoMap.value(pack.logoName));
+            return icon;
         }
-        QIcon icon = APPLICATION->getThemedIcon("screenshot-placeholder");
-        ((ListModel *)this)->requestLogo(pack.logoName, pack.logoUrl);
-        return icon;
+        return APPLICATION->getThemedIcon("screenshot-placeholder");
     }
     else if(role == Qt::UserRole)
     {
@@ -75,63 +84,44 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
     return QVariant();
 }
 
-void ListModel::logoLoaded(QString logo, QIcon out)
+void ListModel::logoLoaded(const QString &base, const QString &path)
 {
-    m_loadingLogos.removeAll(logo);
-    m_logoMap.insert(logo, out);
+    if(base != "FlamePacks")
+    {
+        return;
+    }
     for(int i = 0; i < modpacks.size(); i++) {
-        if(modpacks[i].logoName == logo) {
+        if(logoPath(modpacks[i].logoName) == path) {
             emit dataChanged(createIndex(i, 0), createIndex(i, 0), {Qt::DecorationRole});
         }
     }
-}
-
-void ListModel::logoFailed(QString logo)
-{
-    m_failedLogos.append(logo);
-    m_loadingLogos.removeAll(logo);
-}
-
-void ListModel::requestLogo(QString logo, QString url)
-{
-    if(m_loadingLogos.contains(logo) || m_failedLogos.contains(logo))
+    for(auto iter = waitingCallbacks.begin(); iter != waitingCallbacks.end();)
     {
-        return;
-    }
-
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("FlamePacks", QString("logos/%1").arg(logo.section(".", 0, 0)));
-    NetJob *job = new NetJob(QString("Flame Icon Download %1").arg(logo));
-    job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
-
-    auto fullPath = entry->getFullPath();
-    QObject::connect(job, &NetJob::succeeded, this, [this, logo, fullPath]
-    {
-        emit logoLoaded(logo, QIcon(fullPath));
-        if(waitingCallbacks.contains(logo))
+        if(logoPath(iter.key()) == path)
         {
-            waitingCallbacks.value(logo)(fullPath);
+            iter.value()(APPLICATION->images()->originalPath(base, path));
+            iter = waitingCallbacks.erase(iter);
         }
-    });
-
-    QObject::connect(job, &NetJob::failed, this, [this, logo]
-    {
-        emit logoFailed(logo);
-    });
-
-    job->start(APPLICATION->network());
-
-    m_loadingLogos.append(logo);
+        else
+        {
+            iter++;
+        }
+    }
 }
 
 void ListModel::getLogo(const QString &logo, const QString &logoUrl, LogoCallback callback)
 {
-    if(m_logoMap.contains(logo))
+    auto fullPath = APPLICATION->images()->originalPath("FlamePacks", logoPath(logo));
+    if(QFile::exists(fullPath))
     {
-        callback(APPLICATION->metacache()->resolveEntry("FlamePacks", QString("logos/%1").arg(logo.section(".", 0, 0)))->getFullPath());
+        callback(fullPath);
     }
     else
     {
-        requestLogo(logo, logoUrl);
+        // only the pack selected last is waiting for its logo
+        waitingCallbacks.clear();
+        waitingCallbacks.insert(logo, callback);
+        APPLICATION->images()->icon("FlamePacks", logoPath(logo), logoUrl, QSize(48, 48));
     }
 }
 
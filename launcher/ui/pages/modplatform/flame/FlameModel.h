@@ -19,8 +19,6 @@
 
 namespace Flame {
 
-
-typedef QMap<QString, QIcon> LogoMap;
 typedef std::function<void(QString)> LogoCallback;
 
 class ListModel : public QAbstractListModel
@@ -44,20 +42,13 @@ public:
 private slots:
     void performPaginatedSearch();
 
-    void logoFailed(QString logo);
-    void logoLoaded(QString logo, QIcon out);
+    void logoLoaded(const QString &base, const QString &path);
 
     void searchRequestFinished();
     void searchRequestFailed(QString reason);
 
-private:
-    void requestLogo(QString file, QString url);
-
 private:
     QList<IndexedPack> modpacks;
-    QStringList m_failedLogos;
-    QStringList m_loadingLogos;
-    LogoMap m_logoMap;
     QMap<QString, LogoCallback> waitingCallbacks;
 
     QString currentSearchTerm;
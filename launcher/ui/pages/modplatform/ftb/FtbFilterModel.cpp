@@ -39,6 +39,52 @@ FilterModel::Sorting FilterModel::getCurrentSorting()
 void FilterModel::setSearchTerm(const QString& term)
 {
     searchTerm = term.trimmed();
+    updateMatches();
+}
+
+void FilterModel::setSourceModel(QAbstractItemModel *model)
+{
+    QSortFilterProxyModel::setSourceModel(model);
+    connect(model, &QAbstractItemModel::modelReset, this, &FilterModel::packsChanged);
+    connect(model, &QAbstractItemModel::rowsInserted, this, &FilterModel::packsChanged);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &FilterModel::packsChanged);
+    connect(model, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &, const QModelIndex &, const QVector<int> &roles) {
+        // logos arriving don't change what can be searched
+        if (roles.isEmpty() || roles.contains(Qt::DisplayRole)) {
+            packsChanged();
+        }
+    });
+    packsChanged();
+}
+
+void FilterModel::packsChanged()
+{
+    indexDirty = true;
+    if (!searchTerm.isEmpty()) {
+        updateMatches();
+    }
+}
+
+void FilterModel::updateMatches()
+{
+    matches.clear();
+    if (!searchTerm.isEmpty()) {
+        if (indexDirty) {
+            searchIndex.clear();
+            for (int row = 0; row < sourceModel()->rowCount(); row++) {
+                auto pack = sourceModel()->data(sourceModel()->index(row, 0), Qt::UserRole).value<ModpacksCH::Modpack>();
+                QString text = pack.synopsis;
+                for (auto &author: pack.authors) {
+                    text += " " + author.name;
+                }
+                searchIndex.add(row, pack.name, text);
+            }
+            indexDirty = false;
+        }
+        for (auto &match: searchIndex.search(searchTerm)) {
+            matches.insert(match.id, match.score);
+        }
+    }
     invalidate();
 }
 
@@ -47,14 +93,20 @@ bool FilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParen
     if (searchTerm.isEmpty()) {
         return true;
     }
-
-    auto index = sourceModel()->index(sourceRow, 0, sourceParent);
-    auto pack = sourceModel()->data(index, Qt::UserRole).value<ModpacksCH::Modpack>();
-    return pack.name.contains(searchTerm, Qt::CaseInsensitive);
+    return matches.contains(sourceRow);
 }
 
 bool FilterModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
+    // while searching, the best matches go first no matter the sorting
+    if (!searchTerm.isEmpty()) {
+        double leftScore = matches.value(left.row());
+        double rightScore = matches.value(right.row());
+        if (leftScore != rightScore) {
+            return sortOrder() == Qt::AscendingOrder ? leftScore > rightScore : leftScore < rightScore;
+        }
+    }
+
     ModpacksCH::Modpack leftPack = sourceModel()->data(left, Qt::UserRole).value<ModpacksCH::Modpack>();
     ModpacksCH::Modpack rightPack = sourceModel()->data(right, Qt::UserRole).value<ModpacksCH::Modpack>();
 
@@ -3,13 +3,23 @@
 #include "BuildConfig.h"
 #include "Application.h"
 #include "Json.h"
+#include "ImageLoader.h"
+#include "modplatform/CatalogStore.h"
 
-#include <QPainter>
+#include <QFile>
 
 namespace Ftb {
 
+namespace {
+QString logoPath(const QString &logo)
+{
+    return QString("logos/%1").arg(logo.section(".", 0, 0));
+}
+}
+
 ListModel::ListModel(QObject *parent) : QAbstractListModel(parent)
 {
+    connect(APPLICATION->images().get(), &ImageLoader::loaded, this, &ListModel::logoLoaded);
 }
 
 ListModel::~ListModel()
@@ -45,23 +55,16 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
     }
     else if(role == Qt::DecorationRole)
     {
-        QIcon placeholder = APPLICATION->getThemedIcon("screenshot-placeholder");
-
-        auto iter = m_logoMap.find(pack.name);
-        if (iter != m_logoMap.end()) {
-            auto & logo = *iter;
-            if(!logo.result.isNull()) {
-                return logo.result;
-            }
-            return placeholder;
-        }
-
         for(auto art : pack.art) {
             if(art.type == "square") {
-                ((ListModel *)this)->requestLogo(pack.name, art.url);
+                auto icon = APPLICATION->images()->icon("ModpacksCHPacks", logoPath(pack.name), art.url, QSize(48, 48));
+                if(!icon.isNull()) {
+                    return icon;
+                }
+                break;
             }
         }
-        return placeholder;
+        return APPLICATION->getThemedIcon("screenshot-placeholder");
     }
     else if(role == Qt::UserRole)
     {
@@ -75,13 +78,17 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
 
 void ListModel::getLogo(const QString &logo, const QString &logoUrl, LogoCallback callback)
 {
-    if(m_logoMap.contains(logo))
+    auto fullPath = APPLICATION->images()->originalPath("ModpacksCHPacks", logoPath(logo));
+    if(QFile::exists(fullPath))
     {
-        callback(APPLICATION->metacache()->resolveEntry("ModpacksCHPacks", QString("logos/%1").arg(logo.section(".", 0, 0)))->getFullPath());
+        callback(fullPath);
     }
     else
     {
-        requestLogo(logo, logoUrl);
+        // only the pack selected last is waiting for its logo
+        waitingCallbacks.clear();
+        waitingCallbacks.insert(logo, callback);
+        APPLICATION->images()->icon("ModpacksCHPacks", logoPath(logo), logoUrl, QSize(48, 48));
     }
 }
 
@@ -91,9 +98,19 @@ void ListModel::request()
     modpacks.clear();
     endResetModel();
 
+    // show the packs from the last sync right away, the downloads below only refresh them
+    for(auto packId : loadPackList(CatalogStore::read("ModpacksCHPacks", "list.json")))
+    {
+        ModpacksCH::Modpack pack;
+        if(loadPack(CatalogStore::read("ModpacksCHPacks", QString("packs/%1.json").arg(packId)), pack))
+        {
+            updatePack(pack);
+        }
+    }
+
     auto *netJob = new NetJob("Ftb::Request");
     auto url = QString(BuildConfig.MODPACKSCH_API_BASE_URL + "public/modpack/all");
-    netJob->addNetAction(Net::Download::makeByteArray(QUrl(url), &response));
+    netJob->addNetAction(CatalogStore::makeDownload("ModpacksCHPacks", "list.json", QUrl(url)));
     jobPtr = netJob;
     jobPtr->start(APPLICATION->network());
 
@@ -101,23 +118,95 @@ void ListModel::request()
     QObject::connect(netJob, &NetJob::failed, this, &ListModel::requestFailed);
 }
 
-void ListModel::requestFinished()
+QList<int> ListModel::loadPackList(const QByteArray &data) const
 {
-    jobPtr.reset();
-    remainingPacks.clear();
+    QList<int> packIds;
+    if(data.isEmpty())
+    {
+        return packIds;
+    }
 
     QJsonParseError parse_error;
-    QJsonDocument doc = QJsonDocument::fromJson(response, &parse_error);
+    QJsonDocument doc = QJsonDocument::fromJson(data, &parse_error);
     if(parse_error.error != QJsonParseError::NoError) {
         qWarning() << "Error while parsing JSON response from FTB at " << parse_error.offset << " reason: " << parse_error.errorString();
-        qWarning() << response;
-        return;
+        qWarning() << data;
+        return packIds;
     }
 
     auto packs = doc.object().value("packs").toArray();
     for(auto pack : packs) {
-        auto packId = pack.toInt();
-        remainingPacks.append(packId);
+        packIds.append(pack.toInt());
+    }
+    return packIds;
+}
+
+bool ListModel::loadPack(const QByteArray &data, ModpacksCH::Modpack &pack) const
+{
+    if(data.isEmpty())
+    {
+        return false;
+    }
+
+    QJsonParseError parse_error;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &parse_error);
+    if(parse_error.error != QJsonParseError::NoError) {
+        qWarning() << "Error while parsing JSON response from FTB at " << parse_error.offset << " reason: " << parse_error.errorString();
+        qWarning() << data;
+        return false;
+    }
+
+    try
+    {
+        ModpacksCH::loadModpack(pack, doc.object());
+    }
+    catch (const JSONValidationError &e)
+    {
+        qDebug() << QString::fromUtf8(data);
+        qWarning() << "Error while reading pack manifest from FTB: " << e.cause();
+        return false;
+    }
+
+    // Since there is no guarantee that packs have a version, this will just
+    // ignore those "dud" packs.
+    if (pack.versions.empty())
+    {
+        qWarning() << "FTB Pack " << pack.id << " ignored. reason: lacking any versions";
+        return false;
+    }
+    return true;
+}
+
+void ListModel::updatePack(const ModpacksCH::Modpack &pack)
+{
+    for(int i = 0; i < modpacks.size(); i++)
+    {
+        if(modpacks[i].id == pack.id)
+        {
+            modpacks[i] = pack;
+            emit dataChanged(createIndex(i, 0), createIndex(i, 0));
+            return;
+        }
+    }
+    beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size());
+    modpacks.append(pack);
+    endInsertRows();
+}
+
+void ListModel::requestFinished()
+{
+    jobPtr.reset();
+    remainingPacks = loadPackList(CatalogStore::read("ModpacksCHPacks", "list.json"));
+
+    // drop the cached packs that are not listed anymore
+    for(int i = modpacks.size() - 1; i >= 0; i--)
+    {
+        if(!remainingPacks.contains(modpacks[i].id))
+        {
+            beginRemoveRows(QModelIndex(), i, i);
+            modpacks.removeAt(i);
+            endRemoveRows();
+        }
     }
 
     if(!remainingPacks.isEmpty()) {
@@ -137,7 +226,7 @@ void ListModel::requestPack()
     auto *netJob = new NetJob("Ftb::Search");
     auto searchUrl = QString(BuildConfig.MODPACKSCH_API_BASE_URL + "public/modpack/%1")
             .arg(currentPack);
-    netJob->addNetAction(Net::Download::makeByteArray(QUrl(searchUrl), &response));
+    netJob->addNetAction(CatalogStore::makeDownload("ModpacksCHPacks", QString("packs/%1.json").arg(currentPack), QUrl(searchUrl)));
     jobPtr = netJob;
     jobPtr->start(APPLICATION->network());
 
@@ -150,40 +239,10 @@ void ListModel::packRequestFinished()
     jobPtr.reset();
     remainingPacks.removeOne(currentPack);
 
-    QJsonParseError parse_error;
-    QJsonDocument doc = QJsonDocument::fromJson(response, &parse_error);
-
-    if(parse_error.error != QJsonParseError::NoError) {
-        qWarning() << "Error while parsing JSON response from FTB at " << parse_error.offset << " reason: " << parse_error.errorString();
-        qWarning() << response;
-        return;
-    }
-
-    auto obj = doc.object();
-
     ModpacksCH::Modpack pack;
-    try
-    {
-        ModpacksCH::loadModpack(pack, obj);
-    }
-    catch (const JSONValidationError &e)
+    if(loadPack(CatalogStore::read("ModpacksCHPacks", QString("packs/%1.json").arg(currentPack)), pack))
     {
-        qDebug() << QString::fromUtf8(response);
-        qWarning() << "Error while reading pack manifest from FTB: " << e.cause();
-        return;
-    }
-
-    // Since there is no guarantee that packs have a version, this will just
-    // ignore those "dud" packs.
-    if (pack.versions.empty())
-    {
-        qWarning() << "FTB Pack " << pack.id << " ignored. reason: lacking any versions";
-    }
-    else
-    {
-        beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size());
-        modpacks.append(pack);
-        endInsertRows();
+        updatePack(pack);
     }
 
     if(!remainingPacks.isEmpty()) {
@@ -198,81 +257,29 @@ void ListModel::packRequestFailed(QString reason)
     remainingPacks.removeOne(currentPack);
 }
 
-void ListModel::logoLoaded(QString logo, bool stale)
+void ListModel::logoLoaded(const QString &base, const QString &path)
 {
-    auto & logoObj = m_logoMap[logo];
-    logoObj.downloadJob.reset();
-    QString smallPath = logoObj.fullpath + ".small";
-
-    QFileInfo smallInfo(smallPath);
-
-    if(stale || !smallInfo.exists()) {
-        QImage image(logoObj.fullpath);
-        if (image.isNull())
-        {
-            logoObj.failed = true;
-            return;
-        }
-        QImage small;
-        if (image.width() > image.height()) {
-            small = image.scaledToWidth(512).scaledToWidth(256, Qt::SmoothTransformation);
-        }
-        else {
-            small = image.scaledToHeight(512).scaledToHeight(256, Qt::SmoothTransformation);
-        }
-        QPoint offset((256 - small.width()) / 2, (256 - small.height()) / 2);
-        QImage square(QSize(256, 256), QImage::Format_ARGB32);
-        square.fill(Qt::transparent);
-
-        QPainter painter(&square);
-        painter.drawImage(offset, small);
-        painter.end();
-
-        square.save(logoObj.fullpath + ".small", "PNG");
+    if(base != "ModpacksCHPacks")
+    {
+        return;
     }
-
-    logoObj.result = QIcon(logoObj.fullpath + ".small");
     for(int i = 0; i < modpacks.size(); i++) {
-        if(modpacks[i].name == logo) {
+        if(logoPath(modpacks[i].name) == path) {
             emit dataChanged(createIndex(i, 0), createIndex(i, 0), {Qt::DecorationRole});
         }
     }
-}
-
-void ListModel::logoFailed(QString logo)
-{
-    m_logoMap[logo].failed = true;
-    m_logoMap[logo].downloadJob.reset();
-}
-
-void ListModel::requestLogo(QString logo, QString url)
-{
-    if(m_logoMap.contains(logo)) {
-        return;
-    }
-
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("ModpacksCHPacks", QString("logos/%1").arg(logo.section(".", 0, 0)));
-
-    bool stale = entry->isStale();
-
-    NetJob *job = new NetJob(QString("FTB Icon Download %1").arg(logo));
-    job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
-
-    auto fullPath = entry->getFullPath();
-    QObject::connect(job, &NetJob::finished, this, [this, logo, fullPath, stale]
-    {
-        logoLoaded(logo, stale);
-    });
-
-    QObject::connect(job, &NetJob::failed, this, [this, logo]
+    for(auto iter = waitingCallbacks.begin(); iter != waitingCallbacks.end();)
     {
-        logoFailed(logo);
-    });
-
-    auto &newLogoEntry = m_logoMap[logo];
-    newLogoEntry.downloadJob = job;
-    newLogoEntry.fullpath = fullPath;
-    job->start(APPLICATION->network());
+        if(logoPath(iter.key()) == path)
+        {
+            iter.value()(APPLICATION->images()->originalPath(base, path));
+            iter = waitingCallbacks.erase(iter);
+        }
+        else
+        {
+            iter++;
+        }
+    }
 }
 
 }
@@ -8,14 +8,6 @@
 
 namespace Ftb {
 
-struct Logo {
-    QString fullpath;
-    NetJob::Ptr downloadJob;
-    QIcon result;
-    bool failed = false;
-};
-
-typedef QMap<QString, Logo> LogoMap;
 typedef std::function<void(QString)> LogoCallback;
 
 class ListModel : public QAbstractListModel
@@ -42,20 +34,20 @@ private slots:
     void packRequestFinished();
     void packRequestFailed(QString reason);
 
-    void logoFailed(QString logo);
-    void logoLoaded(QString logo, bool stale);
+    void logoLoaded(const QString &base, const QString &path);
 
 private:
-    void requestLogo(QString file, QString url);
+    QList<int> loadPackList(const QByteArray &data) const;
+    bool loadPack(const QByteArray &data, ModpacksCH::Modpack &pack) const;
+    void updatePack(const ModpacksCH::Modpack &pack);
 
 private:
     QList<ModpacksCH::Modpack> modpacks;
-    LogoMap m_logoMap;
+    QMap<QString, LogoCallback> waitingCallbacks;
 
     NetJob::Ptr jobPtr;
     int currentPack;
     QList<int> remainingPacks;
-    QByteArray response;
 };
 
 }
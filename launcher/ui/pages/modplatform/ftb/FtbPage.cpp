@@ -93,7 +93,7 @@ void FtbPage::suggestCurrent()
 
             listModel->getLogo(selected.name, art.url, [this, editedLogoName](QString logo)
             {
-                dialog->setSuggestedIconFromFile(logo + ".small", editedLogoName);
+                dialog->setSuggestedIconFromFile(logo, editedLogoName);
             });
         }
     }
@@ -10,11 +10,24 @@
 #include <RWStorage.h>
 
 #include <BuildConfig.h>
-#include <net/HttpMetaCache.h>
-#include <net/NetJob.h>
+#include "ImageLoader.h"
+
+#include <QFile>
 
 namespace LegacyFTB {
 
+namespace {
+QString logoPath(const QString &logo)
+{
+    return QString("logos/%1").arg(logo.section(".", 0, 0));
+}
+
+QUrl logoUrl(const QString &logo)
+{
+    return QString(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/%1").arg(logo);
+}
+}
+
 FilterModel::FilterModel(QObject *parent) : QSortFilterProxyModel(parent)
 {
     currentSorting = Sorting::ByGameVersion;
@@ -69,6 +82,7 @@ FilterModel::Sorting FilterModel::getCurrentSorting()
 
 ListModel::ListModel(QObject *parent) : QAbstractListModel(parent)
 {
+    connect(APPLICATION->images().get(), &ImageLoader::loaded, this, &ListModel::logoLoaded);
 }
 
 ListModel::~ListModel()
@@ -127,13 +141,12 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
     }
     else if(role == Qt::DecorationRole)
     {
-        if(m_logoMap.contains(pack.logo))
+        auto icon = APPLICATION->images()->icon("FTBPacks", logoPath(pack.logo), logoUrl(pack.logo), QSize(42, 42));
+        if(!icon.isNull())
         {
-            return (m_logoMap.value(pack.logo));
+            return icon;
         }
-        QIcon icon = APPLICATION->getThemedIcon("screenshot-placeholder");
-        ((ListModel *)this)->requestLogo(pack.logo);
-        return icon;
+        return APPLICATION->getThemedIcon("screenshot-placeholder");
     }
     else if(role == Qt::TextColorRole)
     {
@@ -197,59 +210,46 @@ void ListModel::remove(int row)
     endRemoveRows();
 }
 
-void ListModel::logoLoaded(QString logo, QIcon out)
-{
-    m_loadingLogos.removeAll(logo);
-    m_logoMap.insert(logo, out);
-    emit dataChanged(createIndex(0, 0), createIndex(1, 0));
-}
-
-void ListModel::logoFailed(QString logo)
+void ListModel::logoLoaded(const QString &base, const QString &path)
 {
-    m_failedLogos.append(logo);
-    m_loadingLogos.removeAll(logo);
-}
-
-void ListModel::requestLogo(QString file)
-{
-    if(m_loadingLogos.contains(file) || m_failedLogos.contains(file))
+    if(base != "FTBPacks")
     {
         return;
     }
-
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("FTBPacks", QString("logos/%1").arg(file.section(".", 0, 0)));
-    NetJob *job = new NetJob(QString("FTB Icon Download for %1").arg(file));
-    job->addNetAction(Net::Download::makeCached(QUrl(QString(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/%1").arg(file)), entry));
-
-    auto fullPath = entry->getFullPath();
-    QObject::connect(job, &NetJob::finished, this, [this, file, fullPath]
+    for(int i = 0; i < modpacks.size(); i++)
     {
-        emit logoLoaded(file, QIcon(fullPath));
-        if(waitingCallbacks.contains(file))
+        if(logoPath(modpacks[i].logo) == path)
         {
-            waitingCallbacks.value(file)(fullPath);
+            emit dataChanged(createIndex(i, 0), createIndex(i, 0), {Qt::DecorationRole});
         }
-    });
-
-    QObject::connect(job, &NetJob::failed, this, [this, file]
+    }
+    for(auto iter = waitingCallbacks.begin(); iter != waitingCallbacks.end();)
     {
-        emit logoFailed(file);
-    });
-
-    job->start(APPLICATION->network());
-
-    m_loadingLogos.append(file);
+        if(logoPath(iter.key()) == path)
+        {
+            iter.value()(APPLICATION->images()->originalPath(base, path));
+            iter = waitingCallbacks.erase(iter);
+        }
+        else
+        {
+            iter++;
+        }
+    }
 }
 
 void ListModel::getLogo(const QString &logo, LogoCallback callback)
 {
-    if(m_logoMap.contains(logo))
+    auto fullPath = APPLICATION->images()->originalPath("FTBPacks", logoPath(logo));
+    if(QFile::exists(fullPath))
     {
-        callback(APPLICATION->metacache()->resolveEntry("FTBPacks", QString("logos/%1").arg(logo.section(".", 0, 0)))->getFullPath());
+        callback(fullPath);
     }
     else
     {
-        requestLogo(logo);
+        // only the pack selected last is waiting for its logo
+        waitingCallbacks.clear();
+        waitingCallbacks.insert(logo, callback);
+        APPLICATION->images()->icon("FTBPacks", logoPath(logo), logoUrl(logo), QSize(42, 42));
     }
 }
 
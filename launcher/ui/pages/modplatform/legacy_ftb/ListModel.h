@@ -13,7 +13,6 @@
 
 namespace LegacyFTB {
 
-typedef QMap<QString, QIcon> FTBLogoMap;
 typedef std::function<void(QString)> LogoCallback;
 
 class FilterModel : public QSortFilterProxyModel
@@ -45,18 +44,13 @@ class ListModel : public QAbstractListModel
     Q_OBJECT
 private:
     ModpackList modpacks;
-    QStringList m_failedLogos;
-    QStringList m_loadingLogos;
-    FTBLogoMap m_logoMap;
     QMap<QString, LogoCallback> waitingCallbacks;
 
-    void requestLogo(QString file);
     QString translatePackType(PackType type) const;
 
 
 private slots:
-    void logoFailed(QString logo);
-    void logoLoaded(QString logo, QIcon out);
+    void logoLoaded(const QString &base, const QString &path);
 
 public:
     ListModel(QObject *parent);
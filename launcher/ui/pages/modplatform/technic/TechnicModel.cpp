@@ -15,12 +15,22 @@
 
 #include "TechnicModel.h"
 #include "Application.h"
+#include "ImageLoader.h"
 #include "Json.h"
 
+#include <QFile>
 #include <QIcon>
 
+namespace {
+QString logoPath(const QString &logo)
+{
+    return QString("logos/%1").arg(logo);
+}
+}
+
 Technic::ListModel::ListModel(QObject *parent) : QAbstractListModel(parent)
 {
+    connect(APPLICATION->images().get(), &ImageLoader::loaded, this, &ListModel::logoLoaded);
 }
 
 Technic::ListModel::~ListModel()
@@ -42,13 +52,15 @@ QVariant Technic::ListModel::data(const QModelIndex& index, int role) const
     }
     else if(role == Qt::DecorationRole)
     {
-        if(m_logoMap.contains(pack.logoName))
+        if(pack.logoName != "null")
         {
-            return (m_logoMap.value(pack.logoName));
+            auto icon = APPLICATION->images()->icon("TechnicPacks", logoPath(pack.logoName), pack.logoUrl, QSize(48, 48));
+            if(!icon.isNull())
+            {
+                return icon;
+            }
         }
-        QIcon icon = APPLICATION->getThemedIcon("screenshot-placeholder");
-        ((ListModel *)this)->requestLogo(pack.logoName, pack.logoUrl);
-        return icon;
+        return APPLICATION->getThemedIcon("screenshot-placeholder");
     }
     else if(role == Qt::UserRole)
     {
@@ -160,13 +172,21 @@ void Technic::ListModel::searchRequestFinished()
 
 void Technic::ListModel::getLogo(const QString& logo, const QString& logoUrl, Technic::LogoCallback callback)
 {
-    if(m_logoMap.contains(logo))
+    if(logo == "null")
+    {
+        return;
+    }
+    auto fullPath = APPLICATION->images()->originalPath("TechnicPacks", logoPath(logo));
+    if(QFile::exists(fullPath))
     {
-        callback(APPLICATION->metacache()->resolveEntry("TechnicPacks", QString("logos/%1").arg(logo))->getFullPath());
+        callback(fullPath);
     }
     else
     {
-        requestLogo(logo, logoUrl);
+        // only the pack selected last is waiting for its logo
+        waitingCallbacks.clear();
+        waitingCallbacks.insert(logo, callback);
+        APPLICATION->images()->icon("TechnicPacks", logoPath(logo), logoUrl, QSize(48, 48));
     }
 }
 
@@ -189,49 +209,29 @@ void Technic::ListModel::searchRequestFailed()
 }
 
 
-void Technic::ListModel::logoLoaded(QString logo, QString out)
+void Technic::ListModel::logoLoaded(const QString &base, const QString &path)
 {
-    m_loadingLogos.removeAll(logo);
-    m_logoMap.insert(logo, QIcon(out));
+    if(base != "TechnicPacks")
+    {
+        return;
+    }
     for(int i = 0; i < modpacks.size(); i++)
     {
-        if(modpacks[i].logoName == logo)
+        if(logoPath(modpacks[i].logoName) == path)
         {
             emit dataChanged(createIndex(i, 0), createIndex(i, 0), {Qt::DecorationRole});
         }
     }
-}
-
-void Technic::ListModel::logoFailed(QString logo)
-{
-    m_failedLogos.append(logo);
-    m_loadingLogos.removeAll(logo);
-}
-
-void Technic::ListModel::requestLogo(QString logo, QString url)
-{
-    if(m_loadingLogos.contains(logo) || m_failedLogos.contains(logo) || logo == "null")
+    for(auto iter = waitingCallbacks.begin(); iter != waitingCallbacks.end();)
     {
-        return;
+        if(logoPath(iter.key()) == path)
+        {
+            iter.value()(APPLICATION->images()->originalPath(base, path));
+            iter = waitingCallbacks.erase(iter);
+        }
+        else
+        {
+            iter++;
+        }
     }
-
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("TechnicPacks", QString("logos/%1").arg(logo));
-    NetJob *job = new NetJob(QString("Technic Icon Download %1").arg(logo));
-    job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
-
-    auto fullPath = entry->getFullPath();
-
-    QObject::connect(job, &NetJob::succeeded, this, [this, logo, fullPath]
-    {
-        logoLoaded(logo, fullPath);
-    });
-
-    QObject::connect(job, &NetJob::failed, this, [this, logo]
-    {
-        logoFailed(logo);
-    });
-
-    job->start(APPLICATION->network());
-
-    m_loadingLogos.append(logo);
 }
@@ -43,18 +43,13 @@ private slots:
     void searchRequestFinished();
     void searchRequestFailed();
 
-    void logoFailed(QString logo);
-    void logoLoaded(QString logo, QString out);
+    void logoLoaded(const QString &base, const QString &path);
 
 private:
     void performSearch();
-    void requestLogo(QString logo, QString url);
 
 private:
     QList<Modpack> modpacks;
-    QStringList m_failedLogos;
-    QStringList m_loadingLogos;
-    QMap<QString, QIcon> m_logoMap;
     QMap<QString, LogoCallback> waitingCallbacks;
 
     QString currentSearchTerm;
@@ -138,7 +138,7 @@ void LogView::scrollToBottom()
     verticalScrollBar()->setSliderPosition(verticalScrollBar()->maximum());
 }
 
-void LogView::findNext(const QString& what, bool reverse)
+bool LogView::findNext(const QString& what, bool reverse)
 {
-    find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0));
+    return find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0));
 }
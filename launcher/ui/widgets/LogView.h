@@ -16,7 +16,7 @@ public:
 
 public slots:
     void setWordWrap(bool wrapping);
-    void findNext(const QString & what, bool reverse);
+    bool findNext(const QString & what, bool reverse);
     void scrollToBottom();
 
 protected slots: